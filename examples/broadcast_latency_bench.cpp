@@ -0,0 +1,204 @@
+/**
+ * @file broadcast_latency_bench.cpp
+ * @brief 跨进程 Pub/Sub 单向延迟基准
+ *
+ * 父进程发布、子进程订阅 (fork)，订阅端以 LatencyTracker 统计发布到接收的延迟分布与序号缺口。
+ *
+ * 用法:
+ *   broadcast_latency_bench [--messages N] [--rate MSG_PER_SEC] [--payload BYTES]
+ *                           [--pub-cpu CPU] [--sub-cpu CPU] [--numa] [--transport shm_ring|iceoryx2]
+ * rate 为 0 时不限速。
+ */
+
+#include "qaultra/ipc/broadcast_transport.hpp"
+#include "qaultra/ipc/latency_tracker.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace qaultra::ipc;
+
+namespace {
+
+struct BenchOptions {
+    uint64_t messages = 100000;
+    uint64_t rate = 100000;
+    size_t payload = 64;
+    std::optional<int> pub_cpu;
+    std::optional<int> sub_cpu;
+    bool numa = false;
+    BroadcastTransport transport = BroadcastTransport::SharedMemoryRing;
+    std::string service_name;
+};
+
+bool parse_options(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--messages" && has_value) {
+            options.messages = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rate" && has_value) {
+            options.rate = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--payload" && has_value) {
+            options.payload = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--pub-cpu" && has_value) {
+            options.pub_cpu = std::atoi(argv[++i]);
+        } else if (arg == "--sub-cpu" && has_value) {
+            options.sub_cpu = std::atoi(argv[++i]);
+        } else if (arg == "--numa") {
+            options.numa = true;
+        } else if (arg == "--transport" && has_value) {
+            const std::string name = argv[++i];
+            if (name == "shm_ring") {
+                options.transport = BroadcastTransport::SharedMemoryRing;
+            } else if (name == "iceoryx2") {
+                options.transport = BroadcastTransport::IceOryx2;
+            } else {
+                std::cerr << "Unsupported transport: " << name << std::endl;
+                return false;
+            }
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.payload == 0 || options.payload > ZeroCopyMarketBlock::DATA_SIZE) {
+        std::cerr << "Payload must be 1.." << ZeroCopyMarketBlock::DATA_SIZE << " bytes" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+BroadcastConfig bench_config(const BenchOptions& options) {
+    BroadcastConfig config;
+    config.transport = options.transport;
+    config.service_name = options.service_name;
+    config.queue_capacity = 8192;
+    config.latency_tracking = true;
+    return config;
+}
+
+void print_summary(const LatencySummary& summary, uint64_t expected) {
+    std::cout << "\n📊 单向延迟 (发布 → 接收)\n";
+    std::cout << std::string(50, '-') << "\n";
+    std::cout << "  样本数:   " << summary.samples << " / " << expected << "\n";
+    std::cout << "  最小:     " << summary.min_ns << " ns\n";
+    std::cout << "  平均:     " << std::fixed << std::setprecision(0) << summary.mean_ns << " ns\n";
+    std::cout << "  p50:      " << summary.p50_ns << " ns\n";
+    std::cout << "  p90:      " << summary.p90_ns << " ns\n";
+    std::cout << "  p99:      " << summary.p99_ns << " ns\n";
+    std::cout << "  p99.9:    " << summary.p999_ns << " ns\n";
+    std::cout << "  最大:     " << summary.max_ns << " ns\n";
+    std::cout << "  序号缺口: " << summary.sequence_gaps << " (丢失 " << summary.missing_sequences
+              << ", 乱序 " << summary.out_of_order << ")\n";
+    if (summary.negative_samples > 0) {
+        std::cout << "  时钟异常: " << summary.negative_samples << "\n";
+    }
+}
+
+int run_subscriber(const BenchOptions& options, int ready_fd) {
+    BroadcastConfig config = bench_config(options);
+    config.cpu_affinity = options.sub_cpu;
+
+    auto subscriber = create_subscriber(config, "bench");
+    const char ready = subscriber ? 1 : 0;
+    if (::write(ready_fd, &ready, 1) != 1 || !subscriber) {
+        return 1;
+    }
+    ::close(ready_fd);
+
+    // 收齐或空闲 2 秒后结束 (丢失的消息不会再到达)
+    constexpr uint64_t IDLE_TIMEOUT_NS = 2000000000ULL;
+    uint64_t received = 0;
+    uint64_t last_receive = latency_clock_ns();
+    while (received < options.messages) {
+        if (subscriber->receive()) {
+            received++;
+            last_receive = latency_clock_ns();
+        } else if (latency_clock_ns() - last_receive > IDLE_TIMEOUT_NS) {
+            break;
+        }
+    }
+
+    print_summary(subscriber->get_latency(), options.messages);
+    std::cout.flush();     // 子进程以 _Exit 退出，不会自动刷新
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parse_options(argc, argv, options)) {
+        return 1;
+    }
+    options.service_name = "latency_bench_" + std::to_string(::getpid());
+
+    BroadcastConfig config = bench_config(options);
+    config.cpu_affinity = options.pub_cpu;
+    config.numa_aware = options.numa;
+
+    int pipe_fds[2];
+    if (::pipe(pipe_fds) != 0) {
+        std::perror("pipe");
+        return 1;
+    }
+
+    // 先创建发布端，子进程连接已存在的流
+    auto broadcaster = create_broadcaster(config, "bench");
+    if (!broadcaster) {
+        return 1;
+    }
+
+    const pid_t child = ::fork();
+    if (child < 0) {
+        std::perror("fork");
+        return 1;
+    }
+    if (child == 0) {
+        ::close(pipe_fds[0]);
+        // 不析构继承来的发布端 (析构会删除共享内存段)
+        std::_Exit(run_subscriber(options, pipe_fds[1]));
+    }
+
+    ::close(pipe_fds[1]);
+    char ready = 0;
+    if (::read(pipe_fds[0], &ready, 1) != 1 || ready != 1) {
+        std::cerr << "Subscriber failed to start" << std::endl;
+        ::waitpid(child, nullptr, 0);
+        return 1;
+    }
+    ::close(pipe_fds[0]);
+
+    const BroadcastStats stats = broadcaster->get_stats();
+    std::cout << "Transport: " << transport_name(broadcaster->transport())
+              << ", messages: " << options.messages
+              << ", rate: " << (options.rate ? std::to_string(options.rate) + "/s" : std::string("unlimited"))
+              << ", payload: " << options.payload << " B"
+              << ", publisher CPU " << stats.placement.cpu << " (node " << stats.placement.numa_node << ")"
+              << std::endl;
+
+    std::vector<uint8_t> payload(options.payload, 0x5A);
+    const uint64_t interval_ns = options.rate ? 1000000000ULL / options.rate : 0;
+    uint64_t next_send = latency_clock_ns();
+    for (uint64_t i = 0; i < options.messages; ++i) {
+        if (interval_ns) {
+            while (latency_clock_ns() < next_send) {
+            }
+            next_send += interval_ns;
+        }
+        broadcaster->broadcast(payload.data(), payload.size(), 1, MarketDataType::Tick);
+    }
+
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
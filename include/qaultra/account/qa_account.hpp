@@ -147,6 +147,7 @@ public:
     // 市场数据更新
     void update_market_data(const std::string& code, double price);
     void update_market_data_batch(const std::unordered_map<std::string, double>& prices);
+    void update_market_data(const data::KlineMap& bars);  // 按 InstrumentId 对持仓做收盘价标记
 
     // 结算相关
     void daily_settle();
@@ -218,14 +219,14 @@ private:
     std::atomic<double> float_pnl_;
 
     // 交易数据
-    std::unordered_map<std::string, QA_Position> positions_;
+    std::unordered_map<data::InstrumentId, QA_Position> positions_;   // 代码只在接口边界与ID互转
     std::unordered_map<std::string, Order> orders_;
     std::vector<std::string> trade_history_;
     std::vector<AccountSlice> history_slices_;
 
     // 配置和状态
     MarketPreset market_preset_;
-    std::unordered_map<std::string, double> market_prices_;
+    std::vector<double> marks_;                                       // 按 InstrumentId 直接索引的最新价, NaN 为无行情
 
     // 计数器
     std::atomic<int> order_id_counter_;
@@ -249,6 +250,10 @@ private:
     std::string generate_order_id();
     std::string generate_trade_id();
 
+    // 调用方需持有 positions_mutex_
+    double mark_price(data::InstrumentId id) const;
+    void set_mark(data::InstrumentId id, double price);
+
     double calculate_commission(double price, double volume, bool is_buy) const;
     double calculate_tax(double price, double volume) const;
 
@@ -0,0 +1,174 @@
+#pragma once
+
+/**
+ * @file covariance.hpp
+ * @brief 全市场规模的协方差 / 相关系数矩阵与组合方差
+ *
+ * 收益率矩阵按时间主序存放 (第 t 行为 series 个标的在 t 时刻的收益率，与 RollingMomentsBatch 相同)。
+ * 输出为压缩对称矩阵 (只存上三角，按行主序)，N = 5000 时约 100 MB，为稠密矩阵的一半。
+ *
+ * 批量计算先把去均值后的数据转为标的主序，再按 block_size 列一块分块，
+ * 每个 (块 i, 块 j >= i) 对由一个线程用 SimdMath::dot_product 计算，两块数据常驻 L2。
+ * 方差口径默认为总体方差 (除以 T)，与 RiskCalculator / FinancialMath 一致。
+ */
+
+#include <cstddef>
+#include <vector>
+
+namespace qaultra::analysis {
+
+/**
+ * @brief 压缩存储的对称矩阵
+ *
+ * 第 i 行从 (i, i) 开始存 dimension - i 个元素，row(i) 指向 (i, i)。
+ */
+class PackedSymmetricMatrix {
+public:
+    PackedSymmetricMatrix() = default;
+    explicit PackedSymmetricMatrix(size_t dimension);
+
+    static size_t packed_size(size_t dimension) { return dimension * (dimension + 1) / 2; }
+
+    size_t dimension() const { return dimension_; }
+    size_t size() const { return data_.size(); }
+
+    /**
+     * @brief (i, j) 在压缩数组中的位置 (i、j 顺序任意)
+     */
+    size_t index(size_t i, size_t j) const {
+        if (i > j) {
+            const size_t k = i;
+            i = j;
+            j = k;
+        }
+        return i * dimension_ - i * (i - 1) / 2 + (j - i);
+    }
+
+    double operator()(size_t i, size_t j) const { return data_[index(i, j)]; }
+    double& operator()(size_t i, size_t j) { return data_[index(i, j)]; }
+
+    double* row(size_t i) { return data_.data() + index(i, i); }
+    const double* row(size_t i) const { return data_.data() + index(i, i); }
+    double* data() { return data_.data(); }
+    const double* data() const { return data_.data(); }
+
+    /**
+     * @brief 展开为行主序的稠密矩阵 (可直接传给 FinancialMath::portfolio_variance)
+     */
+    std::vector<double> to_dense() const;
+
+private:
+    size_t dimension_ = 0;
+    std::vector<double> data_;
+};
+
+/**
+ * @brief 批量计算选项
+ */
+struct CovarianceOptions {
+    size_t threads = 0;                      // 0 表示 hardware_concurrency
+    size_t block_size = 64;                  // 分块的标的数
+    bool sample = false;                     // true 时除以 T - 1
+};
+
+/**
+ * @brief 收益率矩阵 (periods × series) 的协方差矩阵
+ */
+PackedSymmetricMatrix covariance_matrix(const double* returns, size_t periods, size_t series,
+                                        const CovarianceOptions& options = {});
+
+/**
+ * @brief 由协方差得到相关系数 (方差为 0 的标的所在行列为 0)
+ */
+PackedSymmetricMatrix correlation_matrix(const PackedSymmetricMatrix& covariance);
+
+/**
+ * @brief 二次型 w' Σ w (组合方差)
+ */
+double quadratic_form(const PackedSymmetricMatrix& matrix, const double* weights);
+
+/**
+ * @brief 多个组合的二次型: weights 为 portfolios × dimension (行主序)
+ */
+void quadratic_forms(const PackedSymmetricMatrix& matrix, const double* weights, size_t portfolios,
+                     double* out, size_t threads = 0);
+
+/**
+ * @brief 指数加权协方差 (逐行增量更新，每行 O(N^2))
+ *
+ * d = x - mean; mean += (1 - lambda) d; cov = lambda (cov + (1 - lambda) d d')
+ * 第一行只用于初始化均值。
+ */
+class EwmaCovariance {
+public:
+    /**
+     * @throws std::invalid_argument series 为 0 或 lambda 不在 (0, 1)
+     */
+    EwmaCovariance(size_t series, double lambda, size_t threads = 0);
+
+    void update(const double* row);
+    void reset();
+
+    size_t series() const { return mean_.size(); }
+    double lambda() const { return lambda_; }
+    size_t count() const { return count_; }
+
+    const double* mean() const { return mean_.data(); }
+    const PackedSymmetricMatrix& covariance() const { return covariance_; }
+
+private:
+    double lambda_;
+    size_t threads_;
+    size_t count_ = 0;
+    std::vector<double> mean_;
+    std::vector<double> delta_;
+    PackedSymmetricMatrix covariance_;
+};
+
+/**
+ * @brief 滚动窗口协方差
+ *
+ * 维护窗口内的协离差矩阵 C = sum (x - mean)(x - mean)'，替换最旧一行 y 为 x 时
+ * C += delta_i (x_j - mean'_j) + (y_i - mean_i) delta_j，delta = x - y。
+ * 每 window 次更新从环形缓冲区分块重算一次，避免舍入误差累积 (摊还仍为每行 O(N^2))。
+ */
+class RollingCovariance {
+public:
+    /**
+     * @throws std::invalid_argument series 或 window 为 0
+     */
+    RollingCovariance(size_t series, size_t window, const CovarianceOptions& options = {});
+
+    void update(const double* row);
+    void reset();
+
+    size_t series() const { return mean_.size(); }
+    size_t window() const { return window_; }
+    size_t count() const { return count_; }
+    bool full() const { return count_ == window_; }
+
+    const double* mean() const { return mean_.data(); }
+
+    /**
+     * @brief 当前窗口的协方差 (out 按需重新分配)
+     */
+    void covariance(PackedSymmetricMatrix& out) const;
+    PackedSymmetricMatrix covariance() const;
+
+private:
+    size_t window_;
+    CovarianceOptions options_;
+    std::vector<double> rows_;               // window_ 行的环形缓冲
+    size_t head_ = 0;
+    size_t count_ = 0;
+    size_t updates_since_rebuild_ = 0;
+    std::vector<double> mean_;
+    std::vector<double> delta_;
+    std::vector<double> centered_;
+    std::vector<double> old_centered_;
+    PackedSymmetricMatrix comoment_;
+
+    void rebuild();
+};
+
+} // namespace qaultra::analysis
@@ -0,0 +1,241 @@
+#pragma once
+
+/**
+ * @file incremental_indicators.hpp
+ * @brief 增量技术指标 (每根 bar 每个标的 O(1) 更新)
+ *
+ * 每个指标对象同时维护 series 个标的的状态，按 SoA 存放 (每个状态量一个长度为 series 的数组)。
+ * update 传入一个横截面 (series 个值，按标的下标)，一次更新全部标的；结果同样按标的下标读取。
+ *
+ * 口径与 SimdMath 的整段数组版本一致:
+ * - SMA / 布林带 / Z-score: 窗口未满前为 NaN，标准差为总体标准差
+ * - EMA / MACD: 以第一个值为初值，alpha = 2 / (period + 1)
+ * - RSI / ATR: 首个值为前 period 个变动 (真实波幅) 的简单平均，之后按 Wilder 平滑
+ */
+
+#include "qaultra/analysis/rolling_stats.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace qaultra::analysis {
+
+/**
+ * @brief 简单移动平均
+ *
+ * 窗口满后用 "加新减旧" 更新滚动和，每 window 次更新按缓冲区重算一次，避免舍入误差累积。
+ */
+class IncrementalSMA {
+public:
+    /**
+     * @throws std::invalid_argument series 或 window 为 0
+     */
+    IncrementalSMA(size_t series, size_t window);
+
+    void update(const double* row);
+    void reset();
+
+    size_t series() const { return series_; }
+    size_t window() const { return window_; }
+    size_t count() const { return count_; }
+    bool ready() const { return count_ >= window_; }
+
+    const double* value() const { return value_.data(); }
+
+private:
+    size_t series_;
+    size_t window_;
+    std::vector<double> rows_;                  // window_ 行的环形缓冲 (时间主序)
+    size_t head_ = 0;                           // 最旧一行 (窗口满后)
+    size_t count_ = 0;
+    std::vector<double> sum_;
+    std::vector<double> scratch_;
+    std::vector<double> value_;
+};
+
+/**
+ * @brief 指数移动平均
+ */
+class IncrementalEMA {
+public:
+    /**
+     * @throws std::invalid_argument series 为 0 或 alpha 不在 (0, 1]
+     */
+    IncrementalEMA(size_t series, double alpha);
+
+    /**
+     * @brief 按周期构造，alpha = 2 / (period + 1)
+     *
+     * @throws std::invalid_argument series 或 period 为 0
+     */
+    static IncrementalEMA from_period(size_t series, size_t period);
+
+    void update(const double* row);
+    void reset();
+
+    size_t series() const { return series_; }
+    double alpha() const { return alpha_; }
+    size_t count() const { return count_; }
+    bool ready() const { return count_ > 0; }
+
+    const double* value() const { return value_.data(); }
+
+private:
+    size_t series_;
+    double alpha_;
+    size_t count_ = 0;
+    std::vector<double> value_;
+};
+
+/**
+ * @brief 相对强弱指数 (前 period 根为 NaN)
+ */
+class IncrementalRSI {
+public:
+    /**
+     * @throws std::invalid_argument series 或 period 为 0
+     */
+    IncrementalRSI(size_t series, size_t period = 14);
+
+    void update(const double* row);
+    void reset();
+
+    size_t series() const { return series_; }
+    size_t period() const { return period_; }
+    size_t count() const { return count_; }
+    bool ready() const { return count_ > period_; }
+
+    const double* value() const { return value_.data(); }
+
+private:
+    size_t series_;
+    size_t period_;
+    size_t count_ = 0;
+    std::vector<double> previous_;
+    std::vector<double> avg_gain_;              // 预热期间为累计值
+    std::vector<double> avg_loss_;
+    std::vector<double> value_;
+};
+
+/**
+ * @brief MACD (快慢 EMA 之差、其信号线与柱状图)
+ */
+class IncrementalMACD {
+public:
+    /**
+     * @throws std::invalid_argument series 或任一周期为 0
+     */
+    IncrementalMACD(size_t series, size_t fast_period = 12, size_t slow_period = 26, size_t signal_period = 9);
+
+    void update(const double* row);
+    void reset();
+
+    size_t series() const { return series_; }
+    size_t count() const { return fast_.count(); }
+    bool ready() const { return fast_.ready(); }
+
+    const double* macd() const { return macd_.data(); }
+    const double* signal() const { return signal_.value(); }
+    const double* histogram() const { return histogram_.data(); }
+
+private:
+    size_t series_;
+    IncrementalEMA fast_;
+    IncrementalEMA slow_;
+    IncrementalEMA signal_;
+    std::vector<double> macd_;
+    std::vector<double> histogram_;
+};
+
+/**
+ * @brief 布林带 (中轨为滚动均值，带宽为 multiplier 倍滚动总体标准差)
+ */
+class IncrementalBollinger {
+public:
+    /**
+     * @throws std::invalid_argument series 或 window 为 0
+     */
+    IncrementalBollinger(size_t series, size_t window = 20, double multiplier = 2.0);
+
+    void update(const double* row);
+    void reset();
+
+    size_t series() const { return moments_.series(); }
+    size_t count() const { return count_; }
+    bool ready() const { return moments_.full(); }
+
+    const double* middle() const { return middle_.data(); }
+    const double* upper() const { return upper_.data(); }
+    const double* lower() const { return lower_.data(); }
+
+private:
+    RollingMomentsBatch moments_;
+    double multiplier_;
+    size_t count_ = 0;
+    std::vector<double> middle_;
+    std::vector<double> upper_;
+    std::vector<double> lower_;
+};
+
+/**
+ * @brief 平均真实波幅
+ *
+ * 第一根的真实波幅为 high - low，之后为 max(high - low, |high - 前收|, |low - 前收|)；
+ * 前 period - 1 根为 NaN。
+ */
+class IncrementalATR {
+public:
+    /**
+     * @throws std::invalid_argument series 或 period 为 0
+     */
+    IncrementalATR(size_t series, size_t period = 14);
+
+    void update(const double* high, const double* low, const double* close);
+    void reset();
+
+    size_t series() const { return series_; }
+    size_t period() const { return period_; }
+    size_t count() const { return count_; }
+    bool ready() const { return count_ >= period_; }
+
+    const double* value() const { return value_.data(); }
+
+private:
+    size_t series_;
+    size_t period_;
+    size_t count_ = 0;
+    std::vector<double> previous_close_;
+    std::vector<double> atr_;                   // 预热期间为真实波幅累计值
+    std::vector<double> value_;
+};
+
+/**
+ * @brief 滚动 Z-score: (x - 窗口均值) / 窗口总体标准差 (标准差为 0 时取 0)
+ */
+class IncrementalZScore {
+public:
+    /**
+     * @throws std::invalid_argument series 或 window 为 0
+     */
+    IncrementalZScore(size_t series, size_t window);
+
+    void update(const double* row);
+    void reset();
+
+    size_t series() const { return moments_.series(); }
+    size_t count() const { return count_; }
+    bool ready() const { return moments_.full(); }
+
+    const double* value() const { return value_.data(); }
+    const double* mean() const { return moments_.mean(); }
+    const double* stddev() const { return stddev_.data(); }
+
+private:
+    RollingMomentsBatch moments_;
+    size_t count_ = 0;
+    std::vector<double> stddev_;
+    std::vector<double> value_;
+};
+
+} // namespace qaultra::analysis
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -94,6 +95,44 @@ struct RiskMetrics {
     void print_report() const;
 };
 
+/**
+ * @brief 批量风险指标表 (SoA，第 i 列对应输入矩阵的第 i 个序列)
+ */
+struct RiskMetricsTable {
+    std::vector<double> total_return;        // 复利总收益率
+    std::vector<double> annual_return;
+    std::vector<double> annual_volatility;
+    std::vector<double> max_drawdown;        // 净值从 1 开始计算
+    std::vector<double> sharpe_ratio;
+    std::vector<double> sortino_ratio;
+    std::vector<double> calmar_ratio;
+    std::vector<double> omega_ratio;
+    std::vector<double> downside_risk;
+    std::vector<double> value_at_risk;       // BatchRiskOptions::var_confidence 分位
+    std::vector<double> conditional_var;
+    std::vector<double> tail_ratio;
+    std::vector<double> skew;
+    std::vector<double> kurtosis;
+
+    size_t size() const { return sharpe_ratio.size(); }
+    void resize(size_t series);
+
+    /**
+     * @brief 取出单个序列的指标 (VaR / CVaR 写入 value_at_risk_95 / conditional_var_95)
+     */
+    RiskMetrics row(size_t series) const;
+};
+
+/**
+ * @brief 批量计算选项
+ */
+struct BatchRiskOptions {
+    double risk_free_rate = 0.0;             // 年化无风险利率
+    int trading_days = 252;
+    double var_confidence = 0.05;            // 与 calculate_value_at_risk 的 confidence 含义相同
+    size_t threads = 0;                      // 0 表示 hardware_concurrency
+};
+
 /**
  * @brief 性能报告结构
  */
@@ -121,6 +160,84 @@ struct PerformanceReport {
     bool save_to_file(const std::string& filename) const;
 };
 
+/**
+ * @brief 列式交易对存储
+ *
+ * 品种代码驻留为整数下标，开平仓时间存为纳秒时间戳 (util::datetime 口径，未知时为 0)，
+ * 其余字段各占一列；只追加不修改。交易 ID 不保留。
+ */
+struct TradePairStore {
+    std::vector<std::string> codes;                          // 下标 -> 代码
+    std::unordered_map<std::string, uint32_t> code_index;    // 代码 -> 下标
+
+    std::vector<uint32_t> code;
+    std::vector<int64_t> open_time;
+    std::vector<int64_t> close_time;
+    std::vector<uint8_t> is_buy_open;
+    std::vector<double> amount;
+    std::vector<double> open_price;
+    std::vector<double> close_price;
+    std::vector<double> pnl_ratio;
+    std::vector<double> pnl_money;
+    std::vector<double> hold_gap_days;
+    std::vector<double> commission;
+
+    size_t size() const { return code.size(); }
+    uint32_t intern(const std::string& symbol);
+
+    /**
+     * @brief 追加一个交易对，返回行号
+     *
+     * 时间取自 open_datetime / close_datetime，未设置时解析 open_date / close_date。
+     */
+    size_t append(const TradePair& trade);
+
+    /**
+     * @brief 还原第 row 行 (日期按时间戳格式化，整日时只输出日期)
+     */
+    TradePair row(size_t index) const;
+};
+
+/**
+ * @brief 单个品种交易统计的增量累加器
+ *
+ * 每追加一笔 O(1) 更新计数、盈亏和、收益率的 1~4 阶中心矩、复利、回撤与下行平方和；
+ * VaR / CVaR 需要分位数，另维护一份有序收益率: 新增收益率先暂存，metrics() 时排序后归并一次。
+ * metrics() 与 SingleAssetPerformanceAnalyzer::calculate_metrics 口径一致。
+ */
+class TradeStatsAccumulator {
+public:
+    void add(double pnl_money, double pnl_ratio, double hold_gap_days);
+    RiskMetrics metrics(double var_confidence = 0.05) const;
+    size_t count() const { return count_; }
+
+private:
+    size_t count_ = 0;
+    int profitable_ = 0;
+    double win_sum_ = 0.0;
+    double loss_sum_ = 0.0;                  // 非盈利交易的亏损绝对值之和
+    double largest_win_ = 0.0;
+    double largest_loss_ = 0.0;
+    double holding_days_ = 0.0;
+
+    // 收益率序列 (按追加顺序)
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+    double m3_ = 0.0;
+    double m4_ = 0.0;
+    double growth_ = 1.0;                    // prod(1 + r)
+    double first_ = 0.0;
+    double last_ = 0.0;
+    double peak_ = 0.0;
+    double max_drawdown_ = 0.0;              // 与 RiskCalculator::calculate_max_drawdown(returns) 相同
+    double downside_sq_ = 0.0;
+    size_t downside_count_ = 0;
+    mutable std::vector<double> sorted_;
+    mutable std::vector<double> pending_;    // 上次 metrics() 之后追加、尚未归并的收益率
+
+    void merge_pending() const;
+};
+
 /**
  * @brief 单个品种性能分析器
  */
@@ -167,14 +284,27 @@ public:
     void add_trade_pair(const TradePair& trade_pair);
     void add_trade_pairs(const std::vector<TradePair>& trade_pairs);
 
+    size_t get_trade_count() const;
+
+    /**
+     * @brief 第 from 笔起的交易对 (供看板只拉取新增部分)
+     */
+    std::vector<TradePair> get_trade_pairs(size_t from = 0) const;
+
     // 计算综合性能指标
     RiskMetrics calculate_portfolio_metrics() const;
 
     // 分品种分析
     std::unordered_map<std::string, RiskMetrics> calculate_by_asset_metrics() const;
 
-    // 生成完整报告
-    PerformanceReport generate_report() const;
+    /**
+     * @brief 生成报告
+     *
+     * 分品种指标只重算上次报告后有新增交易的品种，组合指标只在净值曲线或基准变化后重算，
+     * 因此两次报告之间的开销与新增交易数成正比。include_trade_pairs 为 false 时
+     * 不展开全部交易对 (需要时用 get_trade_pairs(from) 增量拉取)。
+     */
+    PerformanceReport generate_report(bool include_trade_pairs = true) const;
 
     // 比较分析
     double calculate_tracking_error() const;
@@ -191,17 +321,29 @@ private:
     std::vector<std::string> dates_;
     std::vector<double> benchmark_returns_;
     std::vector<std::string> benchmark_dates_;
-    std::vector<TradePair> trade_pairs_;
 
-    // 分品种数据
-    std::unordered_map<std::string, std::vector<TradePair>> trade_pairs_by_asset_;
+    TradePairStore trades_;
+    std::vector<TradeStatsAccumulator> asset_stats_;    // 按 trades_ 的代码下标
+    int profitable_trades_ = 0;
+
+    // 报告缓存 (在 mutex_ 保护下惰性刷新)
+    mutable std::vector<uint32_t> dirty_assets_;
+    mutable std::vector<uint8_t> asset_dirty_;
+    mutable std::unordered_map<std::string, RiskMetrics> by_asset_cache_;
+    mutable bool curve_dirty_ = true;
+    mutable RiskMetrics curve_metrics_;                 // 不含交易统计
+    mutable std::vector<double> daily_returns_;
+    mutable std::vector<double> cumulative_returns_;
 
     mutable std::mutex mutex_;
 
-    // 内部计算方法
+    // 内部计算方法 (调用方持有 mutex_)
     std::vector<double> calculate_daily_returns() const;
     std::vector<double> calculate_cumulative_returns() const;
-    void update_trade_pairs_by_asset();
+    void append_trade_pair(const TradePair& trade_pair);
+    void refresh_curve_cache() const;
+    void refresh_asset_cache() const;
+    RiskMetrics portfolio_metrics_locked() const;
 };
 
 /**
@@ -248,7 +390,7 @@ public:
     static double calculate_kurtosis(const std::vector<double>& returns);
     static double calculate_tail_ratio(const std::vector<double>& returns);
 
-    // 滚动指标
+    // 滚动指标 (基于 rolling_stats.hpp，每个输出点摊还 O(1))
     static std::vector<double> calculate_rolling_sharpe(const std::vector<double>& returns,
                                                        int window = 252);
     static std::vector<double> calculate_rolling_volatility(const std::vector<double>& returns,
@@ -256,6 +398,17 @@ public:
     static std::vector<double> calculate_rolling_max_drawdown(const std::vector<double>& cumulative_returns,
                                                              int window = 252);
 
+    /**
+     * @brief 批量计算多个收益率序列的风险指标
+     *
+     * returns 为列主序矩阵: 第 s 个序列位于 returns[s * periods, (s + 1) * periods)。
+     * 每个序列一次遍历得到各阶矩、净值回撤、下行风险与欧米茄比率，
+     * VaR / CVaR / 尾部比率用 nth_element 选取分位数 (不做完整排序)，序列按块分配到多个线程。
+     * 口径与单序列函数一致 (总体方差，CVaR 取最小的 floor(n * confidence) 个收益的均值)。
+     */
+    static RiskMetricsTable calculate_batch_metrics(const double* returns, size_t periods, size_t series,
+                                                    const BatchRiskOptions& options = {});
+
     // 辅助函数
     static std::vector<double> calculate_excess_returns(const std::vector<double>& portfolio_returns,
                                                        const std::vector<double>& benchmark_returns);
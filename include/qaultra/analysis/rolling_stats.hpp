@@ -0,0 +1,224 @@
+#pragma once
+
+/**
+ * @file rolling_stats.hpp
+ * @brief 流式滚动窗口统计 (每个新值摊还 O(1)，窗口内不分配内存)
+ *
+ * - RollingMoments: 滑动窗口 Welford 更新的均值 / 总体方差
+ * - RollingExtremum: 单调队列维护的滚动最大 / 最小值
+ * - RollingDrawdown: 双栈滑动窗口聚合维护的滚动最大回撤
+ * - RollingMomentsBatch: 按时间主序的多序列面板，每一步用 SIMD 内核同时更新所有序列
+ *
+ * RiskCalculator::calculate_rolling_* 基于这些类实现，口径与逐窗口重算一致
+ * (总体方差，回撤为 (峰值 - 当前值) / 峰值)。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace qaultra::analysis {
+
+/**
+ * @brief 滚动均值 / 方差
+ *
+ * 窗口未满时为普通 Welford 累加，满后用 "新值替换旧值" 的 Welford 更新。
+ * 窗口内全部为同一个值时方差精确为 0 (避免滑动更新留下的舍入残差)。
+ */
+class RollingMoments {
+public:
+    /**
+     * @throws std::invalid_argument window 为 0
+     */
+    explicit RollingMoments(size_t window);
+
+    void push(double value);
+    void reset();
+
+    size_t window() const { return window_; }
+    size_t count() const { return count_; }
+    bool full() const { return count_ == window_; }
+
+    double mean() const { return mean_; }
+    double variance() const;                    // 总体方差 (除以 count)
+    double stddev() const;
+
+private:
+    size_t window_;
+    std::vector<double> buffer_;
+    size_t head_ = 0;                           // 最旧值的位置 (窗口满后)
+    size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+    double last_ = 0.0;
+    size_t run_ = 0;                            // 末尾连续相同值的个数
+};
+
+/**
+ * @brief 滚动极值 (单调队列，环形存储)
+ *
+ * Better(a, b) 为 true 表示 a 比 b 更优 (std::greater 求最大，std::less 求最小)；
+ * 相等时保留较新的值，使其更晚过期。
+ */
+template <typename Better>
+class RollingExtremum {
+public:
+    explicit RollingExtremum(size_t window)
+        : window_(window)
+        , entries_(window)
+    {
+        if (window == 0) {
+            throw std::invalid_argument("RollingExtremum window must be positive");
+        }
+    }
+
+    void push(double value) {
+        // 队尾不优于新值的元素永远不会再成为极值
+        while (size_ > 0 && !better_(back().value, value)) {
+            size_--;
+        }
+        if (size_ > 0 && front().sequence + window_ <= sequence_) {
+            front_ = (front_ + 1) % window_;
+            size_--;
+        }
+        entries_[(front_ + size_) % window_] = Entry{sequence_, value};
+        size_++;
+        sequence_++;
+    }
+
+    void reset() {
+        front_ = 0;
+        size_ = 0;
+        sequence_ = 0;
+    }
+
+    /**
+     * @brief 最近 min(count, window) 个值的极值 (未 push 过时未定义)
+     */
+    double value() const { return front().value; }
+
+    bool full() const { return sequence_ >= window_; }
+    size_t window() const { return window_; }
+
+private:
+    struct Entry {
+        uint64_t sequence;
+        double value;
+    };
+
+    const Entry& front() const { return entries_[front_]; }
+    const Entry& back() const { return entries_[(front_ + size_ - 1) % window_]; }
+
+    size_t window_;
+    std::vector<Entry> entries_;
+    size_t front_ = 0;
+    size_t size_ = 0;
+    uint64_t sequence_ = 0;
+    Better better_{};
+};
+
+using RollingMax = RollingExtremum<std::greater<double>>;
+using RollingMin = RollingExtremum<std::less<double>>;
+
+/**
+ * @brief 滚动最大回撤 (输入为净值 / 累计收益序列)
+ *
+ * 区间摘要 (最大值, 最小值, 最大回撤) 满足结合律: 合并 L、R 时跨段回撤为 (L.max - R.min) / L.max。
+ * 用双栈队列维护窗口: 入栈端保存前缀摘要，出栈端保存后缀摘要，每个值最多搬移一次。
+ */
+class RollingDrawdown {
+public:
+    /**
+     * @throws std::invalid_argument window 为 0
+     */
+    explicit RollingDrawdown(size_t window);
+
+    void push(double value);
+    void reset();
+
+    /**
+     * @brief 最近 min(count, window) 个值内的最大回撤 (比例，非负)
+     */
+    double max_drawdown() const;
+
+    /**
+     * @brief 窗口内最高值与当前值的回撤
+     */
+    double current_drawdown() const;
+
+    size_t count() const { return front_.size() + back_values_.size(); }
+    bool full() const { return count() == window_; }
+
+private:
+    struct Summary {
+        double max;
+        double min;
+        double drawdown;
+    };
+
+    static Summary leaf(double value) { return Summary{value, value, 0.0}; }
+    static Summary combine(const Summary& earlier, const Summary& later);
+
+    void pop_front();
+
+    size_t window_;
+    std::vector<Summary> front_;                // 栈顶为最旧值，保存其到出栈端末尾的摘要
+    std::vector<double> back_values_;           // 入栈端的原始值 (按时间顺序)
+    Summary back_summary_{};
+    double last_ = 0.0;
+};
+
+/**
+ * @brief 多序列滚动均值 / 方差
+ *
+ * 面板按时间主序存放: 第 t 行为 series 个序列在 t 时刻的值。
+ * 每次 push 一行，用 SimdMath 的分派内核同时更新全部序列，适合对上千个序列计算同一窗口的指标。
+ */
+class RollingMomentsBatch {
+public:
+    /**
+     * @throws std::invalid_argument series 或 window 为 0
+     */
+    RollingMomentsBatch(size_t series, size_t window);
+
+    void push(const double* row);
+    void reset();
+
+    size_t series() const { return series_; }
+    size_t window() const { return window_; }
+    size_t count() const { return count_; }
+    bool full() const { return count_ == window_; }
+
+    const double* mean() const { return mean_.data(); }
+    void variance(double* out) const;
+    void stddev(double* out) const;
+
+private:
+    size_t series_;
+    size_t window_;
+    std::vector<double> rows_;                  // window_ 行的环形缓冲
+    size_t head_ = 0;
+    size_t count_ = 0;
+    std::vector<double> mean_;
+    std::vector<double> m2_;
+    std::vector<uint32_t> run_;                 // 各序列末尾连续相同值的个数
+    std::vector<double> delta_;
+    std::vector<double> scratch_;
+    std::vector<double> old_mean_;
+};
+
+/**
+ * @brief 面板上的滚动均值与总体标准差 (输出同为时间主序，前 window - 1 行为 NaN)
+ */
+void rolling_moments_batch(const double* panel, size_t length, size_t series, size_t window,
+                           double* mean_out, double* stddev_out);
+
+/**
+ * @brief 面板上的滚动年化夏普比率 (口径同 RiskCalculator::calculate_sharpe_ratio，前 window - 1 行为 NaN)
+ */
+void rolling_sharpe_batch(const double* panel, size_t length, size_t series, size_t window,
+                          double* sharpe_out, double risk_free_rate = 0.0, int trading_days = 252);
+
+} // namespace qaultra::analysis
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "datatype.hpp"
+#include "instrument_registry.hpp"
+#include "../protocol/mifi.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace qaultra::ipc {
+struct MarketTick;
+}
+
+/**
+ * @file bar_aggregator.hpp
+ * @brief 实时K线聚合器 - 将逐笔 Tick 流增量合成为多周期K线截面
+ *
+ * 使用示例:
+ * ```cpp
+ * BarAggregator aggregator;
+ * aggregator.set_publisher([](const BarCrossSection& section) {
+ *     // section.bars: 该周期收盘时全部证券的K线 (shared_ptr，可零拷贝分发)
+ * });
+ *
+ * for (const auto& tick : ticks) {
+ *     aggregator.update(tick);
+ * }
+ * aggregator.flush_all();
+ * ```
+ */
+
+namespace qaultra::data {
+
+/**
+ * @brief K线周期
+ */
+enum class BarPeriod : uint8_t {
+    Min1 = 0,
+    Min5 = 1,
+    Min15 = 2,
+    Min30 = 3,
+    Min60 = 4,
+    Day = 5
+};
+
+constexpr size_t BAR_PERIOD_COUNT = 6;
+
+/**
+ * @brief 周期长度 (纳秒)
+ */
+constexpr int64_t bar_period_nanos(BarPeriod period) {
+    constexpr int64_t seconds[BAR_PERIOD_COUNT] = {60, 300, 900, 1800, 3600, 86400};
+    return seconds[static_cast<size_t>(period)] * 1000000000LL;
+}
+
+/**
+ * @brief 周期名称 ("1min", "5min", ..., "day")
+ */
+const char* bar_period_name(BarPeriod period);
+
+/**
+ * @brief 聚合器输入 - 与具体行情协议无关的最小 Tick
+ */
+struct AggregatorTick {
+    InstrumentId instrument_id = INVALID_INSTRUMENT_ID;
+    int64_t timestamp_ns = 0;       // 纳秒时间戳
+    double last_price = 0.0;        // 最新价
+    double volume = 0.0;            // 成交量 (累计或单笔，见 BarAggregatorConfig::cumulative_volume)
+    double amount = 0.0;            // 成交额 (同上)
+    double limit_up = 0.0;          // 涨停价
+    double limit_down = 0.0;        // 跌停价
+};
+
+/**
+ * @brief 一个周期收盘时的全市场K线截面
+ */
+struct BarCrossSection {
+    BarPeriod period = BarPeriod::Min1;
+    int64_t timestamp_ns = 0;               // K线起始时间
+    bool final = true;                      // false 表示盘中日线快照 (日线尚未收盘)
+    std::shared_ptr<const KlineMap> bars;
+};
+
+/**
+ * @brief 聚合器配置
+ */
+struct BarAggregatorConfig {
+    bool cumulative_volume = true;          // Tick 中的成交量/额为当日累计值 (CTP/MIFI 快照惯例)
+    bool emit_partial_daily = true;         // 每根1分钟K线收盘时同时发布盘中日线快照
+    uint8_t period_mask = 0x3F;             // 启用的周期 (bit i 对应 BarPeriod i)
+    int64_t time_offset_ns = 0;             // 周期对齐偏移 (时间戳为UTC且需按本地日切分时设置)
+};
+
+/**
+ * @brief 聚合统计
+ */
+struct BarAggregatorStats {
+    uint64_t ticks_processed = 0;
+    uint64_t late_ticks = 0;                // 落后于任一周期当前K线的 Tick (所有周期均忽略)
+    uint64_t sections_published = 0;
+    uint64_t bars_published = 0;
+};
+
+/**
+ * @brief 实时K线聚合器
+ *
+ * 每个证券在各周期上的未完成K线保存在按 InstrumentId 下标的连续数组中，
+ * 每个 Tick 的处理为 O(1)。周期边界由全市场时钟推进: 当任一 Tick 进入新周期时，
+ * 上一周期所有被更新过的证券组成截面一次性发布。
+ *
+ * 非线程安全: 需由单个行情线程驱动；发布出去的截面为只读 shared_ptr，可跨线程共享。
+ */
+class BarAggregator {
+public:
+    using Publisher = std::function<void(const BarCrossSection&)>;
+
+    explicit BarAggregator(const BarAggregatorConfig& config = BarAggregatorConfig());
+
+    /**
+     * @brief 设置默认的截面发布回调
+     */
+    void set_publisher(Publisher publisher) { publisher_ = std::move(publisher); }
+
+    /**
+     * @brief 处理一个 Tick，周期收盘时通过 sink (或默认发布回调) 发布截面
+     */
+    void update(const AggregatorTick& tick, const Publisher& sink);
+    void update(const AggregatorTick& tick) { update(tick, publisher_); }
+
+    void update(const protocol::mifi::Tick& tick, const Publisher& sink);
+    void update(const protocol::mifi::Tick& tick) { update(tick, publisher_); }
+
+    void update(const ipc::MarketTick& tick, const Publisher& sink);
+    void update(const ipc::MarketTick& tick) { update(tick, publisher_); }
+
+    /**
+     * @brief 按时钟推进: 关闭所有结束时间不晚于 now_ns 的周期 (用于午休、收盘等无 Tick 时段)
+     *
+     * 被关闭的周期推进到下一周期，之后落在已关闭周期内的 Tick 计为迟到。
+     */
+    void flush(int64_t now_ns, const Publisher& sink);
+    void flush(int64_t now_ns) { flush(now_ns, publisher_); }
+
+    /**
+     * @brief 关闭所有未完成周期 (同样推进到下一周期)
+     */
+    void flush_all(const Publisher& sink);
+    void flush_all() { flush_all(publisher_); }
+
+    /**
+     * @brief 获取某证券在指定周期的未完成K线 (不存在时返回 nullopt)
+     */
+    std::optional<Kline> current_bar(InstrumentId instrument_id, BarPeriod period) const;
+
+    /**
+     * @brief 当前周期起始时间 (尚无数据时返回 NO_BUCKET)
+     */
+    int64_t current_bucket(BarPeriod period) const {
+        return current_bucket_[static_cast<size_t>(period)];
+    }
+
+    /**
+     * @brief 清空全部状态 (换日时调用)
+     */
+    void reset();
+
+    const BarAggregatorStats& get_stats() const { return stats_; }
+    const BarAggregatorConfig& get_config() const { return config_; }
+
+    /**
+     * @brief 解析 "YYYY-MM-DD HH:MM:SS[.ffffff]" 为纳秒时间戳 (按UTC民用时间解释，见 util::datetime)
+     */
+    static int64_t parse_datetime(const std::string& datetime);
+
+    static constexpr int64_t NO_BUCKET = std::numeric_limits<int64_t>::min();
+
+private:
+    struct BarState {
+        int64_t bucket = NO_BUCKET;
+        double open = 0.0;
+        double high = 0.0;
+        double low = 0.0;
+        double close = 0.0;
+        double volume = 0.0;
+        double amount = 0.0;
+        double limit_up = 0.0;
+        double limit_down = 0.0;
+    };
+
+    struct InstrumentState {
+        double last_cum_volume = 0.0;
+        double last_cum_amount = 0.0;
+        std::array<BarState, BAR_PERIOD_COUNT> bars;
+    };
+
+    bool enabled(size_t period) const { return (config_.period_mask >> period) & 1u; }
+    int64_t bucket_of(int64_t timestamp_ns, size_t period) const;
+    void close_period(size_t period, const Publisher& sink);
+    void publish_partial_daily(const Publisher& sink);
+    std::shared_ptr<const KlineMap> collect(size_t period) const;
+    static Kline to_kline(InstrumentId instrument_id, const BarState& bar);
+
+    BarAggregatorConfig config_;
+    Publisher publisher_;
+    std::vector<InstrumentState> states_;                               // 按 InstrumentId 下标
+    std::array<int64_t, BAR_PERIOD_COUNT> current_bucket_;
+    std::array<std::vector<InstrumentId>, BAR_PERIOD_COUNT> touched_;   // 当前周期内有成交的证券
+    BarAggregatorStats stats_;
+};
+
+} // namespace qaultra::data
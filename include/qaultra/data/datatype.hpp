@@ -3,7 +3,9 @@
 #include <string>
 #include <chrono>
 #include <optional>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
+#include "instrument_registry.hpp"
 
 namespace qaultra::data {
 
@@ -40,7 +42,7 @@ struct Date {
  */
 struct StockCnDay {
     Date date;                              // 日期 (匹配 Rust chrono::NaiveDate)
-    std::string order_book_id;              // 证券代码
+    InstrumentId instrument_id = INVALID_INSTRUMENT_ID;  // 证券ID (见 InstrumentRegistry)
     float num_trades;                       // 成交笔数
     float limit_up;                         // 涨停价
     float limit_down;                       // 跌停价
@@ -56,14 +58,27 @@ struct StockCnDay {
      */
     StockCnDay() = default;
     StockCnDay(const Date& date,
-               const std::string& order_book_id,
+               InstrumentId instrument_id,
                float num_trades, float limit_up, float limit_down,
                float open, float high, float low, float close,
                float volume, float total_turnover)
-        : date(date), order_book_id(order_book_id), num_trades(num_trades),
+        : date(date), instrument_id(instrument_id), num_trades(num_trades),
           limit_up(limit_up), limit_down(limit_down), open(open),
           high(high), low(low), close(close), volume(volume),
           total_turnover(total_turnover) {}
+    StockCnDay(const Date& date,
+               const std::string& order_book_id,
+               float num_trades, float limit_up, float limit_down,
+               float open, float high, float low, float close,
+               float volume, float total_turnover)
+        : StockCnDay(date, intern_instrument(order_book_id), num_trades,
+                     limit_up, limit_down, open, high, low, close,
+                     volume, total_turnover) {}
+
+    /**
+     * @brief 证券代码 (I/O边界使用)
+     */
+    const std::string& order_book_id() const { return instrument_code(instrument_id); }
 
     /**
      * @brief 序列化
@@ -77,7 +92,7 @@ struct StockCnDay {
  */
 struct StockCn1Min {
     std::chrono::system_clock::time_point datetime;  // 日期时间
-    std::string order_book_id;                       // 证券代码
+    InstrumentId instrument_id = INVALID_INSTRUMENT_ID;  // 证券ID (见 InstrumentRegistry)
     float open;                                      // 开盘价
     float high;                                      // 最高价
     float low;                                       // 最低价
@@ -90,12 +105,23 @@ struct StockCn1Min {
      */
     StockCn1Min() = default;
     StockCn1Min(const std::chrono::system_clock::time_point& datetime,
-                const std::string& order_book_id,
+                InstrumentId instrument_id,
                 float open, float high, float low, float close,
                 float volume, float total_turnover)
-        : datetime(datetime), order_book_id(order_book_id),
+        : datetime(datetime), instrument_id(instrument_id),
           open(open), high(high), low(low), close(close),
           volume(volume), total_turnover(total_turnover) {}
+    StockCn1Min(const std::chrono::system_clock::time_point& datetime,
+                const std::string& order_book_id,
+                float open, float high, float low, float close,
+                float volume, float total_turnover)
+        : StockCn1Min(datetime, intern_instrument(order_book_id),
+                      open, high, low, close, volume, total_turnover) {}
+
+    /**
+     * @brief 证券代码 (I/O边界使用)
+     */
+    const std::string& order_book_id() const { return instrument_code(instrument_id); }
 
     /**
      * @brief 序列化
@@ -110,7 +136,7 @@ struct StockCn1Min {
 struct FutureCn1Min {
     std::chrono::system_clock::time_point datetime;  // 日期时间
     Date trading_date;                               // 交易日期 (匹配 Rust chrono::NaiveDate)
-    std::string order_book_id;                       // 合约代码
+    InstrumentId instrument_id = INVALID_INSTRUMENT_ID;  // 合约ID (见 InstrumentRegistry)
     float open_interest;                             // 持仓量
     float open;                                      // 开盘价
     float high;                                      // 最高价
@@ -125,12 +151,24 @@ struct FutureCn1Min {
     FutureCn1Min() = default;
     FutureCn1Min(const std::chrono::system_clock::time_point& datetime,
                  const Date& trading_date,
-                 const std::string& order_book_id,
+                 InstrumentId instrument_id,
                  float open_interest, float open, float high, float low,
                  float close, float volume, float total_turnover)
-        : datetime(datetime), trading_date(trading_date), order_book_id(order_book_id),
+        : datetime(datetime), trading_date(trading_date), instrument_id(instrument_id),
           open_interest(open_interest), open(open), high(high), low(low),
           close(close), volume(volume), total_turnover(total_turnover) {}
+    FutureCn1Min(const std::chrono::system_clock::time_point& datetime,
+                 const Date& trading_date,
+                 const std::string& order_book_id,
+                 float open_interest, float open, float high, float low,
+                 float close, float volume, float total_turnover)
+        : FutureCn1Min(datetime, trading_date, intern_instrument(order_book_id),
+                       open_interest, open, high, low, close, volume, total_turnover) {}
+
+    /**
+     * @brief 合约代码 (I/O边界使用)
+     */
+    const std::string& order_book_id() const { return instrument_code(instrument_id); }
 
     /**
      * @brief 序列化
@@ -144,7 +182,7 @@ struct FutureCn1Min {
  */
 struct FutureCnDay {
     Date date;                              // 日期 (匹配 Rust chrono::NaiveDate)
-    std::string order_book_id;              // 合约代码
+    InstrumentId instrument_id = INVALID_INSTRUMENT_ID;  // 合约ID (见 InstrumentRegistry)
     float limit_up;                         // 涨停价
     float limit_down;                       // 跌停价
     float open_interest;                    // 持仓量
@@ -162,16 +200,30 @@ struct FutureCnDay {
      */
     FutureCnDay() = default;
     FutureCnDay(const Date& date,
-                const std::string& order_book_id,
+                InstrumentId instrument_id,
                 float limit_up, float limit_down, float open_interest,
                 float prev_settlement, float settlement,
                 float open, float high, float low, float close,
                 float volume, float total_turnover)
-        : date(date), order_book_id(order_book_id), limit_up(limit_up),
+        : date(date), instrument_id(instrument_id), limit_up(limit_up),
           limit_down(limit_down), open_interest(open_interest),
           prev_settlement(prev_settlement), settlement(settlement),
           open(open), high(high), low(low), close(close),
           volume(volume), total_turnover(total_turnover) {}
+    FutureCnDay(const Date& date,
+                const std::string& order_book_id,
+                float limit_up, float limit_down, float open_interest,
+                float prev_settlement, float settlement,
+                float open, float high, float low, float close,
+                float volume, float total_turnover)
+        : FutureCnDay(date, intern_instrument(order_book_id), limit_up, limit_down,
+                      open_interest, prev_settlement, settlement,
+                      open, high, low, close, volume, total_turnover) {}
+
+    /**
+     * @brief 合约代码 (I/O边界使用)
+     */
+    const std::string& order_book_id() const { return instrument_code(instrument_id); }
 
     /**
      * @brief 序列化
@@ -184,7 +236,7 @@ struct FutureCnDay {
  * @brief K线数据结构 - 完全匹配Rust Kline
  */
 struct Kline {
-    std::string order_book_id;              // 证券/合约代码
+    InstrumentId instrument_id = INVALID_INSTRUMENT_ID;  // 证券/合约ID (见 InstrumentRegistry)
     double open = 0.0;                      // 开盘价
     double close = 0.0;                     // 收盘价
     double high = 0.0;                      // 最高价
@@ -200,23 +252,37 @@ struct Kline {
      * @brief 构造函数
      */
     Kline() = default;
-    Kline(const std::string& order_book_id,
+    Kline(InstrumentId instrument_id,
           double open, double close, double high, double low,
           double volume, double limit_up, double limit_down,
           double total_turnover,
           double split_coefficient_to = 0.0,
           double dividend_cash_before_tax = 0.0)
-        : order_book_id(order_book_id), open(open), close(close),
+        : instrument_id(instrument_id), open(open), close(close),
           high(high), low(low), volume(volume), limit_up(limit_up),
           limit_down(limit_down), total_turnover(total_turnover),
           split_coefficient_to(split_coefficient_to),
           dividend_cash_before_tax(dividend_cash_before_tax) {}
+    Kline(const std::string& order_book_id,
+          double open, double close, double high, double low,
+          double volume, double limit_up, double limit_down,
+          double total_turnover,
+          double split_coefficient_to = 0.0,
+          double dividend_cash_before_tax = 0.0)
+        : Kline(intern_instrument(order_book_id), open, close, high, low,
+                volume, limit_up, limit_down, total_turnover,
+                split_coefficient_to, dividend_cash_before_tax) {}
+
+    /**
+     * @brief 证券/合约代码 (I/O边界使用)
+     */
+    const std::string& order_book_id() const { return instrument_code(instrument_id); }
 
     /**
      * @brief 比较操作符
      */
     bool operator==(const Kline& other) const {
-        return order_book_id == other.order_book_id &&
+        return instrument_id == other.instrument_id &&
                std::abs(open - other.open) < 1e-9 &&
                std::abs(close - other.close) < 1e-9 &&
                std::abs(high - other.high) < 1e-9 &&
@@ -273,6 +339,11 @@ struct Kline {
     }
 };
 
+/**
+ * @brief 按证券ID索引的K线截面 (同一日期/分钟的全市场数据)
+ */
+using KlineMap = std::unordered_map<InstrumentId, Kline>;
+
 /**
  * @brief 数据类型工具函数命名空间
  */
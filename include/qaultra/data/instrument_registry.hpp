@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace qaultra::data {
+
+/**
+ * @brief 证券ID - 全局注册表分配的稠密32位编号
+ */
+using InstrumentId = uint32_t;
+
+/**
+ * @brief 无效证券ID
+ */
+constexpr InstrumentId INVALID_INSTRUMENT_ID = std::numeric_limits<InstrumentId>::max();
+
+/**
+ * @brief 全局证券代码注册表 - 代码字符串与稠密ID的双向映射
+ *
+ * 数据结构内部只保存 InstrumentId，字符串仅在 I/O 边界 (JSON、Python、Parquet)
+ * 进行转换。ID 按注册顺序从 0 开始连续分配，可直接作为数组下标使用。
+ *
+ * 线程安全:
+ * - intern/find: 读写锁保护 (命中时只取共享锁)
+ * - code: 无锁，分段存储保证已分配的字符串地址永不变化
+ */
+class InstrumentRegistry {
+public:
+    /**
+     * @brief 获取全局实例
+     */
+    static InstrumentRegistry& instance();
+
+    InstrumentRegistry() = default;
+    ~InstrumentRegistry();
+
+    InstrumentRegistry(const InstrumentRegistry&) = delete;
+    InstrumentRegistry& operator=(const InstrumentRegistry&) = delete;
+
+    /**
+     * @brief 注册代码并返回ID (已存在时返回原ID)
+     */
+    InstrumentId intern(std::string_view code);
+
+    /**
+     * @brief 查找代码对应ID，不存在时返回 INVALID_INSTRUMENT_ID
+     */
+    InstrumentId find(std::string_view code) const;
+
+    /**
+     * @brief ID转代码，无效ID返回空字符串
+     */
+    const std::string& code(InstrumentId id) const;
+
+    /**
+     * @brief 已注册的代码数量
+     */
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t SEGMENT_BITS = 12;
+    static constexpr size_t SEGMENT_SIZE = size_t{1} << SEGMENT_BITS;   // 每段 4096 个代码
+    static constexpr size_t MAX_SEGMENTS = 4096;                        // 上限约 1600 万个代码
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string_view, InstrumentId> ids_;            // 键指向分段存储中的字符串
+    std::array<std::atomic<std::string*>, MAX_SEGMENTS> segments_{};
+    std::atomic<uint32_t> size_{0};
+};
+
+/**
+ * @brief 便捷函数: 使用全局注册表注册代码 (空代码返回 INVALID_INSTRUMENT_ID)
+ */
+inline InstrumentId intern_instrument(std::string_view code) {
+    return code.empty() ? INVALID_INSTRUMENT_ID : InstrumentRegistry::instance().intern(code);
+}
+
+/**
+ * @brief 便捷函数: 使用全局注册表查询代码
+ */
+inline const std::string& instrument_code(InstrumentId id) {
+    return InstrumentRegistry::instance().code(id);
+}
+
+} // namespace qaultra::data
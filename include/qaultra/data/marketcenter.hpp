@@ -1,6 +1,8 @@
 #pragma once
 
 #include "datatype.hpp"
+#include "bar_aggregator.hpp"
+#include "tick_store.hpp"
 #include <arrow/api.h>
 #include <arrow/io/api.h>
 #include <parquet/arrow/reader.h>
@@ -12,6 +14,9 @@
 #include <optional>
 #include <chrono>
 #include <functional>
+#include <array>
+#include <limits>
+#include <map>
 
 namespace qaultra::data {
 
@@ -23,9 +28,9 @@ class QAMarketCenter {
 private:
     int32_t dateidx_;                                               // 日期索引
     std::string date_;                                              // 当前日期
-    std::unordered_map<int32_t, std::unordered_map<std::string, Kline>> data_;    // 日线数据缓存
-    std::unordered_map<std::string, Kline> today_;                  // 今日数据
-    std::unordered_map<int64_t, std::unordered_map<std::string, Kline>> minutes_; // 分钟数据缓存
+    std::unordered_map<int32_t, KlineMap> data_;                    // 日线数据缓存
+    std::shared_ptr<const KlineMap> today_;                         // 今日数据 (实时模式下为盘中日线快照)
+    std::unordered_map<int64_t, KlineMap> minutes_;                 // 分钟数据缓存
 
     // Arrow 数据缓存
     std::shared_ptr<arrow::Table> daily_table_;                     // 日线数据表
@@ -33,8 +38,18 @@ private:
     std::shared_ptr<arrow::Table> tick_table_;                      // Tick数据表
 
     // Arc 零拷贝缓存 (Rust Arc 等价实现)
-    std::unordered_map<int32_t, std::shared_ptr<const std::unordered_map<std::string, Kline>>> date_cache_;
-    std::unordered_map<int64_t, std::shared_ptr<const std::unordered_map<std::string, Kline>>> minute_cache_;
+    std::unordered_map<int32_t, std::shared_ptr<const KlineMap>> date_cache_;
+    std::unordered_map<int64_t, std::shared_ptr<const KlineMap>> minute_cache_;
+
+    // 实时K线: 每个周期一个按K线序号直接映射的定长环 (容纳一个自然日)，写线程原子替换单个槽位，
+    // 读线程 atomic_load 无锁读取；进入新交易日时清空上一交易日的日内截面
+    struct RealtimeBarEntry {
+        int64_t timestamp_ns;
+        std::shared_ptr<const KlineMap> bars;
+    };
+    std::array<std::vector<std::shared_ptr<const RealtimeBarEntry>>, BAR_PERIOD_COUNT> realtime_bars_;
+    int64_t realtime_day_ = std::numeric_limits<int64_t>::min();  // 最近发布的日内截面所在日 (仅写线程)
+    std::unique_ptr<BarAggregator> aggregator_;                     // 仅 new_for_realtime 创建
 
 public:
     /**
@@ -65,31 +80,44 @@ public:
      */
     static std::shared_ptr<arrow::Table> load_parquet_mmap(const std::string& path);
 
+    /*
+     * 日期类接口均提供 int32_t dateidx (自1970-01-01起的天数) 重载，
+     * 分钟/Tick 类接口均提供 int64_t 纳秒时间戳重载；热循环中应直接使用整数键，
+     * 字符串版本仅做一次定长解析后转发 (见 util/datetime.hpp)。
+     */
+
     /**
      * @brief 获取指定日期和代码的数据 - 匹配Rust get_codedate方法
      */
-    std::unordered_map<std::string, Kline> get_codedate(const std::string& date, const std::string& code);
+    KlineMap get_codedate(const std::string& date, const std::string& code);
+    KlineMap get_codedate(const std::string& date, InstrumentId instrument_id);
+    KlineMap get_codedate(int32_t dateidx, InstrumentId instrument_id);
 
     /**
      * @brief 获取指定日期的所有数据 - 匹配Rust get_date方法
      */
-    std::unordered_map<std::string, Kline> get_date(const std::string& date);
+    KlineMap get_date(const std::string& date);
+    KlineMap get_date(int32_t dateidx);
 
     /**
      * @brief 尝试获取指定日期的数据引用 - 匹配Rust try_get_date方法
      */
-    std::optional<std::reference_wrapper<const std::unordered_map<std::string, Kline>>>
+    std::optional<std::reference_wrapper<const KlineMap>>
     try_get_date(const std::string& date);
+    std::optional<std::reference_wrapper<const KlineMap>>
+    try_get_date(int32_t dateidx);
 
     /**
      * @brief 获取指定时间的分钟数据 - 匹配Rust get_minutes方法
      */
-    std::unordered_map<std::string, Kline> get_minutes(const std::string& datetime);
+    KlineMap get_minutes(const std::string& datetime);
+    KlineMap get_minutes(int64_t timestamp_ns);
 
     /**
      * @brief 获取指定时间的分钟数据引用 - 匹配Rust get_minutes_ref方法
      */
-    const std::unordered_map<std::string, Kline>& get_minutes_ref(const std::string& datetime);
+    const KlineMap& get_minutes_ref(const std::string& datetime);
+    const KlineMap& get_minutes_ref(int64_t timestamp_ns);
 
     /**
      * @brief 加载分钟数据 - 匹配Rust load_minutes方法
@@ -106,6 +134,23 @@ public:
      */
     void load_tick_with_filter(const std::string& date, const std::vector<std::string>& order_book_id_list);
 
+    /**
+     * @brief 将某日 Tick Parquet 按时间顺序追加到内存映射 Tick 存储
+     * @return 写入的 Tick 数
+     */
+    size_t import_tick_to_store(const std::string& date, TickStoreWriter& writer);
+
+    /**
+     * @brief 从 Tick 存储流式回放 [start_ns, end_ns) 区间到实时聚合器
+     *
+     * 逐块解码、边读边聚合，不在内存中展开整日 Tick，适合全市场多日回测；
+     * 合成的K线截面经 publish_bars 发布。instruments 为空时回放全部证券。
+     * @return 回放的 Tick 数
+     */
+    size_t replay_ticks(const TickStore& store,
+                        const std::vector<std::string>& instruments,
+                        int64_t start_ns, int64_t end_ns);
+
     /**
      * @brief 使用下推过滤器加载分钟数据 - 匹配Rust load_minutes_with_filter_pushdown方法
      */
@@ -118,6 +163,11 @@ public:
      */
     std::vector<std::string> get_minutes_range();
 
+    /**
+     * @brief 获取已加载的分钟时间戳 (纳秒，升序)
+     */
+    std::vector<int64_t> get_minutes_timestamps() const;
+
     /**
      * @brief 加载期货分钟数据 - 匹配Rust load_future_minutes方法
      */
@@ -136,7 +186,8 @@ public:
     /**
      * @brief 获取指定日期数据引用 - 匹配Rust get_date_ref方法
      */
-    const std::unordered_map<std::string, Kline>& get_date_ref(const std::string& date);
+    const KlineMap& get_date_ref(const std::string& date);
+    const KlineMap& get_date_ref(int32_t dateidx);
 
     /**
      * @brief Arc 零拷贝获取日期数据 - 匹配Rust get_date_arc方法
@@ -154,8 +205,10 @@ public:
      * @param date 日期字符串 (YYYY-MM-DD)
      * @return shared_ptr，所有调用者共享同一数据
      */
-    std::shared_ptr<const std::unordered_map<std::string, Kline>>
+    std::shared_ptr<const KlineMap>
     get_date_shared(const std::string& date);
+    std::shared_ptr<const KlineMap>
+    get_date_shared(int32_t dateidx);
 
     /**
      * @brief Arc 零拷贝获取分钟数据 - 匹配Rust get_minutes_arc方法
@@ -163,14 +216,59 @@ public:
      * @param datetime 时间字符串 (YYYY-MM-DD HH:MM:SS)
      * @return shared_ptr，所有调用者共享同一数据
      */
-    std::shared_ptr<const std::unordered_map<std::string, Kline>>
+    std::shared_ptr<const KlineMap>
     get_minutes_shared(const std::string& datetime);
+    std::shared_ptr<const KlineMap>
+    get_minutes_shared(int64_t timestamp_ns);
 
     /**
      * @brief 清除 Arc 缓存
      */
     void clear_shared_cache();
 
+    /**
+     * @brief 实时模式: 推入一个 Tick，周期收盘时自动发布K线截面
+     *
+     * 需由单个行情线程调用；读取接口可在其他线程并发使用。
+     * 非 new_for_realtime 创建的实例首次调用时按默认配置创建聚合器。
+     */
+    void on_tick(const protocol::mifi::Tick& tick);
+    void on_tick(const ipc::MarketTick& tick);
+
+    /**
+     * @brief 实时模式: 按时钟关闭已到期的周期 (午休/收盘等无 Tick 时段)
+     */
+    void flush_realtime(int64_t now_ns);
+
+    /**
+     * @brief 发布一个K线截面 (聚合器回调，也可直接推入外部合成的K线)
+     *
+     * 1分钟K线进入实时分钟索引 (get_minutes_shared 可查)，日线写入 today_。
+     * 每个周期只保留最近一个自然日的截面，多日回放时内存不随天数增长。
+     */
+    void publish_bars(const BarCrossSection& section);
+
+    /**
+     * @brief 无锁获取实时K线截面
+     * @param bar_timestamp_ns K线起始时间 (纳秒，UTC民用时间口径)
+     */
+    std::shared_ptr<const KlineMap> get_realtime_bars(BarPeriod period, int64_t bar_timestamp_ns) const;
+
+    /**
+     * @brief 无锁获取指定周期已发布的全部K线时间
+     */
+    std::vector<int64_t> get_realtime_timestamps(BarPeriod period) const;
+
+    /**
+     * @brief 无锁获取今日日线快照
+     */
+    std::shared_ptr<const KlineMap> get_today_shared() const;
+
+    /**
+     * @brief 访问实时聚合器 (未启用时返回 nullptr)
+     */
+    BarAggregator* realtime_aggregator() { return aggregator_.get(); }
+
     /**
      * @brief 获取股票日线数据范围 (兼容性方法)
      */
@@ -214,29 +312,51 @@ public:
     nlohmann::json to_json() const;
 
 private:
+    /**
+     * @brief 分区范围 - 已排序表中同一时间键的连续行区间
+     */
+    struct PartitionRange {
+        int64_t key = 0;        // 分区键 (日期索引 / 纳秒时间戳)
+        int64_t offset = 0;     // 起始行
+        int64_t length = 0;     // 行数
+    };
+
+    /**
+     * @brief 列视图 - 直接引用Arrow缓冲区，避免逐列拷贝到std::vector (定义见marketcenter.cpp)
+     *
+     * order_book_id 列在分区前按chunk转换为 InstrumentId 列；字典编码的列
+     * 每个字典值只注册一次。
+     */
+    struct ColumnViews;
+
     /**
      * @brief 分割日线数据 - 匹配Rust run_split_date方法
      */
-    static std::pair<int32_t, std::unordered_map<std::string, Kline>>
-    run_split_date(std::shared_ptr<arrow::Table> table);
+    static std::pair<int32_t, KlineMap>
+    run_split_date(const ColumnViews& columns, const PartitionRange& range);
 
     /**
      * @brief 分割分钟数据 - 匹配Rust run_split_minutes方法
      */
-    static std::pair<int64_t, std::unordered_map<std::string, Kline>>
-    run_split_minutes(std::shared_ptr<arrow::Table> table);
+    static std::pair<int64_t, KlineMap>
+    run_split_minutes(const ColumnViews& columns, const PartitionRange& range);
 
     /**
      * @brief 分割Tick数据 - 匹配Rust run_split_ticks方法
      */
-    static std::pair<int64_t, std::unordered_map<std::string, Kline>>
-    run_split_ticks(std::shared_ptr<arrow::Table> table);
+    static std::pair<int64_t, KlineMap>
+    run_split_ticks(const ColumnViews& columns, const PartitionRange& range);
 
     /**
      * @brief 日期字符串转时间戳
      */
     static int64_t date_string_to_timestamp(const std::string& date);
 
+    /**
+     * @brief 日期字符串转日期索引 (自1970-01-01起的天数)
+     */
+    static int32_t date_string_to_index(const std::string& date);
+
     /**
      * @brief 时间字符串转纳秒时间戳
      */
@@ -248,16 +368,21 @@ private:
     static std::string nanos_to_datetime_string(int64_t nanos);
 
     /**
-     * @brief 按日期分组Arrow表数据
+     * @brief 按日期分区 - 合并chunk、按date列排序后返回分区边界
+     * @param table 输入表，返回时被替换为已排序的单chunk表
      */
-    std::unordered_map<int32_t, std::shared_ptr<arrow::Table>>
-    partition_by_date(std::shared_ptr<arrow::Table> table);
+    static std::vector<PartitionRange> partition_by_date(std::shared_ptr<arrow::Table>& table);
 
     /**
-     * @brief 按时间分组Arrow表数据
+     * @brief 按时间分区 - 合并chunk、按datetime列排序后返回分区边界
+     * @param table 输入表，返回时被替换为已排序的单chunk表
      */
-    std::unordered_map<int64_t, std::shared_ptr<arrow::Table>>
-    partition_by_datetime(std::shared_ptr<arrow::Table> table);
+    static std::vector<PartitionRange> partition_by_datetime(std::shared_ptr<arrow::Table>& table);
+
+    /**
+     * @brief 并行分割分钟/Tick数据并写入minutes_
+     */
+    void ingest_minutes(std::shared_ptr<arrow::Table> table, bool tick_data);
 
     /**
      * @brief 应用过滤器到Arrow表
@@ -266,24 +391,6 @@ private:
                                               const std::string& column_name,
                                               const std::vector<std::string>& values);
 
-    /**
-     * @brief 从Arrow表提取字符串列
-     */
-    static std::vector<std::string> extract_string_column(std::shared_ptr<arrow::Table> table,
-                                                          const std::string& column_name);
-
-    /**
-     * @brief 从Arrow表提取浮点列
-     */
-    static std::vector<double> extract_double_column(std::shared_ptr<arrow::Table> table,
-                                                     const std::string& column_name);
-
-    /**
-     * @brief 从Arrow表提取时间戳列
-     */
-    static std::vector<int64_t> extract_timestamp_column(std::shared_ptr<arrow::Table> table,
-                                                         const std::string& column_name);
-
     /**
      * @brief 构建缓存路径
      */
@@ -321,12 +428,12 @@ namespace marketcenter_utils {
     /**
      * @brief Arrow表转换为Kline映射
      */
-    std::unordered_map<std::string, Kline> table_to_kline_map(std::shared_ptr<arrow::Table> table);
+    KlineMap table_to_kline_map(std::shared_ptr<arrow::Table> table);
 
     /**
      * @brief Kline映射转换为Arrow表
      */
-    std::shared_ptr<arrow::Table> kline_map_to_table(const std::unordered_map<std::string, Kline>& klines,
+    std::shared_ptr<arrow::Table> kline_map_to_table(const KlineMap& klines,
                                                      const std::string& timestamp);
 
     /**
@@ -3,21 +3,31 @@
 #include "marketcenter.hpp"
 #include "datatype.hpp"
 #include "../protocol/mifi.hpp"  // 包含 Tick 定义
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <string>
 #include <chrono>
+#include <vector>
 
 /**
  * @file tick_broadcaster.hpp
- * @brief Tick 数据广播器 - Arc 零拷贝高性能实现
+ * @brief Tick 数据广播器 - 每订阅者 SPSC 环形队列 + 纪元回收
  *
  * 基于 Rust TickBroadcaster 的 C++ 实现
  *
- * 性能特点:
- * - Arc 零拷贝: 25,000-50,000x 加速 (vs 深拷贝)
- * - 智能缓存: 同一天数据仅 10-20 ns
- * - 批量处理: 支持高频 tick 推送
+ * 设计:
+ * - 广播的是轻量快照句柄 (日期、序号、裸指针)，不再向每个订阅者拷贝 shared_ptr，
+ *   每个订阅者每 tick 只有一次普通写入，批量推送时每个订阅者只做一次 release 发布
+ * - 每个订阅者一个单生产者单消费者环形队列，队列满时丢弃最新句柄并计数
+ * - 快照数据由广播器持有；日期切换后旧数据进入回收列表，待所有订阅者宣告的
+ *   纪元 (已释放序号) 越过其最后序号后释放
+ * - 日期按天数整数比较，批量推送不为每个 tick 分配日期字符串
+ * - 订阅者列表写时复制，注册/取消订阅可与广播并发
+ *
+ * 线程模型: push_tick/push_batch/clear_cache 由单个生产者线程调用；
+ * 每个 Subscriber 由单个消费者线程 drain。
  *
  * 使用示例:
  * ```cpp
@@ -25,13 +35,15 @@
  * TickBroadcaster broadcaster(std::move(market));
  *
  * // 注册订阅者
- * broadcaster.register_subscriber("strategy1");
- * broadcaster.register_subscriber("strategy2");
+ * auto strategy1 = broadcaster.register_subscriber("strategy1");
  *
  * // 推送 tick
- * for (const auto& tick : ticks) {
- *     broadcaster.push_tick(tick.date, tick);
- * }
+ * broadcaster.push_batch(ticks);
+ *
+ * // 消费者线程
+ * strategy1->drain([](const TickSnapshot& snapshot) {
+ *     if (snapshot.data) { ... }
+ * });
  * ```
  */
 
@@ -40,30 +52,112 @@ namespace qaultra::data {
 // 使用 protocol::mifi 命名空间中的 Tick
 using protocol::mifi::Tick;
 
+/**
+ * @brief 快照句柄
+ *
+ * data 由 TickBroadcaster 持有，在订阅者下一次 drain/release 之前有效；
+ * 对应日期没有数据时为 nullptr。
+ */
+struct TickSnapshot {
+    int32_t date = 0;                   // 自 1970-01-01 起的天数
+    uint64_t sequence = 0;              // 广播序号 (每个 tick 递增)
+    const KlineMap* data = nullptr;
+};
+
+/**
+ * @brief 快照句柄的单生产者单消费者环形队列
+ */
+class SnapshotRing {
+public:
+    explicit SnapshotRing(size_t capacity);
+
+    SnapshotRing(const SnapshotRing&) = delete;
+    SnapshotRing& operator=(const SnapshotRing&) = delete;
+
+    /**
+     * @brief 生产者批量写入，只做一次 release 发布
+     * @return 写入数量 (队列满时丢弃其余的最新句柄)
+     */
+    size_t push_bulk(const TickSnapshot* items, size_t count);
+
+    /**
+     * @brief 消费者批量取出
+     * @return 取出数量
+     */
+    size_t pop_bulk(TickSnapshot* out, size_t max_count);
+
+    size_t capacity() const { return slots_.size(); }
+    size_t size() const;
+
+private:
+    std::vector<TickSnapshot> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<uint64_t> head_{0};   // 消费者位置
+    uint64_t cached_tail_ = 0;
+    alignas(64) std::atomic<uint64_t> tail_{0};   // 生产者位置
+    uint64_t cached_head_ = 0;
+};
+
 /**
  * @brief Tick 数据订阅者
+ *
+ * 由 TickBroadcaster::register_subscriber 创建。drain 开始时宣告上一批句柄
+ * (最新快照除外) 已用完，广播器据此回收旧日期数据；长期不 drain 的订阅者会推迟回收。
  */
-struct Subscriber {
-    std::string id;
-    size_t received_count = 0;
-    std::shared_ptr<const std::unordered_map<std::string, Kline>> last_data;
+class Subscriber {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
 
-    explicit Subscriber(const std::string& subscriber_id) : id(subscriber_id) {}
+    Subscriber(const std::string& subscriber_id, uint64_t start_sequence,
+               size_t capacity = DEFAULT_CAPACITY);
+
+    Subscriber(const Subscriber&) = delete;
+    Subscriber& operator=(const Subscriber&) = delete;
 
     /**
-     * @brief 接收数据 (零拷贝)
+     * @brief 取出所有待处理快照，依次回调 fn(const TickSnapshot&)
+     * @return 回调次数
+     *
+     * 上一次 drain 取到的句柄在此调用后失效。
      */
-    void receive(std::shared_ptr<const std::unordered_map<std::string, Kline>> data) {
-        last_data = data;  // shared_ptr copy (零拷贝)
-        received_count++;
-    }
+    template <typename Fn>
+    size_t drain(Fn&& fn);
 
     /**
-     * @brief 获取最新数据
+     * @brief 取出至多 max_count 个快照追加到 out
      */
-    const std::shared_ptr<const std::unordered_map<std::string, Kline>>& get_latest() const {
-        return last_data;
-    }
+    size_t poll(std::vector<TickSnapshot>& out, size_t max_count = DEFAULT_CAPACITY);
+
+    /**
+     * @brief 宣告已取出的句柄 (包括最新快照) 全部用完，允许回收
+     */
+    void release();
+
+    /**
+     * @brief 最近一次取出的快照
+     *
+     * 在取到更新的快照或调用 release() 之前保持有效；尚未取到时 data 为 nullptr。
+     */
+    const TickSnapshot& get_latest() const { return latest_; }
+
+    const std::string& id() const { return id_; }
+    size_t received_count() const { return received_count_; }
+    size_t pending() const { return ring_.size(); }
+    size_t capacity() const { return ring_.capacity(); }
+
+private:
+    friend class TickBroadcaster;
+
+    void begin_batch();
+
+    std::string id_;
+    SnapshotRing ring_;
+    alignas(64) std::atomic<uint64_t> released_sequence_;  // 序号小于此值的句柄已不再引用
+    uint64_t consumed_end_;                                // 已取出句柄的最大序号 + 1
+    size_t received_count_ = 0;
+    TickSnapshot latest_;
+    bool holds_latest_ = false;                            // latest_ 仍被引用
+    std::vector<TickSnapshot> scratch_;
 };
 
 /**
@@ -74,14 +168,16 @@ struct BroadcastStats {
     size_t total_broadcasts = 0;
     size_t cache_hits = 0;
     size_t cache_misses = 0;
+    size_t ring_overflows = 0;          // 因订阅者队列满而丢弃的句柄数
+    size_t reclaimed_snapshots = 0;     // 已回收的旧日期数据
     uint64_t total_latency_ns = 0;
 
     /**
      * @brief 获取平均延迟 (纳秒)
      */
     double avg_latency_ns() const {
-        return total_broadcasts == 0 ? 0.0 :
-            static_cast<double>(total_latency_ns) / total_broadcasts;
+        return total_ticks == 0 ? 0.0 :
+            static_cast<double>(total_latency_ns) / total_ticks;
     }
 
     /**
@@ -100,45 +196,72 @@ struct BroadcastStats {
  */
 class TickBroadcaster {
 private:
+    using SubscriberList = std::vector<std::shared_ptr<Subscriber>>;
+
+    /**
+     * @brief 待回收的旧日期数据
+     */
+    struct RetiredSnapshot {
+        uint64_t last_sequence;
+        std::shared_ptr<const KlineMap> data;
+    };
+
+    static constexpr int32_t NO_DATE = INT32_MIN;
+
     QAMarketCenter market_;
-    std::unordered_map<std::string, Subscriber> subscribers_;
-    std::string current_date_;
-    std::shared_ptr<const std::unordered_map<std::string, Kline>> cached_data_;
+    std::mutex registry_mutex_;
+    std::shared_ptr<const SubscriberList> subscribers_;
+    std::atomic<uint64_t> next_sequence_{0};
+    int32_t current_date_ = NO_DATE;
+    std::shared_ptr<const KlineMap> cached_data_;
+    std::vector<RetiredSnapshot> retired_;
+    std::vector<TickSnapshot> batch_;
     BroadcastStats stats_;
 
+    std::shared_ptr<const SubscriberList> load_subscribers() const;
+    TickSnapshot make_snapshot(int32_t dateidx, uint64_t sequence);
+    void retire_current(uint64_t last_sequence);
+    void reclaim(const SubscriberList& subscribers);
+    void publish(const int32_t* dates, size_t count);
+
 public:
     /**
      * @brief 构造函数
      * @param market 市场数据中心 (移动语义)
      */
-    explicit TickBroadcaster(QAMarketCenter&& market)
-        : market_(std::move(market)) {}
+    explicit TickBroadcaster(QAMarketCenter&& market);
 
     /**
-     * @brief 禁止拷贝，允许移动
+     * @brief 禁止拷贝和移动 (订阅者持有的句柄指向广播器内的数据)
      */
     TickBroadcaster(const TickBroadcaster&) = delete;
     TickBroadcaster& operator=(const TickBroadcaster&) = delete;
-    TickBroadcaster(TickBroadcaster&&) = default;
-    TickBroadcaster& operator=(TickBroadcaster&&) = default;
 
     /**
-     * @brief 注册订阅者
+     * @brief 注册订阅者 (可与广播并发；id 已存在时返回原订阅者)
+     * @param capacity 订阅者队列容量 (向上取整为2的幂)
      */
-    void register_subscriber(const std::string& id);
+    std::shared_ptr<Subscriber> register_subscriber(const std::string& id,
+                                                    size_t capacity = Subscriber::DEFAULT_CAPACITY);
 
     /**
      * @brief 取消订阅
+     *
+     * 取消后不再向其推送，也不再等待其纪元；该订阅者已取出的句柄不应再使用。
      */
     void unregister_subscriber(const std::string& id);
 
     /**
-     * @brief 推送 Tick 数据 (Arc 零拷贝)
+     * @brief 查找订阅者
+     */
+    std::shared_ptr<Subscriber> get_subscriber(const std::string& id) const;
+
+    /**
+     * @brief 推送 Tick 数据 (零拷贝)
      *
      * 性能特点:
      * - 首次访问新日期: ~500 μs (创建 shared_ptr)
-     * - 后续访问同日期: ~10-20 ns (clone shared_ptr)
-     * - 广播给 N 个订阅者: ~10-20 ns × N
+     * - 后续访问同日期: 整数比较 + 每订阅者一次句柄写入
      *
      * @param date 日期字符串 (YYYY-MM-DD)
      * @param tick Tick 数据 (当前版本未使用，保留接口兼容性)
@@ -146,7 +269,12 @@ public:
     void push_tick(const std::string& date, const Tick& tick);
 
     /**
-     * @brief 批量推送 Tick 数据
+     * @param dateidx 自 1970-01-01 起的天数
+     */
+    void push_tick(int32_t dateidx, const Tick& tick);
+
+    /**
+     * @brief 批量推送 Tick 数据 (每个订阅者只发布一次)
      */
     void push_batch(const std::vector<Tick>& ticks);
 
@@ -163,10 +291,15 @@ public:
     /**
      * @brief 获取订阅者数量
      */
-    size_t subscriber_count() const { return subscribers_.size(); }
+    size_t subscriber_count() const { return load_subscribers()->size(); }
 
     /**
-     * @brief 清除缓存
+     * @brief 待回收的旧日期数据数量
+     */
+    size_t retired_count() const { return retired_.size(); }
+
+    /**
+     * @brief 清除缓存 (当前数据转入回收列表)
      */
     void clear_cache();
 
@@ -176,4 +309,22 @@ public:
     QAMarketCenter& market() { return market_; }
 };
 
+template <typename Fn>
+size_t Subscriber::drain(Fn&& fn) {
+    begin_batch();
+    size_t delivered = 0;
+    scratch_.resize(ring_.capacity());
+    while (size_t count = ring_.pop_bulk(scratch_.data(), scratch_.size())) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(static_cast<const TickSnapshot&>(scratch_[i]));
+        }
+        latest_ = scratch_[count - 1];
+        holds_latest_ = true;
+        consumed_end_ = latest_.sequence + 1;
+        delivered += count;
+    }
+    received_count_ += delivered;
+    return delivered;
+}
+
 } // namespace qaultra::data
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "instrument_registry.hpp"
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file tick_store.hpp
+ * @brief 内存映射的逐笔行情存储 - 追加写入、按时间区间流式读取
+ *
+ * 目录结构:
+ *   <root>/<code>.qts   数据段: 文件头 + 若干数据块 (每块为增量编码的 Tick)
+ *   <root>/<code>.qti   稀疏时间索引: 每个数据块一条 (首/末时间戳、偏移、条数)
+ *
+ * 编码: 时间戳、价格、成交量、成交额均换算为整数后与前一条做差，
+ * 采用 zigzag + varint 编码；每个数据块从零状态开始，可独立解码。
+ *
+ * 使用示例:
+ * ```cpp
+ * TickStoreWriter writer("/data/ticks");
+ * writer.append("000001.XSHE", tick);
+ * writer.flush();
+ *
+ * TickStore store("/data/ticks");
+ * auto cursor = store.scan({"000001.XSHE", "600000.XSHG"}, start_ns, end_ns);
+ * TickRecord record;
+ * while (cursor.next(record)) {
+ *     // 按时间顺序合并的多证券 Tick，内存占用与区间长度无关
+ * }
+ * ```
+ */
+
+namespace qaultra::data {
+
+/**
+ * @brief 存储的 Tick 字段
+ */
+struct StoredTick {
+    int64_t timestamp_ns = 0;       // 纳秒时间戳
+    double last_price = 0.0;        // 最新价
+    double bid_price = 0.0;         // 买一价
+    double ask_price = 0.0;         // 卖一价
+    double volume = 0.0;            // 成交量 (通常为当日累计)
+    double amount = 0.0;            // 成交额 (通常为当日累计)
+};
+
+/**
+ * @brief 游标输出记录
+ */
+struct TickRecord {
+    InstrumentId instrument_id = INVALID_INSTRUMENT_ID;
+    StoredTick tick;
+};
+
+/**
+ * @brief 存储配置 (写入时记录在每个数据段文件头中)
+ */
+struct TickStoreOptions {
+    double price_scale = 10000.0;   // 价格精度 0.0001
+    double volume_scale = 1.0;      // 成交量精度 1
+    double amount_scale = 100.0;    // 成交额精度 0.01
+    uint32_t block_ticks = 256;     // 每个数据块的 Tick 数 (索引粒度)
+};
+
+/**
+ * @brief 数据段概要
+ */
+struct TickSegmentInfo {
+    std::string code;
+    uint64_t tick_count = 0;
+    uint64_t block_count = 0;
+    uint64_t bytes = 0;
+    int64_t first_timestamp_ns = 0;
+    int64_t last_timestamp_ns = 0;
+};
+
+/**
+ * @brief 追加写入器
+ *
+ * 每个证券在内存中只缓存当前未满的数据块，满块后追加写入数据段并登记索引。
+ * 同一证券的时间戳必须单调不减。非线程安全。
+ */
+class TickStoreWriter {
+public:
+    explicit TickStoreWriter(const std::string& root, const TickStoreOptions& options = TickStoreOptions());
+    ~TickStoreWriter();
+
+    TickStoreWriter(const TickStoreWriter&) = delete;
+    TickStoreWriter& operator=(const TickStoreWriter&) = delete;
+
+    /**
+     * @brief 追加一个 Tick，时间倒退或代码超过 32 字节时返回 false
+     */
+    bool append(InstrumentId instrument_id, const StoredTick& tick);
+    bool append(const std::string& code, const StoredTick& tick);
+
+    /**
+     * @brief 将所有未满数据块写入磁盘
+     */
+    bool flush();
+
+    const std::string& root() const { return root_; }
+
+private:
+    struct SegmentState;
+
+    SegmentState* state_for(InstrumentId instrument_id);   // 代码过长时返回 nullptr
+    bool flush_block(SegmentState& state);
+
+    std::string root_;
+    TickStoreOptions options_;
+    std::vector<std::unique_ptr<SegmentState>> segments_;   // 按 InstrumentId 下标
+};
+
+class MappedTickSegment;
+
+/**
+ * @brief 多证券按时间合并的流式游标
+ *
+ * 每个证券只持有当前数据块的解码位置，通过最小堆按时间戳合并输出；
+ * 同一时间戳按 InstrumentId 排序，输出顺序确定。
+ * 游标持有数据段映射的引用，可独立于 TickStore 存活。
+ */
+class TickCursor {
+public:
+    TickCursor() = default;
+    TickCursor(TickCursor&&) noexcept;
+    TickCursor& operator=(TickCursor&&) noexcept;
+    ~TickCursor();
+
+    /**
+     * @brief 读取下一条记录，区间结束时返回 false
+     */
+    bool next(TickRecord& record);
+
+    /**
+     * @brief 批量读取，返回实际读取条数
+     */
+    size_t next_batch(std::vector<TickRecord>& records, size_t max_records);
+
+private:
+    friend class TickStore;
+    struct Stream;
+
+    void push_stream(std::unique_ptr<Stream> stream);
+
+    std::vector<std::unique_ptr<Stream>> streams_;
+    std::vector<Stream*> heap_;
+};
+
+/**
+ * @brief 只读存储 - 数据段以 mmap 方式按需映射
+ *
+ * 打开游标时映射的是当时的文件长度，之后追加的数据对该游标不可见。
+ */
+class TickStore {
+public:
+    explicit TickStore(const std::string& root);
+
+    /**
+     * @brief 存储中的全部证券代码
+     */
+    std::vector<std::string> instruments() const;
+
+    /**
+     * @brief 数据段概要 (不存在时 tick_count 为0)
+     */
+    TickSegmentInfo info(const std::string& code) const;
+
+    /**
+     * @brief 打开全部证券 [start_ns, end_ns) 区间的合并游标
+     */
+    TickCursor scan_all(int64_t start_ns = std::numeric_limits<int64_t>::min(),
+                        int64_t end_ns = std::numeric_limits<int64_t>::max()) const;
+
+    /**
+     * @brief 打开指定证券 [start_ns, end_ns) 区间的合并游标 (重复代码只计一次，空列表等同 scan_all)
+     */
+    TickCursor scan(const std::vector<std::string>& instruments,
+                    int64_t start_ns = std::numeric_limits<int64_t>::min(),
+                    int64_t end_ns = std::numeric_limits<int64_t>::max()) const;
+    TickCursor scan(std::initializer_list<std::string> instruments,   // 使 scan({...}) / scan({}) 无歧义
+                    int64_t start_ns = std::numeric_limits<int64_t>::min(),
+                    int64_t end_ns = std::numeric_limits<int64_t>::max()) const;
+    TickCursor scan(const std::vector<InstrumentId>& instruments,
+                    int64_t start_ns = std::numeric_limits<int64_t>::min(),
+                    int64_t end_ns = std::numeric_limits<int64_t>::max()) const;
+
+    const std::string& root() const { return root_; }
+
+private:
+    std::string root_;
+};
+
+} // namespace qaultra::data
@@ -1,11 +1,12 @@
 #pragma once
 
+#include "qaultra/analysis/incremental_indicators.hpp"
+
 #include <vector>
 #include <string>
 #include <memory>
 #include <map>
 #include <unordered_map>
-#include <mutex>
 #include <atomic>
 #include <functional>
 
@@ -15,13 +16,6 @@ namespace account {
     class QA_Account;
     class QA_Position;
 }
-namespace market {
-    class MatchingEngine;
-    struct TradeResult;
-}
-namespace arrow_data {
-    class ArrowKlineCollection;
-}
 }
 
 namespace qaultra::engine {
@@ -33,11 +27,12 @@ struct BacktestConfig {
     std::string start_date = "2024-01-01";     // 开始日期
     std::string end_date = "2024-12-31";       // 结束日期
     double initial_cash = 1000000.0;           // 初始资金
-    double commission_rate = 0.0003;           // 手续费率
+    double commission_rate = 0.0003;           // 手续费率 (按成交额，买卖双边)
+    double lot_size = 100.0;                   // 最小交易单位 (order_target_* 按此取整)
     std::string benchmark = "000300.XSHG";     // 基准指数
 
     // 引擎配置
-    bool enable_matching_engine = false;       // 是否启用撮合引擎
+    bool enable_matching_engine = false;       // 是否启用撮合引擎 (当前按当根收盘价成交)
     int max_threads = 4;                       // 最大线程数
 
     // 其他配置
@@ -55,7 +50,7 @@ struct BacktestResults {
     double max_drawdown = 0.0;                 // 最大回撤
     double volatility = 0.0;                   // 波动率
     double win_rate = 0.0;                     // 胜率
-    double profit_factor = 0.0;                // 盈亏比
+    double profit_factor = 0.0;                // 盈亏比 (无亏损交易时为 +inf)
     int total_trades = 0;                      // 总交易次数
     double final_value = 0.0;                  // 最终资产价值
 
@@ -63,26 +58,147 @@ struct BacktestResults {
     std::vector<double> daily_returns;         // 每日收益率
 };
 
+/**
+ * @brief K线字段
+ */
+enum class BarField {
+    Open,
+    High,
+    Low,
+    Close,
+    Volume
+};
+
+/**
+ * @brief 连续 double 序列的只读视图 (不拥有数据，生命周期随 BacktestEngine 的行情面板)
+ */
+class SeriesView {
+public:
+    SeriesView() = default;
+    SeriesView(const double* data, size_t size) : data_(data), size_(size) {}
+
+    const double* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const double* begin() const { return data_; }
+    const double* end() const { return data_ + size_; }
+    double operator[](size_t index) const { return data_[index]; }
+    double front() const { return data_[0]; }
+    double back() const { return data_[size_ - 1]; }
+
+    std::vector<double> to_vector() const { return std::vector<double>(begin(), end()); }
+
+private:
+    const double* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief 单条日线记录 (用于构建行情面板)
+ */
+struct BarRecord {
+    std::string date;                          // 交易日 (YYYY-MM-DD)
+    std::string symbol;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+};
+
+/**
+ * @brief 预加载的列式行情面板
+ *
+ * 所有标的对齐到同一个稠密日期索引。每个字段一整块连续数组，按标的主序存放:
+ * 标的 s 在第 t 根 bar 的值位于 [s * bars() + t]，因此任意标的的历史窗口都是一段连续内存。
+ * 停牌等缺失的 bar 用前值填充 (成交量为 0)；首根有效 bar 之前的值为 0。
+ */
+struct BarPanel {
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    std::vector<std::string> dates;            // 稠密日期索引 (升序)
+    std::vector<std::string> symbols;          // 标的 (升序)
+    std::unordered_map<std::string, size_t> symbol_index;
+    std::vector<size_t> first_bar;             // 各标的首根有效 bar (无数据时为 bars())
+
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> volume;
+    std::vector<double> close_rows;            // 收盘价的时间主序副本 [t * symbol_count() + s]，用于截面估值
+
+    size_t bars() const { return dates.size(); }
+    size_t symbol_count() const { return symbols.size(); }
+    size_t find_symbol(const std::string& symbol) const;
+
+    /**
+     * @brief 标的 s 某字段的整段序列起点 (长度为 bars())
+     */
+    const double* column(BarField field, size_t symbol) const;
+
+    /**
+     * @brief 由无序记录构建面板 (同一标的同一日期重复时以后出现者为准)
+     */
+    static BarPanel from_records(const std::vector<BarRecord>& records);
+};
+
+class BacktestEngine;
+
 /**
  * @brief 策略上下文
+ *
+ * 按标的下标的接口直接读取行情面板，不做字符串查找；按代码的接口先查 symbol_index。
+ * 下单在当前 bar 的收盘价立即成交，由引擎内部的资金 / 持仓簿记账。
  */
 struct StrategyContext {
-    std::shared_ptr<account::QA_Account> account;
-    std::vector<std::string> universe;        // 股票池
+    std::shared_ptr<account::QA_Account> account;   // 外部账户 (引擎不使用)
+    const std::vector<std::string>* universe = nullptr;   // 股票池 (指向行情面板的标的列表，不复制)
     std::string current_date;                 // 当前日期
-    double current_price = 0.0;               // 当前价格
+    double current_price = 0.0;               // 当前价格 (单标的回测时为该标的收盘价)
+    size_t bar_index = 0;                     // 当前 bar 在稠密日期索引中的位置
 
-    // 数据缓存
-    mutable std::mutex cache_mutex_;
-    // std::unordered_map<std::string, std::shared_ptr<arrow_data::ArrowKlineCollection>> data_cache_; // 暂时注释掉
+    BacktestEngine* engine = nullptr;         // 由 BacktestEngine::run 设置
 
     // 接口方法
     double get_price(const std::string& symbol) const;
-    std::vector<double> get_history(const std::string& symbol, int window, const std::string& field = "close") const;
+    SeriesView get_history(const std::string& symbol, int window, const std::string& field = "close") const;
     std::shared_ptr<account::QA_Position> get_position(const std::string& symbol) const;
     double get_cash() const;
     double get_portfolio_value() const;
     void log(const std::string& message) const;
+
+    // 按标的下标的快速接口
+    size_t symbol_count() const;
+    double get_price(size_t symbol) const;
+
+    /**
+     * @brief 截至当前 bar (含) 最近 window 根的字段序列，零拷贝
+     *
+     * 上市不足 window 根时返回全部已有的 bar；window <= 0 或无数据时返回空视图。
+     */
+    SeriesView get_history(size_t symbol, int window, BarField field = BarField::Close) const;
+    double get_holding(size_t symbol) const;
+
+    /**
+     * @brief 当前 bar 全部标的的收盘价 (按标的下标，零拷贝)，可直接喂给增量指标
+     *
+     * 上市前的位置为 0。
+     */
+    SeriesView get_cross_section() const;
+
+    // 下单 (按当前收盘价成交，成功返回 true)
+    bool buy(size_t symbol, double volume);
+    bool sell(size_t symbol, double volume);
+    bool buy(const std::string& symbol, double volume);
+    bool sell(const std::string& symbol, double volume);
+
+    /**
+     * @brief 调整持仓至目标市值 (按最小交易单位向下取整)
+     */
+    bool order_target_value(size_t symbol, double value);
+    bool order_target_percent(size_t symbol, double percent);
 };
 
 /**
@@ -139,7 +255,8 @@ public:
 private:
     int fast_window_;
     int slow_window_;
-    std::unordered_map<std::string, bool> positions_;
+    std::unique_ptr<analysis::IncrementalSMA> fast_sma_;   // initialize 时按标的数创建
+    std::unique_ptr<analysis::IncrementalSMA> slow_sma_;
 };
 
 /**
@@ -158,7 +275,6 @@ public:
 private:
     int lookback_window_;
     double threshold_;
-    std::unordered_map<std::string, std::vector<double>> price_history_;
 };
 
 /**
@@ -177,7 +293,7 @@ public:
 private:
     int window_;
     double z_score_threshold_;
-    std::unordered_map<std::string, std::vector<double>> price_buffer_;
+    std::unique_ptr<analysis::IncrementalZScore> z_score_;
 };
 
 /**
@@ -194,20 +310,59 @@ public:
     void add_strategy(std::shared_ptr<Strategy> strategy);
 
     /**
-     * @brief 设置股票池
+     * @brief 移除全部策略 (同一引擎依次回测不同策略时使用)
+     */
+    void clear_strategies();
+
+    /**
+     * @brief 设置股票池 (需在加载数据之前调用；为空时使用数据中的全部标的)
      */
     void set_universe(const std::vector<std::string>& symbols);
 
     /**
      * @brief 加载数据
+     *
+     * data_source 为 CSV 文件路径，表头需包含 date (或 datetime)、code (或 symbol)、
+     * open、high、low、close，volume 可选。为空时从数据库加载。
      */
     bool load_data(const std::string& data_source = "");
 
+    /**
+     * @brief 从内存记录加载数据 (按配置的日期区间和股票池过滤)
+     */
+    bool load_bars(const std::vector<BarRecord>& records);
+
+    /**
+     * @brief 使用已构建的行情面板 (只读共享，多个引擎可同时引用同一份数据)
+     *
+     * @throws std::invalid_argument data 为空
+     */
+    void set_market_data(std::shared_ptr<const BarPanel> data);
+
+    /**
+     * @brief 预加载的行情面板
+     */
+    const BarPanel& market_data() const { return *market_data_; }
+    std::shared_ptr<const BarPanel> shared_market_data() const { return market_data_; }
+
     /**
      * @brief 运行回测
      */
     BacktestResults run();
 
+    /**
+     * @brief 运行回测，结果留在引擎内不复制
+     *
+     * 资产曲线、收益率等缓冲区沿用上次运行的容量，同一引擎重复运行不再按 bar 数分配内存。
+     * 返回的引用在下次运行前有效。
+     */
+    const BacktestResults& run_in_place();
+
+    /**
+     * @brief 最近一次回测的结果
+     */
+    const BacktestResults& get_results() const { return results_; }
+
     /**
      * @brief 保存结果
      */
@@ -229,39 +384,47 @@ public:
     std::map<std::string, std::vector<double>> get_trade_analysis() const;
 
 private:
+    friend struct StrategyContext;
+
     BacktestConfig config_;
     BacktestResults results_;
 
     // 核心组件
-    std::shared_ptr<account::QA_Account> account_;
-    // std::unique_ptr<market::MatchingEngine> matching_engine_; // 暂时注释掉，避免不完整类型问题
     std::vector<std::shared_ptr<Strategy>> strategies_;
 
     // 数据管理
     std::vector<std::string> universe_;
-    // std::unordered_map<std::string, std::shared_ptr<arrow_data::ArrowKlineCollection>> market_data_; // 暂时注释掉
-    std::vector<std::string> date_index_;
+    std::shared_ptr<const BarPanel> market_data_;
 
     // 运行状态
     std::atomic<bool> is_running_{false};
     size_t current_index_ = 0;
     std::string current_date_;
 
+    // 资金 / 持仓簿 (按标的下标)
+    double cash_ = 0.0;
+    std::vector<double> holdings_;
+    std::vector<double> cost_basis_;          // 持仓总成本 (含手续费)
+    int total_fills_ = 0;
+
     // 性能记录
-    std::vector<double> daily_equity_;
-    std::vector<std::pair<std::string, double>> trade_records_;
+    std::vector<double> daily_equity_;        // 按 bar 预分配
+    std::vector<size_t> trade_bars_;          // 平仓 bar
+    std::vector<double> trade_pnl_;           // 对应的已实现盈亏
 
     // 内部方法
-    void initialize_account();
-    void initialize_matching_engine();
+    void reset_book();
     bool load_data_from_file(const std::string& filename);
     bool load_data_from_database();
-    void run_single_day(const std::string& date);
-    void update_market_data(const std::string& date);
+    void run_single_day(StrategyContext& context, size_t bar);
+    void update_market_data(StrategyContext& context, size_t bar);
     void execute_strategies(StrategyContext& context);
     void record_daily_performance();
     void calculate_performance_metrics();
 
+    bool execute_order(size_t symbol, double volume, bool is_buy);
+    double portfolio_value(size_t bar) const;
+
     // 性能计算
     double calculate_sharpe_ratio() const;
     double calculate_max_drawdown() const;
@@ -271,7 +434,7 @@ private:
     double calculate_profit_factor() const;
 
     // SIMD优化计算
-    std::vector<double> calculate_returns_simd(const std::vector<double>& prices) const;
+    void calculate_returns_simd(const std::vector<double>& prices, std::vector<double>& returns) const;
     double calculate_volatility_simd(const std::vector<double>& returns) const;
 };
 
@@ -284,6 +447,7 @@ namespace utils {
     double calculate_annual_return(const std::vector<double>& equity_curve, int trading_days = 252);
     double calculate_volatility(const std::vector<double>& returns, bool annualized = true);
     double calculate_win_rate(const std::vector<double>& trade_returns);
+    /// 盈利总额 / 亏损总额；无亏损交易时返回 +inf，无盈利交易时返回 0
     double calculate_profit_factor(const std::vector<double>& trade_returns);
     std::vector<double> calculate_rolling_sharpe(const std::vector<double>& returns, int window);
     double calculate_beta(const std::vector<double>& strategy_returns, const std::vector<double>& benchmark_returns);
@@ -0,0 +1,137 @@
+#pragma once
+
+/**
+ * @file parameter_sweep.hpp
+ * @brief 策略参数扫描 (网格 / 随机搜索)
+ *
+ * 行情面板只加载一次，以只读 shared_ptr<const BarPanel> 在所有回测之间共享；
+ * 每个工作线程只创建一个 BacktestEngine，逐个参数点调用 run_in_place() 复用；
+ * 资金 / 持仓簿与净值、成交缓冲区在参数点之间沿用 (每次运行前重置内容，保留容量)，
+ * 因此每个线程的额外内存与策略状态同阶，而不随参数点数或行情数据量增长。
+ * 结果按列写入预分配的 SweepResultTable，各线程写不相交的行，无需加锁。
+ */
+
+#include "qaultra/engine/backtest_engine.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace qaultra::engine {
+
+/**
+ * @brief 随机搜索的参数区间
+ */
+struct ParameterRange {
+    std::string name;
+    double min = 0.0;
+    double max = 0.0;
+    bool integer = false;                      // 为 true 时在 [min, max] 内均匀抽取整数
+};
+
+/**
+ * @brief 参数点集合
+ *
+ * 按行主序存放: 第 i 组参数位于 values[i * names.size(), (i + 1) * names.size())。
+ */
+struct ParameterGrid {
+    std::vector<std::string> names;
+    std::vector<double> values;
+
+    size_t size() const { return names.empty() ? 0 : values.size() / names.size(); }
+    const double* point(size_t index) const { return values.data() + index * names.size(); }
+
+    /**
+     * @brief 各轴取值的笛卡尔积 (最后一个轴变化最快)
+     */
+    static ParameterGrid cartesian(const std::vector<std::pair<std::string, std::vector<double>>>& axes);
+
+    /**
+     * @brief 在各区间内独立均匀抽样 samples 组参数 (同一 seed 结果可复现)
+     *
+     * @throws std::invalid_argument 区间 min > max
+     */
+    static ParameterGrid random(const std::vector<ParameterRange>& ranges, size_t samples, uint64_t seed = 42);
+};
+
+/**
+ * @brief 列式扫描结果，第 i 行对应 ParameterGrid 的第 i 组参数
+ */
+struct SweepResultTable {
+    std::vector<std::string> parameter_names;
+    std::vector<std::vector<double>> parameters;   // 每个参数一列
+
+    std::vector<double> total_return;
+    std::vector<double> annual_return;
+    std::vector<double> sharpe_ratio;
+    std::vector<double> max_drawdown;
+    std::vector<double> volatility;
+    std::vector<double> win_rate;
+    std::vector<double> profit_factor;
+    std::vector<double> final_value;
+    std::vector<int> total_trades;
+    std::vector<uint8_t> completed;                // 策略初始化或运行抛出异常时为 0
+    std::vector<std::string> errors;               // 失败原因；completed 为 1 时仅记录 on_result 回调的异常
+
+    size_t size() const { return total_return.size(); }
+    void resize(size_t rows);
+
+    /**
+     * @brief 写入第 row 行的指标
+     */
+    void set_row(size_t row, const BacktestResults& results);
+
+    /**
+     * @brief 已完成的行中 column 最大者的行号，没有已完成的行时返回 size()
+     */
+    size_t best(const std::vector<double>& column) const;
+};
+
+/**
+ * @brief 扫描选项
+ */
+struct SweepOptions {
+    size_t threads = 0;                        // 0 表示使用 BacktestConfig::max_threads
+
+    /**
+     * @brief 每个参数点完成后的回调 (串行调用，可用于流式落盘或进度显示)
+     *
+     * results 引用工作线程复用的缓冲区，只在回调期间有效。回调抛出异常时该行仍为已完成，
+     * 异常信息写入 errors。
+     */
+    std::function<void(size_t row, const BacktestResults& results)> on_result;
+};
+
+/**
+ * @brief 参数扫描执行器
+ */
+class ParameterSweep {
+public:
+    using StrategyFactory = std::function<std::shared_ptr<Strategy>()>;
+
+    /**
+     * @throws std::invalid_argument data 为空
+     */
+    ParameterSweep(const BacktestConfig& config, std::shared_ptr<const BarPanel> data);
+
+    /**
+     * @brief 对每组参数: factory() 新建策略、逐个 set_parameter，再在共享行情上回测
+     *
+     * 工作线程各自持有一段参数下标区间，做完后从其他线程剩余区间的后半段窃取任务，
+     * 适合不同参数耗时差异较大的情形。factory 会在多个工作线程上并发调用。
+     */
+    SweepResultTable run(const StrategyFactory& factory, const ParameterGrid& grid,
+                         const SweepOptions& options = {}) const;
+
+    const BacktestConfig& config() const { return config_; }
+    const std::shared_ptr<const BarPanel>& market_data() const { return data_; }
+
+private:
+    BacktestConfig config_;
+    std::shared_ptr<const BarPanel> data_;
+};
+
+} // namespace qaultra::engine
@@ -0,0 +1,97 @@
+#pragma once
+
+/**
+ * @file vectorized_backtest.hpp
+ * @brief 向量化目标权重回测 (与事件驱动的 BacktestEngine 并列)
+ *
+ * 输入为 日期 × 标的 的目标权重矩阵 (时间主序，与 BarPanel::close_rows 同布局)，
+ * 按行一次遍历: 每根 bar 用收盘价估值、换算目标持仓、结算成交额与费用、更新净值，
+ * 全部在长度为标的数的数组上完成，不创建订单对象。
+ *
+ * 成交口径与 BacktestEngine 的 order_target_value 一致: 当根收盘价成交，
+ * 目标数量 = floor(max(权重 × 调仓前净值, 0) / (价格 × 合约乘数) / lot_size) × lot_size。
+ * 每根 bar 先卖后买 (买入按标的下标顺序)，买入成交额加费用超过当前现金时整笔拒绝、保持原持仓，
+ * 与 BacktestEngine::execute_order 的资金检查相同，现金不会为负。权重和为 1 且有手续费时，
+ * 靠后的买单可能因费用不足被拒；按同样顺序下单的事件驱动策略结果一致。
+ */
+
+#include "qaultra/engine/backtest_engine.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace qaultra::account {
+    class MarketPreset;
+}
+
+namespace qaultra::engine {
+
+/**
+ * @brief 各标的的成交费用参数 (按标的下标的 SoA)
+ */
+struct InstrumentCosts {
+    std::vector<double> multiplier;             // 合约乘数
+    std::vector<double> commission_rate;        // 按成交额的手续费率
+    std::vector<double> commission_per_volume;  // 按数量的手续费
+    std::vector<double> sell_tax_rate;          // 卖出时按成交额的税率 (印花税)
+
+    size_t size() const { return multiplier.size(); }
+
+    /**
+     * @brief 全部标的使用同一手续费率 (与 BacktestEngine 的 commission_rate 口径相同)
+     */
+    static InstrumentCosts uniform(size_t symbols, double commission_rate);
+
+    /**
+     * @brief 按 MarketPreset 解析每个标的的乘数、手续费与印花税
+     */
+    static InstrumentCosts from_preset(account::MarketPreset& preset, const std::vector<std::string>& symbols);
+};
+
+/**
+ * @brief 向量化回测结果 (汇总指标口径与 BacktestEngine 相同)
+ */
+struct VectorizedResults : BacktestResults {
+    std::vector<double> cash;                   // 每根 bar 收盘后的现金
+    std::vector<double> turnover;               // 每根 bar 的成交额
+    std::vector<double> costs;                  // 每根 bar 的手续费与税
+    std::vector<double> holdings;               // 持仓数量 [t * symbols + s] (record_holdings 为 true 时)
+};
+
+/**
+ * @brief 目标权重回测器
+ */
+class VectorizedBacktest {
+public:
+    /**
+     * @throws std::invalid_argument data 为空、initial_cash 或 lot_size 非正
+     */
+    VectorizedBacktest(const BacktestConfig& config, std::shared_ptr<const BarPanel> data);
+
+    /**
+     * @throws std::invalid_argument 标的数与行情面板不一致
+     */
+    void set_costs(InstrumentCosts costs);
+    void set_market_preset(account::MarketPreset& preset);
+
+    /**
+     * @brief 按目标权重回测
+     *
+     * @param target_weights bars × symbols，时间主序；NaN 表示该标的本根不调仓，
+     *                       未上市或价格非正的标的同样保持原持仓
+     * @throws std::invalid_argument 权重矩阵大小与行情面板不一致
+     */
+    VectorizedResults run(const std::vector<double>& target_weights, bool record_holdings = false) const;
+
+    const BacktestConfig& config() const { return config_; }
+    const InstrumentCosts& costs() const { return costs_; }
+    const BarPanel& market_data() const { return *data_; }
+
+private:
+    BacktestConfig config_;
+    std::shared_ptr<const BarPanel> data_;
+    InstrumentCosts costs_;
+};
+
+} // namespace qaultra::engine
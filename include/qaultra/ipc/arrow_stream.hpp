@@ -0,0 +1,254 @@
+#pragma once
+
+/**
+ * @file arrow_stream.hpp
+ * @brief 基于共享内存环的 Arrow IPC 流 (截面数据，schema 只发送一次，证券代码字典增量发送)
+ *
+ * 环上的消息依次构成一条标准 Arrow IPC 流 (封装格式: 0xFFFFFFFF + 元数据长度 + 元数据 + 消息体):
+ *   [Schema] [Dictionary (全量)] [RecordBatch] ... [Dictionary (增量)] [RecordBatch] ...
+ * 每条 IPC 消息占一条逻辑消息 (data_type = ArrowIpc，用户标志位区分消息种类)，
+ * 超过单块容量时按 block_flags 分片。消息体由 WriteIpcPayload 直接写入借出的槽位，
+ * 不经过中间缓冲区。未分片的消息在共享内存中连续且按 8 字节对齐，
+ * Python/Rust 订阅者映射同一段共享内存后可直接以 pyarrow.ipc.read_message 零拷贝读取。
+ *
+ * 证券代码列的类型为 dictionary<int32, utf8>，索引即 InstrumentRegistry 分配的 InstrumentId，
+ * 字典即注册表中的代码 (只增不改)，因此每个批次之前只需发送新注册代码的增量字典。
+ *
+ * 迟到的订阅者无法从环中取得已发送过的 schema 与字典，发布端另外维护一个目录段
+ * ("<ring shm 名>_arrow")，以 seqlock 保存 schema 消息与当前全量字典消息:
+ *   [ArrowCatalogHeader (64B)] [Schema 消息] [Dictionary 消息 (全量)]
+ * 发布端总是先更新目录再发布增量字典；字典消息的 record_count 为应用后的字典长度，
+ * 订阅者据此跳过目录中已包含的增量。
+ *
+ * 使用示例:
+ * ```cpp
+ * auto schema = arrow::schema({arrow::field("instrument", ArrowStreamPublisher::instrument_type()),
+ *                              arrow::field("close", arrow::float64())});
+ * ArrowStreamPublisher pub(config, "bars", schema);
+ * auto batch = arrow::RecordBatch::Make(schema, n, {pub.instrument_column(ids), close});
+ * pub.publish(*batch);
+ *
+ * ArrowStreamSubscriber sub(config, "bars");
+ * sub.read([](const std::shared_ptr<arrow::RecordBatch>& batch) { ... });
+ * ```
+ */
+
+#include "shm_ring.hpp"
+#include "../data/instrument_registry.hpp"
+
+#include <arrow/api.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace arrow::ipc {
+class StreamDecoder;
+}
+
+namespace qaultra::ipc {
+
+/**
+ * @brief Arrow 流消息种类 (MarketBlockHeader::flags 的用户标志位)
+ */
+namespace arrow_message_flags {
+constexpr uint8_t SCHEMA = 0x01;
+constexpr uint8_t DICTIONARY = 0x02;
+constexpr uint8_t RECORD_BATCH = 0x04;
+constexpr uint8_t MASK = SCHEMA | DICTIONARY | RECORD_BATCH;
+} // namespace arrow_message_flags
+
+/**
+ * @brief 目录段头
+ */
+struct alignas(64) ArrowCatalogHeader {
+    static constexpr uint64_t MAGIC = 0x434F52524141515AULL;   // "ZQAARROC"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> closed;
+    uint64_t capacity;                          // 消息区字节数
+    std::atomic<uint64_t> sequence;             // seqlock: 奇数表示更新中
+    uint64_t schema_size;                       // Schema 消息字节数
+    uint64_t dictionary_size;                   // 全量字典消息字节数
+    uint64_t dictionary_length;                 // 字典中的代码数
+};
+
+static_assert(sizeof(ArrowCatalogHeader) == 64, "ArrowCatalogHeader must occupy one cache line");
+
+/**
+ * @brief Arrow 流目录段的 shm 对象名
+ */
+std::string arrow_catalog_name(const BroadcastConfig& config, const std::string& stream_name);
+
+/**
+ * @brief Arrow IPC 流发布器 (单生产者，LargeMarketBlock 共享内存环)
+ *
+ * schema 必须恰好包含一个 instrument_type() 类型的顶层字段 (证券代码列)，
+ * 不支持其他字典列。构造时创建环与目录段，并发布 schema 与初始全量字典。
+ */
+class ArrowStreamPublisher {
+public:
+    static constexpr size_t DEFAULT_CATALOG_CAPACITY = 4 * 1024 * 1024;
+
+    /**
+     * @throws std::invalid_argument schema 不满足要求
+     * @throws std::runtime_error 创建共享内存失败
+     */
+    ArrowStreamPublisher(const BroadcastConfig& config,
+                         const std::string& stream_name,
+                         std::shared_ptr<arrow::Schema> schema,
+                         size_t catalog_capacity = DEFAULT_CATALOG_CAPACITY);
+    ~ArrowStreamPublisher();
+
+    ArrowStreamPublisher(const ArrowStreamPublisher&) = delete;
+    ArrowStreamPublisher& operator=(const ArrowStreamPublisher&) = delete;
+
+    /**
+     * @brief 证券代码列类型: dictionary<int32, utf8>
+     */
+    static std::shared_ptr<arrow::DataType> instrument_type();
+
+    /**
+     * @brief 由 InstrumentId 构造证券代码列 (字典为注册表中的全部代码)
+     */
+    std::shared_ptr<arrow::Array> instrument_column(const std::vector<data::InstrumentId>& ids);
+
+    /**
+     * @brief 发布一个批次 (必要时先发送增量字典)
+     * @return false 表示 schema 不匹配、序列化失败或目录容量不足
+     */
+    bool publish(const arrow::RecordBatch& batch);
+
+    const std::shared_ptr<arrow::Schema>& schema() const { return schema_; }
+    int instrument_field() const { return instrument_field_; }
+
+    /**
+     * @brief 已发送的字典长度 (代码数)
+     */
+    size_t dictionary_length() const { return sent_length_; }
+
+    struct PublishStats {
+        uint64_t batches_sent = 0;
+        uint64_t rows_sent = 0;
+        uint64_t dictionary_deltas = 0;     // 增量字典消息数
+        uint64_t message_bytes = 0;         // IPC 消息字节数 (不含数据块头)
+        uint64_t errors = 0;
+    };
+
+    PublishStats get_publish_stats() const { return stats_; }
+    const shm::LargeShmRingBroadcaster& ring() const { return ring_; }
+
+private:
+    class MessageStream;
+    class Catalog;
+
+    bool send_dictionary(bool is_delta, size_t from, size_t to);
+    bool write_catalog(size_t length);
+    std::shared_ptr<arrow::Array> dictionary_array(size_t from, size_t to) const;
+
+    shm::LargeShmRingBroadcaster ring_;
+    std::shared_ptr<arrow::Schema> schema_;
+    int instrument_field_ = -1;
+    int64_t dictionary_id_ = 0;
+    size_t sent_length_ = 0;
+    std::unique_ptr<Catalog> catalog_;
+    std::unique_ptr<MessageStream> stream_;
+    std::shared_ptr<arrow::Buffer> schema_message_;
+    std::shared_ptr<arrow::Array> dictionary_;      // 缓存的全量字典 (instrument_column 使用)
+    PublishStats stats_;
+};
+
+/**
+ * @brief Arrow IPC 流订阅器
+ *
+ * 连接时从目录段取得 schema 与全量字典，之后只处理环上的增量字典与批次。
+ * 环被覆盖且期间目录发生变化时重新读取目录 (计入 resyncs)。
+ */
+class ArrowStreamSubscriber {
+public:
+    using StartPosition = shm::LargeShmRingSubscriber::StartPosition;
+
+    /**
+     * @throws std::runtime_error 环或目录段不存在、布局不兼容
+     */
+    ArrowStreamSubscriber(const BroadcastConfig& config,
+                          const std::string& stream_name,
+                          StartPosition start = StartPosition::Latest);
+    ~ArrowStreamSubscriber();
+
+    ArrowStreamSubscriber(const ArrowStreamSubscriber&) = delete;
+    ArrowStreamSubscriber& operator=(const ArrowStreamSubscriber&) = delete;
+
+    /**
+     * @brief 读取下一个批次，回调参数为 const std::shared_ptr<arrow::RecordBatch>&
+     *
+     * 未分片批次的列缓冲区直接指向共享内存，只在回调内有效 (需要保留时自行拷贝)；
+     * 返回 false 表示暂无批次，或批次在读取期间被覆盖 (回调结果应丢弃)。
+     */
+    template <typename Fn>
+    bool read(Fn&& fn);
+
+    const std::shared_ptr<arrow::Schema>& schema() const { return schema_; }
+    size_t dictionary_length() const { return dictionary_length_; }
+
+    struct ReadStats {
+        uint64_t batches_received = 0;
+        uint64_t rows_received = 0;
+        uint64_t dictionary_deltas = 0;     // 应用的增量字典
+        uint64_t skipped_messages = 0;      // 目录中已包含的 schema/字典消息
+        uint64_t resyncs = 0;               // 重新读取目录的次数
+        uint64_t decode_errors = 0;
+    };
+
+    ReadStats get_read_stats() const { return stats_; }
+    const shm::LargeShmRingSubscriber& ring() const { return ring_; }
+
+private:
+    class Listener;
+
+    void bootstrap();
+    std::shared_ptr<arrow::RecordBatch> decode(const MessageView& message);
+    void after_read(uint64_t overruns_before);
+
+    std::string catalog_name_;
+    const ArrowCatalogHeader* catalog_ = nullptr;
+    size_t catalog_mapped_size_ = 0;
+    shm::LargeShmRingSubscriber ring_;
+    std::shared_ptr<Listener> listener_;
+    std::unique_ptr<arrow::ipc::StreamDecoder> decoder_;
+    std::shared_ptr<arrow::Schema> schema_;
+    size_t dictionary_length_ = 0;
+    uint64_t catalog_sequence_ = 0;
+    ReadStats stats_;
+};
+
+template <typename Fn>
+bool ArrowStreamSubscriber::read(Fn&& fn) {
+    while (true) {
+        const uint64_t overruns_before = ring_.get_receive_stats().overruns;
+        bool delivered = false;
+        int64_t rows = 0;
+        const bool ok = ring_.read_message([&](const MessageView& message) {
+            if (auto batch = decode(message)) {
+                rows = batch->num_rows();
+                fn(static_cast<const std::shared_ptr<arrow::RecordBatch>&>(batch));
+                delivered = true;
+            }
+        });
+        after_read(overruns_before);
+        if (!ok) {
+            return false;
+        }
+        if (delivered) {
+            stats_.batches_received++;
+            stats_.rows_received += static_cast<uint64_t>(rows);
+            return true;
+        }
+    }
+}
+
+} // namespace qaultra::ipc
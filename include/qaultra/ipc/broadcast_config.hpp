@@ -1,11 +1,22 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <optional>
 
 namespace qaultra::ipc {
 
+/**
+ * @brief 广播传输后端
+ */
+enum class BroadcastTransport : uint8_t {
+    Auto,               // 按编译可用性选择: iceoryx2 > iceoryx > 共享内存环
+    IceOryx,            // iceoryx v1 (需要 RouDi)
+    IceOryx2,           // iceoryx2
+    SharedMemoryRing    // 内置 POSIX 共享内存环 (无外部依赖)
+};
+
 /**
  * @brief 数据广播配置
  *
@@ -28,14 +39,31 @@ struct BroadcastConfig {
     size_t heartbeat_interval_ms = 1000;    // 心跳间隔 (毫秒)
     bool stats_enabled = true;              // 启用统计监控
 
-    // NUMA 和 CPU 亲和性
-    bool numa_aware = false;                // NUMA 感知内存分配
-    std::optional<int> cpu_affinity;        // CPU 亲和性绑定
+    // NUMA 和 CPU 亲和性 (numa_placement.hpp)
+    bool numa_aware = false;                // 共享内存段绑定到发布线程所在 NUMA 节点并预先缺页
+    std::optional<int> cpu_affinity;        // 构造广播器/订阅器的线程绑定到该 CPU
+    bool lock_memory = false;               // mlock 共享内存段 (每段上限 memory_pool_size_mb)
+
+    // 延迟测量 (latency_tracker.hpp): 订阅端按 CLOCK_MONOTONIC 记录发布到接收的单向延迟与序号缺口
+    bool latency_tracking = false;
 
     // IceOryx 特定配置
     std::string service_name = "QAULTRA";   // IceOryx 服务名称
     std::string instance_name = "Broadcast";// IceOryx 实例名称
-    size_t queue_capacity = 1000;           // 队列容量
+    size_t queue_capacity = 1000;           // 队列容量 (共享内存环的槽位数，向上取2的幂)
+
+    // 传输后端
+    BroadcastTransport transport = BroadcastTransport::Auto;
+
+    // 合并模式 (共享内存环): 按证券维护最新值缓存，落后的订阅者直接读取最新状态
+    bool conflation_enabled = false;
+    size_t conflation_capacity = 8192;      // 证券ID上限
+    size_t conflation_value_size = 256;     // 单个证券最新值的最大字节数
+
+    // 持久化日志 (market_journal.hpp): 非空时发布端将每个数据块追加到该目录下按段滚动的 mmap 文件，
+    // 序列号从已有日志末尾续接。日志写入端为单线程，要求每个流只有一个发布线程
+    std::string journal_dir;
+    size_t journal_segment_mb = 256;        // 单个段文件大小 (MB)
 
     /**
      * @brief 默认构造函数 - 优化配置
@@ -97,10 +125,47 @@ struct BroadcastConfig {
         if (memory_pool_size_mb == 0 || memory_pool_size_mb > 65536) {
             return false;
         }
+        if (conflation_enabled &&
+            (conflation_capacity == 0 || conflation_value_size == 0 || conflation_value_size > 65535)) {
+            return false;
+        }
+        if (!journal_dir.empty() && (journal_segment_mb == 0 || journal_segment_mb > 65536)) {
+            return false;
+        }
         return true;
     }
 };
 
+/**
+ * @brief 线程与共享内存的放置情况 (-1 表示未知或未绑定)
+ */
+struct MemoryPlacement {
+    int cpu = -1;                       // 构造时所在 CPU
+    int numa_node = -1;                 // 该 CPU 所在 NUMA 节点
+    bool thread_pinned = false;         // 已按 cpu_affinity 绑定
+    int memory_node = -1;               // 共享内存段绑定的 NUMA 节点
+    size_t prefaulted_bytes = 0;        // 启动时预先缺页的字节数
+    size_t locked_bytes = 0;            // mlock 锁定的字节数
+};
+
+/**
+ * @brief 单向延迟与序号缺口摘要 (纳秒，由订阅端的 LatencyTracker 生成)
+ */
+struct LatencySummary {
+    uint64_t samples = 0;               // 记录的延迟样本数
+    uint64_t min_ns = 0;
+    uint64_t max_ns = 0;
+    double mean_ns = 0.0;
+    uint64_t p50_ns = 0;
+    uint64_t p90_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    uint64_t negative_samples = 0;      // 接收时间早于发布时间 (时钟不一致)
+    uint64_t sequence_gaps = 0;         // 序号跳跃次数
+    uint64_t missing_sequences = 0;     // 跳过的序号总数
+    uint64_t out_of_order = 0;          // 序号回退 (重复或发布端重启)
+};
+
 /**
  * @brief 广播统计信息
  */
@@ -123,6 +188,8 @@ struct BroadcastStats {
     // 资源统计
     size_t memory_usage_bytes = 0;      // 内存使用量
     double cpu_usage_percent = 0.0;     // CPU 使用率
+    MemoryPlacement placement;          // 发布线程与共享内存的放置
+    LatencySummary latency;             // 本进程订阅该流测得的延迟 (BroadcastManager::get_all_stats)
 
     // 时间统计
     uint64_t start_time_ns = 0;         // 开始时间
@@ -2,6 +2,9 @@
 
 #include "market_data_block.hpp"
 #include "broadcast_config.hpp"
+#include "subscription_filter.hpp"
+#include "latency_tracker.hpp"
+#include "market_journal.hpp"
 
 #include "iceoryx_posh/popo/publisher.hpp"
 #include "iceoryx_posh/popo/subscriber.hpp"
@@ -83,7 +86,8 @@ public:
     bool broadcast(const uint8_t* data,
                    size_t data_size,
                    size_t record_count,
-                   MarketDataType type);
+                   MarketDataType type,
+                   uint32_t instrument_id = MarketBlockHeader::NO_INSTRUMENT);
 
     /**
      * @brief 批量广播数据
@@ -138,6 +142,10 @@ private:
     BroadcastStats stats_;
     std::atomic<uint64_t> sequence_number_{0};
 
+    // 持久化日志 (journal_dir): 编号与追加在同一临界区内，保证日志序号单调
+    std::unique_ptr<MarketJournalWriter> journal_;
+    std::mutex journal_mutex_;
+
     // 计时器
     std::chrono::steady_clock::time_point start_time_;
 
@@ -211,11 +219,22 @@ public:
      */
     std::optional<const ZeroCopyMarketBlock*> receive_block();
 
+    /**
+     * @brief 设置订阅过滤器 (receive/receive_nowait 按元数据跳过不匹配的数据块，不拷贝其负载)
+     */
+    void set_filter(const SubscriptionFilter& filter) { filter_ = filter; }
+    const SubscriptionFilter& get_filter() const { return filter_; }
+
     /**
      * @brief 获取配置
      */
     const BroadcastConfig& get_config() const { return config_; }
 
+    /**
+     * @brief 订阅线程的放置情况 (cpu_affinity)
+     */
+    const MemoryPlacement& get_placement() const { return placement_; }
+
     /**
      * @brief 获取流名称
      */
@@ -234,19 +253,28 @@ public:
         uint64_t records_received = 0;
         uint64_t bytes_received = 0;
         uint64_t missed_samples = 0;
+        uint64_t blocks_filtered = 0;
     };
 
     ReceiveStats get_receive_stats() const;
 
     /**
-     * @brief 重置接收统计
+     * @brief 重置接收统计 (含延迟直方图)
      */
     void reset_receive_stats();
 
+    /**
+     * @brief 单向延迟与序号缺口 (需启用 BroadcastConfig::latency_tracking)
+     */
+    LatencySummary get_latency() const;
+
 private:
     BroadcastConfig config_;
     std::string stream_name_;
     std::unique_ptr<Subscriber> subscriber_;
+    SubscriptionFilter filter_;
+    MemoryPlacement placement_;
+    std::unique_ptr<LatencyTracker> latency_;
 
     // 接收统计
     mutable std::mutex stats_mutex_;
@@ -284,6 +312,8 @@ public:
 
     /**
      * @brief 获取所有广播器统计
+     *
+     * latency 字段为本进程同名订阅器测得的单向延迟 (需启用 latency_tracking)。
      */
     std::unordered_map<std::string, BroadcastStats> get_all_stats() const;
 
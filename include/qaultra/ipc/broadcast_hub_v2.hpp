@@ -2,6 +2,9 @@
 
 #include "market_data_block.hpp"
 #include "broadcast_config.hpp"
+#include "subscription_filter.hpp"
+#include "latency_tracker.hpp"
+#include "market_journal.hpp"
 
 #include "iox2/iceoryx2.hpp"
 
@@ -32,6 +35,63 @@ enum class BroadcastError {
     Unknown
 };
 
+class DataBroadcaster;
+
+/**
+ * @brief 借出的发布槽 (iceoryx2 未初始化样本)
+ *
+ * 由 DataBroadcaster::loan() 返回，生产者通过 BlockWriter 接口直接向共享内存
+ * 序列化记录，再交给 DataBroadcaster::publish() 发送；未发布即析构时样本归还。
+ */
+class LoanedBlock {
+public:
+    static constexpr auto SERVICE_TYPE = iox2::ServiceType::Ipc;
+    using Sample = iox2::SampleMutUninit<SERVICE_TYPE, ZeroCopyMarketBlock, void>;
+
+    LoanedBlock() = default;
+    LoanedBlock(LoanedBlock&&) noexcept = default;
+    LoanedBlock& operator=(LoanedBlock&&) noexcept = default;
+    LoanedBlock(const LoanedBlock&) = delete;
+    LoanedBlock& operator=(const LoanedBlock&) = delete;
+
+    bool valid() const { return sample_.has_value(); }
+    explicit operator bool() const { return valid(); }
+
+    bool append(const void* src, size_t size, size_t records = 1) { return writer_.append(src, size, records); }
+
+    template <typename T>
+    T* emplace() { return writer_.emplace<T>(); }
+
+    bool commit(size_t size, size_t records) { return writer_.commit(size, records); }
+
+    uint8_t* data() { return writer_.data(); }
+    uint8_t* cursor() { return writer_.cursor(); }
+    size_t size() const { return writer_.size(); }
+    size_t records() const { return writer_.records(); }
+    size_t remaining() const { return writer_.remaining(); }
+    MarketDataType type() const { return type_; }
+
+    /**
+     * @brief 设置发布时写入的标志位 (分片标志见 block_flags)
+     */
+    void set_flags(uint8_t flags) { flags_ = flags; }
+
+    /**
+     * @brief 标注数据块所属证券 (只含单一证券时)，订阅端据此过滤
+     */
+    void set_instrument(uint32_t instrument_id) { writer_.set_instrument(instrument_id); }
+    uint8_t flags() const { return flags_; }
+
+private:
+    friend class DataBroadcaster;
+
+    std::optional<Sample> sample_;
+    BlockWriter writer_;
+    MarketDataType type_ = MarketDataType::Unknown;
+    uint8_t flags_ = 0;
+    std::chrono::steady_clock::time_point loaned_at_;
+};
+
 /**
  * @brief 数据广播器 (Publisher - iceoryx2)
  *
@@ -77,7 +137,35 @@ public:
     bool broadcast(const uint8_t* data,
                    size_t data_size,
                    size_t record_count,
-                   MarketDataType type);
+                   MarketDataType type,
+                   uint32_t instrument_id = MarketBlockHeader::NO_INSTRUMENT);
+
+    /**
+     * @brief 借出一个发布槽，生产者直接在共享内存中填写负载
+     * @return 借用失败时返回无效的 LoanedBlock
+     *
+     * 样本不做零初始化；只有写入的字节和32字节元数据会被触及。
+     */
+    LoanedBlock loan(MarketDataType type);
+
+    /**
+     * @brief 发布借出的发布槽 (填写元数据后发送)
+     * @return 是否成功
+     */
+    bool publish(LoanedBlock&& block);
+
+    /**
+     * @brief 广播一条逻辑消息，超过单块容量时按 block_flags 分片
+     * @return 是否全部分片发送成功
+     *
+     * 分片依赖序列号连续，同一广播器上的分片消息应由单个线程发送；
+     * 订阅端使用 FragmentAssembler 重组。
+     */
+    bool broadcast_message(const uint8_t* data,
+                           size_t data_size,
+                           size_t record_count,
+                           MarketDataType type,
+                           uint32_t instrument_id = MarketBlockHeader::NO_INSTRUMENT);
 
     /**
      * @brief 批量广播数据
@@ -136,21 +224,17 @@ private:
     BroadcastStats stats_;
     std::atomic<uint64_t> sequence_number_{0};
 
+    // 持久化日志 (journal_dir): 编号与追加在同一临界区内，保证日志序号单调
+    std::unique_ptr<MarketJournalWriter> journal_;
+    std::mutex journal_mutex_;
+
     // 计时器
     std::chrono::steady_clock::time_point start_time_;
 
-    /**
-     * @brief 创建数据块
-     */
-    ZeroCopyMarketBlock create_block(const uint8_t* data,
-                                      size_t data_size,
-                                      size_t record_count,
-                                      MarketDataType type);
-
     /**
      * @brief 更新统计信息
      */
-    void update_stats(const ZeroCopyMarketBlock& block, uint64_t latency_ns, bool success);
+    void update_stats(size_t record_count, size_t bytes, uint64_t latency_ns, bool success);
 };
 
 /**
@@ -205,11 +289,22 @@ public:
      */
     std::optional<const ZeroCopyMarketBlock*> receive_block();
 
+    /**
+     * @brief 设置订阅过滤器 (按元数据跳过不匹配的数据块，不拷贝其负载)
+     */
+    void set_filter(const SubscriptionFilter& filter) { filter_ = filter; }
+    const SubscriptionFilter& get_filter() const { return filter_; }
+
     /**
      * @brief 获取配置
      */
     const BroadcastConfig& get_config() const { return config_; }
 
+    /**
+     * @brief 订阅线程的放置情况 (cpu_affinity)
+     */
+    const MemoryPlacement& get_placement() const { return placement_; }
+
     /**
      * @brief 获取流名称
      */
@@ -228,15 +323,21 @@ public:
         uint64_t records_received = 0;
         uint64_t bytes_received = 0;
         uint64_t missed_samples = 0;
+        uint64_t blocks_filtered = 0;
     };
 
     ReceiveStats get_receive_stats() const;
 
     /**
-     * @brief 重置接收统计
+     * @brief 重置接收统计 (含延迟直方图)
      */
     void reset_receive_stats();
 
+    /**
+     * @brief 单向延迟与序号缺口 (需启用 BroadcastConfig::latency_tracking)
+     */
+    LatencySummary get_latency() const;
+
 private:
     BroadcastConfig config_;
     std::string stream_name_;
@@ -245,6 +346,9 @@ private:
     std::optional<Node> node_;
     std::optional<Service> service_;
     std::optional<Subscriber> subscriber_;
+    SubscriptionFilter filter_;
+    MemoryPlacement placement_;
+    std::unique_ptr<LatencyTracker> latency_;
 
     // 接收统计
     mutable std::mutex stats_mutex_;
@@ -282,6 +386,8 @@ public:
 
     /**
      * @brief 获取所有广播器统计
+     *
+     * latency 字段为本进程同名订阅器测得的单向延迟 (需启用 latency_tracking)。
      */
     std::unordered_map<std::string, BroadcastStats> get_all_stats() const;
 
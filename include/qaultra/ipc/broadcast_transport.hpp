@@ -0,0 +1,164 @@
+#pragma once
+
+/**
+ * @file broadcast_transport.hpp
+ * @brief 按 BroadcastConfig::transport 选择广播后端的统一接口
+ *
+ * 上层只依赖 Broadcaster / Subscriber 接口，后端可以是 iceoryx、iceoryx2
+ * 或内置共享内存环 (shm_ring.hpp)。iceoryx v1 后端需要调用方事先初始化 RouDi 运行时。
+ */
+
+#include "broadcast_config.hpp"
+#include "market_data_block.hpp"
+#include "subscription_filter.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace qaultra::ipc {
+
+/**
+ * @brief 广播器接口
+ */
+class Broadcaster {
+public:
+    virtual ~Broadcaster() = default;
+
+    /**
+     * @param instrument_id 数据块只含单一证券时标注其ID，供订阅端过滤
+     */
+    virtual bool broadcast(const uint8_t* data, size_t data_size, size_t record_count, MarketDataType type,
+                           uint32_t instrument_id = MarketBlockHeader::NO_INSTRUMENT) = 0;
+    virtual size_t broadcast_batch(const uint8_t* data, size_t data_size, size_t record_count, MarketDataType type) = 0;
+
+    virtual BroadcastStats get_stats() const = 0;
+    virtual void reset_stats() = 0;
+    virtual bool has_subscribers() const = 0;
+    virtual size_t get_subscriber_count() const = 0;
+
+    /**
+     * @brief 实际使用的传输后端 (Auto 已解析)
+     */
+    virtual BroadcastTransport transport() const = 0;
+};
+
+/**
+ * @brief 订阅器接口
+ */
+class Subscriber {
+public:
+    virtual ~Subscriber() = default;
+
+    virtual std::optional<std::vector<uint8_t>> receive() = 0;
+    virtual std::optional<std::vector<uint8_t>> receive_nowait() = 0;
+    virtual bool has_data() const = 0;
+
+    /**
+     * @brief 设置订阅过滤器，不匹配的数据块按元数据跳过
+     */
+    virtual void set_filter(const SubscriptionFilter& filter) = 0;
+
+    /**
+     * @brief 单向延迟与序号缺口 (需启用 BroadcastConfig::latency_tracking)
+     */
+    virtual LatencySummary get_latency() const = 0;
+
+    virtual BroadcastTransport transport() const = 0;
+};
+
+/**
+ * @brief 解析 Auto: 按编译可用性依次选择 iceoryx2、iceoryx、共享内存环
+ */
+BroadcastTransport resolve_transport(BroadcastTransport requested);
+
+/**
+ * @brief 当前构建是否包含指定后端
+ */
+bool transport_available(BroadcastTransport transport);
+
+const char* transport_name(BroadcastTransport transport);
+
+/**
+ * @brief 创建广播器，后端不可用或创建失败时返回 nullptr
+ */
+std::unique_ptr<Broadcaster> create_broadcaster(const BroadcastConfig& config,
+                                                const std::string& stream_name = "market_data");
+
+/**
+ * @brief 创建订阅器，后端不可用或创建失败时返回 nullptr
+ */
+std::unique_ptr<Subscriber> create_subscriber(const BroadcastConfig& config,
+                                              const std::string& stream_name = "market_data");
+
+/**
+ * @brief 按证券分区的广播器
+ *
+ * 将一个逻辑数据流拆成 partition_count 个物理流 ("<stream>.p<k>")，
+ * 每条消息按证券哈希发送到对应分区并标注证券ID。订阅少量证券的进程
+ * 只需连接其证券所在的分区，其余分区的数据完全不经过该进程。
+ */
+class PartitionedBroadcaster {
+public:
+    /**
+     * @throws std::runtime_error 任一分区创建失败
+     */
+    PartitionedBroadcaster(const BroadcastConfig& config,
+                           const std::string& stream_name,
+                           uint32_t partition_count);
+
+    /**
+     * @brief 发送单一证券的数据 (data_size 不超过单块容量)
+     */
+    bool broadcast(uint32_t instrument_id, const uint8_t* data, size_t data_size,
+                   size_t record_count, MarketDataType type);
+
+    uint32_t partition_of(uint32_t instrument_id) const {
+        return instrument_partition(instrument_id, partition_count_);
+    }
+
+    uint32_t get_partition_count() const { return partition_count_; }
+    Broadcaster& partition(uint32_t index) { return *partitions_.at(index); }
+
+    /**
+     * @brief 各分区统计之和
+     */
+    BroadcastStats get_stats() const;
+
+private:
+    uint32_t partition_count_;
+    std::vector<std::unique_ptr<Broadcaster>> partitions_;
+};
+
+/**
+ * @brief 按证券分区的订阅器
+ *
+ * 只连接 filter 中证券所在的分区 (未指定证券时连接全部分区)，
+ * 并在每个分区上应用同一过滤器。receive() 轮询已连接的分区。
+ */
+class PartitionedSubscriber {
+public:
+    /**
+     * @throws std::runtime_error 任一分区连接失败
+     */
+    PartitionedSubscriber(const BroadcastConfig& config,
+                          const std::string& stream_name,
+                          uint32_t partition_count,
+                          const SubscriptionFilter& filter);
+
+    std::optional<std::vector<uint8_t>> receive();
+
+    /**
+     * @brief 已连接的分区编号
+     */
+    const std::vector<uint32_t>& get_partitions() const { return partition_ids_; }
+
+private:
+    std::vector<uint32_t> partition_ids_;
+    std::vector<std::unique_ptr<Subscriber>> partitions_;
+    size_t next_ = 0;
+};
+
+} // namespace qaultra::ipc
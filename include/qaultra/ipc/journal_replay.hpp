@@ -0,0 +1,135 @@
+#pragma once
+
+/**
+ * @file journal_replay.hpp
+ * @brief 从持久化日志回放后无缝切换到共享内存环的实时订阅
+ *
+ * 发布端先写日志再发布 (shm_ring.hpp)，因此日志末尾总是不早于环的写入位置。
+ * 回放读到日志末尾时，把环订阅器的游标移到同一序号即可切换，既不重复也不遗漏。
+ * 回放期间发布的消息会继续进入日志，回放会一直追到日志末尾，与环的容量无关。
+ *
+ * 使用示例:
+ * ```cpp
+ * ReplaySubscriber sub(config, "market_data", last_processed + 1);
+ * while (running) {
+ *     sub.read([](const MarketBlockHeader& header, const uint8_t* payload) { ... });
+ * }
+ * ```
+ */
+
+#include "shm_ring.hpp"
+#include "market_journal.hpp"
+
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace qaultra::ipc::shm {
+
+/**
+ * @brief 先回放日志、再读取实时环的订阅器 (单线程使用)
+ */
+template <typename Block>
+class BasicReplaySubscriber {
+public:
+    /**
+     * @param from_sequence 回放起点 (早于日志起点时从日志第一条开始)
+     * @throws std::invalid_argument 未设置 journal_dir
+     * @throws std::runtime_error 共享内存环不存在
+     */
+    BasicReplaySubscriber(const BroadcastConfig& config, const std::string& stream_name, uint64_t from_sequence)
+        : live_(config, stream_name)
+        , journal_(journal_directory(config, stream_name))
+        , next_(from_sequence)
+    {
+        if (config.journal_dir.empty()) {
+            throw std::invalid_argument("ReplaySubscriber requires BroadcastConfig::journal_dir");
+        }
+    }
+
+    /**
+     * @brief 读取下一条消息，回调参数为 (const MarketBlockHeader&, const uint8_t* payload)
+     *
+     * 回放阶段零拷贝回调日志映射，实时阶段语义同 BasicShmRingSubscriber::read()。
+     * @return false 表示暂无消息
+     */
+    template <typename Fn>
+    bool read(Fn&& fn);
+
+    std::optional<std::vector<uint8_t>> receive() {
+        std::vector<uint8_t> payload;
+        const bool ok = read([&payload](const MarketBlockHeader& header, const uint8_t* data) {
+            payload.assign(data, data + header.payload_size);
+        });
+        if (!ok) {
+            return std::nullopt;
+        }
+        return payload;
+    }
+
+    /**
+     * @brief 是否仍在回放日志
+     */
+    bool replaying() const { return replaying_; }
+
+    /**
+     * @brief 下一条待读消息的序号
+     */
+    uint64_t position() const { return replaying_ ? next_ : live_.position(); }
+
+    uint64_t get_replayed() const { return replayed_; }
+
+    BasicShmRingSubscriber<Block>& live() { return live_; }
+    MarketJournalReader& journal() { return journal_; }
+
+private:
+    void switch_to_live();
+
+    BasicShmRingSubscriber<Block> live_;
+    MarketJournalReader journal_;
+    uint64_t next_;
+    uint64_t replayed_ = 0;
+    bool replaying_ = true;
+};
+
+template <typename Block>
+template <typename Fn>
+bool BasicReplaySubscriber<Block>::read(Fn&& fn) {
+    while (replaying_) {
+        if (journal_.read(next_, fn)) {
+            next_++;
+            replayed_++;
+            return true;
+        }
+
+        // 读到已知段的末尾: 发现新段后继续，或跨过缺口，或已追上日志末尾
+        journal_.refresh();
+        if (next_ < journal_.end_sequence()) {
+            next_ = journal_.next_available(next_);
+            continue;
+        }
+        switch_to_live();
+    }
+
+    return live_.read([&fn](const Block& block) {
+        fn(block.header(), static_cast<const uint8_t*>(block.data));
+    });
+}
+
+template <typename Block>
+void BasicReplaySubscriber<Block>::switch_to_live() {
+    if (!live_.seek(next_)) {
+        // 日志落后于环 (发布端未启用日志)，只能从当前位置接收
+        std::cerr << "Journal of " << live_.get_stream_name() << " ends at " << next_
+                  << ", behind the live ring; continuing from " << live_.position() << std::endl;
+    }
+    replaying_ = false;
+}
+
+using ReplaySubscriber = BasicReplaySubscriber<ZeroCopyMarketBlock>;
+using SmallReplaySubscriber = BasicReplaySubscriber<SmallMarketBlock>;
+using LargeReplaySubscriber = BasicReplaySubscriber<LargeMarketBlock>;
+
+} // namespace qaultra::ipc::shm
@@ -0,0 +1,196 @@
+#pragma once
+
+/**
+ * @file last_value_cache.hpp
+ * @brief 共享内存最新值缓存 (按证券合并行情，供慢订阅者追赶)
+ *
+ * 内存布局:
+ *   [CacheHeader] [读者0脏位图] ... [读者63脏位图] [槽位0] ... [槽位 capacity-1]
+ *
+ * 每个证券一个槽位，生产者用 seqlock 原位覆盖 (序号为奇数表示写入中)，
+ * 写完后在每个已注册读者的脏位图中置位。读者用 exchange(0) 取走自己的脏位，
+ * 只读取发生变化的证券的最新值，而不必回放积压的全部消息。
+ * 最多支持 MAX_READERS 个并发读者；异常退出的读者不会释放其读者位。
+ */
+
+#include "market_data_block.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace qaultra::ipc::shm {
+
+/**
+ * @brief 缓存段头
+ */
+struct alignas(64) CacheHeader {
+    static constexpr uint64_t MAGIC = 0x45554C41565A5141ULL;   // "AQZVALUE"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_size;                         // 槽位步长 (64B 槽头 + 负载区)
+    uint64_t capacity;                          // 证券ID上限 (不含)
+    uint32_t value_size;                        // 每个槽位的最大负载
+    uint32_t bitmap_words;                      // 每个读者位图的 64 位字数
+    std::atomic<uint32_t> closed;
+    alignas(64) std::atomic<uint64_t> reader_mask;  // 已注册读者
+    std::atomic<uint64_t> updates;              // 累计更新次数
+};
+
+/**
+ * @brief 槽头 (负载紧随其后)
+ */
+struct alignas(64) CacheSlotHeader {
+    std::atomic<uint64_t> sequence;             // 0 从未写入，奇数写入中
+    uint64_t timestamp_ns;
+    uint64_t record_count;
+    uint64_t source_sequence;                   // 对应广播消息的序列号
+    MarketDataType data_type;
+    uint8_t flags;
+    uint16_t payload_size;
+    uint32_t instrument_id;
+};
+
+static_assert(sizeof(CacheSlotHeader) == 64, "CacheSlotHeader must occupy one cache line");
+
+/**
+ * @brief 读取到的最新值 (data 指向读者内部缓冲区，有效期到下一次读取)
+ */
+struct LastValueView {
+    uint32_t instrument_id = MarketBlockHeader::NO_INSTRUMENT;
+    MarketDataType data_type = MarketDataType::Unknown;
+    uint8_t flags = 0;
+    uint64_t timestamp_ns = 0;
+    uint64_t record_count = 0;
+    uint64_t source_sequence = 0;
+    uint64_t version = 0;                       // 槽位序号/2，即该证券的更新次数
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * @brief 最新值缓存写入端 (单生产者)
+ *
+ * 构造时创建 (或替换) 同名共享内存段，析构时标记关闭并 unlink。
+ */
+class LastValueCacheWriter {
+public:
+    static constexpr size_t MAX_READERS = 64;
+
+    /**
+     * @param shm_name POSIX shm 对象名 (以 '/' 开头)
+     * @param capacity 证券ID上限，ID >= capacity 的更新被忽略
+     * @param value_size 单个证券最新值的最大字节数
+     * @throws std::runtime_error 创建共享内存失败
+     */
+    LastValueCacheWriter(const std::string& shm_name, size_t capacity, size_t value_size);
+    ~LastValueCacheWriter();
+
+    LastValueCacheWriter(const LastValueCacheWriter&) = delete;
+    LastValueCacheWriter& operator=(const LastValueCacheWriter&) = delete;
+
+    /**
+     * @brief 覆盖证券的最新值并通知所有读者
+     * @return false 表示证券ID越界或数据超过 value_size
+     */
+    bool update(uint32_t instrument_id, const uint8_t* data, size_t size,
+                const MarketBlockHeader& meta);
+
+    const std::string& get_shm_name() const { return shm_name_; }
+    size_t get_capacity() const { return capacity_; }
+    size_t get_value_size() const { return value_size_; }
+    uint64_t get_update_count() const;
+    size_t get_reader_count() const;
+
+private:
+    std::string shm_name_;
+    size_t capacity_;
+    size_t value_size_;
+    size_t slot_size_;
+    size_t bitmap_words_;
+    size_t mapped_size_ = 0;
+    CacheHeader* header_ = nullptr;
+    uint8_t* slots_ = nullptr;
+};
+
+/**
+ * @brief 最新值缓存读取端
+ *
+ * 构造时注册一个读者位，此后发生的更新都会记入其脏位图。
+ */
+class LastValueCacheReader {
+public:
+    static constexpr uint32_t MAX_READ_RETRIES = 1u << 14;   // 槽位持续处于写入中时的重试上限
+
+    /**
+     * @throws std::runtime_error 共享内存不存在、布局不兼容或读者数已满
+     */
+    explicit LastValueCacheReader(const std::string& shm_name);
+    ~LastValueCacheReader();
+
+    LastValueCacheReader(const LastValueCacheReader&) = delete;
+    LastValueCacheReader& operator=(const LastValueCacheReader&) = delete;
+
+    /**
+     * @brief 读取单个证券的最新值
+     * @return false 表示未写入过、写端已关闭时槽位停在写入中，
+     *         或重试 MAX_READ_RETRIES 次仍未读到一致快照 (写端可能在写入中途崩溃)
+     */
+    bool read(uint32_t instrument_id, LastValueView& out);
+
+    /**
+     * @brief 取走本读者的脏位，对每个变化过的证券以最新值回调 fn(const LastValueView&)
+     * @return 回调次数
+     */
+    template <typename Fn>
+    size_t drain_dirty(Fn&& fn);
+
+    /**
+     * @brief 丢弃当前所有脏位 (例如刚完成一次全量读取)
+     */
+    void clear_dirty();
+
+    size_t get_capacity() const { return capacity_; }
+    size_t get_reader_index() const { return lane_; }
+    bool is_closed() const;
+
+private:
+    const CacheSlotHeader& slot_at(uint32_t instrument_id) const {
+        return *reinterpret_cast<const CacheSlotHeader*>(slots_ + instrument_id * slot_size_);
+    }
+
+    std::string shm_name_;
+    size_t capacity_ = 0;
+    size_t value_size_ = 0;
+    size_t slot_size_ = 0;
+    size_t bitmap_words_ = 0;
+    size_t mapped_size_ = 0;
+    size_t lane_ = 0;
+    CacheHeader* header_ = nullptr;
+    std::atomic<uint64_t>* bitmap_ = nullptr;   // 本读者的脏位图
+    const uint8_t* slots_ = nullptr;
+    std::vector<uint8_t> buffer_;
+};
+
+template <typename Fn>
+size_t LastValueCacheReader::drain_dirty(Fn&& fn) {
+    size_t delivered = 0;
+    LastValueView view;
+    for (size_t word = 0; word < bitmap_words_; ++word) {
+        uint64_t bits = bitmap_[word].exchange(0, std::memory_order_acq_rel);
+        for (; bits != 0; bits &= bits - 1) {
+            const auto id = static_cast<uint32_t>(word * 64 + __builtin_ctzll(bits));
+            if (read(id, view)) {
+                fn(static_cast<const LastValueView&>(view));
+                delivered++;
+            }
+        }
+    }
+    return delivered;
+}
+
+} // namespace qaultra::ipc::shm
@@ -0,0 +1,119 @@
+#pragma once
+
+/**
+ * @file latency_tracker.hpp
+ * @brief 端到端单向延迟测量: HDR 风格直方图 + 序号缺口检测
+ *
+ * 所有后端发布时以 latency_clock_ns() (CLOCK_MONOTONIC) 写入 MarketBlockHeader::timestamp_ns，
+ * 同一主机上的进程共享该时钟，订阅端以接收时刻减去发布时刻得到单向延迟。
+ * 启用 BroadcastConfig::latency_tracking 后每个订阅器持有独立的 LatencyTracker。
+ *
+ * 直方图按对数分段、段内线性分桶 (每段 64 个子桶)，相对误差小于 1/64，
+ * 记录为 O(1) 且不分配内存，覆盖 0 ~ 2^40 纳秒 (约 18 分钟)，更大的值记入最高桶。
+ */
+
+#include "broadcast_config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace qaultra::ipc {
+
+/**
+ * @brief 延迟测量使用的时钟 (CLOCK_MONOTONIC，纳秒)
+ */
+uint64_t latency_clock_ns();
+
+/**
+ * @brief 对数-线性分桶的延迟直方图
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 7;      // 低于 128 的值精确记录
+    static constexpr unsigned MAX_VALUE_BITS = 40;
+
+    LatencyHistogram();
+
+    void record(uint64_t value_ns);
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ == 0 ? 0 : min_; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(count_); }
+
+    /**
+     * @brief 百分位数 (percentile 取 0~100)，返回所在桶的上界 (不超过最大值)
+     */
+    uint64_t value_at_percentile(double percentile) const;
+
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+private:
+    static size_t index_of(uint64_t value);
+    static uint64_t highest_equivalent(size_t index);
+
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+    uint64_t sum_ = 0;
+};
+
+/**
+ * @brief 按 sequence_number 检测丢失与乱序
+ */
+class SequenceGapDetector {
+public:
+    void observe(uint64_t sequence);
+
+    uint64_t gaps() const { return gaps_; }
+    uint64_t missing() const { return missing_; }
+    uint64_t out_of_order() const { return out_of_order_; }
+    void reset() { *this = SequenceGapDetector(); }
+
+    /**
+     * @brief 有意跳过消息后 (如合并追赶) 从下一条重新对齐，不计缺口
+     */
+    void resync() { started_ = false; }
+
+private:
+    bool started_ = false;
+    uint64_t expected_ = 0;
+    uint64_t gaps_ = 0;
+    uint64_t missing_ = 0;
+    uint64_t out_of_order_ = 0;
+};
+
+/**
+ * @brief 订阅端延迟跟踪 (单线程使用)
+ */
+class LatencyTracker {
+public:
+    /**
+     * @brief 记录一条收到的消息
+     * @param publish_ns 消息头中的 timestamp_ns
+     * @param receive_ns 接收时刻 (latency_clock_ns)
+     */
+    void record(uint64_t sequence, uint64_t publish_ns, uint64_t receive_ns);
+
+    /**
+     * @brief 只记录序号 (被过滤的消息不计延迟，但不应算作缺口)
+     */
+    void record_sequence(uint64_t sequence) { gaps_.observe(sequence); }
+    void resync() { gaps_.resync(); }
+
+    const LatencyHistogram& histogram() const { return histogram_; }
+    const SequenceGapDetector& gaps() const { return gaps_; }
+
+    LatencySummary summary() const;
+    void reset();
+
+private:
+    LatencyHistogram histogram_;
+    SequenceGapDetector gaps_;
+    uint64_t negative_samples_ = 0;
+};
+
+} // namespace qaultra::ipc
@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <cstring>
 #include <array>
+#include <type_traits>
+#include <vector>
 
 namespace qaultra::ipc {
 
@@ -15,42 +17,89 @@ enum class MarketDataType : uint8_t {
     Kline = 2,      // K线数据 (别名)
     OrderBook = 3,  // 订单簿
     Trade = 4,      // 成交数据
+    ArrowIpc = 5,   // Arrow IPC 流消息 (arrow_stream.hpp)
     Unknown = 255
 };
 
 /**
- * @brief 零拷贝市场数据块
- *
- * 固定大小的数据块用于 IceOryx 零拷贝传输
- * 8KB 数据块可容纳约 100-200 条 tick 数据
+ * @brief 数据块元数据 (32 bytes)，各尺寸档位共用同一布局
  */
-struct alignas(64) ZeroCopyMarketBlock {
-    // 数据块大小常量
-    static constexpr size_t BLOCK_SIZE = 8192;
-    static constexpr size_t DATA_SIZE = BLOCK_SIZE - 32;  // 预留 32 字节元数据
-
-    // 元数据 (32 bytes)
+struct MarketBlockHeader {
     uint64_t sequence_number;      // 序列号
     uint64_t timestamp_ns;         // 纳秒级时间戳
     uint64_t record_count;         // 数据记录数量
     MarketDataType data_type;      // 数据类型
-    uint8_t flags;                 // 标志位
-    uint8_t reserved[6];           // 保留字节
-
-    // 数据区 (8160 bytes)
-    uint8_t data[DATA_SIZE];
+    uint8_t flags;                 // 标志位 (高3位为分片标志，见 block_flags)
+    uint16_t payload_size;         // 数据区有效字节数 (其后字节内容未定义)
+    uint32_t instrument_tag;       // 单一证券数据块为 InstrumentId+1，0 表示混合或未标注
 
-    /**
-     * @brief 默认构造函数
-     */
-    ZeroCopyMarketBlock() noexcept
+    MarketBlockHeader() noexcept
         : sequence_number(0)
         , timestamp_ns(0)
         , record_count(0)
         , data_type(MarketDataType::Unknown)
         , flags(0)
-        , reserved{0}
-        , data{0}
+        , payload_size(0)
+        , instrument_tag(0)
+    {}
+
+    /**
+     * @brief 数据块所属证券 (混合或未标注时返回 NO_INSTRUMENT)
+     */
+    uint32_t instrument() const noexcept {
+        return instrument_tag - 1;
+    }
+
+    bool has_instrument() const noexcept {
+        return instrument_tag != 0;
+    }
+
+    /**
+     * @brief 标注证券 (NO_INSTRUMENT 清除标注)
+     */
+    void set_instrument(uint32_t instrument_id) noexcept {
+        instrument_tag = instrument_id + 1;
+    }
+
+    static constexpr uint32_t NO_INSTRUMENT = UINT32_MAX;   // 与 data::INVALID_INSTRUMENT_ID 一致
+};
+
+static_assert(sizeof(MarketBlockHeader) == 32, "MarketBlockHeader must be exactly 32 bytes");
+
+/**
+ * @brief 数据块标志位
+ *
+ * 超过单块容量的消息拆成若干序列号连续的分片发送:
+ * 每个分片带 FRAGMENT，首片另带 FRAGMENT_FIRST，末片另带 FRAGMENT_LAST。
+ * 不带 FRAGMENT 的数据块是完整消息 (与旧版本兼容)。低5位留给应用自定义。
+ */
+namespace block_flags {
+constexpr uint8_t FRAGMENT = 0x80;
+constexpr uint8_t FRAGMENT_FIRST = 0x40;
+constexpr uint8_t FRAGMENT_LAST = 0x20;
+constexpr uint8_t FRAGMENT_MASK = FRAGMENT | FRAGMENT_FIRST | FRAGMENT_LAST;
+constexpr uint8_t USER_MASK = static_cast<uint8_t>(~FRAGMENT_MASK);
+} // namespace block_flags
+
+/**
+ * @brief 零拷贝市场数据块 (按总大小分档)
+ *
+ * 固定大小的数据块用于 IceOryx / 共享内存环零拷贝传输，32 字节元数据之后为数据区
+ */
+template <size_t BlockSize>
+struct alignas(64) BasicMarketBlock : MarketBlockHeader {
+    // 数据块大小常量
+    static constexpr size_t BLOCK_SIZE = BlockSize;
+    static constexpr size_t DATA_SIZE = BLOCK_SIZE - sizeof(MarketBlockHeader);
+
+    // 数据区
+    uint8_t data[DATA_SIZE];
+
+    /**
+     * @brief 默认构造函数
+     */
+    BasicMarketBlock() noexcept
+        : data{0}
     {}
 
     /**
@@ -64,9 +113,23 @@ struct alignas(64) ZeroCopyMarketBlock {
             return false;
         }
         std::memcpy(data, src, size);
+        payload_size = static_cast<uint16_t>(size);
         return true;
     }
 
+    /**
+     * @brief 接收端应读取的有效字节数
+     *
+     * payload_size 占用旧版本的保留字节: 旧版发布端或将保留字节置零的 Rust 端发来的数据块
+     * payload_size 为 0，此时沿用旧行为，record_count > 0 即视为整个数据区有效。
+     */
+    size_t effective_payload_size() const noexcept {
+        if (payload_size == 0) {
+            return record_count > 0 ? DATA_SIZE : 0;
+        }
+        return payload_size < DATA_SIZE ? payload_size : DATA_SIZE;
+    }
+
     /**
      * @brief 获取可用数据大小
      */
@@ -74,6 +137,13 @@ struct alignas(64) ZeroCopyMarketBlock {
         return DATA_SIZE;
     }
 
+    /**
+     * @brief 获取元数据
+     */
+    const MarketBlockHeader& header() const noexcept {
+        return *this;
+    }
+
     /**
      * @brief 获取数据指针
      */
@@ -97,16 +167,280 @@ struct alignas(64) ZeroCopyMarketBlock {
         record_count = 0;
         data_type = MarketDataType::Unknown;
         flags = 0;
+        payload_size = 0;
         std::memset(data, 0, DATA_SIZE);
     }
+
+    static_assert(BlockSize % 64 == 0, "block size must be a multiple of the cache line");
+    static_assert(BlockSize - sizeof(MarketBlockHeader) <= UINT16_MAX,
+                  "payload_size must be able to describe the whole data area");
 };
 
+/**
+ * @brief 尺寸档位
+ *
+ * - SmallMarketBlock (256B): 单条 tick / 订单簿增量，避免小消息占用 8KB 槽位
+ * - ZeroCopyMarketBlock (8KB): 默认档位，与 Rust 端约定的布局一致
+ * - LargeMarketBlock (64KB): 快照等大批量数据，配合分片可减少发布次数
+ */
+using SmallMarketBlock = BasicMarketBlock<256>;
+using ZeroCopyMarketBlock = BasicMarketBlock<8192>;
+using LargeMarketBlock = BasicMarketBlock<65536>;
+
 // 编译时验证大小
 static_assert(sizeof(ZeroCopyMarketBlock) == ZeroCopyMarketBlock::BLOCK_SIZE,
               "ZeroCopyMarketBlock size must be exactly 8KB");
+static_assert(sizeof(SmallMarketBlock) == SmallMarketBlock::BLOCK_SIZE, "SmallMarketBlock size");
+static_assert(sizeof(LargeMarketBlock) == LargeMarketBlock::BLOCK_SIZE, "LargeMarketBlock size");
 static_assert(alignof(ZeroCopyMarketBlock) == 64,
               "ZeroCopyMarketBlock must be 64-byte aligned for optimal cache performance");
 
+/**
+ * @brief 尺寸档位枚举 (用于配置)
+ */
+enum class BlockSizeClass : uint8_t {
+    Small,      // 256B
+    Standard,   // 8KB
+    Large       // 64KB
+};
+
+/**
+ * @brief 能单块容纳 payload_bytes 的最小档位 (超过 64KB 时返回 Large，需分片)
+ */
+constexpr BlockSizeClass select_size_class(size_t payload_bytes) noexcept {
+    if (payload_bytes <= SmallMarketBlock::DATA_SIZE) {
+        return BlockSizeClass::Small;
+    }
+    if (payload_bytes <= ZeroCopyMarketBlock::DATA_SIZE) {
+        return BlockSizeClass::Standard;
+    }
+    return BlockSizeClass::Large;
+}
+
+/**
+ * @brief 按数据块类型计算消息所需分片数 (空消息也占一个数据块)
+ */
+template <typename Block>
+constexpr size_t fragment_count(size_t message_size) noexcept {
+    return message_size == 0 ? 1 : (message_size + Block::DATA_SIZE - 1) / Block::DATA_SIZE;
+}
+
+/**
+ * @brief 数据块原位写入器
+ *
+ * 直接在 (通常为借出的共享内存) 数据块上顺序写入记录，不清零、不经过栈上副本；
+ * finish() 只填写32字节元数据，发送方与接收方都只需处理 payload_size 字节。
+ *
+ * 使用示例:
+ * ```cpp
+ * BlockWriter writer(block);
+ * while (auto* tick = writer.emplace<MarketTick>()) {
+ *     fill(*tick);
+ * }
+ * writer.finish(seq, now_ns, MarketDataType::Tick);
+ * ```
+ */
+template <typename Block>
+class BasicBlockWriter {
+public:
+    BasicBlockWriter() = default;
+    explicit BasicBlockWriter(Block& block) noexcept : block_(&block) {}
+
+    /**
+     * @brief 追加一段字节 (空间不足时返回 false，不做部分写入)
+     */
+    bool append(const void* src, size_t size, size_t records = 1) noexcept {
+        if (!block_ || size > remaining()) {
+            return false;
+        }
+        std::memcpy(block_->data + size_, src, size);
+        size_ += size;
+        records_ += records;
+        return true;
+    }
+
+    /**
+     * @brief 为一条定长记录预留空间并返回其地址 (空间不足时返回 nullptr)
+     */
+    template <typename T>
+    T* emplace() noexcept {
+        static_assert(std::is_trivially_copyable_v<T>, "records must be trivially copyable");
+        const size_t aligned = (size_ + alignof(T) - 1) & ~(alignof(T) - 1);
+        if (!block_ || aligned + sizeof(T) > Block::DATA_SIZE) {
+            return nullptr;
+        }
+        size_ = aligned + sizeof(T);
+        records_++;
+        return reinterpret_cast<T*>(block_->data + aligned);
+    }
+
+    /**
+     * @brief 直接写入 data() 之后登记长度 (用于外部序列化器)
+     */
+    bool commit(size_t size, size_t records) noexcept {
+        if (!block_ || size > remaining()) {
+            return false;
+        }
+        size_ += size;
+        records_ += records;
+        return true;
+    }
+
+    /**
+     * @brief 填写元数据，完成写入
+     */
+    void finish(uint64_t sequence_number, uint64_t timestamp_ns, MarketDataType type, uint8_t flags = 0) noexcept {
+        if (!block_) {
+            return;
+        }
+        block_->sequence_number = sequence_number;
+        block_->timestamp_ns = timestamp_ns;
+        block_->record_count = records_;
+        block_->data_type = type;
+        block_->flags = flags;
+        block_->payload_size = static_cast<uint16_t>(size_);
+        block_->set_instrument(instrument_);
+    }
+
+    /**
+     * @brief 标注数据块所属证券 (只含单一证券时)，订阅端据此过滤
+     */
+    void set_instrument(uint32_t instrument_id) noexcept { instrument_ = instrument_id; }
+
+    uint8_t* data() noexcept { return block_ ? block_->data : nullptr; }
+    uint8_t* cursor() noexcept { return block_ ? block_->data + size_ : nullptr; }
+    size_t size() const noexcept { return size_; }
+    size_t records() const noexcept { return records_; }
+    size_t remaining() const noexcept { return block_ ? Block::DATA_SIZE - size_ : 0; }
+    bool valid() const noexcept { return block_ != nullptr; }
+
+private:
+    Block* block_ = nullptr;
+    size_t size_ = 0;
+    size_t records_ = 0;
+    uint32_t instrument_ = MarketBlockHeader::NO_INSTRUMENT;
+};
+
+using BlockWriter = BasicBlockWriter<ZeroCopyMarketBlock>;
+
+/**
+ * @brief 重组完成的消息视图
+ *
+ * 未分片的消息直接指向数据块 (零拷贝，有效期同数据块)；
+ * 分片消息指向 FragmentAssembler 内部缓冲区 (有效期到下一次 feed)。
+ */
+struct MessageView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    uint64_t record_count = 0;
+    uint64_t first_sequence = 0;    // 首个分片的序列号
+    uint64_t timestamp_ns = 0;      // 末个分片的时间戳
+    uint32_t fragments = 0;
+    MarketDataType data_type = MarketDataType::Unknown;
+    uint8_t flags = 0;              // 用户标志位 (已去除分片标志)
+};
+
+/**
+ * @brief 分片重组器
+ *
+ * 按到达顺序喂入数据块，要求同一消息的分片序列号连续；出现缺口、
+ * 未收到首片或被新消息打断时丢弃未完成的消息并计数。缓冲区在消息间复用。
+ */
+class FragmentAssembler {
+public:
+    /**
+     * @brief 喂入一个数据块
+     * @return true 表示得到一条完整消息 (写入 out)
+     */
+    bool feed(const MarketBlockHeader& header, const uint8_t* payload, MessageView& out) {
+        const uint8_t flags = header.flags;
+        if (!(flags & block_flags::FRAGMENT)) {
+            drop_partial();
+            out.data = payload;
+            out.size = header.payload_size;
+            out.record_count = header.record_count;
+            out.first_sequence = header.sequence_number;
+            out.timestamp_ns = header.timestamp_ns;
+            out.fragments = 1;
+            out.data_type = header.data_type;
+            out.flags = flags & block_flags::USER_MASK;
+            return true;
+        }
+
+        if (flags & block_flags::FRAGMENT_FIRST) {
+            drop_partial();
+            active_ = true;
+            buffer_.clear();
+            first_sequence_ = header.sequence_number;
+            records_ = 0;
+            fragments_ = 0;
+            type_ = header.data_type;
+        } else if (!active_ || header.sequence_number != first_sequence_ + fragments_ ||
+                   header.data_type != type_) {
+            drop_partial();
+            if (!active_) {
+                orphan_fragments_++;
+            }
+            return false;
+        }
+
+        buffer_.insert(buffer_.end(), payload, payload + header.payload_size);
+        records_ += header.record_count;
+        fragments_++;
+
+        if (!(flags & block_flags::FRAGMENT_LAST)) {
+            return false;
+        }
+
+        active_ = false;
+        out.data = buffer_.data();
+        out.size = buffer_.size();
+        out.record_count = records_;
+        out.first_sequence = first_sequence_;
+        out.timestamp_ns = header.timestamp_ns;
+        out.fragments = fragments_;
+        out.data_type = type_;
+        out.flags = flags & block_flags::USER_MASK;
+        return true;
+    }
+
+    template <typename Block>
+    bool feed(const Block& block, MessageView& out) {
+        return feed(block.header(), block.data, out);
+    }
+
+    /**
+     * @brief 放弃正在重组的消息 (例如检测到传输层丢包)
+     */
+    void reset() { drop_partial(); }
+
+    bool in_progress() const { return active_; }
+    uint64_t dropped_messages() const { return dropped_messages_; }
+    uint64_t orphan_fragments() const { return orphan_fragments_; }
+
+    /**
+     * @brief 预留重组缓冲区 (如已知全市场快照大小)
+     */
+    void reserve(size_t bytes) { buffer_.reserve(bytes); }
+
+private:
+    void drop_partial() {
+        if (active_) {
+            dropped_messages_++;
+            active_ = false;
+        }
+    }
+
+    std::vector<uint8_t> buffer_;
+    bool active_ = false;
+    uint64_t first_sequence_ = 0;
+    uint64_t records_ = 0;
+    uint32_t fragments_ = 0;
+    MarketDataType type_ = MarketDataType::Unknown;
+    uint64_t dropped_messages_ = 0;
+    uint64_t orphan_fragments_ = 0;
+};
+
 /**
  * @brief 批量数据块 (用于高吞吐场景)
  */
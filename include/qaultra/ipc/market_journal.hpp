@@ -0,0 +1,257 @@
+#pragma once
+
+/**
+ * @file market_journal.hpp
+ * @brief 可回放的行情持久化日志 (mmap 文件，按段滚动，按序列号与时间索引)
+ *
+ * 启用 BroadcastConfig::journal_dir 后，发布端在数据块对订阅者可见之前将其追加到日志，
+ * 因此任何已发布的序列号都已在日志中。目录布局:
+ *   <journal_dir>/<service>_<stream>/<首序列号(20位)>.qjournal
+ * 每个段文件:
+ *   [JournalSegmentHeader] [索引: index_capacity 个 JournalIndexEntry] [数据区]
+ * 数据区中每条记录为 32 字节 MarketBlockHeader + 有效负载，按 64 字节对齐；
+ * 段内序列号连续，第 i 条记录的序列号为 first_sequence + i。
+ * 写入端提交记录后以 release 语义递增 record_count，其他进程的读取端无锁读取已提交部分。
+ *
+ * 日志写入页缓存即返回 (进程崩溃不丢数据，主机掉电可能丢失未刷盘部分，可调用 sync())。
+ * 重启的发布端从日志末尾的下一个序列号继续编号，序列号跳跃时开启新段。
+ *
+ * 使用示例:
+ * ```cpp
+ * MarketJournalReader journal(journal_directory(config, "market_data"));
+ * journal.replay(journal.sequence_at_time(start_of_day_ns), journal.end_sequence(),
+ *                [](const MarketBlockHeader& header, const uint8_t* payload) { ... });
+ * ```
+ */
+
+#include "market_data_block.hpp"
+#include "broadcast_config.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace qaultra::ipc {
+
+/**
+ * @brief 段文件头
+ */
+struct alignas(64) JournalSegmentHeader {
+    static constexpr uint64_t MAGIC = 0x4C4E524A5A514151ULL;   // "QAQZJRNL"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> sealed;               // 写入端已转到下一段或已关闭
+    uint64_t first_sequence;
+    uint64_t index_capacity;                    // 索引条目数 (段内记录数上限)
+    uint64_t data_capacity;                     // 数据区字节数
+    alignas(64) std::atomic<uint64_t> record_count;    // 已提交的记录数
+};
+
+/**
+ * @brief 索引条目 (下标即段内序号)
+ */
+struct JournalIndexEntry {
+    uint64_t offset;                            // 记录在数据区内的偏移
+    uint64_t wall_time_ns;                      // 写入时刻 (system_clock，纳秒)
+};
+
+static_assert(sizeof(JournalSegmentHeader) == 128, "JournalSegmentHeader layout");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "journal requires lock-free 64-bit atomics");
+
+/**
+ * @brief 流的日志目录 ("<journal_dir>/<service>_<stream>")
+ */
+std::string journal_directory(const BroadcastConfig& config, const std::string& stream_name);
+
+/**
+ * @brief 日志写入端 (单线程)
+ *
+ * 构造时扫描目录，已有日志时从最后一段之后续写 (旧段标记为封存)，
+ * 新段在第一次追加时按其首序列号创建。
+ */
+class MarketJournalWriter {
+public:
+    /**
+     * @param directory 日志目录 (不存在时创建)
+     * @param segment_bytes 单个段文件大小 (至少 1MB，且能容纳一个最大数据块)
+     * @throws std::runtime_error 目录无法创建或已有日志无法读取
+     */
+    MarketJournalWriter(const std::string& directory, size_t segment_bytes);
+    ~MarketJournalWriter();
+
+    MarketJournalWriter(const MarketJournalWriter&) = delete;
+    MarketJournalWriter& operator=(const MarketJournalWriter&) = delete;
+
+    /**
+     * @brief 追加一个数据块 (只写入元数据与有效负载)
+     * @return false 表示序列号回退或写入失败 (计入 get_rejected())
+     */
+    bool append(const MarketBlockHeader& header, const uint8_t* payload);
+
+    template <typename Block>
+    bool append(const Block& block) {
+        return append(block.header(), block.data);
+    }
+
+    /**
+     * @brief 下一条期望的序列号 (发布端据此续接编号)
+     */
+    uint64_t next_sequence() const { return next_sequence_; }
+
+    /**
+     * @brief 将当前段刷入磁盘 (msync)
+     */
+    bool sync();
+
+    const std::string& get_directory() const { return directory_; }
+    size_t get_segment_bytes() const { return segment_bytes_; }
+    uint64_t get_records_appended() const { return records_appended_; }
+    uint64_t get_bytes_appended() const { return bytes_appended_; }
+    uint64_t get_segments_created() const { return segments_created_; }
+    uint64_t get_rejected() const { return rejected_; }
+
+private:
+    bool open_segment(uint64_t first_sequence);
+    void close_segment();
+
+    std::string directory_;
+    size_t segment_bytes_;
+    uint64_t index_capacity_ = 0;
+    uint64_t data_capacity_ = 0;
+    uint64_t next_sequence_ = 0;
+
+    // 当前段
+    void* mapping_ = nullptr;
+    JournalSegmentHeader* header_ = nullptr;
+    JournalIndexEntry* index_ = nullptr;
+    uint8_t* data_ = nullptr;
+    uint64_t data_used_ = 0;
+
+    uint64_t records_appended_ = 0;
+    uint64_t bytes_appended_ = 0;
+    uint64_t segments_created_ = 0;
+    uint64_t rejected_ = 0;
+};
+
+/**
+ * @brief 日志读取端 (只读映射，可与写入端并发)
+ *
+ * 段按需映射；写入端创建的新段需调用 refresh() 才会被发现。
+ */
+class MarketJournalReader {
+public:
+    /**
+     * @param directory 日志目录 (不存在时视为空日志)
+     */
+    explicit MarketJournalReader(const std::string& directory);
+    ~MarketJournalReader();
+
+    MarketJournalReader(const MarketJournalReader&) = delete;
+    MarketJournalReader& operator=(const MarketJournalReader&) = delete;
+
+    /**
+     * @brief 重新扫描目录，返回段数
+     */
+    size_t refresh();
+
+    size_t segment_count() const { return segments_.size(); }
+    bool empty() const { return first_sequence() == end_sequence(); }
+
+    /**
+     * @brief 最早一条记录的序列号 (空日志时等于 end_sequence())
+     */
+    uint64_t first_sequence() const;
+
+    /**
+     * @brief 最后一条已提交记录之后的序列号 (读取最后一段的实时提交数)
+     */
+    uint64_t end_sequence() const;
+
+    /**
+     * @brief 不小于 sequence 的第一条可读记录的序列号 (跨过段间缺口)，没有时返回 end_sequence()
+     */
+    uint64_t next_available(uint64_t sequence) const;
+
+    /**
+     * @brief 写入时刻不早于 wall_time_ns 的第一条记录的序列号，没有时返回 end_sequence()
+     */
+    uint64_t sequence_at_time(uint64_t wall_time_ns) const;
+
+    /**
+     * @brief 读取单条记录，回调参数为 (const MarketBlockHeader&, const uint8_t* payload)
+     * @return false 表示该序列号不在日志中
+     */
+    template <typename Fn>
+    bool read(uint64_t sequence, Fn&& fn);
+
+    /**
+     * @brief 顺序回放 [from, to) 内的全部记录 (零拷贝回调，跳过段间缺口)
+     * @return 回调次数
+     */
+    template <typename Fn>
+    uint64_t replay(uint64_t from, uint64_t to, Fn&& fn);
+
+private:
+    struct Segment {
+        uint64_t first_sequence = 0;
+        std::string path;
+        void* mapping = nullptr;
+        size_t mapped_size = 0;
+        const JournalSegmentHeader* header = nullptr;
+        const JournalIndexEntry* index = nullptr;
+        const uint8_t* data = nullptr;
+    };
+
+    bool map(Segment& segment) const;
+    uint64_t committed(const Segment& segment) const;
+    size_t segment_for(uint64_t sequence) const;        // 首序列号不大于 sequence 的最后一段，没有时返回 size()
+
+    const Segment* locate(uint64_t sequence, uint64_t& position);
+
+    std::string directory_;
+    mutable std::vector<Segment> segments_;
+    size_t hint_ = 0;
+};
+
+template <typename Fn>
+bool MarketJournalReader::read(uint64_t sequence, Fn&& fn) {
+    uint64_t position = 0;
+    const Segment* segment = locate(sequence, position);
+    if (!segment) {
+        return false;
+    }
+    const auto* header = reinterpret_cast<const MarketBlockHeader*>(segment->data + segment->index[position].offset);
+    fn(*header, reinterpret_cast<const uint8_t*>(header + 1));
+    return true;
+}
+
+template <typename Fn>
+uint64_t MarketJournalReader::replay(uint64_t from, uint64_t to, Fn&& fn) {
+    uint64_t delivered = 0;
+    size_t first = segment_for(from);
+    if (first == segments_.size()) {
+        first = 0;      // from 早于日志起点
+    }
+    for (size_t s = first; s < segments_.size(); ++s) {
+        Segment& segment = segments_[s];
+        if (segment.first_sequence >= to || !map(segment)) {
+            break;
+        }
+        const uint64_t count = committed(segment);
+        const uint64_t begin = from > segment.first_sequence ? from - segment.first_sequence : 0;
+        const uint64_t end = std::min(count, to - segment.first_sequence);
+        for (uint64_t i = begin; i < end; ++i) {
+            const auto* header = reinterpret_cast<const MarketBlockHeader*>(segment.data + segment.index[i].offset);
+            fn(*header, reinterpret_cast<const uint8_t*>(header + 1));
+            delivered++;
+        }
+    }
+    return delivered;
+}
+
+} // namespace qaultra::ipc
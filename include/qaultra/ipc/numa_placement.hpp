@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+ * @file numa_placement.hpp
+ * @brief 线程 CPU 绑定与共享内存 NUMA 放置 (Linux，无 libnuma 依赖)
+ *
+ * 双路服务器上发布线程、订阅线程与共享内存段跨 NUMA 节点时，每次读写都要经过
+ * 处理器互联。BroadcastConfig 中的相关选项由各广播后端在构造时应用:
+ *   - cpu_affinity: 构造广播器/订阅器的线程绑定到该 CPU (之后应在同一线程收发)
+ *   - numa_aware:   发布端在首次访问前将共享内存段 mbind 到发布线程所在节点，并预先缺页
+ *   - lock_memory:  mlock 共享内存段，避免运行中缺页或换出 (受 RLIMIT_MEMLOCK 限制)
+ * 各步骤失败只打印警告，不影响收发；实际结果记录在 MemoryPlacement 中。
+ */
+
+#include "broadcast_config.hpp"
+
+#include <cstddef>
+
+namespace qaultra::ipc {
+
+/**
+ * @brief 当前线程所在 CPU (未知时返回 -1)
+ */
+int current_cpu();
+
+/**
+ * @brief CPU 所在 NUMA 节点 (非 NUMA 系统返回 0，未知时返回 -1)
+ */
+int cpu_numa_node(int cpu);
+
+/**
+ * @brief 将当前线程绑定到指定 CPU
+ */
+bool pin_current_thread(int cpu);
+
+/**
+ * @brief 将 [addr, addr+size) 的内存绑定到指定 NUMA 节点 (已缺页的页会迁移)
+ */
+bool bind_memory_to_node(void* addr, size_t size, int node);
+
+/**
+ * @brief 预先缺页 (写入触发分配，应在 bind_memory_to_node 之后、内容初始化之前调用)
+ * @return 预先缺页的字节数
+ */
+size_t prefault_memory(void* addr, size_t size);
+
+/**
+ * @brief mlock 内存，超过 limit 的部分不锁定
+ * @return 锁定的字节数 (失败时为 0)
+ */
+size_t lock_memory(void* addr, size_t size, size_t limit);
+
+/**
+ * @brief 按 cpu_affinity 绑定当前线程，并记录所在 CPU 与 NUMA 节点
+ */
+MemoryPlacement place_current_thread(const BroadcastConfig& config);
+
+/**
+ * @brief 按配置放置共享内存段
+ * @param owner 创建该段的一方 (发布端) 才执行 NUMA 绑定与预先缺页
+ */
+void place_shared_memory(const BroadcastConfig& config, void* addr, size_t size, bool owner,
+                         MemoryPlacement& placement);
+
+} // namespace qaultra::ipc
@@ -0,0 +1,476 @@
+#pragma once
+
+/**
+ * @file shm_ring.hpp
+ * @brief 无外部依赖的共享内存单生产者/多消费者环形广播 (POSIX shm_open + mmap)
+ *
+ * 适用于无法运行 RouDi / iceoryx2 的主机。内存布局:
+ *   [RingHeader (64B 对齐)] [Slot 0] [Slot 1] ... [Slot N-1]
+ * 每个 Slot 由一个序号字 (seqlock) 和一个数据块组成，数据块尺寸档位由模板参数决定
+ * (SmallMarketBlock / ZeroCopyMarketBlock / LargeMarketBlock)，双方须使用同一档位。
+ *
+ * 生产者写入第 n 条消息时先将槽位序号置为 2n+1 (写入中)，写完后置为 2n+2 (可读)，
+ * 再推进全局 write_sequence。消费者持有各自的读游标，无锁读取:
+ *   - 槽位序号 < 2n+2: 尚未发布
+ *   - 槽位序号 > 2n+2 或读取前后序号变化: 已被覆盖 (overrun)，游标跳到最旧可读位置
+ *
+ * 使用示例:
+ * ```cpp
+ * ShmRingBroadcaster pub(config, "market_data");
+ * pub.broadcast(bytes, size, count, MarketDataType::Tick);
+ *
+ * ShmRingSubscriber sub(config, "market_data", ShmRingSubscriber::StartPosition::Oldest);
+ * while (auto payload = sub.receive()) { ... }
+ *
+ * // 合并模式 (config.conflation_enabled): 落后的订阅者跳过积压，只读各证券最新值
+ * if (sub.lag() > 1000) sub.catch_up([](const LastValueView& v) { ... });
+ *
+ * // 超过单块容量的消息分片发送，订阅端重组
+ * pub.broadcast_message(snapshot, snapshot_size, count, MarketDataType::Tick);
+ * sub.read_message([](const MessageView& msg) { ... });
+ * ```
+ */
+
+#include "market_data_block.hpp"
+#include "broadcast_config.hpp"
+#include "subscription_filter.hpp"
+#include "last_value_cache.hpp"
+#include "latency_tracker.hpp"
+#include "market_journal.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace qaultra::ipc::shm {
+
+/**
+ * @brief 共享内存段头
+ */
+struct alignas(64) RingHeader {
+    static constexpr uint64_t MAGIC = 0x474E495241515A51ULL;   // "QZQARING"
+    static constexpr uint32_t VERSION = 2;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_size;                         // sizeof(Slot)
+    uint64_t slot_count;                        // 2的幂
+    std::atomic<uint32_t> closed;               // 生产者已退出
+    std::atomic<uint32_t> subscribers;          // 已连接的订阅者 (异常退出的进程不会递减)
+    uint64_t first_sequence;                    // 本段第一条消息的序号 (启用日志时从日志末尾续接)
+    alignas(64) std::atomic<uint64_t> write_sequence;   // 下一条待发布消息的序号
+};
+
+/**
+ * @brief 环形槽位
+ */
+template <typename Block>
+struct alignas(64) RingSlot {
+    std::atomic<uint64_t> sequence;             // 2n+1 写入中，2n+2 消息 n 可读
+    uint8_t padding[56];
+    Block block;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory ring requires lock-free 64-bit atomics");
+static_assert(sizeof(RingSlot<ZeroCopyMarketBlock>) == 64 + sizeof(ZeroCopyMarketBlock), "RingSlot layout");
+
+/**
+ * @brief 根据服务名与流名生成 shm 对象名 ("/qaultra_<service>_<stream>")
+ */
+std::string shm_object_name(const BroadcastConfig& config, const std::string& stream_name);
+
+/**
+ * @brief 环形槽位数 (queue_capacity 向上取2的幂，至少2)
+ */
+size_t ring_slot_count(const BroadcastConfig& config);
+
+/**
+ * @brief 合并模式最新值缓存的 shm 对象名
+ */
+std::string lvc_object_name(const BroadcastConfig& config, const std::string& stream_name);
+
+/**
+ * @brief 共享内存环形广播器 (单生产者)
+ *
+ * 构造时创建 (或替换) 同名共享内存段，析构时标记关闭并 unlink。
+ * broadcast/loan/publish 只能由单个线程调用，通常即构造线程 (按 cpu_affinity 绑定，
+ * numa_aware 时共享内存段放置在该线程所在节点，见 numa_placement.hpp)。
+ * 合并模式下，标注了证券的完整 (未分片) 消息在发布前同时写入最新值缓存。
+ * 设置 journal_dir 时，每个数据块在发布前追加到持久化日志 (market_journal.hpp)，
+ * 序号从日志末尾续接，因此重启后序号仍然单调。
+ */
+template <typename Block>
+class BasicShmRingBroadcaster {
+public:
+    using BlockType = Block;
+    using Slot = RingSlot<Block>;
+    using Writer = BasicBlockWriter<Block>;
+
+    explicit BasicShmRingBroadcaster(const BroadcastConfig& config,
+                                const std::string& stream_name = "market_data");
+    ~BasicShmRingBroadcaster();
+
+    BasicShmRingBroadcaster(const BasicShmRingBroadcaster&) = delete;
+    BasicShmRingBroadcaster& operator=(const BasicShmRingBroadcaster&) = delete;
+
+    /**
+     * @brief 广播单个数据块 (data_size 不超过 Block::DATA_SIZE)
+     * @param instrument_id 数据块只含单一证券时标注其ID，供订阅端过滤
+     */
+    bool broadcast(const uint8_t* data, size_t data_size, size_t record_count, MarketDataType type,
+                   uint32_t instrument_id = MarketBlockHeader::NO_INSTRUMENT);
+
+    /**
+     * @brief 按数据块大小切分后广播，返回成功发送的记录数 (全部成功时等于 record_count)
+     */
+    size_t broadcast_batch(const uint8_t* data, size_t data_size, size_t record_count, MarketDataType type);
+
+    /**
+     * @brief 广播一条逻辑消息，超过单块容量时按 block_flags 分片 (序列号连续)
+     *
+     * 分片数超过槽位数时，读取慢于生产的订阅者无法完整重组，应选择更大的尺寸档位。
+     * 记录数按字节比例分摊到各分片，重组后总数不变。
+     */
+    bool broadcast_message(const uint8_t* data, size_t data_size, size_t record_count, MarketDataType type,
+                           uint32_t instrument_id = MarketBlockHeader::NO_INSTRUMENT);
+
+    /**
+     * @brief 借出下一个槽位，直接在共享内存中填写负载
+     *
+     * 借出期间槽位标记为写入中，读到该槽位的消费者会等待或判定为覆盖。
+     */
+    Writer loan();
+
+    /**
+     * @brief 发布借出的槽位
+     */
+    bool publish(Writer& writer, MarketDataType type, uint8_t flags = 0);
+
+    BroadcastStats get_stats() const;
+    void reset_stats();
+
+    const BroadcastConfig& get_config() const { return config_; }
+    const std::string& get_stream_name() const { return stream_name_; }
+    const std::string& get_shm_name() const { return shm_name_; }
+    size_t get_slot_count() const { return slot_count_; }
+
+    bool has_subscribers() const { return get_subscriber_count() > 0; }
+    size_t get_subscriber_count() const;
+
+    /**
+     * @brief 最新值缓存 (未启用合并模式时为 nullptr)
+     */
+    const LastValueCacheWriter* get_last_value_cache() const { return lvc_.get(); }
+
+    /**
+     * @brief 持久化日志 (未设置 journal_dir 时为 nullptr)
+     */
+    MarketJournalWriter* get_journal() { return journal_.get(); }
+
+private:
+    Slot& slot_at(uint64_t sequence) { return slots_[sequence & mask_]; }
+
+    BroadcastConfig config_;
+    std::string stream_name_;
+    std::string shm_name_;
+    size_t slot_count_ = 0;
+    uint64_t mask_ = 0;
+    size_t mapped_size_ = 0;
+    RingHeader* header_ = nullptr;
+    Slot* slots_ = nullptr;
+
+    uint64_t next_sequence_ = 0;
+    bool loaned_ = false;
+    std::unique_ptr<LastValueCacheWriter> lvc_;
+    std::unique_ptr<MarketJournalWriter> journal_;
+    MemoryPlacement placement_;
+
+    std::atomic<uint64_t> blocks_sent_{0};
+    std::atomic<uint64_t> records_sent_{0};
+    std::atomic<uint64_t> bytes_sent_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::chrono::steady_clock::time_point start_time_;
+};
+
+/**
+ * @brief 共享内存环形订阅器
+ *
+ * 每个订阅器持有独立读游标，读取不加锁、不影响生产者与其他订阅器。
+ */
+template <typename Block>
+class BasicShmRingSubscriber {
+public:
+    using BlockType = Block;
+    using Slot = RingSlot<Block>;
+
+    /**
+     * @brief 起始读取位置
+     */
+    enum class StartPosition {
+        Latest,     // 只接收连接之后发布的消息
+        Oldest      // 先追赶环中仍保留的历史消息 (迟到订阅者)
+    };
+
+    explicit BasicShmRingSubscriber(const BroadcastConfig& config,
+                               const std::string& stream_name = "market_data",
+                               StartPosition start = StartPosition::Latest);
+    ~BasicShmRingSubscriber();
+
+    BasicShmRingSubscriber(const BasicShmRingSubscriber&) = delete;
+    BasicShmRingSubscriber& operator=(const BasicShmRingSubscriber&) = delete;
+
+    /**
+     * @brief 非阻塞接收下一条消息的有效负载
+     */
+    std::optional<std::vector<uint8_t>> receive();
+    std::optional<std::vector<uint8_t>> receive_nowait() { return receive(); }
+
+    /**
+     * @brief 接收下一条消息到调用方数据块 (只拷贝元数据与有效负载)
+     */
+    bool receive_block(Block& out);
+
+    /**
+     * @brief 零拷贝读取: 回调直接访问共享内存中的数据块
+     *
+     * 回调返回后会校验槽位是否在读取期间被覆盖；返回 false 表示本次读取无效
+     * (回调中的结果应丢弃) 或暂无消息。回调中不应长时间停留。
+     */
+    template <typename Fn>
+    bool read(Fn&& fn);
+
+    /**
+     * @brief 读取下一条完整的逻辑消息 (自动重组分片)，回调参数为 const MessageView&
+     *
+     * 未分片消息在共享内存上零拷贝回调，语义同 read()；分片消息在末片校验通过后
+     * 从重组缓冲区回调。分片被覆盖时丢弃整条消息 (计入 get_assembler().dropped_messages())。
+     * 返回 false 表示暂无完整消息。
+     */
+    template <typename Fn>
+    bool read_message(Fn&& fn);
+
+    const FragmentAssembler& get_assembler() const { return assembler_; }
+
+    /**
+     * @brief 设置订阅过滤器: 不匹配的数据块只读取元数据即跳过 (计入 blocks_filtered)
+     */
+    void set_filter(const SubscriptionFilter& filter) { filter_ = filter; }
+    const SubscriptionFilter& get_filter() const { return filter_; }
+
+    /**
+     * @brief 合并追赶: 跳过环中全部积压，改为读取自上次追赶以来变化过的证券的最新值
+     *
+     * 回调参数为 const LastValueView&，每个证券最多一次 (受订阅过滤器约束)。
+     * 需要生产者与订阅器都启用 conflation_enabled；未启用时返回 0 且不移动游标。
+     * 追赶期间新发布的消息可能既出现在回调中又留在环中，按最新状态处理即可。
+     * @return 回调次数
+     */
+    template <typename Fn>
+    size_t catch_up(Fn&& fn);
+
+    bool has_last_value_cache() const { return lvc_ != nullptr; }
+
+    bool has_data() const;
+    bool is_closed() const;
+
+    /**
+     * @brief 生产者写入位置与本订阅器读游标的差 (待读消息数，含会被过滤的数据块)
+     */
+    uint64_t lag() const;
+
+    /**
+     * @brief 下一条待读消息的序号
+     */
+    uint64_t position() const { return cursor_; }
+
+    /**
+     * @brief 移动读游标 (用于从日志回放切换到实时)
+     * @return false 表示该序号已被覆盖 (早于环中最旧的消息)
+     */
+    bool seek(uint64_t sequence);
+
+    struct ReceiveStats {
+        uint64_t blocks_received = 0;
+        uint64_t records_received = 0;
+        uint64_t bytes_received = 0;
+        uint64_t missed_samples = 0;        // 被覆盖而丢失的消息
+        uint64_t overruns = 0;              // 发生覆盖的次数
+        uint64_t blocks_filtered = 0;       // 被订阅过滤器跳过的数据块
+        uint64_t conflated_samples = 0;     // 合并追赶时跳过的积压消息
+    };
+
+    ReceiveStats get_receive_stats() const { return stats_; }
+    void reset_receive_stats();
+
+    /**
+     * @brief 延迟跟踪 (未启用 latency_tracking 时为 nullptr)
+     */
+    const LatencyTracker* get_latency_tracker() const { return latency_.get(); }
+    LatencySummary get_latency() const { return latency_ ? latency_->summary() : LatencySummary{}; }
+
+    const BroadcastConfig& get_config() const { return config_; }
+    const std::string& get_stream_name() const { return stream_name_; }
+
+    /**
+     * @brief 订阅线程与映射的放置情况 (cpu_affinity / lock_memory)
+     */
+    const MemoryPlacement& get_placement() const { return placement_; }
+
+private:
+    enum class SlotState { Ready, Empty, Overrun };
+
+    const Slot& slot_at(uint64_t sequence) const { return slots_[sequence & mask_]; }
+    SlotState begin_read(uint64_t& observed);
+    bool end_read(uint64_t observed);
+    void skip_overrun();
+    uint64_t oldest_retained(uint64_t written) const;
+    void account(uint64_t records, size_t payload_size);
+
+    BroadcastConfig config_;
+    std::string stream_name_;
+    uint64_t slot_count_ = 0;
+    uint64_t mask_ = 0;
+    size_t mapped_size_ = 0;
+    RingHeader* header_ = nullptr;
+    const Slot* slots_ = nullptr;
+
+    MemoryPlacement placement_;
+    uint64_t cursor_ = 0;
+    ReceiveStats stats_;
+    FragmentAssembler assembler_;
+    SubscriptionFilter filter_;
+    std::unique_ptr<LastValueCacheReader> lvc_;
+    std::unique_ptr<LatencyTracker> latency_;
+};
+
+template <typename Block>
+template <typename Fn>
+bool BasicShmRingSubscriber<Block>::read(Fn&& fn) {
+    while (true) {
+        uint64_t observed = 0;
+        const SlotState state = begin_read(observed);
+        if (state == SlotState::Empty) {
+            return false;
+        }
+        if (state == SlotState::Overrun) {
+            skip_overrun();
+            continue;
+        }
+
+        const Block& block = slot_at(cursor_).block;
+        const uint64_t received_ns = latency_ ? latency_clock_ns() : 0;
+        const uint64_t sequence = block.sequence_number;
+        const uint64_t published_ns = block.timestamp_ns;
+        if (!filter_.accepts_all() && !filter_.matches(block.header())) {
+            // 只读取了元数据: 校验未被覆盖后直接跳过
+            if (!end_read(observed)) {
+                skip_overrun();
+                continue;
+            }
+            stats_.blocks_filtered++;
+            if (latency_) {
+                latency_->record_sequence(sequence);
+            }
+            cursor_++;
+            continue;
+        }
+
+        fn(block);
+        const uint64_t records = block.record_count;
+        const size_t payload_size = block.payload_size;
+        if (!end_read(observed)) {
+            skip_overrun();
+            return false;
+        }
+        account(records, payload_size);
+        if (latency_) {
+            latency_->record(sequence, published_ns, received_ns);
+        }
+        cursor_++;
+        return true;
+    }
+}
+
+template <typename Block>
+template <typename Fn>
+bool BasicShmRingSubscriber<Block>::read_message(Fn&& fn) {
+    while (true) {
+        bool complete = false;
+        bool delivered = false;
+        MessageView message;
+        const uint64_t overruns_before = stats_.overruns;
+        const bool ok = read([&](const Block& block) {
+            complete = assembler_.feed(block, message);
+            if (complete && message.fragments == 1) {
+                fn(message);
+                delivered = true;
+            }
+        });
+        if (!ok) {
+            if (stats_.overruns != overruns_before) {
+                // 读取期间槽位被覆盖，已喂入的分片不可信
+                assembler_.reset();
+            }
+            return false;
+        }
+        // 因覆盖跳过的消息会使后续分片序列号不连续，由重组器丢弃
+        if (complete) {
+            if (!delivered) {
+                fn(message);
+            }
+            return true;
+        }
+    }
+}
+
+template <typename Block>
+template <typename Fn>
+size_t BasicShmRingSubscriber<Block>::catch_up(Fn&& fn) {
+    if (!lvc_) {
+        return 0;
+    }
+
+    // 先移动游标再取脏位: 游标之前的消息都已在取脏位前写入缓存
+    const uint64_t written = header_->write_sequence.load(std::memory_order_acquire);
+    if (written > cursor_) {
+        stats_.conflated_samples += written - cursor_;
+        cursor_ = written;
+    }
+    assembler_.reset();
+    if (latency_) {
+        latency_->resync();
+    }
+
+    size_t delivered = 0;
+    lvc_->drain_dirty([&](const LastValueView& value) {
+        MarketBlockHeader header;
+        header.data_type = value.data_type;
+        header.set_instrument(value.instrument_id);
+        if (filter_.matches(header)) {
+            fn(value);
+            delivered++;
+        }
+    });
+    return delivered;
+}
+
+// 尺寸档位
+using ShmRingBroadcaster = BasicShmRingBroadcaster<ZeroCopyMarketBlock>;
+using ShmRingSubscriber = BasicShmRingSubscriber<ZeroCopyMarketBlock>;
+using SmallShmRingBroadcaster = BasicShmRingBroadcaster<SmallMarketBlock>;
+using SmallShmRingSubscriber = BasicShmRingSubscriber<SmallMarketBlock>;
+using LargeShmRingBroadcaster = BasicShmRingBroadcaster<LargeMarketBlock>;
+using LargeShmRingSubscriber = BasicShmRingSubscriber<LargeMarketBlock>;
+
+extern template class BasicShmRingBroadcaster<SmallMarketBlock>;
+extern template class BasicShmRingBroadcaster<ZeroCopyMarketBlock>;
+extern template class BasicShmRingBroadcaster<LargeMarketBlock>;
+extern template class BasicShmRingSubscriber<SmallMarketBlock>;
+extern template class BasicShmRingSubscriber<ZeroCopyMarketBlock>;
+extern template class BasicShmRingSubscriber<LargeMarketBlock>;
+
+} // namespace qaultra::ipc::shm
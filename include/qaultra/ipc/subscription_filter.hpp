@@ -0,0 +1,147 @@
+#pragma once
+
+/**
+ * @file subscription_filter.hpp
+ * @brief 订阅过滤与按证券分区
+ *
+ * 过滤只读取32字节元数据 (data_type、instrument_tag)，不匹配的数据块在订阅端
+ * 直接跳过，无需解码有效负载。混合多个证券的数据块没有证券标注，默认放行，
+ * 由上层自行解码过滤；发布端按证券分区发布时每个数据块只含单一证券。
+ */
+
+#include "market_data_block.hpp"
+
+#include <bitset>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace qaultra::ipc {
+
+/**
+ * @brief 订阅过滤器 (证券ID集合 + 数据类型集合)
+ *
+ * 证券ID为 InstrumentRegistry 分配的稠密编号，使用位图存储，判断为 O(1)。
+ * 默认构造的过滤器接受所有数据块。
+ */
+class SubscriptionFilter {
+public:
+    SubscriptionFilter() = default;
+
+    /**
+     * @brief 只接收指定证券 (可多次调用累加)
+     */
+    SubscriptionFilter& add_instrument(uint32_t instrument_id) {
+        if (instrument_id == MarketBlockHeader::NO_INSTRUMENT) {
+            return *this;
+        }
+        const size_t word = instrument_id / 64;
+        if (word >= instruments_.size()) {
+            instruments_.resize(word + 1, 0);
+        }
+        instruments_[word] |= uint64_t{1} << (instrument_id % 64);
+        instrument_count_++;
+        return *this;
+    }
+
+    SubscriptionFilter& add_instruments(const std::vector<uint32_t>& instrument_ids) {
+        for (uint32_t id : instrument_ids) {
+            add_instrument(id);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 只接收指定数据类型 (可多次调用累加)
+     */
+    SubscriptionFilter& add_type(MarketDataType type) {
+        types_.set(static_cast<uint8_t>(type));
+        return *this;
+    }
+
+    SubscriptionFilter& add_types(std::initializer_list<MarketDataType> types) {
+        for (MarketDataType type : types) {
+            add_type(type);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 是否接收未标注证券的 (混合) 数据块，默认接收
+     */
+    SubscriptionFilter& accept_untagged(bool accept) {
+        accept_untagged_ = accept;
+        return *this;
+    }
+
+    /**
+     * @brief 根据元数据判断是否接收
+     */
+    bool matches(const MarketBlockHeader& header) const noexcept {
+        if (types_.any() && !types_.test(static_cast<uint8_t>(header.data_type))) {
+            return false;
+        }
+        if (instrument_count_ == 0) {
+            return true;
+        }
+        if (!header.has_instrument()) {
+            return accept_untagged_;
+        }
+        return contains(header.instrument());
+    }
+
+    /**
+     * @brief 证券是否在订阅集合内 (未设置证券集合时恒为 true)
+     */
+    bool contains(uint32_t instrument_id) const noexcept {
+        if (instrument_count_ == 0) {
+            return true;
+        }
+        const size_t word = instrument_id / 64;
+        return word < instruments_.size() && (instruments_[word] >> (instrument_id % 64)) & 1;
+    }
+
+    bool accepts_all() const noexcept {
+        return instrument_count_ == 0 && types_.none();
+    }
+
+    /**
+     * @brief 订阅集合内的证券ID (升序)
+     */
+    std::vector<uint32_t> instruments() const {
+        std::vector<uint32_t> ids;
+        for (size_t word = 0; word < instruments_.size(); ++word) {
+            for (uint64_t bits = instruments_[word]; bits != 0; bits &= bits - 1) {
+                ids.push_back(static_cast<uint32_t>(word * 64 + __builtin_ctzll(bits)));
+            }
+        }
+        return ids;
+    }
+
+private:
+    std::vector<uint64_t> instruments_;     // 证券位图
+    size_t instrument_count_ = 0;           // 调用 add_instrument 的次数 (仅用于判断是否为空)
+    std::bitset<256> types_;
+    bool accept_untagged_ = true;
+};
+
+/**
+ * @brief 证券所属分区 (Fibonacci 哈希，稠密ID也能均匀分布)
+ */
+inline uint32_t instrument_partition(uint32_t instrument_id, uint32_t partition_count) noexcept {
+    if (partition_count <= 1) {
+        return 0;
+    }
+    const uint64_t hash = (static_cast<uint64_t>(instrument_id) * 0x9E3779B97F4A7C15ULL) >> 32;
+    return static_cast<uint32_t>(hash % partition_count);
+}
+
+/**
+ * @brief 分区数据流名称 ("<stream>.p<partition>")
+ */
+inline std::string partition_stream_name(const std::string& stream_name, uint32_t partition) {
+    return stream_name + ".p" + std::to_string(partition);
+}
+
+} // namespace qaultra::ipc
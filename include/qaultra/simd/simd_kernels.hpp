@@ -0,0 +1,321 @@
+#pragma once
+
+/**
+ * @file simd_kernels.hpp
+ * @brief SIMD 内核表与按指令集实例化的通用内核
+ *
+ * 每个指令集一个翻译单元 (src/simd/kernels_*.cpp)，以各自的编译选项
+ * (-msse4.2 / -mavx2 -mfma / -mavx512f，均带 -ffp-contract=off) 实例化 VectorKernels<Traits>，
+ * 导出一张 KernelTable。simd_math.cpp 启动时按 CPUID 选择一张表，之后所有调用经函数指针分派。
+ *
+ * 确定性模式下的归约 (sum / dot / centered_dot) 采用与指令集无关的固定顺序:
+ * 按 64 字节分块 (8 个 double 或 16 个 float)，块内第 k 个元素累加到第 k 条通道，
+ * 各通道逐块相加 (乘加不融合)，最后逐级对半合并 (通道 k 加上通道 k + L/2)，
+ * 不足一块的尾部按顺序累加到合并结果上。标量实现即参考顺序，各指令集的结果与其逐位一致。
+ * 快速模式使用更多累加器与 FMA，结果与参考实现只在末位舍入上不同。
+ *
+ * 注意: 本头文件中的模板都以 Traits 为参数，Traits 定义在各翻译单元的匿名命名空间中，
+ * 保证不同编译选项下的实例化不会被链接器合并。
+ */
+
+#include "simd_math.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace qaultra::simd {
+
+/**
+ * @brief 一个指令集的内核函数表
+ */
+struct KernelTable {
+    SimdLevel level;
+    size_t f64_lanes;
+    size_t f32_lanes;
+
+    // 逐元素运算 (结果与标量逐位一致)
+    void (*add_f64)(const double*, const double*, double*, size_t);
+    void (*sub_f64)(const double*, const double*, double*, size_t);
+    void (*mul_f64)(const double*, const double*, double*, size_t);
+    void (*mul_scalar_f64)(const double*, double, double*, size_t);
+    void (*add_f32)(const float*, const float*, float*, size_t);
+    void (*sub_f32)(const float*, const float*, float*, size_t);
+    void (*mul_f32)(const float*, const float*, float*, size_t);
+    void (*mul_scalar_f32)(const float*, float, float*, size_t);
+
+    // 最值 (与顺序无关；含 NaN 时结果未定义)
+    double (*min_f64)(const double*, size_t);
+    double (*max_f64)(const double*, size_t);
+    float (*min_f32)(const float*, size_t);
+    float (*max_f32)(const float*, size_t);
+
+    // 归约 (快速模式)
+    double (*sum_f64)(const double*, size_t);
+    double (*dot_f64)(const double*, const double*, size_t);
+    double (*centered_dot_f64)(const double*, const double*, size_t, double, double);
+    float (*sum_f32)(const float*, size_t);
+    float (*dot_f32)(const float*, const float*, size_t);
+    float (*centered_dot_f32)(const float*, const float*, size_t, float, float);
+
+    // 归约 (确定性模式)
+    double (*sum_f64_det)(const double*, size_t);
+    double (*dot_f64_det)(const double*, const double*, size_t);
+    double (*centered_dot_f64_det)(const double*, const double*, size_t, double, double);
+    float (*sum_f32_det)(const float*, size_t);
+    float (*dot_f32_det)(const float*, const float*, size_t);
+    float (*centered_dot_f32_det)(const float*, const float*, size_t, float, float);
+};
+
+/**
+ * @brief 各指令集的内核表 (该指令集未编译进本构建时返回 nullptr)
+ *
+ * 这些函数本身以对应指令集编译，只能在 CPUID 确认支持后调用 (由 simd_math.cpp 负责)。
+ */
+const KernelTable* scalar_kernels();
+const KernelTable* sse42_kernels();
+const KernelTable* avx2_kernels();
+const KernelTable* avx512_kernels();
+
+/**
+ * @brief 当前生效的内核表
+ */
+const KernelTable& active_kernels();
+
+namespace detail {
+
+/**
+ * @brief 通用向量内核
+ *
+ * Traits 需提供: value_type, reg, LANES, load(p), store(p, r), set1(x), zero(),
+ * add, sub, mul, fmadd(a, b, c) = a*b+c, min, max。标量 Traits 的 reg 即 value_type。
+ */
+template <typename Traits>
+struct VectorKernels {
+    using T = typename Traits::value_type;
+    using R = typename Traits::reg;
+    static constexpr size_t W = Traits::LANES;
+    static constexpr size_t DET_LANES = 64 / sizeof(T);          // 确定性归约的通道数
+    static constexpr size_t DET_REGS = DET_LANES / W;
+    static constexpr size_t FAST_REGS = 4;
+
+    static_assert(DET_LANES % W == 0, "vector width must divide the deterministic block");
+
+    template <typename VectorOp, typename ScalarOp>
+    static void elementwise(const T* a, const T* b, T* out, size_t n, VectorOp op, ScalarOp scalar_op) {
+        size_t i = 0;
+        for (; i + W <= n; i += W) {
+            Traits::store(out + i, op(Traits::load(a + i), Traits::load(b + i)));
+        }
+        for (; i < n; ++i) {
+            // 尾部逐个元素处理: 标量运算与向量通道的 IEEE 结果相同
+            out[i] = scalar_op(a[i], b[i]);
+        }
+    }
+
+    static void add(const T* a, const T* b, T* out, size_t n) {
+        elementwise(a, b, out, n, [](R x, R y) { return Traits::add(x, y); }, [](T x, T y) { return x + y; });
+    }
+    static void sub(const T* a, const T* b, T* out, size_t n) {
+        elementwise(a, b, out, n, [](R x, R y) { return Traits::sub(x, y); }, [](T x, T y) { return x - y; });
+    }
+    static void mul(const T* a, const T* b, T* out, size_t n) {
+        elementwise(a, b, out, n, [](R x, R y) { return Traits::mul(x, y); }, [](T x, T y) { return x * y; });
+    }
+
+    static void mul_scalar(const T* a, T scalar, T* out, size_t n) {
+        const R s = Traits::set1(scalar);
+        size_t i = 0;
+        for (; i + W <= n; i += W) {
+            Traits::store(out + i, Traits::mul(Traits::load(a + i), s));
+        }
+        for (; i < n; ++i) {
+            out[i] = a[i] * scalar;
+        }
+    }
+
+    template <bool IsMax>
+    static T extreme(const T* data, size_t n) {
+        if (n == 0) {
+            return T(0);
+        }
+        size_t i = 0;
+        T best = data[0];
+        if (n >= W) {
+            R acc = Traits::load(data);
+            for (i = W; i + W <= n; i += W) {
+                acc = IsMax ? Traits::max(acc, Traits::load(data + i)) : Traits::min(acc, Traits::load(data + i));
+            }
+            T lanes[W];
+            Traits::store(lanes, acc);
+            best = lanes[0];
+            for (size_t k = 1; k < W; ++k) {
+                best = IsMax ? (lanes[k] > best ? lanes[k] : best) : (lanes[k] < best ? lanes[k] : best);
+            }
+        }
+        for (; i < n; ++i) {
+            best = IsMax ? (data[i] > best ? data[i] : best) : (data[i] < best ? data[i] : best);
+        }
+        return best;
+    }
+
+    static T min(const T* data, size_t n) { return extreme<false>(data, n); }
+    static T max(const T* data, size_t n) { return extreme<true>(data, n); }
+
+    /**
+     * @brief 按固定树形顺序合并 count 个通道 (count 为 2 的幂)
+     */
+    static T combine(T* lanes, size_t count) {
+        for (size_t half = count / 2; half > 0; half /= 2) {
+            for (size_t k = 0; k < half; ++k) {
+                lanes[k] = lanes[k] + lanes[k + half];
+            }
+        }
+        return lanes[0];
+    }
+
+    /**
+     * @brief 确定性归约: term(i) 返回从第 i 个元素开始的 W 个项，scalar_term(i) 为单个项
+     */
+    template <typename Term, typename ScalarTerm>
+    static T reduce_deterministic(size_t n, Term term, ScalarTerm scalar_term) {
+        R acc[DET_REGS];
+        for (size_t r = 0; r < DET_REGS; ++r) {
+            acc[r] = Traits::zero();
+        }
+        const size_t blocks = n / DET_LANES;
+        for (size_t b = 0; b < blocks; ++b) {
+            const size_t base = b * DET_LANES;
+            for (size_t r = 0; r < DET_REGS; ++r) {
+                acc[r] = Traits::add(acc[r], term(base + r * W));
+            }
+        }
+        T lanes[DET_LANES];
+        for (size_t r = 0; r < DET_REGS; ++r) {
+            Traits::store(lanes + r * W, acc[r]);
+        }
+        T total = combine(lanes, DET_LANES);
+        for (size_t i = blocks * DET_LANES; i < n; ++i) {
+            total = total + scalar_term(i);
+        }
+        return total;
+    }
+
+    /**
+     * @brief 快速归约: FAST_REGS 个向量累加器，step(acc, i) 把第 i 个元素起的 W 项累加进 acc
+     */
+    template <typename Step, typename ScalarStep>
+    static T reduce_fast(size_t n, Step step, ScalarStep scalar_step) {
+        R acc[FAST_REGS];
+        for (size_t r = 0; r < FAST_REGS; ++r) {
+            acc[r] = Traits::zero();
+        }
+        size_t i = 0;
+        for (; i + FAST_REGS * W <= n; i += FAST_REGS * W) {
+            for (size_t r = 0; r < FAST_REGS; ++r) {
+                acc[r] = step(acc[r], i + r * W);
+            }
+        }
+        for (; i + W <= n; i += W) {
+            acc[0] = step(acc[0], i);
+        }
+        acc[0] = Traits::add(Traits::add(acc[0], acc[1]), Traits::add(acc[2], acc[3]));
+        T lanes[W];
+        Traits::store(lanes, acc[0]);
+        T total = W > 1 ? combine(lanes, W) : lanes[0];
+        for (; i < n; ++i) {
+            total = scalar_step(total, i);
+        }
+        return total;
+    }
+
+    static T sum(const T* x, size_t n) {
+        return reduce_fast(
+            n, [x](R acc, size_t i) { return Traits::add(acc, Traits::load(x + i)); },
+            [x](T total, size_t i) { return total + x[i]; });
+    }
+
+    static T dot(const T* x, const T* y, size_t n) {
+        return reduce_fast(
+            n, [x, y](R acc, size_t i) { return Traits::fmadd(Traits::load(x + i), Traits::load(y + i), acc); },
+            [x, y](T total, size_t i) { return total + x[i] * y[i]; });
+    }
+
+    static T centered_dot(const T* x, const T* y, size_t n, T mx, T my) {
+        const R vx = Traits::set1(mx);
+        const R vy = Traits::set1(my);
+        return reduce_fast(
+            n,
+            [=](R acc, size_t i) {
+                return Traits::fmadd(Traits::sub(Traits::load(x + i), vx), Traits::sub(Traits::load(y + i), vy), acc);
+            },
+            [=](T total, size_t i) { return total + (x[i] - mx) * (y[i] - my); });
+    }
+
+    static T sum_det(const T* x, size_t n) {
+        return reduce_deterministic(
+            n, [x](size_t i) { return Traits::load(x + i); }, [x](size_t i) { return x[i]; });
+    }
+
+    static T dot_det(const T* x, const T* y, size_t n) {
+        return reduce_deterministic(
+            n, [x, y](size_t i) { return Traits::mul(Traits::load(x + i), Traits::load(y + i)); },
+            [x, y](size_t i) { return x[i] * y[i]; });
+    }
+
+    static T centered_dot_det(const T* x, const T* y, size_t n, T mx, T my) {
+        const R vx = Traits::set1(mx);
+        const R vy = Traits::set1(my);
+        return reduce_deterministic(
+            n,
+            [=](size_t i) {
+                return Traits::mul(Traits::sub(Traits::load(x + i), vx), Traits::sub(Traits::load(y + i), vy));
+            },
+            [=](size_t i) { return (x[i] - mx) * (y[i] - my); });
+    }
+};
+
+/**
+ * @brief 由 double / float 两组 Traits 组装内核表
+ */
+template <typename F64, typename F32>
+KernelTable make_kernel_table(SimdLevel level) {
+    using D = VectorKernels<F64>;
+    using S = VectorKernels<F32>;
+    KernelTable table{};
+    table.level = level;
+    table.f64_lanes = F64::LANES;
+    table.f32_lanes = F32::LANES;
+
+    table.add_f64 = &D::add;
+    table.sub_f64 = &D::sub;
+    table.mul_f64 = &D::mul;
+    table.mul_scalar_f64 = &D::mul_scalar;
+    table.add_f32 = &S::add;
+    table.sub_f32 = &S::sub;
+    table.mul_f32 = &S::mul;
+    table.mul_scalar_f32 = &S::mul_scalar;
+
+    table.min_f64 = &D::min;
+    table.max_f64 = &D::max;
+    table.min_f32 = &S::min;
+    table.max_f32 = &S::max;
+
+    table.sum_f64 = &D::sum;
+    table.dot_f64 = &D::dot;
+    table.centered_dot_f64 = &D::centered_dot;
+    table.sum_f32 = &S::sum;
+    table.dot_f32 = &S::dot;
+    table.centered_dot_f32 = &S::centered_dot;
+
+    table.sum_f64_det = &D::sum_det;
+    table.dot_f64_det = &D::dot_det;
+    table.centered_dot_f64_det = &D::centered_dot_det;
+    table.sum_f32_det = &S::sum_det;
+    table.dot_f32_det = &S::dot_det;
+    table.centered_dot_f32_det = &S::centered_dot_det;
+    return table;
+}
+
+} // namespace detail
+
+} // namespace qaultra::simd
@@ -1,29 +1,20 @@
 #pragma once
 
-#include <cstddef>
-#include <vector>
 #include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
 
-#ifdef QAULTRA_ENABLE_SIMD
-#include <immintrin.h>
-#ifdef __AVX512F__
-#define QAULTRA_SIMD_WIDTH 512
+/// Kernels are selected at runtime (see SimdLevel), so buffers are aligned for the widest ISA.
 #define QAULTRA_SIMD_ALIGNMENT 64
-#elif __AVX2__
-#define QAULTRA_SIMD_WIDTH 256
-#define QAULTRA_SIMD_ALIGNMENT 32
-#elif __SSE4_2__
-#define QAULTRA_SIMD_WIDTH 128
-#define QAULTRA_SIMD_ALIGNMENT 16
-#else
-#define QAULTRA_SIMD_WIDTH 64
-#define QAULTRA_SIMD_ALIGNMENT 8
-#endif
-#else
-#define QAULTRA_SIMD_WIDTH 64
-#define QAULTRA_SIMD_ALIGNMENT 8
-#endif
 
 namespace qaultra::simd {
 
@@ -91,7 +82,36 @@ using f32_vector = aligned_vector<float>;
 using i64_vector = aligned_vector<int64_t>;
 using i32_vector = aligned_vector<int32_t>;
 
+/// Instruction set of the active kernels
+enum class SimdLevel : uint8_t {
+    Scalar = 0,
+    SSE42 = 1,
+    AVX2 = 2,      ///< AVX2 + FMA
+    AVX512 = 3     ///< AVX-512F
+};
+
+/// Best level supported by both this build and the host CPU (CPUID, detected once)
+SimdLevel detected_simd_level();
+
+/// Level of the kernels in use; defaults to detected_simd_level() or QAULTRA_SIMD_LEVEL
+/// (scalar / sse4.2 / avx2 / avx512) from the environment
+SimdLevel active_simd_level();
+
+/// Switch kernels; returns false if the level exceeds detected_simd_level()
+bool set_simd_level(SimdLevel level);
+
+const char* simd_level_name(SimdLevel level);
+
+/// Deterministic mode: sum / dot_product / std_dev and every reduction built on them
+/// return results bit-for-bit identical to the scalar kernels on every level
+/// (fixed 64-byte lane blocking, no FMA). Off by default, or QAULTRA_SIMD_DETERMINISTIC=1.
+void set_simd_deterministic(bool enabled);
+bool simd_deterministic();
+
 /// SIMD math operations
+///
+/// Window-based outputs are NaN until the window is full; returns / log_returns /
+/// price_change / price_change_percent write size - 1 values.
 class SimdMath {
 public:
     /// Vector addition with SIMD optimization
@@ -156,45 +176,9 @@ public:
                     double* histogram, size_t size, size_t fast_period = 12,
                     size_t slow_period = 26, size_t signal_period = 9);
 
-private:
-    /// Internal SIMD implementation helpers
-    static constexpr size_t get_simd_stride() {
-#ifdef QAULTRA_ENABLE_SIMD
-#ifdef __AVX512F__
-        return 8; // 512 bits / 64 bits = 8 doubles
-#elif __AVX2__
-        return 4; // 256 bits / 64 bits = 4 doubles
-#elif __SSE4_2__
-        return 2; // 128 bits / 64 bits = 2 doubles
-#else
-        return 1;
-#endif
-#else
-        return 1;
-#endif
-    }
-
-    static constexpr size_t get_simd_stride_f32() {
-#ifdef QAULTRA_ENABLE_SIMD
-#ifdef __AVX512F__
-        return 16; // 512 bits / 32 bits = 16 floats
-#elif __AVX2__
-        return 8;  // 256 bits / 32 bits = 8 floats
-#elif __SSE4_2__
-        return 4;  // 128 bits / 32 bits = 4 floats
-#else
-        return 1;
-#endif
-#else
-        return 1;
-#endif
-    }
-
-    /// Fallback implementations for non-SIMD systems
-    static void add_fallback(const double* a, const double* b, double* result, size_t size);
-    static void multiply_fallback(const double* a, const double* b, double* result, size_t size);
-    static double dot_product_fallback(const double* a, const double* b, size_t size);
-    static double sum_fallback(const double* data, size_t size);
+    /// Vector width (in elements) of the active kernels
+    static size_t get_simd_stride();
+    static size_t get_simd_stride_f32();
 };
 
 /// High-performance financial calculation utilities
@@ -245,51 +229,208 @@ public:
     static double sortino_ratio(const double* returns, size_t size, double target_return = 0.0);
 };
 
-/// Memory-mapped file for zero-copy data access
+/// Access-pattern hints forwarded to madvise
+enum class MemoryAdvice {
+    Normal,
+    Sequential,     ///< Aggressive read-ahead; pages can be dropped soon after use (streaming backtests)
+    Random,         ///< No read-ahead (point lookups)
+    WillNeed,       ///< Start paging the range in the background
+    DontNeed        ///< Drop the range from the page cache (file-backed mappings only)
+};
+
+/// Mapping options for MemoryMappedArray
+struct MemoryMapOptions {
+    bool huge_pages = false;    ///< In-memory: try MAP_HUGETLB, else transparent huge pages; files: THP hint only
+    bool read_only = false;     ///< File mappings only; resize/reserve throw
+    bool populate = false;      ///< Pre-fault the whole mapping (MAP_POPULATE)
+    MemoryAdvice advice = MemoryAdvice::Normal;   ///< Re-applied after every remap
+};
+
+/// Non-owning typed view over contiguous elements
 template<typename T>
-class MemoryMappedArray {
+class ArrayView {
+public:
+    ArrayView() = default;
+    ArrayView(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    T* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    T& operator[](size_t index) const noexcept { return data_[index]; }
+    T* begin() const noexcept { return data_; }
+    T* end() const noexcept { return data_ + size_; }
+
+    /// Clamped to the view
+    ArrayView subview(size_t offset, size_t count) const noexcept {
+        offset = offset < size_ ? offset : size_;
+        return ArrayView(data_ + offset, count < size_ - offset ? count : size_ - offset);
+    }
+
 private:
-    void* mapped_memory_ = nullptr;
+    T* data_ = nullptr;
     size_t size_ = 0;
-    size_t capacity_ = 0;
-    int fd_ = -1;
+};
+
+namespace detail {
+
+/// Byte-level mapping shared by every MemoryMappedArray<T> (src/simd/memory_map.cpp)
+struct Mapping {
+    void* memory = nullptr;
+    size_t bytes = 0;           ///< Mapped length; for files also the current file length
+    int fd = -1;
+    bool huge_tlb = false;      ///< Backed by MAP_HUGETLB pages
+};
+
+constexpr size_t KEEP_FILE_LENGTH = static_cast<size_t>(-1);
+
+/// Zero-filled anonymous mapping of at least `bytes`; throws std::runtime_error
+Mapping map_anonymous(size_t bytes, const MemoryMapOptions& options);
+
+/// Open (creating unless read-only) and map a file, resized to `bytes` unless KEEP_FILE_LENGTH
+Mapping map_file(const std::string& filename, size_t bytes, const MemoryMapOptions& options);
+
+/// Grow the mapping (and the file) to at least `bytes`; mremap where available, else map + copy
+void grow(Mapping& mapping, size_t bytes, const MemoryMapOptions& options);
+
+/// Unmap, trim a writable file to `used_bytes` and close it
+void release(Mapping& mapping, size_t used_bytes, const MemoryMapOptions& options) noexcept;
+
+bool flush(const Mapping& mapping, size_t bytes);
+bool advise(const Mapping& mapping, size_t offset, size_t bytes, MemoryAdvice advice);
+
+} // namespace detail
+
+/// Memory-mapped array for out-of-core time series (file-backed or anonymous)
+///
+/// Growth remaps geometrically (mremap on Linux), so pointers and views are invalidated by
+/// resize/reserve/push_back. Capacity beyond size() is always zero. A file-backed array keeps
+/// the file length at size() * sizeof(T) once unmapped.
+template<typename T>
+class MemoryMappedArray {
+    static_assert(std::is_trivially_copyable<T>::value, "MemoryMappedArray requires trivially copyable elements");
 
 public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
     MemoryMappedArray() = default;
 
-    /// Create memory-mapped array from file
-    explicit MemoryMappedArray(const std::string& filename);
+    /// Map a file (created empty unless read-only); size() is the file length / sizeof(T)
+    explicit MemoryMappedArray(const std::string& filename, const MemoryMapOptions& options = {})
+        : mapping_(detail::map_file(filename, detail::KEEP_FILE_LENGTH, options))
+        , size_(mapping_.bytes / sizeof(T))
+        , options_(options) {}
 
-    /// Create memory-mapped array in memory
-    explicit MemoryMappedArray(size_t size);
+    /// Map a file resized to `size` elements (new elements are zero)
+    MemoryMappedArray(const std::string& filename, size_t size, const MemoryMapOptions& options = {})
+        : mapping_(detail::map_file(filename, size * sizeof(T), options))
+        , size_(size)
+        , options_(options) {}
 
-    ~MemoryMappedArray();
+    /// Create a zero-filled in-memory array
+    explicit MemoryMappedArray(size_t size, const MemoryMapOptions& options = {})
+        : mapping_(detail::map_anonymous(size * sizeof(T), options))
+        , size_(size)
+        , options_(options) {}
+
+    ~MemoryMappedArray() { unmap(); }
 
     // Non-copyable but movable
     MemoryMappedArray(const MemoryMappedArray&) = delete;
     MemoryMappedArray& operator=(const MemoryMappedArray&) = delete;
 
-    MemoryMappedArray(MemoryMappedArray&& other) noexcept;
-    MemoryMappedArray& operator=(MemoryMappedArray&& other) noexcept;
+    MemoryMappedArray(MemoryMappedArray&& other) noexcept
+        : mapping_(other.mapping_), size_(other.size_), options_(other.options_) {
+        other.mapping_ = detail::Mapping();
+        other.size_ = 0;
+    }
+
+    MemoryMappedArray& operator=(MemoryMappedArray&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            mapping_ = other.mapping_;
+            size_ = other.size_;
+            options_ = other.options_;
+            other.mapping_ = detail::Mapping();
+            other.size_ = 0;
+        }
+        return *this;
+    }
 
     /// Access elements
-    T& operator[](size_t index) noexcept { return static_cast<T*>(mapped_memory_)[index]; }
-    const T& operator[](size_t index) const noexcept { return static_cast<const T*>(mapped_memory_)[index]; }
+    T& operator[](size_t index) noexcept { return data()[index]; }
+    const T& operator[](size_t index) const noexcept { return data()[index]; }
 
     /// Get raw pointer
-    T* data() noexcept { return static_cast<T*>(mapped_memory_); }
-    const T* data() const noexcept { return static_cast<const T*>(mapped_memory_); }
+    T* data() noexcept { return static_cast<T*>(mapping_.memory); }
+    const T* data() const noexcept { return static_cast<const T*>(mapping_.memory); }
 
     /// Size operations
     size_t size() const noexcept { return size_; }
-    size_t capacity() const noexcept { return capacity_; }
+    size_t capacity() const noexcept { return mapping_.bytes / sizeof(T); }
     bool empty() const noexcept { return size_ == 0; }
+    bool file_backed() const noexcept { return mapping_.fd >= 0; }
+    bool huge_pages() const noexcept { return mapping_.huge_tlb; }
 
-    /// Resize (only works for in-memory arrays)
-    void resize(size_t new_size);
+    /// Resize; growing past capacity remaps to max(new_size, 2 * capacity)
+    void resize(size_t new_size) {
+        if (options_.read_only) {
+            throw std::runtime_error("MemoryMappedArray is read-only");
+        }
+        if (new_size > capacity()) {
+            reserve(new_size > 2 * capacity() ? new_size : 2 * capacity());
+        } else if (new_size < size_) {
+            std::memset(static_cast<void*>(data() + new_size), 0, (size_ - new_size) * sizeof(T));
+        }
+        size_ = new_size;
+    }
+
+    /// Grow the mapping (and file) without changing size()
+    void reserve(size_t new_capacity) {
+        if (options_.read_only) {
+            throw std::runtime_error("MemoryMappedArray is read-only");
+        }
+        if (new_capacity > capacity()) {
+            detail::grow(mapping_, new_capacity * sizeof(T), options_);
+        }
+    }
+
+    void push_back(const T& value) {
+        const T copy = value;    // value may live in the mapping being moved
+        if (size_ == capacity()) {
+            reserve(size_ == 0 ? 1 : 2 * size_);
+        }
+        data()[size_++] = copy;
+    }
+
+    /// Flush changes to disk (msync); no-op for in-memory or read-only arrays
+    bool flush() { return options_.read_only || detail::flush(mapping_, size_ * sizeof(T)); }
+
+    /// madvise hint for elements [offset, offset + count)
+    bool advise(MemoryAdvice advice, size_t offset = 0, size_t count = npos) const {
+        const ArrayView<const T> range = view(offset, count);
+        return detail::advise(mapping_, offset * sizeof(T), range.size() * sizeof(T), advice);
+    }
 
-    /// Flush changes to disk
-    void flush();
+    /// Typed views over [offset, offset + count), clamped to size()
+    ArrayView<T> view(size_t offset = 0, size_t count = npos) noexcept {
+        return ArrayView<T>(data(), size_).subview(offset, count);
+    }
+    ArrayView<const T> view(size_t offset = 0, size_t count = npos) const noexcept {
+        return ArrayView<const T>(data(), size_).subview(offset, count);
+    }
+
+    /// Reinterpret `count` elements of U starting at `byte_offset` (e.g. one column of a file of records)
+    template<typename U>
+    ArrayView<U> view_as(size_t byte_offset, size_t count) const {
+        static_assert(std::is_trivially_copyable<U>::value, "view_as requires trivially copyable elements");
+        const size_t used = size_ * sizeof(T);
+        if (byte_offset % alignof(U) != 0 || byte_offset > used || count > (used - byte_offset) / sizeof(U)) {
+            throw std::out_of_range("MemoryMappedArray::view_as range is misaligned or out of bounds");
+        }
+        auto* bytes = static_cast<unsigned char*>(mapping_.memory);
+        return ArrayView<U>(reinterpret_cast<U*>(bytes + byte_offset), count);
+    }
 
     /// Iterator support
     T* begin() noexcept { return data(); }
@@ -298,7 +439,14 @@ public:
     const T* end() const noexcept { return data() + size_; }
 
 private:
-    void unmap();
+    detail::Mapping mapping_;
+    size_t size_ = 0;
+    MemoryMapOptions options_;
+
+    void unmap() noexcept {
+        detail::release(mapping_, size_ * sizeof(T), options_);
+        size_ = 0;
+    }
 };
 
 /// Lock-free ring buffer for high-frequency data
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace qaultra::util {
+
+/**
+ * @brief 定长日期时间解析/格式化 - 回测热路径使用，不经过 iostream/strftime/时区
+ *
+ * 支持的格式:
+ *   "YYYY-MM-DD"
+ *   "YYYY-MM-DD HH:MM:SS[.fffffffff]" (日期与时间之间也可为 'T')
+ *
+ * 所有时间戳按UTC民用时间解释 (与 Arrow timestamp 列的无时区口径一致)，
+ * 日期索引为自1970-01-01起的天数。
+ */
+namespace datetime {
+
+constexpr int64_t NANOS_PER_SECOND = 1000000000LL;
+constexpr int64_t NANOS_PER_DAY = 86400LL * NANOS_PER_SECOND;
+constexpr int64_t MICROS_PER_DAY = 86400LL * 1000000LL;
+
+namespace detail {
+
+constexpr int TABLE_FIRST_YEAR = 1900;
+constexpr int TABLE_YEARS = 256;
+
+constexpr bool is_leap(int64_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+/**
+ * @brief 通用民用日期 -> 天数 (proleptic Gregorian，表外年份使用)
+ */
+constexpr int64_t days_from_civil_slow(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+/**
+ * @brief 年初天数表: YEAR_START[i] 为 (1900+i)-01-01 的天数，多一项作为上界
+ */
+constexpr std::array<int32_t, TABLE_YEARS + 1> make_year_start() {
+    std::array<int32_t, TABLE_YEARS + 1> table{};
+    int64_t days = days_from_civil_slow(TABLE_FIRST_YEAR, 1, 1);
+    for (int i = 0; i <= TABLE_YEARS; ++i) {
+        table[i] = static_cast<int32_t>(days);
+        days += is_leap(TABLE_FIRST_YEAR + i) ? 366 : 365;
+    }
+    return table;
+}
+
+inline constexpr std::array<int32_t, TABLE_YEARS + 1> YEAR_START = make_year_start();
+
+/**
+ * @brief 月初年内天数: MONTH_START[leap][m] (m 为 0..12)
+ */
+inline constexpr uint16_t MONTH_START[2][13] = {
+    {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365},
+    {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366},
+};
+
+/**
+ * @brief 年内天数 -> 月份 (0..11)
+ */
+constexpr std::array<std::array<uint8_t, 366>, 2> make_month_of_day() {
+    std::array<std::array<uint8_t, 366>, 2> table{};
+    for (int leap = 0; leap < 2; ++leap) {
+        for (int month = 0; month < 12; ++month) {
+            for (int day = MONTH_START[leap][month]; day < MONTH_START[leap][month + 1]; ++day) {
+                table[leap][day] = static_cast<uint8_t>(month);
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr std::array<std::array<uint8_t, 366>, 2> MONTH_OF_DAY = make_month_of_day();
+
+/**
+ * @brief "00".."99" 两位数字表
+ */
+constexpr std::array<char, 200> make_two_digits() {
+    std::array<char, 200> table{};
+    for (int i = 0; i < 100; ++i) {
+        table[i * 2] = static_cast<char>('0' + i / 10);
+        table[i * 2 + 1] = static_cast<char>('0' + i % 10);
+    }
+    return table;
+}
+
+inline constexpr std::array<char, 200> TWO_DIGITS = make_two_digits();
+
+/**
+ * @brief 按小端序读取 8 字节: 字节 0 位于最低位，下方 SWAR 掩码均按此编排
+ */
+inline uint64_t load8(const char* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "datetime SWAR parsing requires a little- or big-endian target"
+#endif
+    return value;
+}
+
+/**
+ * @brief SWAR: 8字节中 digit_mask 指定的字节是否全部为 '0'..'9' (小端)
+ */
+inline bool all_digits(uint64_t chunk, uint64_t digit_mask) {
+    const uint64_t high = digit_mask & 0x8080808080808080ULL;
+    const uint64_t lanes = chunk & digit_mask;
+    const uint64_t above = lanes + (0x4646464646464646ULL & digit_mask);   // > '9' 时置高位
+    const uint64_t below = lanes + (0x5050505050505050ULL & digit_mask);   // >= '0' 时置高位
+    return ((chunk & high) == 0) && (((above | ~below) & high) == 0);
+}
+
+/**
+ * @brief SWAR: 相邻两字节合并为两位十进制数，结果位于每对的低字节
+ */
+inline uint64_t pair_values(uint64_t chunk, uint64_t digit_mask) {
+    const uint64_t digits = (chunk & digit_mask) - (0x3030303030303030ULL & digit_mask);
+    return digits * 10 + (digits >> 8);
+}
+
+inline unsigned lane(uint64_t value, int index) {
+    return static_cast<unsigned>((value >> (index * 8)) & 0xFF);
+}
+
+inline void write2(char* out, unsigned value) {
+    std::memcpy(out, &TWO_DIGITS[value * 2], 2);
+}
+
+} // namespace detail
+
+/**
+ * @brief 民用日期 -> 自1970-01-01起的天数 (1900..2155 查表，其余年份公式计算)
+ */
+inline int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+    const int64_t index = year - detail::TABLE_FIRST_YEAR;
+    if (index < 0 || index >= detail::TABLE_YEARS || month < 1 || month > 12) {
+        return detail::days_from_civil_slow(year, month, day);
+    }
+    return static_cast<int64_t>(detail::YEAR_START[index]) +
+           detail::MONTH_START[detail::is_leap(year)][month - 1] + static_cast<int64_t>(day) - 1;
+}
+
+/**
+ * @brief 天数 -> 民用日期
+ */
+inline void civil_from_days(int64_t days, int& year, unsigned& month, unsigned& day) {
+    if (days >= detail::YEAR_START.front() && days < detail::YEAR_START.back()) {
+        // 按平均年长估计年份，再用年初表修正 (至多一步)
+        int64_t index = (days - detail::YEAR_START.front()) * 400 / 146097;
+        if (days >= detail::YEAR_START[index + 1]) {
+            ++index;
+        } else if (days < detail::YEAR_START[index]) {
+            --index;
+        }
+        year = static_cast<int>(detail::TABLE_FIRST_YEAR + index);
+        const int leap = detail::is_leap(year);
+        const int64_t doy = days - detail::YEAR_START[index];
+        const unsigned m = detail::MONTH_OF_DAY[leap][doy];
+        month = m + 1;
+        day = static_cast<unsigned>(doy - detail::MONTH_START[leap][m] + 1);
+        return;
+    }
+
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(static_cast<int64_t>(yoe) + era * 400 + (month <= 2));
+}
+
+/**
+ * @brief 解析 "YYYY-MM-DD" 为天数
+ */
+inline bool parse_date_days(std::string_view text, int64_t& days) {
+    if (text.size() < 10) {
+        return false;
+    }
+    // "YYYY-MM-": 数字位于字节 0-3、5-6，分隔符位于 4、7
+    constexpr uint64_t digit_mask = 0x00FFFF00FFFFFFFFULL;
+    constexpr uint64_t separators = (uint64_t('-') << 32) | (uint64_t('-') << 56);
+    const uint64_t head = detail::load8(text.data());
+    const unsigned d1 = static_cast<unsigned>(text[8] - '0');
+    const unsigned d2 = static_cast<unsigned>(text[9] - '0');
+    if ((head & ~digit_mask) != separators || !detail::all_digits(head, digit_mask) || d1 > 9 || d2 > 9) {
+        return false;
+    }
+
+    const uint64_t pairs = detail::pair_values(head, digit_mask);
+    const int year = static_cast<int>(detail::lane(pairs, 0) * 100 + detail::lane(pairs, 2));
+    const unsigned month = detail::lane(pairs, 5);
+    const unsigned day = d1 * 10 + d2;
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+    days = days_from_civil(year, month, day);
+    return true;
+}
+
+/**
+ * @brief 解析日期或日期时间为纳秒时间戳
+ */
+inline bool parse_datetime_nanos(std::string_view text, int64_t& nanos) {
+    int64_t days = 0;
+    if (!parse_date_days(text, days)) {
+        return false;
+    }
+    int64_t seconds = days * 86400;
+    int64_t fraction = 0;
+
+    if (text.size() >= 19) {
+        if (text[10] != ' ' && text[10] != 'T') {
+            return false;
+        }
+        // "HH:MM:SS": 数字位于字节 0-1、3-4、6-7，分隔符位于 2、5
+        constexpr uint64_t digit_mask = 0xFFFF00FFFF00FFFFULL;
+        constexpr uint64_t separators = (uint64_t(':') << 16) | (uint64_t(':') << 40);
+        const uint64_t clock = detail::load8(text.data() + 11);
+        if ((clock & ~digit_mask) != separators || !detail::all_digits(clock, digit_mask)) {
+            return false;
+        }
+        const uint64_t pairs = detail::pair_values(clock, digit_mask);
+        const unsigned hour = detail::lane(pairs, 0);
+        const unsigned minute = detail::lane(pairs, 3);
+        const unsigned second = detail::lane(pairs, 6);
+        if (hour > 23 || minute > 59 || second > 60) {   // 允许闰秒 60
+            return false;
+        }
+        seconds += static_cast<int64_t>(hour * 3600 + minute * 60 + second);
+
+        // 可选小数秒 (最多9位)
+        if (text.size() > 20 && text[19] == '.') {
+            int64_t scale = NANOS_PER_SECOND / 10;
+            for (size_t i = 20; i < text.size() && scale > 0; ++i, scale /= 10) {
+                const unsigned digit = static_cast<unsigned>(text[i] - '0');
+                if (digit > 9) {
+                    break;
+                }
+                fraction += digit * scale;
+            }
+        }
+    } else if (text.size() != 10) {
+        return false;
+    }
+
+    nanos = seconds * NANOS_PER_SECOND + fraction;
+    return true;
+}
+
+/**
+ * @brief 解析失败时返回0的便捷版本
+ */
+inline int64_t parse_datetime_nanos(std::string_view text) {
+    int64_t nanos = 0;
+    return parse_datetime_nanos(text, nanos) ? nanos : 0;
+}
+
+inline int64_t parse_date_days(std::string_view text) {
+    int64_t days = 0;
+    return parse_date_days(text, days) ? days : 0;
+}
+
+/**
+ * @brief 纳秒时间戳所在日 (向下取整，支持1970年之前)
+ */
+inline int64_t days_from_nanos(int64_t nanos) {
+    const int64_t days = nanos / NANOS_PER_DAY;
+    return (nanos % NANOS_PER_DAY < 0) ? days - 1 : days;
+}
+
+/**
+ * @brief 写出 "YYYY-MM-DD" (10字节，不含结尾0)
+ */
+inline void format_date(int64_t days, char* out) {
+    int year = 0;
+    unsigned month = 0, day = 0;
+    civil_from_days(days, year, month, day);
+    const unsigned y = static_cast<unsigned>(year) % 10000;
+    detail::write2(out, y / 100);
+    detail::write2(out + 2, y % 100);
+    out[4] = '-';
+    detail::write2(out + 5, month);
+    out[7] = '-';
+    detail::write2(out + 8, day);
+}
+
+/**
+ * @brief 写出 "YYYY-MM-DD HH:MM:SS" (19字节，不含结尾0)
+ */
+inline void format_datetime(int64_t nanos, char* out, char separator = ' ') {
+    const int64_t days = days_from_nanos(nanos);
+    const auto second_of_day = static_cast<unsigned>((nanos - days * NANOS_PER_DAY) / NANOS_PER_SECOND);
+    format_date(days, out);
+    out[10] = separator;
+    detail::write2(out + 11, second_of_day / 3600);
+    out[13] = ':';
+    detail::write2(out + 14, second_of_day / 60 % 60);
+    out[16] = ':';
+    detail::write2(out + 17, second_of_day % 60);
+}
+
+inline std::string format_date(int64_t days) {
+    std::string result(10, '\0');
+    format_date(days, result.data());
+    return result;
+}
+
+inline std::string format_datetime(int64_t nanos, char separator = ' ') {
+    std::string result(19, '\0');
+    format_datetime(nanos, result.data(), separator);
+    return result;
+}
+
+} // namespace datetime
+
+} // namespace qaultra::util
@@ -119,25 +119,25 @@ void bind_data_types(py::module& m) {
         .def_readwrite("macd_histogram", &arrow_data::TechnicalIndicators::macd_histogram);
 
     // Memory-mapped array for zero-copy operations
-    py::class_<memory::MemoryMappedArray<double>>(data, "MemoryMappedDoubleArray")
+    py::class_<qaultra::simd::MemoryMappedArray<double>>(data, "MemoryMappedDoubleArray")
         .def(py::init<const std::string&, size_t>(),
             "Create memory-mapped array",
             py::arg("filename"), py::arg("size"))
-        .def("__getitem__", [](const memory::MemoryMappedArray<double>& self, size_t index) {
+        .def("__getitem__", [](const qaultra::simd::MemoryMappedArray<double>& self, size_t index) {
             return self[index];
         })
-        .def("__setitem__", [](memory::MemoryMappedArray<double>& self, size_t index, double value) {
+        .def("__setitem__", [](qaultra::simd::MemoryMappedArray<double>& self, size_t index, double value) {
             self[index] = value;
         })
-        .def("size", &memory::MemoryMappedArray<double>::size)
-        .def("data", [](memory::MemoryMappedArray<double>& self) {
+        .def("size", &qaultra::simd::MemoryMappedArray<double>::size)
+        .def("data", [](qaultra::simd::MemoryMappedArray<double>& self) {
             return py::array_t<double>(
                 self.size(),
                 self.data(),
                 py::handle() // No base object needed for memory-mapped data
             );
         }, py::return_value_policy::reference_internal)
-        .def("sync", &memory::MemoryMappedArray<double>::sync,
+        .def("flush", &qaultra::simd::MemoryMappedArray<double>::flush,
             "Synchronize changes to disk");
 
     // Lock-free ring buffer for high-frequency data
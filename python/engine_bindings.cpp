@@ -4,6 +4,8 @@
 #include <pybind11/chrono.h>
 
 #include "qaultra/engine/backtest_engine.hpp"
+#include "qaultra/engine/parameter_sweep.hpp"
+#include "qaultra/engine/vectorized_backtest.hpp"
 #include "qaultra/engine/strategy.hpp"
 
 namespace py = pybind11;
@@ -57,11 +59,16 @@ void bind_engine_types(py::module& m) {
         .def_readwrite("current_date", &engine::StrategyContext::current_date)
         .def_readwrite("current_price", &engine::StrategyContext::current_price)
         .def_readwrite("account", &engine::StrategyContext::account)
-        .def_readwrite("universe", &engine::StrategyContext::universe)
-        .def("get_price", &engine::StrategyContext::get_price,
+        .def_property_readonly("universe", [](const engine::StrategyContext& context) {
+                return context.universe ? *context.universe : std::vector<std::string>();
+            })
+        .def("get_price", py::overload_cast<const std::string&>(&engine::StrategyContext::get_price, py::const_),
             "Get current price for symbol",
             py::arg("symbol"))
-        .def("get_history", &engine::StrategyContext::get_history,
+        .def("get_history", [](const engine::StrategyContext& context, const std::string& symbol,
+                               int window, const std::string& field) {
+                return context.get_history(symbol, window, field).to_vector();
+            },
             "Get historical data for symbol",
             py::arg("symbol"), py::arg("window"), py::arg("field") = "close")
         .def("get_position", &engine::StrategyContext::get_position,
@@ -168,6 +175,88 @@ void bind_engine_types(py::module& m) {
     }, "Create mean reversion strategy",
        py::arg("window"), py::arg("z_score_threshold"));
 
+    // Parameter sweep
+    py::class_<engine::ParameterRange>(engine, "ParameterRange")
+        .def(py::init<>())
+        .def(py::init([](const std::string& name, double min, double max, bool integer) {
+            return engine::ParameterRange{name, min, max, integer};
+        }), py::arg("name"), py::arg("min"), py::arg("max"), py::arg("integer") = false)
+        .def_readwrite("name", &engine::ParameterRange::name)
+        .def_readwrite("min", &engine::ParameterRange::min)
+        .def_readwrite("max", &engine::ParameterRange::max)
+        .def_readwrite("integer", &engine::ParameterRange::integer);
+
+    py::class_<engine::ParameterGrid>(engine, "ParameterGrid")
+        .def(py::init<>())
+        .def_readonly("names", &engine::ParameterGrid::names)
+        .def_readonly("values", &engine::ParameterGrid::values)
+        .def("__len__", &engine::ParameterGrid::size)
+        .def_static("cartesian", &engine::ParameterGrid::cartesian,
+            "Cartesian product of parameter axes",
+            py::arg("axes"))
+        .def_static("random", &engine::ParameterGrid::random,
+            "Uniform random samples within parameter ranges",
+            py::arg("ranges"), py::arg("samples"), py::arg("seed") = 42);
+
+    py::class_<engine::SweepResultTable>(engine, "SweepResultTable")
+        .def_readonly("parameter_names", &engine::SweepResultTable::parameter_names)
+        .def_readonly("parameters", &engine::SweepResultTable::parameters)
+        .def_readonly("total_return", &engine::SweepResultTable::total_return)
+        .def_readonly("annual_return", &engine::SweepResultTable::annual_return)
+        .def_readonly("sharpe_ratio", &engine::SweepResultTable::sharpe_ratio)
+        .def_readonly("max_drawdown", &engine::SweepResultTable::max_drawdown)
+        .def_readonly("volatility", &engine::SweepResultTable::volatility)
+        .def_readonly("win_rate", &engine::SweepResultTable::win_rate)
+        .def_readonly("profit_factor", &engine::SweepResultTable::profit_factor)
+        .def_readonly("final_value", &engine::SweepResultTable::final_value)
+        .def_readonly("total_trades", &engine::SweepResultTable::total_trades)
+        .def_readonly("completed", &engine::SweepResultTable::completed)
+        .def_readonly("errors", &engine::SweepResultTable::errors)
+        .def("__len__", &engine::SweepResultTable::size);
+
+    py::class_<engine::ParameterSweep>(engine, "ParameterSweep")
+        .def(py::init([](const engine::BacktestConfig& config, const engine::BacktestEngine& loaded) {
+            return engine::ParameterSweep(config, loaded.shared_market_data());
+        }), "Create sweep sharing the market data already loaded into an engine",
+            py::arg("config"), py::arg("engine"))
+        .def("run", [](const engine::ParameterSweep& sweep, const engine::ParameterSweep::StrategyFactory& factory,
+                       const engine::ParameterGrid& grid, size_t threads) {
+                engine::SweepOptions options;
+                options.threads = threads;
+                return sweep.run(factory, grid, options);
+            },
+            "Run one backtest per parameter point on the shared data",
+            py::arg("factory"), py::arg("grid"), py::arg("threads") = 0,
+            py::call_guard<py::gil_scoped_release>());
+
+    py::class_<engine::InstrumentCosts>(engine, "InstrumentCosts")
+        .def(py::init<>())
+        .def_readwrite("multiplier", &engine::InstrumentCosts::multiplier)
+        .def_readwrite("commission_rate", &engine::InstrumentCosts::commission_rate)
+        .def_readwrite("commission_per_volume", &engine::InstrumentCosts::commission_per_volume)
+        .def_readwrite("sell_tax_rate", &engine::InstrumentCosts::sell_tax_rate)
+        .def_static("uniform", &engine::InstrumentCosts::uniform,
+            py::arg("symbols"), py::arg("commission_rate"));
+
+    py::class_<engine::VectorizedResults, engine::BacktestResults>(engine, "VectorizedResults")
+        .def_readonly("cash", &engine::VectorizedResults::cash)
+        .def_readonly("turnover", &engine::VectorizedResults::turnover)
+        .def_readonly("costs", &engine::VectorizedResults::costs)
+        .def_readonly("holdings", &engine::VectorizedResults::holdings);
+
+    py::class_<engine::VectorizedBacktest>(engine, "VectorizedBacktest")
+        .def(py::init([](const engine::BacktestConfig& config, const engine::BacktestEngine& loaded) {
+            return engine::VectorizedBacktest(config, loaded.shared_market_data());
+        }), "Create target-weight backtest over the market data already loaded into an engine",
+            py::arg("config"), py::arg("engine"))
+        .def("set_costs", &engine::VectorizedBacktest::set_costs, py::arg("costs"))
+        .def("set_market_preset", &engine::VectorizedBacktest::set_market_preset, py::arg("preset"))
+        .def_property_readonly("costs", &engine::VectorizedBacktest::costs)
+        .def("run", &engine::VectorizedBacktest::run,
+            "Backtest a time-major (bars x symbols) target weight matrix",
+            py::arg("target_weights"), py::arg("record_holdings") = false,
+            py::call_guard<py::gil_scoped_release>());
+
     // Strategy utilities
     engine.def("calculate_sharpe_ratio", [](const std::vector<double>& returns, double risk_free_rate = 0.0) {
         if (returns.empty()) return 0.0;
@@ -0,0 +1,80 @@
+// Python bindings for broadcast latency tracing
+//
+// 共享内存环订阅器与单向延迟统计的Python接口
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include "qaultra/ipc/shm_ring.hpp"
+#include "qaultra/ipc/latency_tracker.hpp"
+
+namespace py = pybind11;
+using namespace qaultra::ipc;
+
+// Python wrapper for LatencySummary / LatencyHistogram
+void bind_latency(py::module& m) {
+    py::class_<LatencySummary>(m, "LatencySummary")
+        .def(py::init<>())
+        .def_readonly("samples", &LatencySummary::samples)
+        .def_readonly("min_ns", &LatencySummary::min_ns)
+        .def_readonly("max_ns", &LatencySummary::max_ns)
+        .def_readonly("mean_ns", &LatencySummary::mean_ns)
+        .def_readonly("p50_ns", &LatencySummary::p50_ns)
+        .def_readonly("p90_ns", &LatencySummary::p90_ns)
+        .def_readonly("p99_ns", &LatencySummary::p99_ns)
+        .def_readonly("p999_ns", &LatencySummary::p999_ns)
+        .def_readonly("negative_samples", &LatencySummary::negative_samples)
+        .def_readonly("sequence_gaps", &LatencySummary::sequence_gaps)
+        .def_readonly("missing_sequences", &LatencySummary::missing_sequences)
+        .def_readonly("out_of_order", &LatencySummary::out_of_order)
+        .def("__repr__", [](const LatencySummary& s) {
+            return "LatencySummary(samples=" + std::to_string(s.samples) +
+                   ", p50_ns=" + std::to_string(s.p50_ns) +
+                   ", p99_ns=" + std::to_string(s.p99_ns) +
+                   ", max_ns=" + std::to_string(s.max_ns) +
+                   ", sequence_gaps=" + std::to_string(s.sequence_gaps) + ")";
+        });
+
+    py::class_<LatencyHistogram>(m, "LatencyHistogram")
+        .def(py::init<>())
+        .def("record", &LatencyHistogram::record, py::arg("value_ns"))
+        .def("count", &LatencyHistogram::count)
+        .def("min", &LatencyHistogram::min)
+        .def("max", &LatencyHistogram::max)
+        .def("mean", &LatencyHistogram::mean)
+        .def("value_at_percentile", &LatencyHistogram::value_at_percentile, py::arg("percentile"))
+        .def("merge", &LatencyHistogram::merge)
+        .def("reset", &LatencyHistogram::reset);
+
+    m.def("latency_clock_ns", &latency_clock_ns,
+          "CLOCK_MONOTONIC nanoseconds (same clock as MarketBlockHeader.timestamp_ns)");
+}
+
+// Python wrapper for the shared-memory ring subscriber
+void bind_shm_subscriber(py::module& m) {
+    py::class_<BroadcastConfig>(m, "BroadcastConfig")
+        .def(py::init<>())
+        .def_readwrite("service_name", &BroadcastConfig::service_name)
+        .def_readwrite("queue_capacity", &BroadcastConfig::queue_capacity)
+        .def_readwrite("cpu_affinity", &BroadcastConfig::cpu_affinity)
+        .def_readwrite("lock_memory", &BroadcastConfig::lock_memory)
+        .def_readwrite("latency_tracking", &BroadcastConfig::latency_tracking)
+        .def_readwrite("conflation_enabled", &BroadcastConfig::conflation_enabled);
+
+    using RingSubscriber = shm::ShmRingSubscriber;
+    py::class_<RingSubscriber>(m, "ShmRingSubscriber")
+        .def(py::init<const BroadcastConfig&, const std::string&>(),
+             py::arg("config"), py::arg("stream_name") = "market_data")
+        .def("receive", [](RingSubscriber& self) -> py::object {
+            auto payload = self.receive();
+            if (!payload) {
+                return py::none();
+            }
+            return py::bytes(reinterpret_cast<const char*>(payload->data()), payload->size());
+        }, "Receive next payload (None when no message)")
+        .def("has_data", &RingSubscriber::has_data)
+        .def("is_closed", &RingSubscriber::is_closed)
+        .def("lag", &RingSubscriber::lag)
+        .def("get_latency", &RingSubscriber::get_latency,
+             "One-way latency and sequence gaps (requires config.latency_tracking)")
+        .def("reset_receive_stats", &RingSubscriber::reset_receive_stats);
+}
@@ -16,7 +16,10 @@ using namespace qaultra::data;
 void bind_kline(py::module& m) {
     py::class_<Kline>(m, "Kline")
         .def(py::init<>())
-        .def_readwrite("order_book_id", &Kline::order_book_id)
+        .def_readwrite("instrument_id", &Kline::instrument_id)
+        .def_property("order_book_id",
+            [](const Kline& k) { return k.order_book_id(); },
+            [](Kline& k, const std::string& code) { k.instrument_id = intern_instrument(code); })
         .def_readwrite("open", &Kline::open)
         .def_readwrite("high", &Kline::high)
         .def_readwrite("low", &Kline::low)
@@ -28,7 +31,7 @@ void bind_kline(py::module& m) {
         .def_readwrite("split_coefficient_to", &Kline::split_coefficient_to)
         .def_readwrite("dividend_cash_before_tax", &Kline::dividend_cash_before_tax)
         .def("__repr__", [](const Kline& k) {
-            return "Kline(id='" + k.order_book_id + "', close=" + std::to_string(k.close) + ")";
+            return "Kline(id='" + k.order_book_id() + "', close=" + std::to_string(k.close) + ")";
         });
 }
 
@@ -65,8 +68,8 @@ void bind_marketcenter(py::module& m) {
 
                 // Convert shared_ptr<const unordered_map> to Python dict
                 py::dict result;
-                for (const auto& [code, kline] : *data_shared) {
-                    result[py::str(code)] = kline;
+                for (const auto& [instrument_id, kline] : *data_shared) {
+                    result[py::str(instrument_code(instrument_id))] = kline;
                 }
                 return result;
             },
@@ -98,8 +101,8 @@ void bind_marketcenter(py::module& m) {
                 }
 
                 py::dict result;
-                for (const auto& [code, kline] : *data_shared) {
-                    result[py::str(code)] = kline;
+                for (const auto& [instrument_id, kline] : *data_shared) {
+                    result[py::str(instrument_code(instrument_id))] = kline;
                 }
                 return result;
             },
@@ -122,8 +125,8 @@ void bind_marketcenter(py::module& m) {
             [](QAMarketCenter& self, const std::string& date) -> py::dict {
                 auto data = self.get_date(date);
                 py::dict result;
-                for (const auto& [code, kline] : data) {
-                    result[py::str(code)] = kline;
+                for (const auto& [instrument_id, kline] : data) {
+                    result[py::str(instrument_code(instrument_id))] = kline;
                 }
                 return result;
             },
@@ -134,8 +137,8 @@ void bind_marketcenter(py::module& m) {
             [](QAMarketCenter& self, const std::string& datetime) -> py::dict {
                 auto data = self.get_minutes(datetime);
                 py::dict result;
-                for (const auto& [code, kline] : data) {
-                    result[py::str(code)] = kline;
+                for (const auto& [instrument_id, kline] : data) {
+                    result[py::str(instrument_code(instrument_id))] = kline;
                 }
                 return result;
             },
@@ -51,6 +51,8 @@ void bind_broadcast_stats(py::module& m) {
         .def_readwrite("total_broadcasts", &BroadcastStats::total_broadcasts)
         .def_readwrite("cache_hits", &BroadcastStats::cache_hits)
         .def_readwrite("cache_misses", &BroadcastStats::cache_misses)
+        .def_readwrite("ring_overflows", &BroadcastStats::ring_overflows)
+        .def_readwrite("reclaimed_snapshots", &BroadcastStats::reclaimed_snapshots)
         .def_readwrite("total_latency_ns", &BroadcastStats::total_latency_ns)
         .def("avg_latency_ns", &BroadcastStats::avg_latency_ns,
              "Average latency in nanoseconds")
@@ -62,6 +64,8 @@ void bind_broadcast_stats(py::module& m) {
             result["total_broadcasts"] = stats.total_broadcasts;
             result["cache_hits"] = stats.cache_hits;
             result["cache_misses"] = stats.cache_misses;
+            result["ring_overflows"] = stats.ring_overflows;
+            result["reclaimed_snapshots"] = stats.reclaimed_snapshots;
             result["total_latency_ns"] = stats.total_latency_ns;
             result["avg_latency_ns"] = stats.avg_latency_ns();
             result["cache_hit_rate"] = stats.cache_hit_rate();
@@ -74,15 +78,35 @@ void bind_broadcast_stats(py::module& m) {
         });
 }
 
-// Python wrapper for Subscriber
+// Python wrapper for TickSnapshot / Subscriber
 void bind_subscriber(py::module& m) {
-    py::class_<Subscriber>(m, "Subscriber")
-        .def(py::init<const std::string&>(), py::arg("id"))
-        .def_readwrite("id", &Subscriber::id)
-        .def_readwrite("received_count", &Subscriber::received_count)
+    py::class_<TickSnapshot>(m, "TickSnapshot")
+        .def_readonly("date", &TickSnapshot::date)
+        .def_readonly("sequence", &TickSnapshot::sequence)
+        .def_property_readonly("instrument_count", [](const TickSnapshot& snapshot) {
+            return snapshot.data ? snapshot.data->size() : size_t{0};
+        })
+        .def("__repr__", [](const TickSnapshot& snapshot) {
+            return "TickSnapshot(date=" + std::to_string(snapshot.date) +
+                   ", sequence=" + std::to_string(snapshot.sequence) + ")";
+        });
+
+    py::class_<Subscriber, std::shared_ptr<Subscriber>>(m, "Subscriber")
+        .def_property_readonly("id", &Subscriber::id)
+        .def_property_readonly("received_count", &Subscriber::received_count)
+        .def("pending", &Subscriber::pending, "Number of queued snapshots")
+        .def("poll", [](Subscriber& self, size_t max_count) {
+            std::vector<TickSnapshot> out;
+            self.poll(out, max_count);
+            return out;
+        }, py::arg("max_count") = Subscriber::DEFAULT_CAPACITY,
+           "Take queued snapshots (handles from the previous poll become invalid)")
+        .def("release", &Subscriber::release,
+             "Declare all taken snapshots unused so old data can be reclaimed")
+        .def("get_latest", &Subscriber::get_latest)
         .def("__repr__", [](const Subscriber& sub) {
-            return "Subscriber(id='" + sub.id + "', received=" +
-                   std::to_string(sub.received_count) + ")";
+            return "Subscriber(id='" + sub.id() + "', received=" +
+                   std::to_string(sub.received_count()) + ")";
         });
 }
 
@@ -107,19 +131,24 @@ void bind_tick_broadcaster(py::module& m) {
         )doc")
 
         .def("register_subscriber", &TickBroadcaster::register_subscriber,
+             py::arg("id"), py::arg("capacity") = Subscriber::DEFAULT_CAPACITY,
+             "Register a new subscriber (returns the existing one if id is taken)")
+
+        .def("get_subscriber", &TickBroadcaster::get_subscriber,
              py::arg("id"),
-             "Register a new subscriber")
+             "Look up a subscriber by id")
 
         .def("unregister_subscriber", &TickBroadcaster::unregister_subscriber,
              py::arg("id"),
              "Unregister a subscriber")
 
-        .def("push_tick", &TickBroadcaster::push_tick,
+        .def("push_tick",
+             py::overload_cast<const std::string&, const Tick&>(&TickBroadcaster::push_tick),
              py::arg("date"), py::arg("tick"),
              R"doc(
              Push a single tick to all subscribers (零拷贝广播)
 
-             Performance: ~3 ns per subscriber (with cache hit)
+             Performance: one handle write per subscriber (with cache hit)
 
              Args:
                  date: Date string in format "YYYY-MM-DD"
@@ -18,6 +18,8 @@ void bind_tick(py::module& m);
 void bind_broadcast_stats(py::module& m);
 void bind_subscriber(py::module& m);
 void bind_tick_broadcaster(py::module& m);
+void bind_latency(py::module& m);
+void bind_shm_subscriber(py::module& m);
 
 // Main Python module
 PYBIND11_MODULE(qaultra_py, m) {
@@ -86,6 +88,10 @@ PYBIND11_MODULE(qaultra_py, m) {
     bind_subscriber(m);
     bind_tick_broadcaster(m);
 
+    // Bind shared-memory subscriber and latency tracing
+    bind_latency(m);
+    bind_shm_subscriber(m);
+
     // Submodules (for organization, optional)
     auto data_module = m.def_submodule("data", "Market data module");
     data_module.doc() = "Market data center with Arc zero-copy optimization";
@@ -2,6 +2,9 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 
+#include <limits>
+#include <stdexcept>
+
 #include "qaultra/simd/simd_math.hpp"
 #include "qaultra/memory/object_pool.hpp"
 #include "qaultra/threading/lockfree_queue.hpp"
@@ -12,128 +15,114 @@ using namespace qaultra;
 void bind_simd_types(py::module& m) {
     auto simd = m.def_submodule("simd", "SIMD-optimized mathematical operations");
 
-    // SIMD Math Functions
+    // SIMD Math Functions (kernels selected at runtime, see simd::active_simd_level())
     simd.def("vectorized_add",
-        [](py::array_t<double> a, py::array_t<double> b) -> py::array_t<double> {
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> a,
+           py::array_t<double, py::array::c_style | py::array::forcecast> b) -> py::array_t<double> {
             if (a.size() != b.size()) {
                 throw std::invalid_argument("Arrays must have the same size");
             }
 
             auto result = py::array_t<double>(a.size());
-            auto result_ptr = static_cast<double*>(result.mutable_unchecked<1>().mutable_data(0));
-            auto a_ptr = static_cast<const double*>(a.unchecked<1>().data(0));
-            auto b_ptr = static_cast<const double*>(b.unchecked<1>().data(0));
-
-            auto result_vec = simd::vectorized_add(a_ptr, b_ptr, a.size());
-            std::copy(result_vec.begin(), result_vec.end(), result_ptr);
-
+            simd::SimdMath::add(a.data(), b.data(), result.mutable_data(), a.size());
             return result;
         },
         "Vectorized addition of two arrays",
         py::arg("a"), py::arg("b"));
 
     simd.def("vectorized_multiply",
-        [](py::array_t<double> a, py::array_t<double> b) -> py::array_t<double> {
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> a,
+           py::array_t<double, py::array::c_style | py::array::forcecast> b) -> py::array_t<double> {
             if (a.size() != b.size()) {
                 throw std::invalid_argument("Arrays must have the same size");
             }
 
             auto result = py::array_t<double>(a.size());
-            auto result_ptr = static_cast<double*>(result.mutable_unchecked<1>().mutable_data(0));
-            auto a_ptr = static_cast<const double*>(a.unchecked<1>().data(0));
-            auto b_ptr = static_cast<const double*>(b.unchecked<1>().data(0));
-
-            auto result_vec = simd::vectorized_multiply(a_ptr, b_ptr, a.size());
-            std::copy(result_vec.begin(), result_vec.end(), result_ptr);
-
+            simd::SimdMath::multiply(a.data(), b.data(), result.mutable_data(), a.size());
             return result;
         },
         "Vectorized multiplication of two arrays",
         py::arg("a"), py::arg("b"));
 
     simd.def("vectorized_multiply_scalar",
-        [](py::array_t<double> array, double scalar) -> py::array_t<double> {
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> array, double scalar) -> py::array_t<double> {
             auto result = py::array_t<double>(array.size());
-            auto result_ptr = static_cast<double*>(result.mutable_unchecked<1>().mutable_data(0));
-            auto array_ptr = static_cast<const double*>(array.unchecked<1>().data(0));
-
-            auto result_vec = simd::vectorized_multiply_scalar(array_ptr, &scalar, array.size());
-            std::copy(result_vec.begin(), result_vec.end(), result_ptr);
-
+            simd::SimdMath::multiply_scalar(array.data(), scalar, result.mutable_data(), array.size());
             return result;
         },
         "Vectorized scalar multiplication",
         py::arg("array"), py::arg("scalar"));
 
     simd.def("calculate_sma",
-        [](py::array_t<double> prices, int window) -> py::array_t<double> {
-            auto prices_ptr = static_cast<const double*>(prices.unchecked<1>().data(0));
-            auto result_vec = simd::calculate_sma(prices_ptr, prices.size(), window);
-
-            auto result = py::array_t<double>(result_vec.size());
-            auto result_ptr = static_cast<double*>(result.mutable_unchecked<1>().mutable_data(0));
-            std::copy(result_vec.begin(), result_vec.end(), result_ptr);
-
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> prices, size_t window) -> py::array_t<double> {
+            auto result = py::array_t<double>(prices.size());
+            simd::SimdMath::moving_average(prices.data(), result.mutable_data(), prices.size(), window);
             return result;
         },
-        "Calculate Simple Moving Average with SIMD optimization",
+        "Calculate Simple Moving Average (NaN until the window is full)",
         py::arg("prices"), py::arg("window"));
 
     simd.def("calculate_ema",
-        [](py::array_t<double> prices, double alpha) -> py::array_t<double> {
-            auto prices_ptr = static_cast<const double*>(prices.unchecked<1>().data(0));
-            auto result_vec = simd::calculate_ema(prices_ptr, prices.size(), alpha);
-
-            auto result = py::array_t<double>(result_vec.size());
-            auto result_ptr = static_cast<double*>(result.mutable_unchecked<1>().mutable_data(0));
-            std::copy(result_vec.begin(), result_vec.end(), result_ptr);
-
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> prices, double alpha) -> py::array_t<double> {
+            auto result = py::array_t<double>(prices.size());
+            simd::SimdMath::ema(prices.data(), result.mutable_data(), prices.size(), alpha);
             return result;
         },
-        "Calculate Exponential Moving Average with SIMD optimization",
+        "Calculate Exponential Moving Average",
         py::arg("prices"), py::arg("alpha"));
 
     simd.def("calculate_returns",
-        [](py::array_t<double> prices) -> py::array_t<double> {
-            auto prices_ptr = static_cast<const double*>(prices.unchecked<1>().data(0));
-            auto result_vec = simd::calculate_returns(prices_ptr, prices.size());
-
-            auto result = py::array_t<double>(result_vec.size());
-            auto result_ptr = static_cast<double*>(result.mutable_unchecked<1>().mutable_data(0));
-            std::copy(result_vec.begin(), result_vec.end(), result_ptr);
-
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> prices) -> py::array_t<double> {
+            const size_t n = prices.size() > 0 ? static_cast<size_t>(prices.size()) - 1 : 0;
+            auto result = py::array_t<double>(n);
+            simd::SimdMath::returns(prices.data(), result.mutable_data(), prices.size());
             return result;
         },
-        "Calculate returns with SIMD optimization",
+        "Calculate simple returns (size - 1 values)",
         py::arg("prices"));
 
     simd.def("calculate_volatility",
-        [](py::array_t<double> returns, int window) -> py::array_t<double> {
-            auto returns_ptr = static_cast<const double*>(returns.unchecked<1>().data(0));
-            auto result_vec = simd::calculate_volatility(returns_ptr, returns.size(), window);
-
-            auto result = py::array_t<double>(result_vec.size());
-            auto result_ptr = static_cast<double*>(result.mutable_unchecked<1>().mutable_data(0));
-            std::copy(result_vec.begin(), result_vec.end(), result_ptr);
-
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> returns, size_t window) -> py::array_t<double> {
+            const size_t n = returns.size();
+            auto result = py::array_t<double>(n);
+            const double* data = returns.data();
+            double* out = result.mutable_data();
+            for (size_t i = 0; i < n; ++i) {
+                if (window == 0 || i + 1 < window) {
+                    out[i] = std::numeric_limits<double>::quiet_NaN();
+                    continue;
+                }
+                const double* w = data + i + 1 - window;
+                const double mean = simd::SimdMath::sum(w, window) / static_cast<double>(window);
+                out[i] = simd::SimdMath::std_dev(w, window, mean);
+            }
             return result;
         },
-        "Calculate volatility with SIMD optimization",
+        "Calculate rolling (population) volatility",
         py::arg("returns"), py::arg("window"));
 
+    simd.def("calculate_rsi",
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> prices, size_t period) -> py::array_t<double> {
+            auto result = py::array_t<double>(prices.size());
+            simd::SimdMath::rsi(prices.data(), result.mutable_data(), prices.size(), period);
+            return result;
+        },
+        "Calculate RSI with Wilder smoothing",
+        py::arg("prices"), py::arg("period") = 14);
+
     // Financial calculations with SIMD
     auto financial = simd.def_submodule("financial", "SIMD-optimized financial calculations");
 
     financial.def("calculate_sharpe_ratio_simd",
-        [](py::array_t<double> returns, double risk_free_rate) -> double {
-            auto returns_ptr = static_cast<const double*>(returns.unchecked<1>().data(0));
-            return simd::calculate_sharpe_ratio_simd(returns_ptr, returns.size(), risk_free_rate);
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> returns, double risk_free_rate) -> double {
+            return simd::FinancialMath::sharpe_ratio(returns.data(), returns.size(), risk_free_rate);
         },
-        "Calculate Sharpe ratio with SIMD optimization",
+        "Calculate annualized Sharpe ratio",
         py::arg("returns"), py::arg("risk_free_rate") = 0.0);
 
     financial.def("calculate_portfolio_variance_simd",
-        [](py::array_t<double> weights, py::array_t<double> covariance_matrix) -> double {
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> weights,
+           py::array_t<double, py::array::c_style | py::array::forcecast> covariance_matrix) -> double {
             if (weights.ndim() != 1) {
                 throw std::invalid_argument("Weights must be 1D array");
             }
@@ -141,25 +130,22 @@ void bind_simd_types(py::module& m) {
                 throw std::invalid_argument("Covariance matrix must be 2D array");
             }
 
-            size_t n = weights.size();
+            const auto n = weights.shape(0);
             if (covariance_matrix.shape(0) != n || covariance_matrix.shape(1) != n) {
                 throw std::invalid_argument("Covariance matrix dimensions must match weights size");
             }
 
-            auto weights_ptr = static_cast<const double*>(weights.unchecked<1>().data(0));
-            auto cov_ptr = static_cast<const double*>(covariance_matrix.unchecked<2>().data(0, 0));
-
-            return simd::calculate_portfolio_variance_simd(weights_ptr, cov_ptr, n);
+            return simd::FinancialMath::portfolio_variance(weights.data(), covariance_matrix.data(), n);
         },
-        "Calculate portfolio variance with SIMD optimization",
+        "Calculate portfolio variance w' * Sigma * w",
         py::arg("weights"), py::arg("covariance_matrix"));
 
     financial.def("calculate_var_simd",
-        [](py::array_t<double> returns, double confidence_level) -> double {
-            auto returns_ptr = static_cast<const double*>(returns.unchecked<1>().data(0));
-            return simd::calculate_var_simd(returns_ptr, returns.size(), confidence_level);
+        [](py::array_t<double, py::array::c_style | py::array::forcecast> returns, double confidence_level) -> double {
+            // confidence_level 为左尾概率 (0.05 即 95% VaR)
+            return simd::FinancialMath::value_at_risk(returns.data(), returns.size(), 1.0 - confidence_level);
         },
-        "Calculate Value at Risk with SIMD optimization",
+        "Calculate historical Value at Risk",
         py::arg("returns"), py::arg("confidence_level") = 0.05);
 
     // Memory management utilities
@@ -198,24 +184,24 @@ void bind_simd_types(py::module& m) {
             "Get pool capacity");
 
     // Memory-mapped array for zero-copy operations
-    py::class_<memory::MemoryMappedArray<double>>(memory, "MemoryMappedDoubleArray")
+    py::class_<qaultra::simd::MemoryMappedArray<double>>(memory, "MemoryMappedDoubleArray")
         .def(py::init<const std::string&, size_t>(),
             "Create memory-mapped array",
             py::arg("filename"), py::arg("size"))
-        .def("__getitem__", [](const memory::MemoryMappedArray<double>& self, size_t index) {
+        .def("__getitem__", [](const qaultra::simd::MemoryMappedArray<double>& self, size_t index) {
             if (index >= self.size()) {
                 throw py::index_error("Index out of range");
             }
             return self[index];
         })
-        .def("__setitem__", [](memory::MemoryMappedArray<double>& self, size_t index, double value) {
+        .def("__setitem__", [](qaultra::simd::MemoryMappedArray<double>& self, size_t index, double value) {
             if (index >= self.size()) {
                 throw py::index_error("Index out of range");
             }
             self[index] = value;
         })
-        .def("size", &memory::MemoryMappedArray<double>::size)
-        .def("as_array", [](memory::MemoryMappedArray<double>& self) {
+        .def("size", &qaultra::simd::MemoryMappedArray<double>::size)
+        .def("as_array", [](qaultra::simd::MemoryMappedArray<double>& self) {
             return py::array_t<double>(
                 self.size(),
                 self.data(),
@@ -223,7 +209,7 @@ void bind_simd_types(py::module& m) {
             );
         }, "Get as NumPy array (zero-copy)",
            py::return_value_policy::reference_internal)
-        .def("sync", &memory::MemoryMappedArray<double>::sync,
+        .def("flush", &qaultra::simd::MemoryMappedArray<double>::flush,
             "Synchronize changes to disk");
 
     // Threading utilities
@@ -325,22 +311,34 @@ void bind_simd_types(py::module& m) {
     }, "Compare performance of multiple implementations",
        py::arg("functions"), py::arg("args"), py::arg("kwargs"), py::arg("iterations") = 1000);
 
-    // SIMD capability detection
+    // SIMD capability detection and kernel selection
+    py::enum_<simd::SimdLevel>(simd, "SimdLevel")
+        .value("Scalar", simd::SimdLevel::Scalar)
+        .value("SSE42", simd::SimdLevel::SSE42)
+        .value("AVX2", simd::SimdLevel::AVX2)
+        .value("AVX512", simd::SimdLevel::AVX512);
+
     simd.def("get_simd_capabilities", []() {
+        const auto detected = simd::detected_simd_level();
         py::dict caps;
-        caps["sse"] = simd::has_sse();
-        caps["sse2"] = simd::has_sse2();
-        caps["sse3"] = simd::has_sse3();
-        caps["sse4_1"] = simd::has_sse4_1();
-        caps["sse4_2"] = simd::has_sse4_2();
-        caps["avx"] = simd::has_avx();
-        caps["avx2"] = simd::has_avx2();
-        caps["avx512"] = simd::has_avx512();
+        caps["sse4_2"] = detected >= simd::SimdLevel::SSE42;
+        caps["avx2"] = detected >= simd::SimdLevel::AVX2;
+        caps["avx512"] = detected >= simd::SimdLevel::AVX512;
+        caps["detected"] = simd::simd_level_name(detected);
+        caps["active"] = simd::simd_level_name(simd::active_simd_level());
+        caps["deterministic"] = simd::simd_deterministic();
         return caps;
-    }, "Get available SIMD capabilities");
+    }, "Get available SIMD capabilities and the active kernels");
+
+    simd.def("detected_simd_level", &simd::detected_simd_level);
+    simd.def("active_simd_level", &simd::active_simd_level);
+    simd.def("set_simd_level", &simd::set_simd_level,
+             "Select kernels; returns False if the host does not support the level", py::arg("level"));
+    simd.def("set_deterministic", &simd::set_simd_deterministic,
+             "Bit-for-bit reproducible reductions across SIMD levels", py::arg("enabled"));
 
     simd.def("get_optimal_batch_size", []() {
-        return simd::get_optimal_batch_size();
+        return simd::SimdMath::get_simd_stride() * 4;
     }, "Get optimal batch size for SIMD operations");
 
     // Utility functions for array operations
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 namespace qaultra::account {
 
@@ -213,7 +214,7 @@ QA_Account::QA_Account(QA_Account&& other) noexcept
     , trade_history_(std::move(other.trade_history_))
     , history_slices_(std::move(other.history_slices_))
     , market_preset_(std::move(other.market_preset_))
-    , market_prices_(std::move(other.market_prices_))
+    , marks_(std::move(other.marks_))
     , order_id_counter_(other.order_id_counter_.load())
     , trade_id_counter_(other.trade_id_counter_.load())
     , performance_monitoring_(other.performance_monitoring_)
@@ -241,7 +242,7 @@ QA_Account& QA_Account::operator=(QA_Account&& other) noexcept {
         trade_history_ = std::move(other.trade_history_);
         history_slices_ = std::move(other.history_slices_);
         market_preset_ = std::move(other.market_preset_);
-        market_prices_ = std::move(other.market_prices_);
+        marks_ = std::move(other.marks_);
         order_id_counter_.store(other.order_id_counter_.load());
         trade_id_counter_.store(other.trade_id_counter_.load());
         performance_monitoring_ = other.performance_monitoring_;
@@ -269,10 +270,9 @@ double QA_Account::get_market_value() const {
     std::lock_guard<std::mutex> lock(positions_mutex_);
     double market_value = 0.0;
 
-    for (const auto& [code, position] : positions_) {
-        auto price_it = market_prices_.find(code);
-        double current_price = (price_it != market_prices_.end()) ?
-                              price_it->second : position.lastest_price;
+    for (const auto& [id, position] : positions_) {
+        const double mark = mark_price(id);
+        double current_price = std::isnan(mark) ? position.lastest_price : mark;
         double net_volume = position.volume_net();
         market_value += net_volume * current_price;
     }
@@ -292,10 +292,9 @@ double QA_Account::get_float_pnl() const {
     std::lock_guard<std::mutex> lock(positions_mutex_);
     double pnl = 0.0;
 
-    for (const auto& [code, position] : positions_) {
-        auto price_it = market_prices_.find(code);
-        if (price_it != market_prices_.end()) {
-            double current_price = price_it->second;
+    for (const auto& [id, position] : positions_) {
+        const double current_price = mark_price(id);
+        if (!std::isnan(current_price)) {
             double net_volume = position.volume_net();
             double avg_price = net_volume > 0 ? position.avg_price_long() : position.avg_price_short();
             pnl += (current_price - avg_price) * net_volume;
@@ -322,11 +321,14 @@ std::string QA_Account::buy(const std::string& code, double volume, double price
     order.order_time = std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
         std::chrono::system_clock::now().time_since_epoch()).count());
 
-    // 检查资金
-    double required_cash = volume * (price > 0 ? price : market_prices_[code]) *
-                          market_preset_.margin_ratio;
-    double commission = calculate_commission(price > 0 ? price : market_prices_[code],
-                                           volume, true);
+    // 检查资金 (市价单按最新标记价估算，无行情时按 0)
+    if (price <= 0) {
+        std::lock_guard<std::mutex> lock(positions_mutex_);
+        const double mark = mark_price(data::InstrumentRegistry::instance().find(code));
+        price = std::isnan(mark) ? 0.0 : mark;
+    }
+    double required_cash = volume * price * market_preset_.margin_ratio;
+    double commission = calculate_commission(price, volume, true);
     required_cash += commission;
 
     if (get_available_cash() < required_cash) {
@@ -356,7 +358,7 @@ std::string QA_Account::sell(const std::string& code, double volume, double pric
     // 检查持仓
     {
         std::lock_guard<std::mutex> lock(positions_mutex_);
-        auto pos_it = positions_.find(code);
+        auto pos_it = positions_.find(data::InstrumentRegistry::instance().find(code));
         if (pos_it == positions_.end() || pos_it->second.volume_net() < volume) {
             return "";  // 持仓不足
         }
@@ -498,12 +500,17 @@ std::optional<Order> QA_Account::find_order(const std::string& order_id) const {
 
 std::unordered_map<std::string, QA_Position> QA_Account::get_positions() const {
     std::lock_guard<std::mutex> lock(positions_mutex_);
-    return positions_;
+    std::unordered_map<std::string, QA_Position> positions;
+    positions.reserve(positions_.size());
+    for (const auto& [id, position] : positions_) {
+        positions.emplace(data::instrument_code(id), position);
+    }
+    return positions;
 }
 
 std::optional<QA_Position> QA_Account::get_position(const std::string& code) const {
     std::lock_guard<std::mutex> lock(positions_mutex_);
-    auto it = positions_.find(code);
+    auto it = positions_.find(data::InstrumentRegistry::instance().find(code));
     if (it != positions_.end()) {
         return it->second;
     }
@@ -512,7 +519,7 @@ std::optional<QA_Position> QA_Account::get_position(const std::string& code) con
 
 bool QA_Account::has_position(const std::string& code) const {
     std::lock_guard<std::mutex> lock(positions_mutex_);
-    return positions_.find(code) != positions_.end();
+    return positions_.find(data::InstrumentRegistry::instance().find(code)) != positions_.end();
 }
 
 void QA_Account::add_trade(const std::string& order_id, double price, double volume,
@@ -575,14 +582,48 @@ void QA_Account::add_trade(const std::string& order_id, double price, double vol
     }
 }
 
+double QA_Account::mark_price(data::InstrumentId id) const {
+    return id < marks_.size() ? marks_[id] : std::numeric_limits<double>::quiet_NaN();
+}
+
+void QA_Account::set_mark(data::InstrumentId id, double price) {
+    if (id == data::INVALID_INSTRUMENT_ID) {
+        return;
+    }
+    if (id >= marks_.size()) {
+        marks_.resize(static_cast<size_t>(id) + 1, std::numeric_limits<double>::quiet_NaN());
+    }
+    marks_[id] = price;
+}
+
 void QA_Account::update_market_data(const std::string& code, double price) {
-    market_prices_[code] = price;
+    {
+        std::lock_guard<std::mutex> lock(positions_mutex_);
+        set_mark(data::intern_instrument(code), price);
+    }
     calculate_pnl();  // 重新计算浮动盈亏
 }
 
 void QA_Account::update_market_data_batch(const std::unordered_map<std::string, double>& prices) {
-    for (const auto& [code, price] : prices) {
-        market_prices_[code] = price;
+    {
+        std::lock_guard<std::mutex> lock(positions_mutex_);
+        for (const auto& [code, price] : prices) {
+            set_mark(data::intern_instrument(code), price);
+        }
+    }
+    calculate_pnl();
+}
+
+void QA_Account::update_market_data(const data::KlineMap& bars) {
+    {
+        // 只遍历持仓 (通常远少于全市场截面)，持仓、截面与价格表都按整数ID关联
+        std::lock_guard<std::mutex> lock(positions_mutex_);
+        for (const auto& [id, position] : positions_) {
+            auto bar_it = bars.find(id);
+            if (bar_it != bars.end()) {
+                set_mark(id, bar_it->second.close);
+            }
+        }
     }
     calculate_pnl();
 }
@@ -598,10 +639,9 @@ void QA_Account::daily_settle() {
     // 对于期货，可能需要处理持仓的每日无负债结算
     if (!market_preset_.is_stock) {
         std::lock_guard<std::mutex> lock(positions_mutex_);
-        for (auto& [code, position] : positions_) {
-            auto price_it = market_prices_.find(code);
-            if (price_it != market_prices_.end()) {
-                double current_price = price_it->second;
+        for (auto& [id, position] : positions_) {
+            const double current_price = mark_price(id);
+            if (!std::isnan(current_price)) {
                 double net_volume = position.volume_net();
                 double avg_price = net_volume > 0 ? position.avg_price_long() : position.avg_price_short();
                 double daily_pnl = (current_price - avg_price) * net_volume;
@@ -650,7 +690,7 @@ double QA_Account::get_margin_usage() const {
     std::lock_guard<std::mutex> lock(positions_mutex_);
     double margin_used = 0.0;
 
-    for (const auto& [code, position] : positions_) {
+    for (const auto& [id, position] : positions_) {
         double net_volume = position.volume_net();
         double avg_price = net_volume > 0 ? position.avg_price_long() : position.avg_price_short();
         double position_value = net_volume * avg_price;
@@ -728,7 +768,7 @@ void QA_Account::from_qifi(const protocol::qifi::QIFI& qifi_data) {
             position.volume_short_his = qifi_pos.volume_short_his;
             position.position_cost_long = qifi_pos.position_cost_long;
             position.position_cost_short = qifi_pos.position_cost_short;
-            positions_[code] = position;
+            positions_[data::intern_instrument(code)] = position;
         }
     }
 }
@@ -845,7 +885,8 @@ void QA_Account::update_position_from_trade(const std::string& code, double pric
                                                double volume, bool is_buy) {
     std::lock_guard<std::mutex> lock(positions_mutex_);
 
-    auto pos_it = positions_.find(code);
+    const data::InstrumentId id = data::intern_instrument(code);
+    auto pos_it = positions_.find(id);
     if (pos_it == positions_.end()) {
         // 新建仓位
         QA_Position position;
@@ -857,7 +898,7 @@ void QA_Account::update_position_from_trade(const std::string& code, double pric
             position.volume_short_today = volume;
             position.position_price_short = price;
         }
-        positions_[code] = position;
+        positions_[id] = position;
     } else {
         // 更新现有仓位
         QA_Position& position = pos_it->second;
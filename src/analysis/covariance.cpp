@@ -0,0 +1,369 @@
+#include "qaultra/analysis/covariance.hpp"
+#include "qaultra/simd/simd_math.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace qaultra::analysis {
+
+using simd::SimdMath;
+
+namespace {
+
+constexpr size_t MIN_ELEMENTS_PER_THREAD = 1 << 16;   // 更小的工作量不值得起线程
+
+size_t resolve_threads(size_t requested, size_t work_items) {
+    size_t threads = requested > 0 ? requested : std::max<size_t>(1, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min(threads, work_items));
+}
+
+/**
+ * @brief 按压缩元素数均分行区间，fn(begin, end, scratch) 在各线程上执行 (scratch 长度为 dimension)
+ */
+template <typename Fn>
+void parallel_rows(size_t dimension, size_t requested_threads, Fn fn) {
+    const size_t total = PackedSymmetricMatrix::packed_size(dimension);
+    const size_t num_threads = resolve_threads(requested_threads, std::max<size_t>(1, total / MIN_ELEMENTS_PER_THREAD));
+    if (num_threads == 1) {
+        std::vector<double> scratch(dimension);
+        fn(0, dimension, scratch.data());
+        return;
+    }
+
+    std::vector<size_t> bounds{0};
+    size_t covered = 0;
+    for (size_t i = 0; i < dimension && bounds.size() < num_threads; ++i) {
+        covered += dimension - i;
+        if (covered * num_threads >= bounds.size() * total) {
+            bounds.push_back(i + 1);
+        }
+    }
+    bounds.push_back(dimension);
+
+    std::vector<std::thread> threads;
+    for (size_t k = 0; k + 1 < bounds.size(); ++k) {
+        if (bounds[k] == bounds[k + 1]) {
+            continue;
+        }
+        threads.emplace_back([&fn, &bounds, dimension, k]() {
+            std::vector<double> scratch(dimension);
+            fn(bounds[k], bounds[k + 1], scratch.data());
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief y += a * x (经 SimdMath 分派内核)
+ */
+void scaled_add(double a, const double* x, double* y, double* scratch, size_t n) {
+    SimdMath::multiply_scalar(x, a, scratch, n);
+    SimdMath::add(y, scratch, y, n);
+}
+
+} // namespace
+
+// ==================== PackedSymmetricMatrix ====================
+
+PackedSymmetricMatrix::PackedSymmetricMatrix(size_t dimension)
+    : dimension_(dimension)
+    , data_(packed_size(dimension), 0.0)
+{
+}
+
+std::vector<double> PackedSymmetricMatrix::to_dense() const {
+    std::vector<double> dense(dimension_ * dimension_);
+    for (size_t i = 0; i < dimension_; ++i) {
+        const double* r = row(i);
+        for (size_t j = i; j < dimension_; ++j) {
+            dense[i * dimension_ + j] = r[j - i];
+            dense[j * dimension_ + i] = r[j - i];
+        }
+    }
+    return dense;
+}
+
+// ==================== 批量计算 ====================
+
+PackedSymmetricMatrix covariance_matrix(const double* returns, size_t periods, size_t series,
+                                        const CovarianceOptions& options) {
+    PackedSymmetricMatrix result(series);
+    const size_t divisor = options.sample ? (periods > 0 ? periods - 1 : 0) : periods;
+    if (series == 0 || divisor == 0) {
+        return result;
+    }
+
+    std::vector<double> mean(series, 0.0);
+    for (size_t t = 0; t < periods; ++t) {
+        SimdMath::add(mean.data(), returns + t * series, mean.data(), series);
+    }
+    SimdMath::multiply_scalar(mean.data(), 1.0 / static_cast<double>(periods), mean.data(), series);
+
+    // 去均值并转为标的主序，按 64 × 64 小块转置
+    constexpr size_t TILE = 64;
+    std::vector<double> centered(series * periods);
+    for (size_t t0 = 0; t0 < periods; t0 += TILE) {
+        const size_t t1 = std::min(periods, t0 + TILE);
+        for (size_t i0 = 0; i0 < series; i0 += TILE) {
+            const size_t i1 = std::min(series, i0 + TILE);
+            for (size_t i = i0; i < i1; ++i) {
+                double* column = centered.data() + i * periods;
+                for (size_t t = t0; t < t1; ++t) {
+                    column[t] = returns[t * series + i] - mean[i];
+                }
+            }
+        }
+    }
+
+    const size_t block = std::max<size_t>(1, options.block_size);
+    const size_t blocks = (series + block - 1) / block;
+    std::vector<std::pair<size_t, size_t>> tiles;
+    tiles.reserve(blocks * (blocks + 1) / 2);
+    for (size_t bi = 0; bi < blocks; ++bi) {
+        for (size_t bj = bi; bj < blocks; ++bj) {
+            tiles.emplace_back(bi, bj);
+        }
+    }
+
+    const double scale = 1.0 / static_cast<double>(divisor);
+    std::atomic<size_t> next{0};
+    const auto worker = [&]() {
+        for (size_t k = next.fetch_add(1); k < tiles.size(); k = next.fetch_add(1)) {
+            const size_t i_end = std::min(series, (tiles[k].first + 1) * block);
+            const size_t j_begin = tiles[k].second * block;
+            const size_t j_end = std::min(series, j_begin + block);
+            for (size_t i = tiles[k].first * block; i < i_end; ++i) {
+                const double* x = centered.data() + i * periods;
+                double* out = result.row(i) - i;
+                for (size_t j = std::max(i, j_begin); j < j_end; ++j) {
+                    out[j] = SimdMath::dot_product(x, centered.data() + j * periods, periods) * scale;
+                }
+            }
+        }
+    };
+
+    const size_t num_threads = resolve_threads(options.threads, tiles.size());
+    if (num_threads == 1) {
+        worker();
+        return result;
+    }
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return result;
+}
+
+PackedSymmetricMatrix correlation_matrix(const PackedSymmetricMatrix& covariance) {
+    const size_t n = covariance.dimension();
+    std::vector<double> stddev(n);
+    for (size_t i = 0; i < n; ++i) {
+        stddev[i] = std::sqrt(std::max(covariance.row(i)[0], 0.0));
+    }
+
+    PackedSymmetricMatrix result(n);
+    for (size_t i = 0; i < n; ++i) {
+        const double* in = covariance.row(i);
+        double* out = result.row(i);
+        if (!(stddev[i] > 0.0)) {
+            continue;
+        }
+        for (size_t j = i; j < n; ++j) {
+            out[j - i] = stddev[j] > 0.0 ? in[j - i] / (stddev[i] * stddev[j]) : 0.0;
+        }
+        out[0] = 1.0;
+    }
+    return result;
+}
+
+double quadratic_form(const PackedSymmetricMatrix& matrix, const double* weights) {
+    // 对角项一次，上三角项两次
+    const size_t n = matrix.dimension();
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double* r = matrix.row(i);
+        const double off_diagonal = i + 1 < n ? SimdMath::dot_product(r + 1, weights + i + 1, n - i - 1) : 0.0;
+        total += weights[i] * (r[0] * weights[i] + 2.0 * off_diagonal);
+    }
+    return total;
+}
+
+void quadratic_forms(const PackedSymmetricMatrix& matrix, const double* weights, size_t portfolios,
+                     double* out, size_t threads) {
+    const size_t n = matrix.dimension();
+    const auto run_range = [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            out[p] = quadratic_form(matrix, weights + p * n);
+        }
+    };
+
+    const size_t num_threads = resolve_threads(threads, portfolios);
+    if (num_threads <= 1) {
+        run_range(0, portfolios);
+        return;
+    }
+    std::vector<std::thread> workers;
+    const size_t chunk_size = (portfolios + num_threads - 1) / num_threads;
+    for (size_t i = 0; i < num_threads && i * chunk_size < portfolios; ++i) {
+        workers.emplace_back(run_range, i * chunk_size, std::min(portfolios, (i + 1) * chunk_size));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// ==================== EwmaCovariance ====================
+
+EwmaCovariance::EwmaCovariance(size_t series, double lambda, size_t threads)
+    : lambda_(lambda)
+    , threads_(threads)
+    , mean_(series, 0.0)
+    , delta_(series, 0.0)
+    , covariance_(series)
+{
+    if (series == 0 || !(lambda > 0.0 && lambda < 1.0)) {
+        throw std::invalid_argument("EwmaCovariance requires positive series and lambda in (0, 1)");
+    }
+}
+
+void EwmaCovariance::update(const double* row) {
+    const size_t n = series();
+    if (count_++ == 0) {
+        std::copy(row, row + n, mean_.begin());
+        return;
+    }
+
+    const double alpha = 1.0 - lambda_;
+    SimdMath::subtract(row, mean_.data(), delta_.data(), n);
+    for (size_t s = 0; s < n; ++s) {
+        mean_[s] += alpha * delta_[s];
+    }
+
+    const double lambda = lambda_;
+    const double* delta = delta_.data();
+    parallel_rows(n, threads_, [&](size_t begin, size_t end, double* scratch) {
+        for (size_t i = begin; i < end; ++i) {
+            double* r = covariance_.row(i);
+            SimdMath::multiply_scalar(r, lambda, r, n - i);
+            scaled_add(lambda * alpha * delta[i], delta + i, r, scratch, n - i);
+        }
+    });
+}
+
+void EwmaCovariance::reset() {
+    count_ = 0;
+    std::fill(mean_.begin(), mean_.end(), 0.0);
+    covariance_ = PackedSymmetricMatrix(series());
+}
+
+// ==================== RollingCovariance ====================
+
+RollingCovariance::RollingCovariance(size_t series, size_t window, const CovarianceOptions& options)
+    : window_(window)
+    , options_(options)
+    , mean_(series, 0.0)
+    , delta_(series, 0.0)
+    , centered_(series, 0.0)
+    , old_centered_(series, 0.0)
+    , comoment_(series)
+{
+    if (series == 0 || window == 0) {
+        throw std::invalid_argument("RollingCovariance requires positive series and window");
+    }
+    rows_.resize(series * window);
+}
+
+void RollingCovariance::update(const double* row) {
+    const size_t n = series();
+    const double* delta = delta_.data();
+    const double* centered = centered_.data();
+
+    if (count_ < window_) {
+        // 追加: delta = x - mean; mean += delta / count; C += delta (x - mean)'
+        std::copy(row, row + n, rows_.begin() + count_ * n);
+        count_++;
+        SimdMath::subtract(row, mean_.data(), delta_.data(), n);
+        for (size_t s = 0; s < n; ++s) {
+            mean_[s] += delta_[s] / static_cast<double>(count_);
+        }
+        SimdMath::subtract(row, mean_.data(), centered_.data(), n);
+        parallel_rows(n, options_.threads, [&](size_t begin, size_t end, double* scratch) {
+            for (size_t i = begin; i < end; ++i) {
+                scaled_add(delta[i], centered + i, comoment_.row(i), scratch, n - i);
+            }
+        });
+        return;
+    }
+
+    // 替换最旧一行 y: C += delta (x - mean')' + (y - mean) delta'
+    double* oldest = rows_.data() + head_ * n;
+    SimdMath::subtract(row, oldest, delta_.data(), n);
+    SimdMath::subtract(oldest, mean_.data(), old_centered_.data(), n);
+    for (size_t s = 0; s < n; ++s) {
+        mean_[s] += delta_[s] / static_cast<double>(window_);
+    }
+    SimdMath::subtract(row, mean_.data(), centered_.data(), n);
+    const double* old_centered = old_centered_.data();
+    parallel_rows(n, options_.threads, [&](size_t begin, size_t end, double* scratch) {
+        for (size_t i = begin; i < end; ++i) {
+            double* r = comoment_.row(i);
+            scaled_add(delta[i], centered + i, r, scratch, n - i);
+            scaled_add(old_centered[i], delta + i, r, scratch, n - i);
+        }
+    });
+    std::copy(row, row + n, oldest);
+    head_ = (head_ + 1) % window_;
+
+    if (++updates_since_rebuild_ >= window_) {
+        rebuild();
+    }
+}
+
+void RollingCovariance::rebuild() {
+    const size_t n = series();
+    CovarianceOptions options = options_;
+    options.sample = false;
+    comoment_ = covariance_matrix(rows_.data(), window_, n, options);
+    SimdMath::multiply_scalar(comoment_.data(), static_cast<double>(window_), comoment_.data(), comoment_.size());
+
+    std::fill(mean_.begin(), mean_.end(), 0.0);
+    for (size_t w = 0; w < window_; ++w) {
+        SimdMath::add(mean_.data(), rows_.data() + w * n, mean_.data(), n);
+    }
+    SimdMath::multiply_scalar(mean_.data(), 1.0 / static_cast<double>(window_), mean_.data(), n);
+    updates_since_rebuild_ = 0;
+}
+
+void RollingCovariance::reset() {
+    head_ = 0;
+    count_ = 0;
+    updates_since_rebuild_ = 0;
+    std::fill(mean_.begin(), mean_.end(), 0.0);
+    comoment_ = PackedSymmetricMatrix(series());
+}
+
+void RollingCovariance::covariance(PackedSymmetricMatrix& out) const {
+    if (out.dimension() != series()) {
+        out = PackedSymmetricMatrix(series());
+    }
+    const size_t divisor = options_.sample ? (count_ > 0 ? count_ - 1 : 0) : count_;
+    const double scale = divisor > 0 ? 1.0 / static_cast<double>(divisor) : 0.0;
+    SimdMath::multiply_scalar(comoment_.data(), scale, out.data(), comoment_.size());
+}
+
+PackedSymmetricMatrix RollingCovariance::covariance() const {
+    PackedSymmetricMatrix out(series());
+    covariance(out);
+    return out;
+}
+
+} // namespace qaultra::analysis
@@ -0,0 +1,307 @@
+#include "qaultra/analysis/incremental_indicators.hpp"
+#include "qaultra/simd/simd_math.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace qaultra::analysis {
+
+using simd::SimdMath;
+
+namespace {
+
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+double period_alpha(size_t period) {
+    if (period == 0) {
+        throw std::invalid_argument("indicator period must be positive");
+    }
+    return 2.0 / (static_cast<double>(period) + 1.0);
+}
+
+double to_rsi(double avg_gain, double avg_loss) {
+    return avg_loss == 0.0 ? 100.0 : 100.0 - 100.0 / (1.0 + avg_gain / avg_loss);
+}
+
+} // namespace
+
+// ==================== IncrementalSMA ====================
+
+IncrementalSMA::IncrementalSMA(size_t series, size_t window)
+    : series_(series)
+    , window_(window)
+{
+    if (series == 0 || window == 0) {
+        throw std::invalid_argument("IncrementalSMA requires positive series and window");
+    }
+    rows_.resize(series * window);
+    sum_.assign(series, 0.0);
+    scratch_.resize(series);
+    value_.assign(series, NaN);
+}
+
+void IncrementalSMA::update(const double* row) {
+    const size_t n = series_;
+    if (count_ < window_) {
+        std::copy(row, row + n, rows_.data() + count_ * n);
+        SimdMath::add(sum_.data(), row, sum_.data(), n);
+        count_++;
+    } else {
+        double* oldest = rows_.data() + head_ * n;
+        SimdMath::subtract(row, oldest, scratch_.data(), n);
+        SimdMath::add(sum_.data(), scratch_.data(), sum_.data(), n);
+        std::copy(row, row + n, oldest);
+        count_++;
+        head_ = (head_ + 1) % window_;
+        if (head_ == 0) {
+            // 缓冲区恰好按时间顺序排列，重算一次窗口和 (摊还 O(1))
+            std::copy(rows_.begin(), rows_.begin() + n, sum_.begin());
+            for (size_t w = 1; w < window_; ++w) {
+                SimdMath::add(sum_.data(), rows_.data() + w * n, sum_.data(), n);
+            }
+        }
+    }
+
+    if (ready()) {
+        SimdMath::multiply_scalar(sum_.data(), 1.0 / static_cast<double>(window_), value_.data(), n);
+    }
+}
+
+void IncrementalSMA::reset() {
+    head_ = 0;
+    count_ = 0;
+    std::fill(sum_.begin(), sum_.end(), 0.0);
+    std::fill(value_.begin(), value_.end(), NaN);
+}
+
+// ==================== IncrementalEMA ====================
+
+IncrementalEMA::IncrementalEMA(size_t series, double alpha)
+    : series_(series)
+    , alpha_(alpha)
+{
+    if (series == 0 || !(alpha > 0.0 && alpha <= 1.0)) {
+        throw std::invalid_argument("IncrementalEMA requires positive series and alpha in (0, 1]");
+    }
+    value_.assign(series, NaN);
+}
+
+IncrementalEMA IncrementalEMA::from_period(size_t series, size_t period) {
+    return IncrementalEMA(series, period_alpha(period));
+}
+
+void IncrementalEMA::update(const double* row) {
+    if (count_++ == 0) {
+        std::copy(row, row + series_, value_.begin());
+        return;
+    }
+    const double alpha = alpha_;
+    const double keep = 1.0 - alpha_;
+    double* value = value_.data();
+    for (size_t s = 0; s < series_; ++s) {
+        value[s] = alpha * row[s] + keep * value[s];
+    }
+}
+
+void IncrementalEMA::reset() {
+    count_ = 0;
+    std::fill(value_.begin(), value_.end(), NaN);
+}
+
+// ==================== IncrementalRSI ====================
+
+IncrementalRSI::IncrementalRSI(size_t series, size_t period)
+    : series_(series)
+    , period_(period)
+{
+    if (series == 0 || period == 0) {
+        throw std::invalid_argument("IncrementalRSI requires positive series and period");
+    }
+    previous_.assign(series, 0.0);
+    avg_gain_.assign(series, 0.0);
+    avg_loss_.assign(series, 0.0);
+    value_.assign(series, NaN);
+}
+
+void IncrementalRSI::update(const double* row) {
+    const size_t n = series_;
+    const size_t changes = count_;          // 含本次在内的变动个数
+    count_++;
+    if (changes == 0) {
+        std::copy(row, row + n, previous_.begin());
+        return;
+    }
+
+    const double p = static_cast<double>(period_);
+    for (size_t s = 0; s < n; ++s) {
+        const double change = row[s] - previous_[s];
+        const double gain = std::max(change, 0.0);
+        const double loss = std::max(-change, 0.0);
+        if (changes <= period_) {
+            avg_gain_[s] += gain;
+            avg_loss_[s] += loss;
+            if (changes == period_) {
+                avg_gain_[s] /= p;
+                avg_loss_[s] /= p;
+                value_[s] = to_rsi(avg_gain_[s], avg_loss_[s]);
+            }
+        } else {
+            avg_gain_[s] = (avg_gain_[s] * (p - 1.0) + gain) / p;
+            avg_loss_[s] = (avg_loss_[s] * (p - 1.0) + loss) / p;
+            value_[s] = to_rsi(avg_gain_[s], avg_loss_[s]);
+        }
+        previous_[s] = row[s];
+    }
+}
+
+void IncrementalRSI::reset() {
+    count_ = 0;
+    std::fill(avg_gain_.begin(), avg_gain_.end(), 0.0);
+    std::fill(avg_loss_.begin(), avg_loss_.end(), 0.0);
+    std::fill(value_.begin(), value_.end(), NaN);
+}
+
+// ==================== IncrementalMACD ====================
+
+IncrementalMACD::IncrementalMACD(size_t series, size_t fast_period, size_t slow_period, size_t signal_period)
+    : series_(series)
+    , fast_(IncrementalEMA::from_period(series, fast_period))
+    , slow_(IncrementalEMA::from_period(series, slow_period))
+    , signal_(IncrementalEMA::from_period(series, signal_period))
+{
+    macd_.assign(series, NaN);
+    histogram_.assign(series, NaN);
+}
+
+void IncrementalMACD::update(const double* row) {
+    fast_.update(row);
+    slow_.update(row);
+    SimdMath::subtract(fast_.value(), slow_.value(), macd_.data(), series_);
+    signal_.update(macd_.data());
+    SimdMath::subtract(macd_.data(), signal_.value(), histogram_.data(), series_);
+}
+
+void IncrementalMACD::reset() {
+    fast_.reset();
+    slow_.reset();
+    signal_.reset();
+    std::fill(macd_.begin(), macd_.end(), NaN);
+    std::fill(histogram_.begin(), histogram_.end(), NaN);
+}
+
+// ==================== IncrementalBollinger ====================
+
+IncrementalBollinger::IncrementalBollinger(size_t series, size_t window, double multiplier)
+    : moments_(series, window)
+    , multiplier_(multiplier)
+{
+    middle_.assign(series, NaN);
+    upper_.assign(series, NaN);
+    lower_.assign(series, NaN);
+}
+
+void IncrementalBollinger::update(const double* row) {
+    moments_.push(row);
+    count_++;
+    if (!ready()) {
+        return;
+    }
+
+    const size_t n = series();
+    const double* mean = moments_.mean();
+    moments_.stddev(upper_.data());
+    for (size_t s = 0; s < n; ++s) {
+        const double band = multiplier_ * upper_[s];
+        middle_[s] = mean[s];
+        upper_[s] = mean[s] + band;
+        lower_[s] = mean[s] - band;
+    }
+}
+
+void IncrementalBollinger::reset() {
+    moments_.reset();
+    count_ = 0;
+    std::fill(middle_.begin(), middle_.end(), NaN);
+    std::fill(upper_.begin(), upper_.end(), NaN);
+    std::fill(lower_.begin(), lower_.end(), NaN);
+}
+
+// ==================== IncrementalATR ====================
+
+IncrementalATR::IncrementalATR(size_t series, size_t period)
+    : series_(series)
+    , period_(period)
+{
+    if (series == 0 || period == 0) {
+        throw std::invalid_argument("IncrementalATR requires positive series and period");
+    }
+    previous_close_.assign(series, 0.0);
+    atr_.assign(series, 0.0);
+    value_.assign(series, NaN);
+}
+
+void IncrementalATR::update(const double* high, const double* low, const double* close) {
+    const size_t n = series_;
+    const bool first = count_ == 0;
+    count_++;
+
+    const double p = static_cast<double>(period_);
+    for (size_t s = 0; s < n; ++s) {
+        double tr = high[s] - low[s];
+        if (!first) {
+            tr = std::max({tr, std::abs(high[s] - previous_close_[s]), std::abs(low[s] - previous_close_[s])});
+        }
+        if (count_ <= period_) {
+            atr_[s] += tr;
+            if (count_ == period_) {
+                atr_[s] /= p;
+                value_[s] = atr_[s];
+            }
+        } else {
+            atr_[s] = (atr_[s] * (p - 1.0) + tr) / p;
+            value_[s] = atr_[s];
+        }
+        previous_close_[s] = close[s];
+    }
+}
+
+void IncrementalATR::reset() {
+    count_ = 0;
+    std::fill(atr_.begin(), atr_.end(), 0.0);
+    std::fill(value_.begin(), value_.end(), NaN);
+}
+
+// ==================== IncrementalZScore ====================
+
+IncrementalZScore::IncrementalZScore(size_t series, size_t window)
+    : moments_(series, window)
+{
+    stddev_.assign(series, NaN);
+    value_.assign(series, NaN);
+}
+
+void IncrementalZScore::update(const double* row) {
+    moments_.push(row);
+    count_++;
+    if (!ready()) {
+        return;
+    }
+
+    const size_t n = series();
+    const double* mean = moments_.mean();
+    moments_.stddev(stddev_.data());
+    for (size_t s = 0; s < n; ++s) {
+        value_[s] = stddev_[s] > 0.0 ? (row[s] - mean[s]) / stddev_[s] : 0.0;
+    }
+}
+
+void IncrementalZScore::reset() {
+    moments_.reset();
+    count_ = 0;
+    std::fill(stddev_.begin(), stddev_.end(), NaN);
+    std::fill(value_.begin(), value_.end(), NaN);
+}
+
+} // namespace qaultra::analysis
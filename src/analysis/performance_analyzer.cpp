@@ -1,4 +1,6 @@
 #include "qaultra/analysis/performance_analyzer.hpp"
+#include "qaultra/analysis/rolling_stats.hpp"
+#include "qaultra/util/datetime.hpp"
 #include <algorithm>
 #include <numeric>
 #include <cmath>
@@ -177,6 +179,181 @@ bool PerformanceReport::save_to_file(const std::string& filename) const {
     }
 }
 
+// ==================== TradePairStore 实现 ====================
+
+namespace {
+
+int64_t trade_time(const std::chrono::system_clock::time_point& time_point, const std::string& text) {
+    if (time_point.time_since_epoch().count() != 0) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time_point.time_since_epoch()).count();
+    }
+    return util::datetime::parse_datetime_nanos(text);
+}
+
+std::string format_trade_time(int64_t nanos) {
+    if (nanos == 0) {
+        return std::string();
+    }
+    if (nanos % util::datetime::NANOS_PER_DAY == 0) {
+        return util::datetime::format_date(util::datetime::days_from_nanos(nanos));
+    }
+    return util::datetime::format_datetime(nanos);
+}
+
+std::chrono::system_clock::time_point to_time_point(int64_t nanos) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanos)));
+}
+
+} // namespace
+
+uint32_t TradePairStore::intern(const std::string& symbol) {
+    const auto [it, inserted] = code_index.emplace(symbol, static_cast<uint32_t>(codes.size()));
+    if (inserted) {
+        codes.push_back(symbol);
+    }
+    return it->second;
+}
+
+size_t TradePairStore::append(const TradePair& trade) {
+    code.push_back(intern(trade.code));
+    open_time.push_back(trade_time(trade.open_datetime, trade.open_date));
+    close_time.push_back(trade_time(trade.close_datetime, trade.close_date));
+    is_buy_open.push_back(trade.is_buy_open ? 1 : 0);
+    amount.push_back(trade.amount);
+    open_price.push_back(trade.open_price);
+    close_price.push_back(trade.close_price);
+    pnl_ratio.push_back(trade.pnl_ratio);
+    pnl_money.push_back(trade.pnl_money);
+    hold_gap_days.push_back(trade.hold_gap_days);
+    commission.push_back(trade.commission);
+    return size() - 1;
+}
+
+TradePair TradePairStore::row(size_t index) const {
+    TradePair trade;
+    trade.code = codes[code[index]];
+    trade.open_datetime = to_time_point(open_time[index]);
+    trade.close_datetime = to_time_point(close_time[index]);
+    trade.open_date = format_trade_time(open_time[index]);
+    trade.close_date = format_trade_time(close_time[index]);
+    trade.is_buy_open = is_buy_open[index] != 0;
+    trade.amount = amount[index];
+    trade.open_price = open_price[index];
+    trade.close_price = close_price[index];
+    trade.pnl_ratio = pnl_ratio[index];
+    trade.pnl_money = pnl_money[index];
+    trade.hold_gap_days = hold_gap_days[index];
+    trade.commission = commission[index];
+    return trade;
+}
+
+// ==================== TradeStatsAccumulator 实现 ====================
+
+void TradeStatsAccumulator::add(double pnl_money, double pnl_ratio, double hold_gap_days) {
+    count_++;
+    holding_days_ += hold_gap_days;
+    if (pnl_money > 0.0) {
+        profitable_++;
+        win_sum_ += pnl_money;
+    } else {
+        loss_sum_ += std::abs(pnl_money);
+    }
+    largest_win_ = std::max(largest_win_, pnl_money);
+    largest_loss_ = std::min(largest_loss_, pnl_money);
+
+    // 1~4 阶中心矩的单遍更新
+    const double r = pnl_ratio;
+    const double n = static_cast<double>(count_);
+    const double delta = r - mean_;
+    const double delta_n = delta / n;
+    const double delta_n2 = delta_n * delta_n;
+    const double term = delta * delta_n * (n - 1.0);
+    mean_ += delta_n;
+    m4_ += term * delta_n2 * (n * n - 3.0 * n + 3.0) + 6.0 * delta_n2 * m2_ - 4.0 * delta_n * m3_;
+    m3_ += term * delta_n * (n - 2.0) - 3.0 * delta_n * m2_;
+    m2_ += term;
+
+    growth_ *= 1.0 + r;
+    if (count_ == 1) {
+        first_ = r;
+        peak_ = r;
+    }
+    last_ = r;
+    peak_ = std::max(peak_, r);
+    max_drawdown_ = std::max(max_drawdown_, (peak_ - r) / peak_);
+    if (r < 0.0) {
+        downside_sq_ += r * r;
+        downside_count_++;
+    }
+    pending_.push_back(r);
+}
+
+void TradeStatsAccumulator::merge_pending() const {
+    if (pending_.empty()) {
+        return;
+    }
+    // 新增部分排序后与已有序部分归并一次，避免逐笔有序插入的 O(n) 搬移
+    std::sort(pending_.begin(), pending_.end());
+    const size_t middle = sorted_.size();
+    sorted_.insert(sorted_.end(), pending_.begin(), pending_.end());
+    std::inplace_merge(sorted_.begin(), sorted_.begin() + middle, sorted_.end());
+    pending_.clear();
+}
+
+RiskMetrics TradeStatsAccumulator::metrics(double var_confidence) const {
+    RiskMetrics metrics;
+    if (count_ == 0) {
+        return metrics;
+    }
+
+    const double n = static_cast<double>(count_);
+    const int losses = static_cast<int>(count_) - profitable_;
+    metrics.total_trades = static_cast<int>(count_);
+    metrics.profitable_trades = profitable_;
+    metrics.loss_trades = losses;
+    metrics.largest_win = largest_win_;
+    metrics.largest_loss = largest_loss_;
+    metrics.win_rate = static_cast<double>(profitable_) / metrics.total_trades;
+    metrics.average_holding_period = holding_days_ / metrics.total_trades;
+    if (profitable_ > 0) {
+        metrics.average_win = win_sum_ / profitable_;
+    }
+    if (losses > 0) {
+        metrics.average_loss = loss_sum_ / losses;
+    }
+    if (metrics.average_loss > 0) {
+        metrics.profit_loss_ratio = metrics.average_win / metrics.average_loss;
+    }
+
+    const double sqrt_days = std::sqrt(252.0);
+    const double stddev = std::sqrt(m2_ / n);
+    metrics.total_return = count_ < 2 || first_ == 0.0 ? 0.0 : (last_ - first_) / first_;
+    metrics.annual_return = std::pow(1.0 + (growth_ - 1.0), 252.0 / n) - 1.0;
+    metrics.annual_volatility = stddev * sqrt_days;
+    metrics.sharpe_ratio = stddev > 0 ? mean_ / stddev * sqrt_days : 0.0;
+    const double downside = downside_count_ > 0 ? std::sqrt(downside_sq_ / downside_count_) : 0.0;
+    metrics.sortino_ratio = downside > 0 ? mean_ / downside * sqrt_days : 0.0;
+    metrics.max_drawdown = max_drawdown_;
+
+    merge_pending();
+    size_t var_index = static_cast<size_t>(sorted_.size() * var_confidence);
+    var_index = std::min(var_index, sorted_.size() - 1);
+    metrics.value_at_risk_95 = -sorted_[var_index];
+    const size_t cutoff = std::max<size_t>(1, static_cast<size_t>(sorted_.size() * var_confidence));
+    metrics.conditional_var_95 = -std::accumulate(sorted_.begin(), sorted_.begin() + cutoff, 0.0) / cutoff;
+
+    if (stddev != 0) {
+        if (count_ >= 3) {
+            metrics.skew = (m3_ / n) / (stddev * stddev * stddev);
+        }
+        if (count_ >= 4) {
+            metrics.kurtosis = (m4_ / n) / (stddev * stddev * stddev * stddev) - 3.0;
+        }
+    }
+    return metrics;
+}
+
 // ==================== SingleAssetPerformanceAnalyzer 实现 ====================
 
 SingleAssetPerformanceAnalyzer::SingleAssetPerformanceAnalyzer(const std::string& asset_code)
@@ -292,6 +469,7 @@ void PortfolioPerformanceAnalyzer::set_benchmark(const std::vector<double>& benc
     std::lock_guard<std::mutex> lock(mutex_);
     benchmark_returns_ = benchmark_returns;
     benchmark_dates_ = dates;
+    curve_dirty_ = true;
 }
 
 void PortfolioPerformanceAnalyzer::add_account_curve(const std::vector<double>& account_values,
@@ -299,39 +477,72 @@ void PortfolioPerformanceAnalyzer::add_account_curve(const std::vector<double>&
     std::lock_guard<std::mutex> lock(mutex_);
     account_values_ = account_values;
     dates_ = dates;
+    curve_dirty_ = true;
 }
 
 void PortfolioPerformanceAnalyzer::add_trade_pair(const TradePair& trade_pair) {
     std::lock_guard<std::mutex> lock(mutex_);
-    trade_pairs_.push_back(trade_pair);
-    trade_pairs_by_asset_[trade_pair.code].push_back(trade_pair);
+    append_trade_pair(trade_pair);
 }
 
 void PortfolioPerformanceAnalyzer::add_trade_pairs(const std::vector<TradePair>& trade_pairs) {
     std::lock_guard<std::mutex> lock(mutex_);
     for (const auto& trade : trade_pairs) {
-        trade_pairs_.push_back(trade);
-        trade_pairs_by_asset_[trade.code].push_back(trade);
+        append_trade_pair(trade);
     }
 }
 
-RiskMetrics PortfolioPerformanceAnalyzer::calculate_portfolio_metrics() const {
+void PortfolioPerformanceAnalyzer::append_trade_pair(const TradePair& trade_pair) {
+    const size_t row = trades_.append(trade_pair);
+    const uint32_t asset = trades_.code[row];
+    if (asset >= asset_stats_.size()) {
+        asset_stats_.resize(asset + 1);
+        asset_dirty_.resize(asset + 1, 0);
+    }
+    asset_stats_[asset].add(trade_pair.pnl_money, trade_pair.get_return_rate(), trade_pair.hold_gap_days);
+    if (trade_pair.is_profitable()) {
+        profitable_trades_++;
+    }
+    if (!asset_dirty_[asset]) {
+        asset_dirty_[asset] = 1;
+        dirty_assets_.push_back(asset);
+    }
+}
+
+size_t PortfolioPerformanceAnalyzer::get_trade_count() const {
     std::lock_guard<std::mutex> lock(mutex_);
+    return trades_.size();
+}
 
-    RiskMetrics metrics;
+std::vector<TradePair> PortfolioPerformanceAnalyzer::get_trade_pairs(size_t from) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<TradePair> result;
+    for (size_t row = from; row < trades_.size(); ++row) {
+        result.push_back(trades_.row(row));
+    }
+    return result;
+}
 
-    // 计算组合收益率
-    auto portfolio_returns = calculate_daily_returns();
+void PortfolioPerformanceAnalyzer::refresh_curve_cache() const {
+    if (!curve_dirty_) {
+        return;
+    }
+    daily_returns_ = calculate_daily_returns();
+    cumulative_returns_ = calculate_cumulative_returns();
+    curve_metrics_ = RiskMetrics();
+    curve_dirty_ = false;
 
+    const auto& portfolio_returns = daily_returns_;
     if (portfolio_returns.empty()) {
-        return metrics;
+        return;
     }
+    RiskMetrics& metrics = curve_metrics_;
 
     // 基础收益指标
     metrics.total_return = RiskCalculator::calculate_return(account_values_);
     metrics.annual_return = RiskCalculator::calculate_annual_return(portfolio_returns);
     metrics.annual_volatility = RiskCalculator::calculate_volatility(portfolio_returns);
-    metrics.max_drawdown = RiskCalculator::calculate_max_drawdown(calculate_cumulative_returns());
+    metrics.max_drawdown = RiskCalculator::calculate_max_drawdown(cumulative_returns_);
 
     // 风险比率
     metrics.sharpe_ratio = RiskCalculator::calculate_sharpe_ratio(portfolio_returns);
@@ -354,41 +565,45 @@ RiskMetrics PortfolioPerformanceAnalyzer::calculate_portfolio_metrics() const {
         metrics.alpha = RiskCalculator::calculate_alpha(portfolio_returns, benchmark_returns_);
         metrics.beta = RiskCalculator::calculate_beta(portfolio_returns, benchmark_returns_);
     }
+}
 
-    // 交易统计
-    metrics.total_trades = trade_pairs_.size();
-    for (const auto& trade : trade_pairs_) {
-        if (trade.is_profitable()) {
-            metrics.profitable_trades++;
-        } else {
-            metrics.loss_trades++;
-        }
+void PortfolioPerformanceAnalyzer::refresh_asset_cache() const {
+    for (uint32_t asset : dirty_assets_) {
+        by_asset_cache_[trades_.codes[asset]] = asset_stats_[asset].metrics();
+        asset_dirty_[asset] = 0;
+    }
+    dirty_assets_.clear();
+}
+
+RiskMetrics PortfolioPerformanceAnalyzer::portfolio_metrics_locked() const {
+    refresh_curve_cache();
+    if (daily_returns_.empty()) {
+        return RiskMetrics();
     }
 
+    // 交易统计
+    RiskMetrics metrics = curve_metrics_;
+    metrics.total_trades = static_cast<int>(trades_.size());
+    metrics.profitable_trades = profitable_trades_;
+    metrics.loss_trades = metrics.total_trades - profitable_trades_;
     if (metrics.total_trades > 0) {
         metrics.win_rate = static_cast<double>(metrics.profitable_trades) / metrics.total_trades;
     }
-
     return metrics;
 }
 
-std::unordered_map<std::string, RiskMetrics> PortfolioPerformanceAnalyzer::calculate_by_asset_metrics() const {
+RiskMetrics PortfolioPerformanceAnalyzer::calculate_portfolio_metrics() const {
     std::lock_guard<std::mutex> lock(mutex_);
+    return portfolio_metrics_locked();
+}
 
-    std::unordered_map<std::string, RiskMetrics> results;
-
-    for (const auto& [asset, trades] : trade_pairs_by_asset_) {
-        SingleAssetPerformanceAnalyzer analyzer(asset);
-        for (const auto& trade : trades) {
-            analyzer.add_trade_pair(trade);
-        }
-        results[asset] = analyzer.calculate_metrics();
-    }
-
-    return results;
+std::unordered_map<std::string, RiskMetrics> PortfolioPerformanceAnalyzer::calculate_by_asset_metrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh_asset_cache();
+    return by_asset_cache_;
 }
 
-PerformanceReport PortfolioPerformanceAnalyzer::generate_report() const {
+PerformanceReport PortfolioPerformanceAnalyzer::generate_report(bool include_trade_pairs) const {
     std::lock_guard<std::mutex> lock(mutex_);
 
     PerformanceReport report;
@@ -399,13 +614,19 @@ PerformanceReport PortfolioPerformanceAnalyzer::generate_report() const {
         report.end_date = dates_.back();
     }
 
-    report.metrics = calculate_portfolio_metrics();
-    report.trade_pairs = trade_pairs_;
-    report.daily_returns = calculate_daily_returns();
-    report.cumulative_returns = calculate_cumulative_returns();
+    report.metrics = portfolio_metrics_locked();
+    if (include_trade_pairs) {
+        report.trade_pairs.reserve(trades_.size());
+        for (size_t row = 0; row < trades_.size(); ++row) {
+            report.trade_pairs.push_back(trades_.row(row));
+        }
+    }
+    report.daily_returns = daily_returns_;
+    report.cumulative_returns = cumulative_returns_;
     report.benchmark_returns = benchmark_returns_;
     report.dates = dates_;
-    report.by_asset = calculate_by_asset_metrics();
+    refresh_asset_cache();
+    report.by_asset = by_asset_cache_;
 
     return report;
 }
@@ -464,7 +685,7 @@ std::vector<double> PortfolioPerformanceAnalyzer::calculate_excess_returns() con
 // ==================== RiskCalculator 实现 ====================
 
 double RiskCalculator::calculate_return(const std::vector<double>& values) {
-    if (values.size() < 2) return 0.0;
+    if (values.size() < 2 || values.front() == 0.0) return 0.0;
     return (values.back() - values.front()) / values.front();
 }
 
@@ -713,14 +934,19 @@ double RiskCalculator::calculate_tail_ratio(const std::vector<double>& returns)
 std::vector<double> RiskCalculator::calculate_rolling_sharpe(const std::vector<double>& returns, int window) {
     std::vector<double> rolling_sharpe;
 
-    if (returns.size() < static_cast<size_t>(window)) {
+    if (window <= 0 || returns.size() < static_cast<size_t>(window)) {
         return rolling_sharpe;
     }
 
-    for (size_t i = window - 1; i < returns.size(); ++i) {
-        std::vector<double> window_returns(returns.begin() + i - window + 1, returns.begin() + i + 1);
-        double sharpe = calculate_sharpe_ratio(window_returns);
-        rolling_sharpe.push_back(sharpe);
+    // 滑动窗口矩，每步 O(1)
+    rolling_sharpe.reserve(returns.size() - window + 1);
+    RollingMoments moments(window);
+    for (double ret : returns) {
+        moments.push(ret);
+        if (moments.full()) {
+            double volatility = moments.stddev();
+            rolling_sharpe.push_back(volatility > 0 ? moments.mean() / volatility * std::sqrt(252.0) : 0.0);
+        }
     }
 
     return rolling_sharpe;
@@ -729,14 +955,17 @@ std::vector<double> RiskCalculator::calculate_rolling_sharpe(const std::vector<d
 std::vector<double> RiskCalculator::calculate_rolling_volatility(const std::vector<double>& returns, int window) {
     std::vector<double> rolling_vol;
 
-    if (returns.size() < static_cast<size_t>(window)) {
+    if (window <= 0 || returns.size() < static_cast<size_t>(window)) {
         return rolling_vol;
     }
 
-    for (size_t i = window - 1; i < returns.size(); ++i) {
-        std::vector<double> window_returns(returns.begin() + i - window + 1, returns.begin() + i + 1);
-        double vol = calculate_volatility(window_returns, true);
-        rolling_vol.push_back(vol);
+    rolling_vol.reserve(returns.size() - window + 1);
+    RollingMoments moments(window);
+    for (double ret : returns) {
+        moments.push(ret);
+        if (moments.full()) {
+            rolling_vol.push_back(moments.stddev() * std::sqrt(252.0));
+        }
     }
 
     return rolling_vol;
@@ -745,14 +974,17 @@ std::vector<double> RiskCalculator::calculate_rolling_volatility(const std::vect
 std::vector<double> RiskCalculator::calculate_rolling_max_drawdown(const std::vector<double>& cumulative_returns, int window) {
     std::vector<double> rolling_dd;
 
-    if (cumulative_returns.size() < static_cast<size_t>(window)) {
+    if (window <= 0 || cumulative_returns.size() < static_cast<size_t>(window)) {
         return rolling_dd;
     }
 
-    for (size_t i = window - 1; i < cumulative_returns.size(); ++i) {
-        std::vector<double> window_values(cumulative_returns.begin() + i - window + 1, cumulative_returns.begin() + i + 1);
-        double dd = calculate_max_drawdown(window_values);
-        rolling_dd.push_back(dd);
+    rolling_dd.reserve(cumulative_returns.size() - window + 1);
+    RollingDrawdown drawdown(window);
+    for (double value : cumulative_returns) {
+        drawdown.push(value);
+        if (drawdown.full()) {
+            rolling_dd.push_back(drawdown.max_drawdown());
+        }
     }
 
     return rolling_dd;
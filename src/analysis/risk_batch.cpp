@@ -0,0 +1,182 @@
+#include "qaultra/analysis/performance_analyzer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace qaultra::analysis {
+
+// ==================== RiskMetricsTable 实现 ====================
+
+void RiskMetricsTable::resize(size_t series) {
+    for (auto* column : {&total_return, &annual_return, &annual_volatility, &max_drawdown,
+                         &sharpe_ratio, &sortino_ratio, &calmar_ratio, &omega_ratio,
+                         &downside_risk, &value_at_risk, &conditional_var, &tail_ratio,
+                         &skew, &kurtosis}) {
+        column->assign(series, 0.0);
+    }
+}
+
+RiskMetrics RiskMetricsTable::row(size_t series) const {
+    RiskMetrics metrics;
+    metrics.total_return = total_return[series];
+    metrics.annual_return = annual_return[series];
+    metrics.annual_volatility = annual_volatility[series];
+    metrics.max_drawdown = max_drawdown[series];
+    metrics.sharpe_ratio = sharpe_ratio[series];
+    metrics.sortino_ratio = sortino_ratio[series];
+    metrics.calmar_ratio = calmar_ratio[series];
+    metrics.omega_ratio = omega_ratio[series];
+    metrics.downside_risk = downside_risk[series];
+    metrics.value_at_risk_95 = value_at_risk[series];
+    metrics.conditional_var_95 = conditional_var[series];
+    metrics.tail_ratio = tail_ratio[series];
+    metrics.skew = skew[series];
+    metrics.kurtosis = kurtosis[series];
+    return metrics;
+}
+
+// ==================== 批量计算 ====================
+
+namespace {
+
+/**
+ * @brief 单个序列的融合计算，scratch 为线程私有的分位数缓冲
+ */
+void compute_series(const double* returns, size_t n, const BatchRiskOptions& options,
+                    RiskMetricsTable& table, size_t index, std::vector<double>& scratch) {
+    if (n == 0) {
+        return;
+    }
+
+    // 一次遍历: 在线中心矩 (Terriberry)、净值与回撤、下行偏差、欧米茄收益/损失
+    double mean = 0.0, m2 = 0.0, m3 = 0.0, m4 = 0.0;
+    double nav = 1.0, peak = 1.0, max_dd = 0.0;
+    double downside_sq = 0.0, gains = 0.0, losses = 0.0;
+    size_t downside_count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double x = returns[i];
+        const double k = static_cast<double>(i + 1);
+        const double delta = x - mean;
+        const double delta_n = delta / k;
+        const double delta_n2 = delta_n * delta_n;
+        const double term = delta * delta_n * (k - 1.0);
+        mean += delta_n;
+        m4 += term * delta_n2 * (k * k - 3.0 * k + 3.0) + 6.0 * delta_n2 * m2 - 4.0 * delta_n * m3;
+        m3 += term * delta_n * (k - 2.0) - 3.0 * delta_n * m2;
+        m2 += term;
+
+        nav *= 1.0 + x;
+        peak = std::max(peak, nav);
+        max_dd = std::max(max_dd, (peak - nav) / peak);
+
+        if (x < 0.0) {
+            downside_sq += x * x;
+            downside_count++;
+        }
+        if (x > 0.0) {
+            gains += x;
+        } else {
+            losses -= x;
+        }
+    }
+
+    const double count = static_cast<double>(n);
+    const double days = static_cast<double>(options.trading_days);
+    const double variance = std::max(m2, 0.0) / count;
+    const double volatility = std::sqrt(variance);
+    const double excess_return = mean - options.risk_free_rate / days;
+    const double downside = downside_count > 0 ? std::sqrt(downside_sq / downside_count) : 0.0;
+    const double annual_return = std::pow(nav, days / count) - 1.0;
+
+    table.total_return[index] = nav - 1.0;
+    table.annual_return[index] = annual_return;
+    table.annual_volatility[index] = volatility * std::sqrt(days);
+    table.max_drawdown[index] = max_dd;
+    table.sharpe_ratio[index] = volatility > 0 ? excess_return / volatility * std::sqrt(days) : 0.0;
+    table.sortino_ratio[index] = downside > 0 ? excess_return / downside * std::sqrt(days) : 0.0;
+    table.calmar_ratio[index] = max_dd > 0 ? annual_return / max_dd : 0.0;
+    table.omega_ratio[index] = losses > 0 ? gains / losses : 0.0;
+    table.downside_risk[index] = downside;
+    if (volatility > 0) {
+        table.skew[index] = n >= 3 ? (m3 / count) / (variance * volatility) : 0.0;
+        table.kurtosis[index] = n >= 4 ? (m4 / count) / (variance * variance) - 3.0 : 0.0;
+    }
+
+    // 分位数: 按升序依次在剩余区间上 nth_element，得到精确的次序统计量
+    scratch.assign(returns, returns + n);
+    const auto clamp_index = [n](double position) {
+        return std::min(static_cast<size_t>(position), n - 1);
+    };
+    const size_t var_cutoff = std::min(static_cast<size_t>(count * options.var_confidence), n);
+    const size_t var_index = clamp_index(count * options.var_confidence);
+    const size_t index_5 = clamp_index(count * 0.05);
+    const size_t index_95 = clamp_index(count * 0.95);
+
+    size_t ranks[3] = {var_index, index_5, index_95};
+    std::sort(ranks, ranks + 3);
+    size_t partitioned = 0;
+    for (size_t rank : ranks) {
+        if (rank >= partitioned) {
+            std::nth_element(scratch.begin() + partitioned, scratch.begin() + rank, scratch.end());
+            partitioned = rank + 1;
+        }
+    }
+
+    table.value_at_risk[index] = -scratch[var_index];
+
+    // var_cutoff < n 时 var_index == var_cutoff，分区后 [0, var_index) 即最小的 var_cutoff 个收益
+    const size_t cutoff = std::max<size_t>(var_cutoff, 1);
+    double tail_sum = 0.0;
+    for (size_t i = 0; i < cutoff; ++i) {
+        tail_sum += scratch[i];
+    }
+    table.conditional_var[index] = -tail_sum / static_cast<double>(cutoff);
+
+    const double percentile_5 = scratch[index_5];
+    const double percentile_95 = scratch[index_95];
+    table.tail_ratio[index] = percentile_5 < 0 ? percentile_95 / std::abs(percentile_5) : 0.0;
+}
+
+} // namespace
+
+RiskMetricsTable RiskCalculator::calculate_batch_metrics(const double* returns, size_t periods, size_t series,
+                                                         const BatchRiskOptions& options) {
+    RiskMetricsTable table;
+    table.resize(series);
+    if (series == 0 || periods == 0) {
+        return table;
+    }
+
+    size_t num_threads = options.threads > 0
+        ? options.threads
+        : std::max<size_t>(1, std::thread::hardware_concurrency());
+    num_threads = std::min(num_threads, series);
+
+    const auto run_range = [&](size_t begin, size_t end) {
+        std::vector<double> scratch;
+        scratch.reserve(periods);
+        for (size_t s = begin; s < end; ++s) {
+            compute_series(returns + s * periods, periods, options, table, s, scratch);
+        }
+    };
+
+    if (num_threads == 1) {
+        run_range(0, series);
+        return table;
+    }
+
+    // 各线程写入不相交的列下标，无需加锁
+    std::vector<std::thread> threads;
+    const size_t chunk_size = (series + num_threads - 1) / num_threads;
+    for (size_t i = 0; i < num_threads && i * chunk_size < series; ++i) {
+        threads.emplace_back(run_range, i * chunk_size, std::min(series, (i + 1) * chunk_size));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return table;
+}
+
+} // namespace qaultra::analysis
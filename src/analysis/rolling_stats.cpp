@@ -0,0 +1,255 @@
+#include "qaultra/analysis/rolling_stats.hpp"
+#include "qaultra/simd/simd_math.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace qaultra::analysis {
+
+using simd::SimdMath;
+
+// ==================== RollingMoments ====================
+
+RollingMoments::RollingMoments(size_t window)
+    : window_(window)
+    , buffer_(window)
+{
+    if (window == 0) {
+        throw std::invalid_argument("RollingMoments window must be positive");
+    }
+}
+
+void RollingMoments::push(double value) {
+    run_ = (count_ > 0 && value == last_) ? run_ + 1 : 1;
+    last_ = value;
+
+    if (count_ < window_) {
+        buffer_[count_++] = value;
+        const double delta = value - mean_;
+        mean_ += delta / static_cast<double>(count_);
+        m2_ += delta * (value - mean_);
+    } else {
+        const double old = buffer_[head_];
+        buffer_[head_] = value;
+        head_ = (head_ + 1) % window_;
+
+        const double old_mean = mean_;
+        const double delta = value - old;
+        mean_ += delta / static_cast<double>(window_);
+        m2_ += delta * (value - mean_ + old - old_mean);
+    }
+
+    if (run_ >= count_) {
+        // 窗口内全部相同: 精确结果
+        mean_ = value;
+        m2_ = 0.0;
+    }
+}
+
+void RollingMoments::reset() {
+    head_ = 0;
+    count_ = 0;
+    mean_ = 0.0;
+    m2_ = 0.0;
+    run_ = 0;
+}
+
+double RollingMoments::variance() const {
+    return count_ == 0 ? 0.0 : std::max(m2_, 0.0) / static_cast<double>(count_);
+}
+
+double RollingMoments::stddev() const {
+    return std::sqrt(variance());
+}
+
+// ==================== RollingDrawdown ====================
+
+RollingDrawdown::RollingDrawdown(size_t window)
+    : window_(window)
+{
+    if (window == 0) {
+        throw std::invalid_argument("RollingDrawdown window must be positive");
+    }
+    front_.reserve(window);
+    back_values_.reserve(window);
+}
+
+RollingDrawdown::Summary RollingDrawdown::combine(const Summary& earlier, const Summary& later) {
+    const double crossing = (earlier.max - later.min) / earlier.max;
+    return Summary{std::max(earlier.max, later.max), std::min(earlier.min, later.min),
+                   std::max({earlier.drawdown, later.drawdown, crossing})};
+}
+
+void RollingDrawdown::push(double value) {
+    if (count() == window_) {
+        pop_front();
+    }
+    back_summary_ = back_values_.empty() ? leaf(value) : combine(back_summary_, leaf(value));
+    back_values_.push_back(value);
+    last_ = value;
+}
+
+void RollingDrawdown::pop_front() {
+    if (front_.empty()) {
+        // 把入栈端整体翻转到出栈端，自新向旧累积后缀摘要
+        Summary suffix = leaf(back_values_.back());
+        front_.push_back(suffix);
+        for (size_t i = back_values_.size() - 1; i-- > 0;) {
+            suffix = combine(leaf(back_values_[i]), suffix);
+            front_.push_back(suffix);
+        }
+        back_values_.clear();
+    }
+    front_.pop_back();
+}
+
+void RollingDrawdown::reset() {
+    front_.clear();
+    back_values_.clear();
+}
+
+double RollingDrawdown::max_drawdown() const {
+    if (front_.empty()) {
+        return back_values_.empty() ? 0.0 : back_summary_.drawdown;
+    }
+    if (back_values_.empty()) {
+        return front_.back().drawdown;
+    }
+    return combine(front_.back(), back_summary_).drawdown;
+}
+
+double RollingDrawdown::current_drawdown() const {
+    if (count() == 0) {
+        return 0.0;
+    }
+    double peak = back_values_.empty() ? front_.back().max : back_summary_.max;
+    if (!front_.empty()) {
+        peak = std::max(peak, front_.back().max);
+    }
+    return (peak - last_) / peak;
+}
+
+// ==================== RollingMomentsBatch ====================
+
+RollingMomentsBatch::RollingMomentsBatch(size_t series, size_t window)
+    : series_(series)
+    , window_(window)
+{
+    if (series == 0 || window == 0) {
+        throw std::invalid_argument("RollingMomentsBatch requires positive series and window");
+    }
+    rows_.resize(series * window);
+    mean_.assign(series, 0.0);
+    m2_.assign(series, 0.0);
+    run_.assign(series, 0);
+    delta_.resize(series);
+    scratch_.resize(series);
+    old_mean_.resize(series);
+}
+
+void RollingMomentsBatch::push(const double* row) {
+    const size_t n = series_;
+    const double* last = count_ > 0 ? rows_.data() + ((head_ + count_ - 1) % window_) * n : nullptr;
+    for (size_t s = 0; s < n; ++s) {
+        run_[s] = (last && row[s] == last[s]) ? run_[s] + 1 : 1;
+    }
+
+    double* slot = nullptr;
+    if (count_ < window_) {
+        // Welford 累加: delta = x - mean; mean += delta / n; m2 += delta * (x - mean)
+        slot = rows_.data() + count_ * n;
+        count_++;
+        SimdMath::subtract(row, mean_.data(), delta_.data(), n);
+        SimdMath::multiply_scalar(delta_.data(), 1.0 / static_cast<double>(count_), scratch_.data(), n);
+        SimdMath::add(mean_.data(), scratch_.data(), mean_.data(), n);
+        SimdMath::subtract(row, mean_.data(), scratch_.data(), n);
+    } else {
+        // 替换最旧一行: delta = x - old; mean += delta / w; m2 += delta * (x - mean + old - old_mean)
+        slot = rows_.data() + head_ * n;
+        head_ = (head_ + 1) % window_;
+        std::copy(mean_.begin(), mean_.end(), old_mean_.begin());
+        SimdMath::subtract(row, slot, delta_.data(), n);
+        SimdMath::multiply_scalar(delta_.data(), 1.0 / static_cast<double>(window_), scratch_.data(), n);
+        SimdMath::add(mean_.data(), scratch_.data(), mean_.data(), n);
+        SimdMath::subtract(row, mean_.data(), scratch_.data(), n);
+        SimdMath::add(scratch_.data(), slot, scratch_.data(), n);
+        SimdMath::subtract(scratch_.data(), old_mean_.data(), scratch_.data(), n);
+    }
+    SimdMath::multiply(delta_.data(), scratch_.data(), scratch_.data(), n);
+    SimdMath::add(m2_.data(), scratch_.data(), m2_.data(), n);
+    std::copy(row, row + n, slot);
+
+    for (size_t s = 0; s < n; ++s) {
+        if (run_[s] >= count_) {
+            mean_[s] = row[s];
+            m2_[s] = 0.0;
+        }
+    }
+}
+
+void RollingMomentsBatch::reset() {
+    head_ = 0;
+    count_ = 0;
+    std::fill(mean_.begin(), mean_.end(), 0.0);
+    std::fill(m2_.begin(), m2_.end(), 0.0);
+    std::fill(run_.begin(), run_.end(), 0);
+}
+
+void RollingMomentsBatch::variance(double* out) const {
+    const double inv = count_ == 0 ? 0.0 : 1.0 / static_cast<double>(count_);
+    for (size_t s = 0; s < series_; ++s) {
+        out[s] = std::max(m2_[s], 0.0) * inv;
+    }
+}
+
+void RollingMomentsBatch::stddev(double* out) const {
+    variance(out);
+    for (size_t s = 0; s < series_; ++s) {
+        out[s] = std::sqrt(out[s]);
+    }
+}
+
+// ==================== 面板函数 ====================
+
+void rolling_moments_batch(const double* panel, size_t length, size_t series, size_t window,
+                           double* mean_out, double* stddev_out) {
+    RollingMomentsBatch moments(series, window);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (size_t t = 0; t < length; ++t) {
+        moments.push(panel + t * series);
+        double* mean_row = mean_out + t * series;
+        double* std_row = stddev_out + t * series;
+        if (!moments.full()) {
+            std::fill(mean_row, mean_row + series, nan);
+            std::fill(std_row, std_row + series, nan);
+            continue;
+        }
+        std::copy(moments.mean(), moments.mean() + series, mean_row);
+        moments.stddev(std_row);
+    }
+}
+
+void rolling_sharpe_batch(const double* panel, size_t length, size_t series, size_t window,
+                          double* sharpe_out, double risk_free_rate, int trading_days) {
+    RollingMomentsBatch moments(series, window);
+    std::vector<double> vol(series);
+    const double daily_rf = risk_free_rate / trading_days;
+    const double scale = std::sqrt(static_cast<double>(trading_days));
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (size_t t = 0; t < length; ++t) {
+        moments.push(panel + t * series);
+        double* out = sharpe_out + t * series;
+        if (!moments.full()) {
+            std::fill(out, out + series, nan);
+            continue;
+        }
+        moments.stddev(vol.data());
+        const double* mean = moments.mean();
+        for (size_t s = 0; s < series; ++s) {
+            out[s] = vol[s] > 0 ? (mean[s] - daily_rf) / vol[s] * scale : 0.0;
+        }
+    }
+}
+
+} // namespace qaultra::analysis
@@ -0,0 +1,232 @@
+#include "qaultra/data/bar_aggregator.hpp"
+#include "qaultra/ipc/cross_lang_data.hpp"
+#include "qaultra/util/datetime.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace qaultra::data {
+
+namespace {
+
+int64_t floor_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+} // namespace
+
+const char* bar_period_name(BarPeriod period) {
+    switch (period) {
+        case BarPeriod::Min1:  return "1min";
+        case BarPeriod::Min5:  return "5min";
+        case BarPeriod::Min15: return "15min";
+        case BarPeriod::Min30: return "30min";
+        case BarPeriod::Min60: return "60min";
+        case BarPeriod::Day:   return "day";
+    }
+    return "unknown";
+}
+
+BarAggregator::BarAggregator(const BarAggregatorConfig& config)
+    : config_(config) {
+    current_bucket_.fill(NO_BUCKET);
+}
+
+int64_t BarAggregator::parse_datetime(const std::string& datetime) {
+    return util::datetime::parse_datetime_nanos(datetime);
+}
+
+int64_t BarAggregator::bucket_of(int64_t timestamp_ns, size_t period) const {
+    const int64_t length = bar_period_nanos(static_cast<BarPeriod>(period));
+    return floor_div(timestamp_ns + config_.time_offset_ns, length) * length - config_.time_offset_ns;
+}
+
+void BarAggregator::update(const AggregatorTick& tick, const Publisher& sink) {
+    if (tick.instrument_id == INVALID_INSTRUMENT_ID) {
+        return;
+    }
+
+    if (tick.instrument_id >= states_.size()) {
+        states_.resize(std::max<size_t>(tick.instrument_id + 1, states_.size() * 2));
+    }
+    InstrumentState& state = states_[tick.instrument_id];
+    stats_.ticks_processed++;
+
+    // 迟到判定对所有周期统一: 落后于任一周期的当前K线 (含已被 flush 关闭的周期) 即整体丢弃，
+    // 各周期K线保持一致；累计量不更新，其成交量计入下一个 Tick 的增量
+    for (size_t period = 0; period < BAR_PERIOD_COUNT; ++period) {
+        if (enabled(period) && bucket_of(tick.timestamp_ns, period) < current_bucket_[period]) {
+            stats_.late_ticks++;
+            return;
+        }
+    }
+
+    // 成交量/额增量 (累计值回退视为换日重置)
+    double delta_volume = tick.volume;
+    double delta_amount = tick.amount;
+    if (config_.cumulative_volume) {
+        delta_volume = tick.volume >= state.last_cum_volume ? tick.volume - state.last_cum_volume : tick.volume;
+        delta_amount = tick.amount >= state.last_cum_amount ? tick.amount - state.last_cum_amount : tick.amount;
+        state.last_cum_volume = tick.volume;
+        state.last_cum_amount = tick.amount;
+    }
+
+    for (size_t period = 0; period < BAR_PERIOD_COUNT; ++period) {
+        if (!enabled(period)) {
+            continue;
+        }
+
+        const int64_t bucket = bucket_of(tick.timestamp_ns, period);
+        if (bucket > current_bucket_[period]) {
+            if (!touched_[period].empty()) {
+                close_period(period, sink);
+                if (period == static_cast<size_t>(BarPeriod::Min1)) {
+                    publish_partial_daily(sink);
+                }
+            }
+            current_bucket_[period] = bucket;
+        }
+
+        BarState& bar = state.bars[period];
+        if (bar.bucket != bucket) {
+            bar.bucket = bucket;
+            bar.open = bar.high = bar.low = bar.close = tick.last_price;
+            bar.volume = delta_volume;
+            bar.amount = delta_amount;
+            touched_[period].push_back(tick.instrument_id);
+        } else {
+            bar.high = std::max(bar.high, tick.last_price);
+            bar.low = std::min(bar.low, tick.last_price);
+            bar.close = tick.last_price;
+            bar.volume += delta_volume;
+            bar.amount += delta_amount;
+        }
+        bar.limit_up = tick.limit_up;
+        bar.limit_down = tick.limit_down;
+    }
+}
+
+void BarAggregator::update(const protocol::mifi::Tick& tick, const Publisher& sink) {
+    AggregatorTick input;
+    input.instrument_id = intern_instrument(tick.instrument_id);
+    input.timestamp_ns = parse_datetime(tick.datetime);
+    input.last_price = tick.last_price;
+    input.volume = tick.volume;
+    input.amount = tick.amount;
+    input.limit_up = tick.limit_up;
+    input.limit_down = tick.limit_down;
+    update(input, sink);
+}
+
+void BarAggregator::update(const ipc::MarketTick& tick, const Publisher& sink) {
+    AggregatorTick input;
+    input.instrument_id = intern_instrument(
+        std::string_view(tick.symbol, strnlen(tick.symbol, sizeof(tick.symbol))));
+    input.timestamp_ns = tick.timestamp_ns;
+    input.last_price = tick.last_price;
+    input.volume = static_cast<double>(tick.volume);
+    update(input, sink);
+}
+
+void BarAggregator::flush(int64_t now_ns, const Publisher& sink) {
+    bool minute_closed = false;
+    for (size_t period = 0; period < BAR_PERIOD_COUNT; ++period) {
+        if (!enabled(period) || current_bucket_[period] == NO_BUCKET) {
+            continue;
+        }
+        const int64_t end = current_bucket_[period] + bar_period_nanos(static_cast<BarPeriod>(period));
+        if (end <= now_ns) {
+            if (!touched_[period].empty()) {
+                close_period(period, sink);
+                minute_closed |= period == static_cast<size_t>(BarPeriod::Min1);
+            }
+            // 推进到下一周期: 已发布周期内的后续 Tick 按迟到处理，不会静默修改已发布的K线
+            current_bucket_[period] = end;
+        }
+    }
+    if (minute_closed) {
+        publish_partial_daily(sink);
+    }
+}
+
+void BarAggregator::flush_all(const Publisher& sink) {
+    for (size_t period = 0; period < BAR_PERIOD_COUNT; ++period) {
+        if (!enabled(period) || current_bucket_[period] == NO_BUCKET) {
+            continue;
+        }
+        if (!touched_[period].empty()) {
+            close_period(period, sink);
+        }
+        current_bucket_[period] += bar_period_nanos(static_cast<BarPeriod>(period));
+    }
+}
+
+std::optional<Kline> BarAggregator::current_bar(InstrumentId instrument_id, BarPeriod period) const {
+    const size_t index = static_cast<size_t>(period);
+    if (instrument_id >= states_.size()) {
+        return std::nullopt;
+    }
+    const BarState& bar = states_[instrument_id].bars[index];
+    if (bar.bucket == NO_BUCKET || bar.bucket != current_bucket_[index]) {
+        return std::nullopt;
+    }
+    return to_kline(instrument_id, bar);
+}
+
+void BarAggregator::reset() {
+    states_.clear();
+    current_bucket_.fill(NO_BUCKET);
+    for (auto& touched : touched_) {
+        touched.clear();
+    }
+}
+
+Kline BarAggregator::to_kline(InstrumentId instrument_id, const BarState& bar) {
+    return Kline(instrument_id, bar.open, bar.close, bar.high, bar.low,
+                 bar.volume, bar.limit_up, bar.limit_down, bar.amount);
+}
+
+std::shared_ptr<const KlineMap> BarAggregator::collect(size_t period) const {
+    auto bars = std::make_shared<KlineMap>();
+    bars->reserve(touched_[period].size());
+    for (InstrumentId instrument_id : touched_[period]) {
+        const BarState& bar = states_[instrument_id].bars[period];
+        if (bar.bucket == current_bucket_[period]) {
+            bars->emplace(instrument_id, to_kline(instrument_id, bar));
+        }
+    }
+    return bars;
+}
+
+void BarAggregator::close_period(size_t period, const Publisher& sink) {
+    if (sink) {
+        BarCrossSection section;
+        section.period = static_cast<BarPeriod>(period);
+        section.timestamp_ns = current_bucket_[period];
+        section.final = true;
+        section.bars = collect(period);
+
+        stats_.sections_published++;
+        stats_.bars_published += section.bars->size();
+        sink(section);
+    }
+    touched_[period].clear();
+}
+
+void BarAggregator::publish_partial_daily(const Publisher& sink) {
+    const size_t day = static_cast<size_t>(BarPeriod::Day);
+    if (!sink || !config_.emit_partial_daily || !enabled(day) || touched_[day].empty()) {
+        return;
+    }
+
+    BarCrossSection section;
+    section.period = BarPeriod::Day;
+    section.timestamp_ns = current_bucket_[day];
+    section.final = false;
+    section.bars = collect(day);
+
+    stats_.sections_published++;
+    sink(section);
+}
+
+} // namespace qaultra::data
@@ -10,7 +10,7 @@ namespace qaultra::data {
 nlohmann::json StockCnDay::to_json() const {
     nlohmann::json j;
     j["date"] = utils::date_to_string(date);
-    j["order_book_id"] = order_book_id;
+    j["order_book_id"] = order_book_id();
     j["num_trades"] = num_trades;
     j["limit_up"] = limit_up;
     j["limit_down"] = limit_down;
@@ -43,7 +43,7 @@ StockCnDay StockCnDay::from_json(const nlohmann::json& j) {
 nlohmann::json StockCn1Min::to_json() const {
     nlohmann::json j;
     j["datetime"] = utils::timestamp_to_string(datetime);
-    j["order_book_id"] = order_book_id;
+    j["order_book_id"] = order_book_id();
     j["open"] = open;
     j["high"] = high;
     j["low"] = low;
@@ -71,7 +71,7 @@ nlohmann::json FutureCn1Min::to_json() const {
     nlohmann::json j;
     j["datetime"] = utils::timestamp_to_string(datetime);
     j["trading_date"] = utils::date_to_string(trading_date);
-    j["order_book_id"] = order_book_id;
+    j["order_book_id"] = order_book_id();
     j["open_interest"] = open_interest;
     j["open"] = open;
     j["high"] = high;
@@ -101,7 +101,7 @@ FutureCn1Min FutureCn1Min::from_json(const nlohmann::json& j) {
 nlohmann::json FutureCnDay::to_json() const {
     nlohmann::json j;
     j["date"] = utils::date_to_string(date);
-    j["order_book_id"] = order_book_id;
+    j["order_book_id"] = order_book_id();
     j["limit_up"] = limit_up;
     j["limit_down"] = limit_down;
     j["open_interest"] = open_interest;
@@ -137,7 +137,7 @@ FutureCnDay FutureCnDay::from_json(const nlohmann::json& j) {
 // Kline 实现
 nlohmann::json Kline::to_json() const {
     nlohmann::json j;
-    j["order_book_id"] = order_book_id;
+    j["order_book_id"] = order_book_id();
     j["open"] = open;
     j["close"] = close;
     j["high"] = high;
@@ -0,0 +1,69 @@
+#include "qaultra/data/instrument_registry.hpp"
+#include <mutex>
+#include <stdexcept>
+
+namespace qaultra::data {
+
+InstrumentRegistry& InstrumentRegistry::instance() {
+    static InstrumentRegistry registry;
+    return registry;
+}
+
+InstrumentRegistry::~InstrumentRegistry() {
+    for (auto& segment : segments_) {
+        delete[] segment.load(std::memory_order_relaxed);
+    }
+}
+
+InstrumentId InstrumentRegistry::intern(std::string_view code) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(code);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(code);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+
+    uint32_t id = size_.load(std::memory_order_relaxed);
+    size_t segment_index = id >> SEGMENT_BITS;
+    if (segment_index >= MAX_SEGMENTS) {
+        throw std::length_error("InstrumentRegistry 容量已满");
+    }
+
+    std::string* segment = segments_[segment_index].load(std::memory_order_relaxed);
+    if (!segment) {
+        segment = new std::string[SEGMENT_SIZE];
+        segments_[segment_index].store(segment, std::memory_order_release);
+    }
+
+    std::string& slot = segment[id & (SEGMENT_SIZE - 1)];
+    slot.assign(code.data(), code.size());
+    ids_.emplace(std::string_view(slot), id);
+
+    // 先写入字符串再发布 size_，保证无锁 code() 读到完整数据
+    size_.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+InstrumentId InstrumentRegistry::find(std::string_view code) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(code);
+    return it != ids_.end() ? it->second : INVALID_INSTRUMENT_ID;
+}
+
+const std::string& InstrumentRegistry::code(InstrumentId id) const {
+    static const std::string empty;
+    if (id >= size_.load(std::memory_order_acquire)) {
+        return empty;
+    }
+    const std::string* segment = segments_[id >> SEGMENT_BITS].load(std::memory_order_acquire);
+    return segment[id & (SEGMENT_SIZE - 1)];
+}
+
+} // namespace qaultra::data
@@ -1,31 +1,462 @@
 #include "qaultra/data/marketcenter.hpp"
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <algorithm>
 #include <memory>
-#include <iomanip>  // 添加 put_time 支持
 #include <set>
+#include <atomic>
+#include "qaultra/ipc/cross_lang_data.hpp"
+#include "qaultra/util/datetime.hpp"
 #include <arrow/compute/api.h>
 #include <arrow/csv/api.h>
 #include <arrow/filesystem/api.h>
+#include <arrow/util/thread_pool.h>
 
 namespace qaultra::data {
 
+namespace {
+
+/**
+ * @brief 时间键列 - 统一读取 date32/date64/timestamp/int64 列
+ *
+ * as_days 为 true 时换算为日期索引 (自1970-01-01起的天数)，否则换算为纳秒时间戳。
+ * 要求键列无空值 (combine_and_sort 已剔除空键行)。
+ */
+class KeyColumn {
+public:
+    KeyColumn() = default;
+
+    KeyColumn(const std::shared_ptr<arrow::Table>& table, const std::string& name, bool as_days) {
+        auto column = table ? table->GetColumnByName(name) : nullptr;
+        if (!column || column->num_chunks() == 0) {
+            return;
+        }
+
+        array_ = column->chunk(0);
+        int64_t per_second = 0;
+        switch (array_->type_id()) {
+            case arrow::Type::DATE32:
+                values32_ = std::static_pointer_cast<arrow::Date32Array>(array_)->raw_values();
+                if (!as_days) {
+                    mul_ = 86400LL * 1000000000LL;
+                }
+                return;
+            case arrow::Type::DATE64:
+                values64_ = std::static_pointer_cast<arrow::Date64Array>(array_)->raw_values();
+                per_second = 1000;
+                break;
+            case arrow::Type::TIMESTAMP:
+                values64_ = std::static_pointer_cast<arrow::TimestampArray>(array_)->raw_values();
+                switch (static_cast<const arrow::TimestampType&>(*array_->type()).unit()) {
+                    case arrow::TimeUnit::SECOND: per_second = 1; break;
+                    case arrow::TimeUnit::MILLI:  per_second = 1000; break;
+                    case arrow::TimeUnit::MICRO:  per_second = 1000000; break;
+                    case arrow::TimeUnit::NANO:   per_second = 1000000000; break;
+                }
+                break;
+            case arrow::Type::INT64:
+                // 无单位信息：按原值使用
+                values64_ = std::static_pointer_cast<arrow::Int64Array>(array_)->raw_values();
+                return;
+            default:
+                array_.reset();
+                return;
+        }
+
+        if (as_days) {
+            div_ = per_second * 86400;
+        } else {
+            mul_ = 1000000000 / per_second;
+        }
+    }
+
+    bool valid() const { return array_ != nullptr; }
+
+    int64_t operator[](int64_t i) const {
+        int64_t value = values32_ ? static_cast<int64_t>(values32_[i]) : values64_[i];
+        return div_ > 1 ? value / div_ : value * mul_;
+    }
+
+private:
+    std::shared_ptr<arrow::Array> array_;
+    const int32_t* values32_ = nullptr;
+    const int64_t* values64_ = nullptr;
+    int64_t mul_ = 1;
+    int64_t div_ = 1;
+};
+
+/**
+ * @brief 将单个chunk的证券代码转换为 InstrumentId 数组
+ *
+ * 字典编码列只注册字典值一次，逐行通过字典下标查表；
+ * 普通字符串列逐行注册。空值映射为 INVALID_INSTRUMENT_ID。
+ */
+std::shared_ptr<arrow::Array> encode_instrument_chunk(const std::shared_ptr<arrow::Array>& chunk) {
+    arrow::UInt32Builder builder;
+    if (!builder.Reserve(chunk->length()).ok()) {
+        return nullptr;
+    }
+
+    auto& registry = InstrumentRegistry::instance();
+
+    if (chunk->type_id() == arrow::Type::DICTIONARY) {
+        auto dict_array = std::static_pointer_cast<arrow::DictionaryArray>(chunk);
+        auto dictionary = arrow::compute::Cast(*dict_array->dictionary(), arrow::utf8());
+        if (!dictionary.ok()) {
+            std::cerr << "证券代码字典转换失败: " << dictionary.status().ToString() << std::endl;
+            return nullptr;
+        }
+
+        auto values = std::static_pointer_cast<arrow::StringArray>(*dictionary);
+        std::vector<InstrumentId> lookup(static_cast<size_t>(values->length()), INVALID_INSTRUMENT_ID);
+        for (int64_t i = 0; i < values->length(); ++i) {
+            if (!values->IsNull(i)) {
+                lookup[static_cast<size_t>(i)] = registry.intern(values->GetView(i));
+            }
+        }
+
+        for (int64_t i = 0; i < dict_array->length(); ++i) {
+            builder.UnsafeAppend(dict_array->IsNull(i) ? INVALID_INSTRUMENT_ID
+                : lookup[static_cast<size_t>(dict_array->GetValueIndex(i))]);
+        }
+    } else {
+        auto strings = arrow::compute::Cast(*chunk, arrow::utf8());
+        if (!strings.ok()) {
+            std::cerr << "证券代码列转换失败: " << strings.status().ToString() << std::endl;
+            return nullptr;
+        }
+
+        auto values = std::static_pointer_cast<arrow::StringArray>(*strings);
+        for (int64_t i = 0; i < values->length(); ++i) {
+            builder.UnsafeAppend(values->IsNull(i) ? INVALID_INSTRUMENT_ID
+                : registry.intern(values->GetView(i)));
+        }
+    }
+
+    std::shared_ptr<arrow::Array> ids;
+    if (!builder.Finish(&ids).ok()) {
+        return nullptr;
+    }
+    return ids;
+}
+
+/**
+ * @brief 将 order_book_id 列替换为 InstrumentId (uint32) 列
+ *
+ * 按chunk转换，避免不同chunk字典不一致时合并失败。
+ */
+std::shared_ptr<arrow::Table> encode_instrument_ids(const std::shared_ptr<arrow::Table>& table) {
+    int index = table->schema()->GetFieldIndex("order_book_id");
+    if (index < 0) {
+        return table;
+    }
+
+    auto column = table->column(index);
+    if (column->type()->id() == arrow::Type::UINT32) {
+        return table;  // 已编码
+    }
+
+    arrow::ArrayVector chunks;
+    chunks.reserve(column->num_chunks());
+    for (const auto& chunk : column->chunks()) {
+        auto ids = encode_instrument_chunk(chunk);
+        if (!ids) {
+            return nullptr;
+        }
+        chunks.push_back(std::move(ids));
+    }
+
+    auto encoded = table->SetColumn(index, arrow::field("order_book_id", arrow::uint32()),
+                                    std::make_shared<arrow::ChunkedArray>(std::move(chunks), arrow::uint32()));
+    if (!encoded.ok()) {
+        std::cerr << "替换证券代码列失败: " << encoded.status().ToString() << std::endl;
+        return nullptr;
+    }
+    return *encoded;
+}
+
+/**
+ * @brief 剔除键列为空的行
+ *
+ * 空键行无法归入任何时间分区；显式剔除并告警，
+ * 避免与 Arrow 排序的空值位置 (排在末尾) 产生不一致。
+ */
+std::shared_ptr<arrow::Table> drop_null_keys(const std::shared_ptr<arrow::Table>& table,
+                                             const std::string& key_column) {
+    auto column = table->GetColumnByName(key_column);
+    if (!column || column->null_count() == 0) {
+        return table;
+    }
+
+    auto mask = arrow::compute::IsValid(arrow::Datum(column));
+    if (!mask.ok()) {
+        std::cerr << "检查空时间键失败: " << mask.status().ToString() << std::endl;
+        return nullptr;
+    }
+    auto filtered = arrow::compute::Filter(arrow::Datum(table), *mask);
+    if (!filtered.ok()) {
+        std::cerr << "剔除空时间键失败: " << filtered.status().ToString() << std::endl;
+        return nullptr;
+    }
+
+    std::cerr << "警告: 丢弃 " << column->null_count() << " 行 " << key_column
+              << " 为空的数据" << std::endl;
+    auto result = filtered->table()->CombineChunks(arrow::default_memory_pool());
+    if (!result.ok()) {
+        std::cerr << "合并Arrow chunk失败: " << result.status().ToString() << std::endl;
+        return nullptr;
+    }
+    return *result;
+}
+
+/**
+ * @brief 合并chunk并保证按键列有序
+ *
+ * 先剔除空键行；已有序的表(常见情况)只做一次O(n)检查；无序时使用稳定排序，
+ * 保持同一时间点内原有的行顺序(后出现的行覆盖先出现的行)。
+ */
+std::shared_ptr<arrow::Table> combine_and_sort(const std::shared_ptr<arrow::Table>& table,
+                                               const std::string& key_column,
+                                               bool as_days) {
+    auto combined = table->CombineChunks(arrow::default_memory_pool());
+    if (!combined.ok()) {
+        std::cerr << "合并Arrow chunk失败: " << combined.status().ToString() << std::endl;
+        return nullptr;
+    }
+
+    auto result = drop_null_keys(*combined, key_column);
+    if (!result) {
+        return nullptr;
+    }
+    KeyColumn keys(result, key_column, as_days);
+    if (!keys.valid()) {
+        return result;
+    }
+
+    const int64_t rows = result->num_rows();
+    bool sorted = true;
+    for (int64_t i = 1; i < rows; ++i) {
+        if (keys[i] < keys[i - 1]) {
+            sorted = false;
+            break;
+        }
+    }
+    if (sorted) {
+        return result;
+    }
+
+    arrow::compute::SortOptions options({arrow::compute::SortKey(key_column)});
+    auto indices = arrow::compute::SortIndices(arrow::Datum(result), options);
+    if (!indices.ok()) {
+        std::cerr << "排序失败: " << indices.status().ToString() << std::endl;
+        return nullptr;
+    }
+
+    auto taken = arrow::compute::Take(arrow::Datum(result), arrow::Datum(*indices));
+    if (!taken.ok()) {
+        std::cerr << "排序失败: " << taken.status().ToString() << std::endl;
+        return nullptr;
+    }
+
+    auto sorted_table = taken->table()->CombineChunks(arrow::default_memory_pool());
+    if (!sorted_table.ok()) {
+        std::cerr << "合并Arrow chunk失败: " << sorted_table.status().ToString() << std::endl;
+        return nullptr;
+    }
+    return *sorted_table;
+}
+
+/**
+ * @brief 在已排序表上扫描键变化点，生成分区边界
+ */
+template <typename Range>
+std::vector<Range> partition_sorted(std::shared_ptr<arrow::Table>& table,
+                                    const std::string& key_column,
+                                    bool as_days) {
+    std::vector<Range> ranges;
+    if (!table || table->num_rows() == 0) {
+        return ranges;
+    }
+
+    table = encode_instrument_ids(table);
+    if (table) {
+        table = combine_and_sort(table, key_column, as_days);
+    }
+    if (!table) {
+        return ranges;
+    }
+
+    const int64_t rows = table->num_rows();
+    KeyColumn keys(table, key_column, as_days);
+    if (!keys.valid()) {
+        // 缺少时间列：整表作为单个分区
+        ranges.push_back(Range{0, 0, rows});
+        return ranges;
+    }
+
+    int64_t start = 0;
+    int64_t current = keys[0];
+    for (int64_t i = 1; i < rows; ++i) {
+        int64_t key = keys[i];
+        if (key != current) {
+            ranges.push_back(Range{current, start, i - start});
+            start = i;
+            current = key;
+        }
+    }
+    ranges.push_back(Range{current, start, rows - start});
+    return ranges;
+}
+
+/**
+ * @brief 并行处理分区
+ *
+ * 复用 Arrow 全局 CPU 线程池 (每次导入不再新建线程)；
+ * 工作任务通过原子计数器领取分区(负载不均时自动平衡)，
+ * 结果写入预分配的槽位，无需加锁。
+ */
+template <typename Range, typename Split>
+auto parallel_split(const std::vector<Range>& ranges, Split split) {
+    using Result = decltype(split(ranges.front()));
+    std::vector<Result> results(ranges.size());
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < ranges.size(); i = next.fetch_add(1)) {
+            results[i] = split(ranges[i]);
+        }
+    };
+
+    auto* pool = arrow::internal::GetCpuThreadPool();
+    size_t workers = std::min(ranges.size(),
+        static_cast<size_t>(std::max(1, pool->GetCapacity())));
+
+    std::vector<arrow::Future<>> futures;
+    futures.reserve(workers);
+    for (size_t w = 1; w < workers; ++w) {
+        auto future = pool->Submit(worker);
+        if (future.ok()) {
+            futures.push_back(std::move(*future));
+        }
+        // 提交失败时其余任务照常领取全部分区
+    }
+    worker();  // 当前线程同样参与处理
+    for (auto& future : futures) {
+        future.Wait();
+    }
+
+    return results;
+}
+
+} // namespace
+
+/**
+ * @brief 列视图 - 直接引用已合并为单chunk的Arrow缓冲区
+ *
+ * 非float64列在构造时一次性转换；缺失列读取为0.0。
+ * order_book_id 列须已由 encode_instrument_ids 转换为 InstrumentId。
+ */
+struct QAMarketCenter::ColumnViews {
+    struct Doubles {
+        std::shared_ptr<arrow::Array> array;
+        const double* values = nullptr;
+
+        double operator[](int64_t i) const {
+            return (values && !array->IsNull(i)) ? values[i] : 0.0;
+        }
+    };
+
+    std::shared_ptr<arrow::UInt32Array> codes;    // 已编码的 InstrumentId 列
+    Doubles open, close, high, low, last, volume, total_turnover;
+    Doubles bid1, ask1;
+    Doubles limit_up, limit_down, split_coefficient_to, dividend_cash_before_tax;
+
+    explicit ColumnViews(const std::shared_ptr<arrow::Table>& table) {
+        if (!table) {
+            return;
+        }
+
+        if (auto array = resolve(table, "order_book_id", arrow::uint32())) {
+            codes = std::static_pointer_cast<arrow::UInt32Array>(array);
+        }
+        open = doubles(table, "open");
+        close = doubles(table, "close");
+        high = doubles(table, "high");
+        low = doubles(table, "low");
+        last = doubles(table, "last");
+        volume = doubles(table, "volume");
+        total_turnover = doubles(table, "total_turnover");
+        bid1 = doubles(table, "b1");
+        ask1 = doubles(table, "a1");
+        limit_up = doubles(table, "limit_up");
+        limit_down = doubles(table, "limit_down");
+        split_coefficient_to = doubles(table, "split_coefficient_to");
+        dividend_cash_before_tax = doubles(table, "dividend_cash_before_tax");
+    }
+
+    InstrumentId instrument(int64_t i) const {
+        return codes->IsNull(i) ? INVALID_INSTRUMENT_ID : codes->Value(i);
+    }
+
+private:
+    static std::shared_ptr<arrow::Array> resolve(const std::shared_ptr<arrow::Table>& table,
+                                                 const std::string& name,
+                                                 const std::shared_ptr<arrow::DataType>& type) {
+        auto column = table->GetColumnByName(name);
+        if (!column || column->num_chunks() == 0) {
+            return nullptr;
+        }
+
+        auto array = column->chunk(0);
+        if (array->type()->Equals(*type)) {
+            return array;
+        }
+
+        auto cast = arrow::compute::Cast(*array, type);
+        if (!cast.ok()) {
+            std::cerr << "列类型转换失败: " << name << " - " << cast.status().ToString() << std::endl;
+            return nullptr;
+        }
+        return *cast;
+    }
+
+    static Doubles doubles(const std::shared_ptr<arrow::Table>& table, const std::string& name) {
+        Doubles view;
+        view.array = resolve(table, name, arrow::float64());
+        if (view.array) {
+            view.values = std::static_pointer_cast<arrow::DoubleArray>(view.array)->raw_values();
+        }
+        return view;
+    }
+};
+
 // 构造函数实现
 QAMarketCenter::QAMarketCenter(const std::string& path)
     : dateidx_(0), date_("") {
-    // 加载主要数据文件
-    daily_table_ = load_parquet_mmap(path);
+    // 实时K线环在读线程出现前一次性分配，之后只替换槽位
+    for (size_t period = 0; period < BAR_PERIOD_COUNT; ++period) {
+        const int64_t length = bar_period_nanos(static_cast<BarPeriod>(period));
+        realtime_bars_[period].resize(static_cast<size_t>(std::max<int64_t>(1, util::datetime::NANOS_PER_DAY / length)));
+    }
 
-    if (daily_table_) {
-        // 按日期分组数据
-        auto partitioned_data = partition_by_date(daily_table_);
+    // 加载主要数据文件 (实时模式传入空路径，不加载)
+    if (!path.empty()) {
+        daily_table_ = load_parquet_mmap(path);
+    }
 
-        // 处理每个日期的数据
-        for (const auto& [date_idx, table] : partitioned_data) {
-            auto [extracted_date, klines] = run_split_date(table);
-            data_[extracted_date] = std::move(klines);
+    if (daily_table_) {
+        // 按日期分区 (daily_table_ 被替换为已排序的单chunk表)
+        auto ranges = partition_by_date(daily_table_);
+        ColumnViews columns(daily_table_);
+
+        // 并行处理每个日期的数据
+        auto results = parallel_split(ranges, [&columns](const PartitionRange& range) {
+            return run_split_date(columns, range);
+        });
+
+        data_.reserve(results.size());
+        for (auto& [date_idx, klines] : results) {
+            data_[date_idx] = std::move(klines);
         }
 
         std::cout << "MarketCenter已加载 " << data_.size() << " 个交易日的数据" << std::endl;
@@ -35,7 +466,8 @@ QAMarketCenter::QAMarketCenter(const std::string& path)
 QAMarketCenter QAMarketCenter::new_for_realtime() {
     QAMarketCenter mc("");
     mc.data_.clear();
-    mc.today_.clear();
+    mc.today_.reset();
+    mc.aggregator_ = std::make_unique<BarAggregator>();
     mc.minutes_.clear();
     mc.date_ = "";
     mc.dateidx_ = 0;
@@ -49,8 +481,25 @@ std::shared_ptr<arrow::Table> QAMarketCenter::load_parquet_mmap(const std::strin
         auto input = fs->OpenInputFile(path).ValueOrDie();
 
         // 创建 Parquet 读取器
+        parquet::arrow::FileReaderBuilder builder;
+        auto status = builder.Open(input);
+
+        if (!status.ok()) {
+            std::cerr << "无法打开Parquet文件: " << path << " - " << status.ToString() << std::endl;
+            return nullptr;
+        }
+
+        // 证券代码列直接读取为字典数组，后续按字典值注册 InstrumentId
+        parquet::ArrowReaderProperties properties;
+        int code_column = builder.raw_reader()->metadata()->schema()->ColumnIndex("order_book_id");
+        if (code_column >= 0) {
+            properties.set_read_dictionary(code_column, true);
+        }
+
         std::unique_ptr<parquet::arrow::FileReader> arrow_reader;
-        auto status = parquet::arrow::OpenFile(input, arrow::default_memory_pool(), &arrow_reader);
+        status = builder.memory_pool(arrow::default_memory_pool())
+                     ->properties(properties)
+                     ->Build(&arrow_reader);
 
         if (!status.ok()) {
             std::cerr << "无法打开Parquet文件: " << path << " - " << status.ToString() << std::endl;
@@ -77,16 +526,25 @@ std::shared_ptr<arrow::Table> QAMarketCenter::load_parquet_mmap(const std::strin
     }
 }
 
-std::unordered_map<std::string, Kline> QAMarketCenter::get_codedate(const std::string& date, const std::string& code) {
-    int64_t timestamp = date_string_to_timestamp(date);
-    int32_t dateidx = static_cast<int32_t>(timestamp / 86400000000);
+KlineMap QAMarketCenter::get_codedate(const std::string& date, const std::string& code) {
+    InstrumentId instrument_id = InstrumentRegistry::instance().find(code);
+    if (instrument_id == INVALID_INSTRUMENT_ID) {
+        return {}; // 未注册的代码
+    }
+    return get_codedate(date, instrument_id);
+}
+
+KlineMap QAMarketCenter::get_codedate(const std::string& date, InstrumentId instrument_id) {
+    return get_codedate(date_string_to_index(date), instrument_id);
+}
 
+KlineMap QAMarketCenter::get_codedate(int32_t dateidx, InstrumentId instrument_id) {
     auto date_it = data_.find(dateidx);
     if (date_it != data_.end()) {
-        auto code_it = date_it->second.find(code);
+        auto code_it = date_it->second.find(instrument_id);
         if (code_it != date_it->second.end()) {
-            std::unordered_map<std::string, Kline> result;
-            result[code] = code_it->second;
+            KlineMap result;
+            result[instrument_id] = code_it->second;
             return result;
         }
     }
@@ -94,10 +552,11 @@ std::unordered_map<std::string, Kline> QAMarketCenter::get_codedate(const std::s
     return {}; // 返回空映射
 }
 
-std::unordered_map<std::string, Kline> QAMarketCenter::get_date(const std::string& date) {
-    int64_t timestamp = date_string_to_timestamp(date);
-    int32_t dateidx = static_cast<int32_t>(timestamp / 86400000000);
+KlineMap QAMarketCenter::get_date(const std::string& date) {
+    return get_date(date_string_to_index(date));
+}
 
+KlineMap QAMarketCenter::get_date(int32_t dateidx) {
     auto it = data_.find(dateidx);
     if (it != data_.end()) {
         return it->second;
@@ -106,11 +565,13 @@ std::unordered_map<std::string, Kline> QAMarketCenter::get_date(const std::strin
     return {}; // 返回空映射
 }
 
-std::optional<std::reference_wrapper<const std::unordered_map<std::string, Kline>>>
+std::optional<std::reference_wrapper<const KlineMap>>
 QAMarketCenter::try_get_date(const std::string& date) {
-    int64_t timestamp = date_string_to_timestamp(date);
-    int32_t dateidx = static_cast<int32_t>(timestamp / 86400000000);
+    return try_get_date(date_string_to_index(date));
+}
 
+std::optional<std::reference_wrapper<const KlineMap>>
+QAMarketCenter::try_get_date(int32_t dateidx) {
     auto it = data_.find(dateidx);
     if (it != data_.end()) {
         return std::cref(it->second);
@@ -119,9 +580,11 @@ QAMarketCenter::try_get_date(const std::string& date) {
     return std::nullopt;
 }
 
-std::unordered_map<std::string, Kline> QAMarketCenter::get_minutes(const std::string& datetime) {
-    int64_t timestamp = datetime_string_to_nanos(datetime);
+KlineMap QAMarketCenter::get_minutes(const std::string& datetime) {
+    return get_minutes(datetime_string_to_nanos(datetime));
+}
 
+KlineMap QAMarketCenter::get_minutes(int64_t timestamp) {
     auto it = minutes_.find(timestamp);
     if (it != minutes_.end()) {
         return it->second;
@@ -130,16 +593,18 @@ std::unordered_map<std::string, Kline> QAMarketCenter::get_minutes(const std::st
     return {}; // 返回空映射
 }
 
-const std::unordered_map<std::string, Kline>& QAMarketCenter::get_minutes_ref(const std::string& datetime) {
-    int64_t timestamp = datetime_string_to_nanos(datetime);
+const KlineMap& QAMarketCenter::get_minutes_ref(const std::string& datetime) {
+    return get_minutes_ref(datetime_string_to_nanos(datetime));
+}
 
+const KlineMap& QAMarketCenter::get_minutes_ref(int64_t timestamp) {
     auto it = minutes_.find(timestamp);
     if (it != minutes_.end()) {
         return it->second;
     }
 
     // 返回静态空映射
-    static const std::unordered_map<std::string, Kline> empty_map;
+    static const KlineMap empty_map;
     return empty_map;
 }
 
@@ -152,13 +617,7 @@ void QAMarketCenter::load_minutes(const std::string& date, const std::string& fr
         return;
     }
 
-    auto partitioned_data = partition_by_datetime(table);
-
-    minutes_.clear();
-    for (const auto& [timestamp, minute_table] : partitioned_data) {
-        auto [extracted_timestamp, klines] = run_split_minutes(minute_table);
-        minutes_[extracted_timestamp] = std::move(klines);
-    }
+    ingest_minutes(table, false);
 
     std::cout << "已加载 " << minutes_.size() << " 个分钟的数据" << std::endl;
 }
@@ -179,13 +638,7 @@ void QAMarketCenter::load_tick(const std::string& date) {
     };
 
     // 简化实现：过滤列并按时间分组
-    auto partitioned_data = partition_by_datetime(table);
-
-    minutes_.clear();
-    for (const auto& [timestamp, tick_table] : partitioned_data) {
-        auto [extracted_timestamp, klines] = run_split_ticks(tick_table);
-        minutes_[extracted_timestamp] = std::move(klines);
-    }
+    ingest_minutes(table, true);
 
     std::cout << "已加载 " << minutes_.size() << " 个Tick时间点的数据" << std::endl;
 }
@@ -202,13 +655,7 @@ void QAMarketCenter::load_tick_with_filter(const std::string& date, const std::v
     // 应用过滤器
     auto filtered_table = apply_filter(table, "order_book_id", order_book_id_list);
 
-    auto partitioned_data = partition_by_datetime(filtered_table);
-
-    minutes_.clear();
-    for (const auto& [timestamp, tick_table] : partitioned_data) {
-        auto [extracted_timestamp, klines] = run_split_ticks(tick_table);
-        minutes_[extracted_timestamp] = std::move(klines);
-    }
+    ingest_minutes(filtered_table, true);
 
     std::cout << "已加载 " << minutes_.size() << " 个过滤后的Tick时间点数据" << std::endl;
 }
@@ -227,42 +674,34 @@ void QAMarketCenter::load_minutes_with_filter_pushdown(const std::string& date,
     // 应用单个值过滤器
     auto filtered_table = apply_filter(table, "order_book_id", {order_book_id});
 
-    auto partitioned_data = partition_by_datetime(filtered_table);
-
-    minutes_.clear();
-    for (const auto& [timestamp, minute_table] : partitioned_data) {
-        auto [extracted_timestamp, klines] = run_split_minutes(minute_table);
-        minutes_[extracted_timestamp] = std::move(klines);
-    }
+    ingest_minutes(filtered_table, false);
 
     std::cout << "已加载 " << minutes_.size() << " 个过滤后的分钟数据" << std::endl;
 }
 
 std::vector<std::string> QAMarketCenter::get_minutes_range() {
-    std::vector<std::pair<int64_t, std::string>> range;
-    range.reserve(minutes_.size());
+    // 先按整数时间戳排序，再统一格式化
+    std::vector<int64_t> timestamps = get_minutes_timestamps();
 
-    for (const auto& [timestamp, _] : minutes_) {
-        std::string formatted_time = nanos_to_datetime_string(timestamp);
-        range.emplace_back(timestamp, formatted_time);
-    }
-
-    // 按时间戳排序
-    std::sort(range.begin(), range.end(),
-              [](const auto& a, const auto& b) {
-                  return a.first < b.first;
-              });
-
-    // 提取格式化时间
     std::vector<std::string> result;
-    result.reserve(range.size());
-    for (const auto& [_, formatted_time] : range) {
-        result.push_back(formatted_time);
+    result.reserve(timestamps.size());
+    for (int64_t timestamp : timestamps) {
+        result.push_back(nanos_to_datetime_string(timestamp));
     }
 
     return result;
 }
 
+std::vector<int64_t> QAMarketCenter::get_minutes_timestamps() const {
+    std::vector<int64_t> timestamps;
+    timestamps.reserve(minutes_.size());
+    for (const auto& [timestamp, _] : minutes_) {
+        timestamps.push_back(timestamp);
+    }
+    std::sort(timestamps.begin(), timestamps.end());
+    return timestamps;
+}
+
 void QAMarketCenter::load_future_minutes(const std::string& date, const std::string& freq) {
     std::string path = build_cache_path("future", "min" + freq, date);
     load_minutes(date, freq); // 复用加载逻辑
@@ -278,17 +717,18 @@ void QAMarketCenter::load_btc_minutes(const std::string& date, const std::string
     load_minutes(date, freq); // 复用加载逻辑
 }
 
-const std::unordered_map<std::string, Kline>& QAMarketCenter::get_date_ref(const std::string& date) {
-    int64_t timestamp = date_string_to_timestamp(date);
-    int32_t dateidx = static_cast<int32_t>(timestamp / 86400000000);
+const KlineMap& QAMarketCenter::get_date_ref(const std::string& date) {
+    return get_date_ref(date_string_to_index(date));
+}
 
+const KlineMap& QAMarketCenter::get_date_ref(int32_t dateidx) {
     auto it = data_.find(dateidx);
     if (it != data_.end()) {
         return it->second;
     }
 
     // 返回静态空映射
-    static const std::unordered_map<std::string, Kline> empty_map;
+    static const KlineMap empty_map;
     return empty_map;
 }
 
@@ -325,10 +765,10 @@ QAMarketCenter::DataStats QAMarketCenter::get_stats() const {
     stats.minute_timestamps_count = minutes_.size();
 
     // 计算总证券数量
-    std::set<std::string> unique_symbols;
+    std::set<InstrumentId> unique_symbols;
     for (const auto& [date, klines] : data_) {
-        for (const auto& [symbol, kline] : klines) {
-            unique_symbols.insert(symbol);
+        for (const auto& [instrument_id, kline] : klines) {
+            unique_symbols.insert(instrument_id);
         }
     }
     stats.total_symbols_count = unique_symbols.size();
@@ -340,9 +780,8 @@ QAMarketCenter::DataStats QAMarketCenter::get_stats() const {
         auto max_date = std::max_element(data_.begin(), data_.end(),
             [](const auto& a, const auto& b) { return a.first < b.first; });
 
-        // 简化的日期转换
-        stats.date_range_start = std::to_string(min_date->first);
-        stats.date_range_end = std::to_string(max_date->first);
+        stats.date_range_start = util::datetime::format_date(min_date->first);
+        stats.date_range_end = util::datetime::format_date(max_date->first);
     }
 
     return stats;
@@ -367,317 +806,210 @@ nlohmann::json QAMarketCenter::to_json() const {
 }
 
 // 私有方法实现
-std::pair<int32_t, std::unordered_map<std::string, Kline>>
-QAMarketCenter::run_split_date(std::shared_ptr<arrow::Table> table) {
-    if (!table || table->num_rows() == 0) {
-        return {0, {}};
+std::pair<int32_t, KlineMap>
+QAMarketCenter::run_split_date(const ColumnViews& columns, const PartitionRange& range) {
+    int32_t date_idx = static_cast<int32_t>(range.key);
+    if (!columns.codes || range.length == 0) {
+        return {date_idx, {}};
     }
 
     try {
-        // 提取各列数据
-        auto codes = extract_string_column(table, "order_book_id");
-        auto opens = extract_double_column(table, "open");
-        auto closes = extract_double_column(table, "close");
-        auto highs = extract_double_column(table, "high");
-        auto lows = extract_double_column(table, "low");
-        auto volumes = extract_double_column(table, "volume");
-        auto total_turnovers = extract_double_column(table, "total_turnover");
-        auto limit_ups = extract_double_column(table, "limit_up");
-        auto limit_downs = extract_double_column(table, "limit_down");
-
-        // 尝试提取可选列
-        std::vector<double> split_coefficients, dividends;
-        try {
-            split_coefficients = extract_double_column(table, "split_coefficient_to");
-            dividends = extract_double_column(table, "dividend_cash_before_tax");
-        } catch (...) {
-            // 如果列不存在，用默认值填充
-            split_coefficients.resize(codes.size(), 0.0);
-            dividends.resize(codes.size(), 0.0);
-        }
-
-        // 提取日期（假设所有行都是同一天）
-        auto timestamps = extract_timestamp_column(table, "date");
-        int32_t date_idx = timestamps.empty() ? 0 : static_cast<int32_t>(timestamps[0]);
-
-        // 构建Kline映射
-        std::unordered_map<std::string, Kline> klines;
-        size_t min_size = std::min({codes.size(), opens.size(), closes.size(),
-                                   highs.size(), lows.size(), volumes.size()});
-
-        for (size_t i = 0; i < min_size; ++i) {
+        KlineMap klines;
+        klines.reserve(static_cast<size_t>(range.length));
+
+        const int64_t end = range.offset + range.length;
+        for (int64_t i = range.offset; i < end; ++i) {
+            InstrumentId instrument_id = columns.instrument(i);
             Kline kline(
-                codes[i], opens[i], closes[i], highs[i], lows[i],
-                volumes[i],
-                i < limit_ups.size() ? limit_ups[i] : 0.0,
-                i < limit_downs.size() ? limit_downs[i] : 0.0,
-                i < total_turnovers.size() ? total_turnovers[i] : 0.0,
-                i < split_coefficients.size() ? split_coefficients[i] : 0.0,
-                i < dividends.size() ? dividends[i] : 0.0
+                instrument_id, columns.open[i], columns.close[i], columns.high[i], columns.low[i],
+                columns.volume[i],
+                columns.limit_up[i],
+                columns.limit_down[i],
+                columns.total_turnover[i],
+                columns.split_coefficient_to[i],
+                columns.dividend_cash_before_tax[i]
             );
-            klines[codes[i]] = std::move(kline);
+            klines.insert_or_assign(instrument_id, std::move(kline));
         }
 
         return {date_idx, std::move(klines)};
     } catch (const std::exception& e) {
         std::cerr << "处理日线数据时发生错误: " << e.what() << std::endl;
-        return {0, {}};
+        return {date_idx, {}};
     }
 }
 
-std::pair<int64_t, std::unordered_map<std::string, Kline>>
-QAMarketCenter::run_split_minutes(std::shared_ptr<arrow::Table> table) {
-    if (!table || table->num_rows() == 0) {
-        return {0, {}};
+std::pair<int64_t, KlineMap>
+QAMarketCenter::run_split_minutes(const ColumnViews& columns, const PartitionRange& range) {
+    if (!columns.codes || range.length == 0) {
+        return {range.key, {}};
     }
 
     try {
-        // 提取各列数据
-        auto codes = extract_string_column(table, "order_book_id");
-        auto opens = extract_double_column(table, "open");
-        auto closes = extract_double_column(table, "close");
-        auto highs = extract_double_column(table, "high");
-        auto lows = extract_double_column(table, "low");
-        auto volumes = extract_double_column(table, "volume");
-        auto total_turnovers = extract_double_column(table, "total_turnover");
-        auto limit_ups = extract_double_column(table, "limit_up");
-        auto limit_downs = extract_double_column(table, "limit_down");
-
-        // 提取时间戳（假设所有行都是同一分钟）
-        auto timestamps = extract_timestamp_column(table, "datetime");
-        int64_t timestamp = timestamps.empty() ? 0 : timestamps[0];
-
-        // 构建Kline映射
-        std::unordered_map<std::string, Kline> klines;
-        size_t min_size = std::min({codes.size(), opens.size(), closes.size(),
-                                   highs.size(), lows.size(), volumes.size()});
-
-        for (size_t i = 0; i < min_size; ++i) {
+        KlineMap klines;
+        klines.reserve(static_cast<size_t>(range.length));
+
+        const int64_t end = range.offset + range.length;
+        for (int64_t i = range.offset; i < end; ++i) {
+            InstrumentId instrument_id = columns.instrument(i);
             Kline kline(
-                codes[i], opens[i], closes[i], highs[i], lows[i],
-                volumes[i],
-                i < limit_ups.size() ? limit_ups[i] : 0.0,
-                i < limit_downs.size() ? limit_downs[i] : 0.0,
-                i < total_turnovers.size() ? total_turnovers[i] : 0.0
+                instrument_id, columns.open[i], columns.close[i], columns.high[i], columns.low[i],
+                columns.volume[i],
+                columns.limit_up[i],
+                columns.limit_down[i],
+                columns.total_turnover[i]
             );
-            klines[codes[i]] = std::move(kline);
+            klines.insert_or_assign(instrument_id, std::move(kline));
         }
 
-        return {timestamp, std::move(klines)};
+        return {range.key, std::move(klines)};
     } catch (const std::exception& e) {
         std::cerr << "处理分钟数据时发生错误: " << e.what() << std::endl;
-        return {0, {}};
+        return {range.key, {}};
     }
 }
 
-std::pair<int64_t, std::unordered_map<std::string, Kline>>
-QAMarketCenter::run_split_ticks(std::shared_ptr<arrow::Table> table) {
-    if (!table || table->num_rows() == 0) {
-        return {0, {}};
+std::pair<int64_t, KlineMap>
+QAMarketCenter::run_split_ticks(const ColumnViews& columns, const PartitionRange& range) {
+    if (!columns.codes || range.length == 0) {
+        return {range.key, {}};
     }
 
     try {
-        // Tick数据使用last价格作为OHLC
-        auto codes = extract_string_column(table, "order_book_id");
-        auto lasts = extract_double_column(table, "last");
-        auto volumes = extract_double_column(table, "volume");
-        auto total_turnovers = extract_double_column(table, "total_turnover");
-        auto limit_ups = extract_double_column(table, "limit_up");
-        auto limit_downs = extract_double_column(table, "limit_down");
-
-        // 提取时间戳
-        auto timestamps = extract_timestamp_column(table, "datetime");
-        int64_t timestamp = timestamps.empty() ? 0 : timestamps[0];
-
-        // 构建Kline映射
-        std::unordered_map<std::string, Kline> klines;
-        size_t min_size = std::min(std::min(codes.size(), lasts.size()), volumes.size());
-
-        for (size_t i = 0; i < min_size; ++i) {
+        KlineMap klines;
+        klines.reserve(static_cast<size_t>(range.length));
+
+        const int64_t end = range.offset + range.length;
+        for (int64_t i = range.offset; i < end; ++i) {
             // Tick数据：开高低收都使用最新价
+            InstrumentId instrument_id = columns.instrument(i);
+            double last = columns.last[i];
             Kline kline(
-                codes[i], lasts[i], lasts[i], lasts[i], lasts[i],
-                volumes[i],
-                i < limit_ups.size() ? limit_ups[i] : 0.0,
-                i < limit_downs.size() ? limit_downs[i] : 0.0,
-                i < total_turnovers.size() ? total_turnovers[i] : 0.0
+                instrument_id, last, last, last, last,
+                columns.volume[i],
+                columns.limit_up[i],
+                columns.limit_down[i],
+                columns.total_turnover[i]
             );
-            klines[codes[i]] = std::move(kline);
+            klines.insert_or_assign(instrument_id, std::move(kline));
         }
 
-        return {timestamp, std::move(klines)};
+        return {range.key, std::move(klines)};
     } catch (const std::exception& e) {
         std::cerr << "处理Tick数据时发生错误: " << e.what() << std::endl;
-        return {0, {}};
+        return {range.key, {}};
     }
 }
 
 int64_t QAMarketCenter::date_string_to_timestamp(const std::string& date) {
-    // 简化实现：将 "YYYY-MM-DD" 转换为微秒时间戳
-    std::istringstream ss(date);
-    int year, month, day;
-    char dash1, dash2;
-    ss >> year >> dash1 >> month >> dash2 >> day;
-
-    std::tm tm = {};
-    tm.tm_year = year - 1900;
-    tm.tm_mon = month - 1;
-    tm.tm_mday = day;
+    // "YYYY-MM-DD" -> 微秒时间戳 (UTC民用日期，与日期索引口径一致)
+    return util::datetime::parse_date_days(date) * util::datetime::MICROS_PER_DAY;
+}
 
-    return static_cast<int64_t>(std::mktime(&tm)) * 1000000; // 转换为微秒
+int32_t QAMarketCenter::date_string_to_index(const std::string& date) {
+    return static_cast<int32_t>(util::datetime::parse_date_days(date));
 }
 
 int64_t QAMarketCenter::datetime_string_to_nanos(const std::string& datetime) {
-    // 简化实现：将 "YYYY-MM-DD HH:MM:SS" 转换为纳秒时间戳
-    std::istringstream ss(datetime);
-    int year, month, day, hour, min, sec;
-    char dash1, dash2, space, colon1, colon2;
-    ss >> year >> dash1 >> month >> dash2 >> day >> space >> hour >> colon1 >> min >> colon2 >> sec;
-
-    std::tm tm = {};
-    tm.tm_year = year - 1900;
-    tm.tm_mon = month - 1;
-    tm.tm_mday = day;
-    tm.tm_hour = hour;
-    tm.tm_min = min;
-    tm.tm_sec = sec;
-
-    return static_cast<int64_t>(std::mktime(&tm)) * 1000000000; // 转换为纳秒
+    // "YYYY-MM-DD HH:MM:SS" -> 纳秒时间戳 (与 Arrow timestamp 列同为无时区口径)
+    return util::datetime::parse_datetime_nanos(datetime);
 }
 
 std::string QAMarketCenter::nanos_to_datetime_string(int64_t nanos) {
-    time_t seconds = nanos / 1000000000;
-    std::tm* tm = std::localtime(&seconds);
-
-    std::stringstream ss;
-    ss << std::put_time(tm, "%Y-%m-%d %H:%M:%S");
-    return ss.str();
+    return util::datetime::format_datetime(nanos);
 }
 
-std::unordered_map<int32_t, std::shared_ptr<arrow::Table>>
-QAMarketCenter::partition_by_date(std::shared_ptr<arrow::Table> table) {
-    // 简化实现：假设表已经按日期分组
-    std::unordered_map<int32_t, std::shared_ptr<arrow::Table>> result;
-
-    // 这里应该实现真正的分组逻辑
-    // 为了简化，直接返回单个分组
-    if (table && table->num_rows() > 0) {
-        result[0] = table;
-    }
-
-    return result;
+std::vector<QAMarketCenter::PartitionRange>
+QAMarketCenter::partition_by_date(std::shared_ptr<arrow::Table>& table) {
+    return partition_sorted<PartitionRange>(table, "date", true);
 }
 
-std::unordered_map<int64_t, std::shared_ptr<arrow::Table>>
-QAMarketCenter::partition_by_datetime(std::shared_ptr<arrow::Table> table) {
-    // 简化实现：假设表已经按时间分组
-    std::unordered_map<int64_t, std::shared_ptr<arrow::Table>> result;
-
-    // 这里应该实现真正的分组逻辑
-    // 为了简化，直接返回单个分组
-    if (table && table->num_rows() > 0) {
-        result[0] = table;
-    }
-
-    return result;
+std::vector<QAMarketCenter::PartitionRange>
+QAMarketCenter::partition_by_datetime(std::shared_ptr<arrow::Table>& table) {
+    return partition_sorted<PartitionRange>(table, "datetime", false);
 }
 
-std::shared_ptr<arrow::Table> QAMarketCenter::apply_filter(std::shared_ptr<arrow::Table> table,
-                                                          const std::string& column_name,
-                                                          const std::vector<std::string>& values) {
-    // 简化实现：返回原表
-    // 实际项目中应该使用 Arrow Compute 进行过滤
-    return table;
-}
+void QAMarketCenter::ingest_minutes(std::shared_ptr<arrow::Table> table, bool tick_data) {
+    auto ranges = partition_by_datetime(table);
+    ColumnViews columns(table);
 
-std::vector<std::string> QAMarketCenter::extract_string_column(std::shared_ptr<arrow::Table> table,
-                                                              const std::string& column_name) {
-    std::vector<std::string> result;
-
-    try {
-        auto column = table->GetColumnByName(column_name);
-        if (!column) {
-            std::cerr << "列不存在: " << column_name << std::endl;
-            return result;
-        }
+    auto results = parallel_split(ranges, [&columns, tick_data](const PartitionRange& range) {
+        return tick_data ? run_split_ticks(columns, range) : run_split_minutes(columns, range);
+    });
 
-        // 简化实现：假设是字符串数组
-        auto array = column->chunk(0);
-        auto string_array = std::static_pointer_cast<arrow::StringArray>(array);
-
-        result.reserve(string_array->length());
-        for (int64_t i = 0; i < string_array->length(); ++i) {
-            if (!string_array->IsNull(i)) {
-                result.push_back(string_array->GetString(i));
-            } else {
-                result.push_back("");
-            }
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "提取字符串列时发生错误: " << e.what() << std::endl;
+    minutes_.clear();
+    minutes_.reserve(results.size());
+    for (auto& [timestamp, klines] : results) {
+        minutes_[timestamp] = std::move(klines);
     }
-
-    return result;
 }
 
-std::vector<double> QAMarketCenter::extract_double_column(std::shared_ptr<arrow::Table> table,
-                                                         const std::string& column_name) {
-    std::vector<double> result;
+size_t QAMarketCenter::import_tick_to_store(const std::string& date, TickStoreWriter& writer) {
+    std::string path = "/opt/cache/data/stocktick/" + date + ".pq";
 
-    try {
-        auto column = table->GetColumnByName(column_name);
-        if (!column) {
-            std::cerr << "列不存在: " << column_name << std::endl;
-            return result;
-        }
+    auto table = load_parquet_mmap(path);
+    if (!table) {
+        std::cerr << "无法加载Tick数据: " << path << std::endl;
+        return 0;
+    }
 
-        // 简化实现：假设是双精度浮点数数组
-        auto array = column->chunk(0);
-        auto double_array = std::static_pointer_cast<arrow::DoubleArray>(array);
-
-        result.reserve(double_array->length());
-        for (int64_t i = 0; i < double_array->length(); ++i) {
-            if (!double_array->IsNull(i)) {
-                result.push_back(double_array->Value(i));
-            } else {
-                result.push_back(0.0);
-            }
+    auto ranges = partition_by_datetime(table);
+    ColumnViews columns(table);
+    if (!columns.codes) {
+        return 0;
+    }
+
+    size_t written = 0;
+    for (const auto& range : ranges) {
+        const int64_t end = range.offset + range.length;
+        for (int64_t i = range.offset; i < end; ++i) {
+            StoredTick tick;
+            tick.timestamp_ns = range.key;
+            tick.last_price = columns.last[i];
+            tick.bid_price = columns.bid1[i];
+            tick.ask_price = columns.ask1[i];
+            tick.volume = columns.volume[i];
+            tick.amount = columns.total_turnover[i];
+            written += writer.append(columns.instrument(i), tick) ? 1 : 0;
         }
-    } catch (const std::exception& e) {
-        std::cerr << "提取浮点列时发生错误: " << e.what() << std::endl;
     }
+    writer.flush();
 
-    return result;
+    std::cout << "已转存 " << written << " 条Tick数据到 " << writer.root() << std::endl;
+    return written;
 }
 
-std::vector<int64_t> QAMarketCenter::extract_timestamp_column(std::shared_ptr<arrow::Table> table,
-                                                             const std::string& column_name) {
-    std::vector<int64_t> result;
-
-    try {
-        auto column = table->GetColumnByName(column_name);
-        if (!column) {
-            std::cerr << "列不存在: " << column_name << std::endl;
-            return result;
-        }
-
-        // 简化实现：假设是时间戳数组
-        auto array = column->chunk(0);
-        auto timestamp_array = std::static_pointer_cast<arrow::TimestampArray>(array);
-
-        result.reserve(timestamp_array->length());
-        for (int64_t i = 0; i < timestamp_array->length(); ++i) {
-            if (!timestamp_array->IsNull(i)) {
-                result.push_back(timestamp_array->Value(i));
-            } else {
-                result.push_back(0);
-            }
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "提取时间戳列时发生错误: " << e.what() << std::endl;
+size_t QAMarketCenter::replay_ticks(const TickStore& store,
+                                    const std::vector<std::string>& instruments,
+                                    int64_t start_ns, int64_t end_ns) {
+    if (!aggregator_) {
+        aggregator_ = std::make_unique<BarAggregator>();
+    }
+    auto sink = [this](const BarCrossSection& section) { publish_bars(section); };
+
+    auto cursor = store.scan(instruments, start_ns, end_ns);
+    size_t replayed = 0;
+    TickRecord record;
+    AggregatorTick tick;
+    while (cursor.next(record)) {
+        tick.instrument_id = record.instrument_id;
+        tick.timestamp_ns = record.tick.timestamp_ns;
+        tick.last_price = record.tick.last_price;
+        tick.volume = record.tick.volume;
+        tick.amount = record.tick.amount;
+        aggregator_->update(tick, sink);
+        replayed++;
     }
+    aggregator_->flush_all(sink);
+    return replayed;
+}
 
-    return result;
+std::shared_ptr<arrow::Table> QAMarketCenter::apply_filter(std::shared_ptr<arrow::Table> table,
+                                                          const std::string& column_name,
+                                                          const std::vector<std::string>& values) {
+    // 简化实现：返回原表
+    // 实际项目中应该使用 Arrow Compute 进行过滤
+    return table;
 }
 
 std::string QAMarketCenter::build_cache_path(const std::string& asset_type,
@@ -698,11 +1030,13 @@ void QAMarketCenter::optimize_memory() {
 
 // ==================== Arc 零拷贝优化实现 ====================
 
-std::shared_ptr<const std::unordered_map<std::string, Kline>>
+std::shared_ptr<const KlineMap>
 QAMarketCenter::get_date_shared(const std::string& date) {
-    int64_t timestamp = date_string_to_timestamp(date);
-    int32_t dateidx = static_cast<int32_t>(timestamp / 86400000000);
+    return get_date_shared(date_string_to_index(date));
+}
 
+std::shared_ptr<const KlineMap>
+QAMarketCenter::get_date_shared(int32_t dateidx) {
     // 缓存命中：返回 shared_ptr clone (仅增加引用计数 ~10-20 ns)
     auto cache_it = date_cache_.find(dateidx);
     if (cache_it != date_cache_.end()) {
@@ -712,7 +1046,7 @@ QAMarketCenter::get_date_shared(const std::string& date) {
     // 缓存未命中：创建 shared_ptr 并缓存
     auto data_it = data_.find(dateidx);
     if (data_it != data_.end()) {
-        auto shared_data = std::make_shared<const std::unordered_map<std::string, Kline>>(
+        auto shared_data = std::make_shared<const KlineMap>(
             data_it->second
         );
         date_cache_[dateidx] = shared_data;
@@ -723,10 +1057,13 @@ QAMarketCenter::get_date_shared(const std::string& date) {
     return nullptr;
 }
 
-std::shared_ptr<const std::unordered_map<std::string, Kline>>
+std::shared_ptr<const KlineMap>
 QAMarketCenter::get_minutes_shared(const std::string& datetime) {
-    int64_t timestamp = datetime_string_to_nanos(datetime);
+    return get_minutes_shared(datetime_string_to_nanos(datetime));
+}
 
+std::shared_ptr<const KlineMap>
+QAMarketCenter::get_minutes_shared(int64_t timestamp) {
     // 缓存命中
     auto cache_it = minute_cache_.find(timestamp);
     if (cache_it != minute_cache_.end()) {
@@ -736,14 +1073,15 @@ QAMarketCenter::get_minutes_shared(const std::string& datetime) {
     // 缓存未命中
     auto data_it = minutes_.find(timestamp);
     if (data_it != minutes_.end()) {
-        auto shared_data = std::make_shared<const std::unordered_map<std::string, Kline>>(
+        auto shared_data = std::make_shared<const KlineMap>(
             data_it->second
         );
         minute_cache_[timestamp] = shared_data;
         return shared_data;
     }
 
-    return nullptr;
+    // 实时模式: 查找聚合器发布的1分钟截面 (已是 shared_ptr，无需缓存)
+    return get_realtime_bars(BarPeriod::Min1, timestamp);
 }
 
 void QAMarketCenter::clear_shared_cache() {
@@ -752,6 +1090,104 @@ void QAMarketCenter::clear_shared_cache() {
     std::cout << "Arc 缓存已清除" << std::endl;
 }
 
+// ==================== 实时K线聚合 ====================
+
+void QAMarketCenter::on_tick(const protocol::mifi::Tick& tick) {
+    if (!aggregator_) {
+        aggregator_ = std::make_unique<BarAggregator>();
+    }
+    aggregator_->update(tick, [this](const BarCrossSection& section) { publish_bars(section); });
+}
+
+void QAMarketCenter::on_tick(const ipc::MarketTick& tick) {
+    if (!aggregator_) {
+        aggregator_ = std::make_unique<BarAggregator>();
+    }
+    aggregator_->update(tick, [this](const BarCrossSection& section) { publish_bars(section); });
+}
+
+void QAMarketCenter::flush_realtime(int64_t now_ns) {
+    if (aggregator_) {
+        aggregator_->flush(now_ns, [this](const BarCrossSection& section) { publish_bars(section); });
+    }
+}
+
+namespace {
+
+// 同一周期的K线时间相差周期长度的整数倍，按K线序号取模即可直接定位槽位
+size_t realtime_slot(BarPeriod period, int64_t timestamp_ns, size_t slots) {
+    const int64_t length = bar_period_nanos(period);
+    int64_t index = timestamp_ns / length;
+    if (timestamp_ns % length < 0) {
+        index--;
+    }
+    const int64_t slot = index % static_cast<int64_t>(slots);
+    return static_cast<size_t>(slot < 0 ? slot + static_cast<int64_t>(slots) : slot);
+}
+
+} // namespace
+
+void QAMarketCenter::publish_bars(const BarCrossSection& section) {
+    if (!section.bars) {
+        return;
+    }
+
+    if (section.period == BarPeriod::Day) {
+        std::atomic_store(&today_, section.bars);
+        if (!section.final) {
+            return;  // 盘中快照只更新 today_
+        }
+    } else {
+        // 进入新交易日: 上一交易日的日内截面已收盘，释放其槽位；旧日截面会占用当日同一时刻的槽位，直接丢弃
+        const int64_t day = util::datetime::days_from_nanos(section.timestamp_ns);
+        if (day < realtime_day_) {
+            return;
+        }
+        if (day > realtime_day_) {
+            if (realtime_day_ != std::numeric_limits<int64_t>::min()) {
+                for (size_t period = 0; period < BAR_PERIOD_COUNT; ++period) {
+                    if (period == static_cast<size_t>(BarPeriod::Day)) {
+                        continue;
+                    }
+                    for (auto& slot : realtime_bars_[period]) {
+                        std::atomic_store(&slot, std::shared_ptr<const RealtimeBarEntry>());
+                    }
+                }
+            }
+            realtime_day_ = day;
+        }
+    }
+
+    auto& ring = realtime_bars_[static_cast<size_t>(section.period)];
+    auto entry = std::make_shared<const RealtimeBarEntry>(RealtimeBarEntry{section.timestamp_ns, section.bars});
+    std::atomic_store(&ring[realtime_slot(section.period, section.timestamp_ns, ring.size())], std::move(entry));
+}
+
+std::shared_ptr<const KlineMap>
+QAMarketCenter::get_realtime_bars(BarPeriod period, int64_t bar_timestamp_ns) const {
+    const auto& ring = realtime_bars_[static_cast<size_t>(period)];
+    if (ring.empty()) {
+        return nullptr;
+    }
+    auto entry = std::atomic_load(&ring[realtime_slot(period, bar_timestamp_ns, ring.size())]);
+    return entry && entry->timestamp_ns == bar_timestamp_ns ? entry->bars : nullptr;
+}
+
+std::vector<int64_t> QAMarketCenter::get_realtime_timestamps(BarPeriod period) const {
+    std::vector<int64_t> result;
+    for (const auto& slot : realtime_bars_[static_cast<size_t>(period)]) {
+        if (auto entry = std::atomic_load(&slot)) {
+            result.push_back(entry->timestamp_ns);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::shared_ptr<const KlineMap> QAMarketCenter::get_today_shared() const {
+    return std::atomic_load(&today_);
+}
+
 std::vector<StockCnDay> QAMarketCenter::get_stock_day(const std::string& code,
                                                        const std::string& start_date,
                                                        const std::string& end_date) {
@@ -825,12 +1261,12 @@ bool validate_schema(std::shared_ptr<arrow::Table> table, const std::string& exp
     return schema->num_fields() > 0;
 }
 
-std::unordered_map<std::string, Kline> table_to_kline_map(std::shared_ptr<arrow::Table> table) {
+KlineMap table_to_kline_map(std::shared_ptr<arrow::Table> table) {
     // 简化实现
     return {};
 }
 
-std::shared_ptr<arrow::Table> kline_map_to_table(const std::unordered_map<std::string, Kline>& klines,
+std::shared_ptr<arrow::Table> kline_map_to_table(const KlineMap& klines,
                                                  const std::string& timestamp) {
     // 简化实现
     return nullptr;
@@ -1,43 +1,236 @@
 #include "qaultra/data/tick_broadcaster.hpp"
+#include "qaultra/util/datetime.hpp"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <string_view>
 
 namespace qaultra::data {
 
-void TickBroadcaster::register_subscriber(const std::string& id) {
-    subscribers_.emplace(id, Subscriber(id));
+namespace {
+
+size_t round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
 }
 
-void TickBroadcaster::unregister_subscriber(const std::string& id) {
-    subscribers_.erase(id);
+int32_t tick_date_index(const Tick& tick) {
+    // datetime 前10个字符为 YYYY-MM-DD，直接解析为天数
+    return static_cast<int32_t>(util::datetime::parse_date_days(std::string_view(tick.datetime)));
 }
 
-void TickBroadcaster::push_tick(const std::string& date, const Tick& tick) {
-    auto start = std::chrono::high_resolution_clock::now();
+} // namespace
+
+// ==================== SnapshotRing ====================
+
+SnapshotRing::SnapshotRing(size_t capacity)
+    : slots_(round_up_pow2(std::max<size_t>(capacity, 2)))
+    , mask_(slots_.size() - 1)
+{}
+
+size_t SnapshotRing::push_bulk(const TickSnapshot* items, size_t count) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    size_t free_slots = slots_.size() - static_cast<size_t>(tail - cached_head_);
+    if (free_slots < count) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        free_slots = slots_.size() - static_cast<size_t>(tail - cached_head_);
+    }
+
+    const size_t accepted = std::min(count, free_slots);
+    for (size_t i = 0; i < accepted; ++i) {
+        slots_[(tail + i) & mask_] = items[i];
+    }
+    if (accepted > 0) {
+        tail_.store(tail + accepted, std::memory_order_release);
+    }
+    return accepted;
+}
+
+size_t SnapshotRing::pop_bulk(TickSnapshot* out, size_t max_count) {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    size_t available = static_cast<size_t>(cached_tail_ - head);
+    if (available == 0) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        available = static_cast<size_t>(cached_tail_ - head);
+    }
+
+    const size_t count = std::min(available, max_count);
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = slots_[(head + i) & mask_];
+    }
+    if (count > 0) {
+        head_.store(head + count, std::memory_order_release);
+    }
+    return count;
+}
+
+size_t SnapshotRing::size() const {
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    return tail > head ? static_cast<size_t>(tail - head) : 0;
+}
+
+// ==================== Subscriber ====================
+
+Subscriber::Subscriber(const std::string& subscriber_id, uint64_t start_sequence, size_t capacity)
+    : id_(subscriber_id)
+    , ring_(capacity)
+    , released_sequence_(start_sequence)
+    , consumed_end_(start_sequence)
+{}
+
+void Subscriber::begin_batch() {
+    // 上一批句柄用完，只保留最新快照
+    const uint64_t released = holds_latest_ ? latest_.sequence : consumed_end_;
+    released_sequence_.store(released, std::memory_order_release);
+}
+
+size_t Subscriber::poll(std::vector<TickSnapshot>& out, size_t max_count) {
+    begin_batch();
+    const size_t offset = out.size();
+    out.resize(offset + max_count);
+    const size_t count = ring_.pop_bulk(out.data() + offset, max_count);
+    out.resize(offset + count);
+    if (count > 0) {
+        latest_ = out.back();
+        holds_latest_ = true;
+        consumed_end_ = latest_.sequence + 1;
+        received_count_ += count;
+    }
+    return count;
+}
+
+void Subscriber::release() {
+    holds_latest_ = false;
+    latest_ = TickSnapshot{};
+    released_sequence_.store(consumed_end_, std::memory_order_release);
+}
+
+// ==================== TickBroadcaster ====================
+
+TickBroadcaster::TickBroadcaster(QAMarketCenter&& market)
+    : market_(std::move(market))
+    , subscribers_(std::make_shared<const SubscriberList>()) {}
+
+std::shared_ptr<const TickBroadcaster::SubscriberList> TickBroadcaster::load_subscribers() const {
+    return std::atomic_load_explicit(&subscribers_, std::memory_order_acquire);
+}
+
+std::shared_ptr<Subscriber> TickBroadcaster::register_subscriber(const std::string& id, size_t capacity) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto current = load_subscribers();
+    for (const auto& subscriber : *current) {
+        if (subscriber->id() == id) {
+            return subscriber;
+        }
+    }
+
+    // 新订阅者不会收到当前序号之前的句柄；读到旧值只会让回收更保守
+    auto subscriber = std::make_shared<Subscriber>(
+        id, next_sequence_.load(std::memory_order_acquire), capacity);
+    auto updated = std::make_shared<SubscriberList>(*current);
+    updated->push_back(subscriber);
+    std::atomic_store_explicit(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(updated)),
+                               std::memory_order_release);
+    return subscriber;
+}
+
+void TickBroadcaster::unregister_subscriber(const std::string& id) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto current = load_subscribers();
+    auto updated = std::make_shared<SubscriberList>();
+    updated->reserve(current->size());
+    for (const auto& subscriber : *current) {
+        if (subscriber->id() != id) {
+            updated->push_back(subscriber);
+        }
+    }
+    if (updated->size() != current->size()) {
+        std::atomic_store_explicit(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(updated)),
+                                   std::memory_order_release);
+    }
+}
 
-    // 检查日期是否变化
-    std::shared_ptr<const std::unordered_map<std::string, Kline>> data_shared;
+std::shared_ptr<Subscriber> TickBroadcaster::get_subscriber(const std::string& id) const {
+    for (const auto& subscriber : *load_subscribers()) {
+        if (subscriber->id() == id) {
+            return subscriber;
+        }
+    }
+    return nullptr;
+}
 
-    if (date != current_date_) {
-        // 日期变化：获取新数据
-        current_date_ = date;
-        data_shared = market_.get_date_shared(date);
-        cached_data_ = data_shared;
+TickSnapshot TickBroadcaster::make_snapshot(int32_t dateidx, uint64_t sequence) {
+    if (dateidx != current_date_) {
+        // 日期变化：旧数据待所有订阅者越过后回收
+        if (cached_data_) {
+            retire_current(sequence - 1);
+        }
+        current_date_ = dateidx;
+        cached_data_ = market_.get_date_shared(dateidx);
         stats_.cache_misses++;
     } else {
-        // 日期相同：使用缓存 (shared_ptr copy ~10-20 ns)
         stats_.cache_hits++;
-        data_shared = cached_data_;
     }
+    return TickSnapshot{dateidx, sequence, cached_data_.get()};
+}
+
+void TickBroadcaster::retire_current(uint64_t last_sequence) {
+    retired_.push_back(RetiredSnapshot{last_sequence, std::move(cached_data_)});
+    cached_data_.reset();
+}
+
+void TickBroadcaster::reclaim(const SubscriberList& subscribers) {
+    uint64_t min_released = next_sequence_.load(std::memory_order_relaxed);
+    for (const auto& subscriber : subscribers) {
+        min_released = std::min(min_released,
+                                subscriber->released_sequence_.load(std::memory_order_acquire));
+    }
+
+    auto alive = std::remove_if(retired_.begin(), retired_.end(),
+                                [min_released](const RetiredSnapshot& retired) {
+                                    return retired.last_sequence < min_released;
+                                });
+    stats_.reclaimed_snapshots += static_cast<size_t>(retired_.end() - alive);
+    retired_.erase(alive, retired_.end());
+}
+
+void TickBroadcaster::publish(const int32_t* dates, size_t count) {
+    // 必须先取订阅者列表再分配序号 (见 register_subscriber)
+    auto subscribers = load_subscribers();
+    const uint64_t first = next_sequence_.load(std::memory_order_relaxed);
+
+    batch_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        batch_[i] = make_snapshot(dates[i], first + i);
+    }
+    next_sequence_.store(first + count, std::memory_order_release);
 
-    // 广播给所有订阅者 (零拷贝)
-    for (auto& [id, subscriber] : subscribers_) {
-        subscriber.receive(data_shared);  // shared_ptr copy
+    // 每个订阅者一次批量写入 + 一次 release 发布
+    for (const auto& subscriber : *subscribers) {
+        const size_t accepted = subscriber->ring_.push_bulk(batch_.data(), count);
+        stats_.ring_overflows += count - accepted;
     }
 
-    // 更新统计
-    stats_.total_ticks++;
-    stats_.total_broadcasts += subscribers_.size();
+    stats_.total_ticks += count;
+    stats_.total_broadcasts += count * subscribers->size();
+
+    if (!retired_.empty()) {
+        reclaim(*subscribers);
+    }
+}
+
+void TickBroadcaster::push_tick(const std::string& date, const Tick& tick) {
+    push_tick(static_cast<int32_t>(util::datetime::parse_date_days(date)), tick);
+}
+
+void TickBroadcaster::push_tick(int32_t dateidx, const Tick& /*tick*/) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    publish(&dateidx, 1);
 
     auto end = std::chrono::high_resolution_clock::now();
     stats_.total_latency_ns +=
@@ -45,11 +238,20 @@ void TickBroadcaster::push_tick(const std::string& date, const Tick& tick) {
 }
 
 void TickBroadcaster::push_batch(const std::vector<Tick>& ticks) {
-    for (const auto& tick : ticks) {
-        // 从 datetime 提取日期部分 (YYYY-MM-DD)
-        std::string date = tick.datetime.substr(0, 10);
-        push_tick(date, tick);
+    if (ticks.empty()) {
+        return;
     }
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<int32_t> dates(ticks.size());
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        dates[i] = tick_date_index(ticks[i]);
+    }
+    publish(dates.data(), dates.size());
+
+    auto end = std::chrono::high_resolution_clock::now();
+    stats_.total_latency_ns +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
 }
 
 void TickBroadcaster::print_stats() const {
@@ -57,13 +259,16 @@ void TickBroadcaster::print_stats() const {
     std::cout << std::string(60, '-') << "\n";
     std::cout << "  总 Tick 数: " << stats_.total_ticks << "\n";
     std::cout << "  总广播次数: " << stats_.total_broadcasts << "\n";
-    std::cout << "  订阅者数: " << subscribers_.size() << "\n";
+    std::cout << "  订阅者数: " << subscriber_count() << "\n";
     std::cout << "  缓存命中率: " << std::fixed << std::setprecision(2)
               << (stats_.cache_hit_rate() * 100) << "%\n";
+    std::cout << "  队列溢出: " << stats_.ring_overflows << "\n";
+    std::cout << "  已回收快照: " << stats_.reclaimed_snapshots
+              << " (待回收 " << retired_.size() << ")\n";
     std::cout << "  平均延迟: " << std::fixed << std::setprecision(0)
               << stats_.avg_latency_ns() << " ns\n";
 
-    if (stats_.total_broadcasts > 0 && stats_.total_latency_ns > 0) {
+    if (stats_.total_ticks > 0 && stats_.total_latency_ns > 0) {
         double ticks_per_sec = (stats_.total_ticks * 1e9) / stats_.total_latency_ns;
         std::cout << "  吞吐量: " << std::fixed << std::setprecision(0)
                   << ticks_per_sec << " ticks/sec\n";
@@ -71,9 +276,12 @@ void TickBroadcaster::print_stats() const {
 }
 
 void TickBroadcaster::clear_cache() {
-    cached_data_.reset();
-    current_date_.clear();
+    if (cached_data_) {
+        retire_current(next_sequence_.load(std::memory_order_relaxed) - 1);
+    }
+    current_date_ = NO_DATE;
     market_.clear_shared_cache();
+    reclaim(*load_subscribers());
 }
 
 } // namespace qaultra::data
@@ -0,0 +1,675 @@
+#include "qaultra/data/tick_store.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace qaultra::data {
+
+namespace {
+
+constexpr char SEGMENT_MAGIC[4] = {'Q', 'A', 'T', 'S'};
+constexpr uint32_t SEGMENT_VERSION = 1;
+constexpr const char* SEGMENT_SUFFIX = ".qts";
+constexpr const char* INDEX_SUFFIX = ".qti";
+
+/**
+ * @brief 数据段文件头
+ */
+struct SegmentHeader {
+    char magic[4];
+    uint32_t version;
+    double price_scale;
+    double volume_scale;
+    double amount_scale;
+    char code[32];
+};
+static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader must be 64 bytes");
+
+/**
+ * @brief 数据块头 (紧随其后为 bytes 字节的编码数据)
+ */
+struct BlockHeader {
+    uint32_t count;
+    uint32_t bytes;
+    int64_t first_timestamp_ns;
+};
+static_assert(sizeof(BlockHeader) == 16, "BlockHeader must be 16 bytes");
+
+/**
+ * @brief 稀疏索引项 (每个数据块一条)
+ */
+struct IndexEntry {
+    int64_t first_timestamp_ns;
+    int64_t last_timestamp_ns;
+    uint64_t offset;                // 编码数据在数据段中的偏移 (块头之后)
+    uint32_t count;
+    uint32_t bytes;
+};
+static_assert(sizeof(IndexEntry) == 32, "IndexEntry must be 32 bytes");
+
+/**
+ * @brief 整数化后的 Tick 字段，同时作为增量编码的前值状态
+ */
+struct FixedTick {
+    int64_t timestamp_ns = 0;
+    int64_t last_price = 0;
+    int64_t bid_price = 0;
+    int64_t ask_price = 0;
+    int64_t volume = 0;
+    int64_t amount = 0;
+};
+
+uint64_t zigzag_encode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzag_decode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void put_delta(std::vector<uint8_t>& out, int64_t value, int64_t& previous) {
+    put_varint(out, zigzag_encode(static_cast<int64_t>(static_cast<uint64_t>(value) - static_cast<uint64_t>(previous))));
+    previous = value;
+}
+
+bool get_delta(const uint8_t*& p, const uint8_t* end, int64_t& previous) {
+    uint64_t raw = 0;
+    if (!get_varint(p, end, raw)) {
+        return false;
+    }
+    previous = static_cast<int64_t>(static_cast<uint64_t>(previous) + static_cast<uint64_t>(zigzag_decode(raw)));
+    return true;
+}
+
+int64_t to_fixed(double value, double scale) {
+    return std::isfinite(value) ? std::llround(value * scale) : 0;
+}
+
+/**
+ * @brief 代码转文件名 ([A-Za-z0-9._-] 以外的字节按 %XX 转义，不同代码不会映射到同一文件)
+ */
+std::string file_stem(const std::string& code) {
+    static constexpr char HEX[] = "0123456789ABCDEF";
+    std::string stem;
+    stem.reserve(code.size());
+    for (const char c : code) {
+        const bool safe = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+                          (c >= '0' && c <= '9') || c == '.' || c == '_' || c == '-';
+        if (safe) {
+            stem.push_back(c);
+        } else {
+            const auto byte = static_cast<unsigned char>(c);
+            stem.push_back('%');
+            stem.push_back(HEX[byte >> 4]);
+            stem.push_back(HEX[byte & 0x0F]);
+        }
+    }
+    return stem;
+}
+
+std::string segment_path(const std::string& root, const std::string& code) {
+    return (std::filesystem::path(root) / (file_stem(code) + SEGMENT_SUFFIX)).string();
+}
+
+std::string index_path(const std::string& root, const std::string& code) {
+    return (std::filesystem::path(root) / (file_stem(code) + INDEX_SUFFIX)).string();
+}
+
+bool read_header(const std::string& path, SegmentHeader& header) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    return std::memcmp(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) == 0 &&
+           header.version == SEGMENT_VERSION;
+}
+
+/**
+ * @brief 读取索引，丢弃指向数据段之外的尾部项 (写入中断)
+ */
+std::vector<IndexEntry> read_index(const std::string& path, uint64_t segment_size) {
+    std::vector<IndexEntry> entries;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return entries;
+    }
+    const auto bytes = static_cast<size_t>(file.tellg());
+    entries.resize(bytes / sizeof(IndexEntry));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(IndexEntry));
+
+    while (!entries.empty() && entries.back().offset + entries.back().bytes > segment_size) {
+        entries.pop_back();
+    }
+    return entries;
+}
+
+bool write_all(int fd, const void* data, size_t size) {
+    const auto* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, p, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+// ========== TickStoreWriter ==========
+
+struct TickStoreWriter::SegmentState {
+    std::string code;
+    double price_scale = 0.0;
+    double volume_scale = 0.0;
+    double amount_scale = 0.0;
+    int64_t last_timestamp_ns = std::numeric_limits<int64_t>::min();
+    bool rejected = false;                  // 代码无法写入文件头，已报告过一次
+
+    // 当前未满数据块
+    std::vector<uint8_t> block;
+    uint32_t count = 0;
+    int64_t first_timestamp_ns = 0;
+    FixedTick previous;
+};
+
+TickStoreWriter::TickStoreWriter(const std::string& root, const TickStoreOptions& options)
+    : root_(root), options_(options) {
+    if (options_.block_ticks == 0) {
+        options_.block_ticks = 1;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(root_, ec);
+    if (ec) {
+        throw std::runtime_error("无法创建Tick存储目录: " + root_ + " (" + ec.message() + ")");
+    }
+}
+
+TickStoreWriter::~TickStoreWriter() {
+    flush();
+}
+
+TickStoreWriter::SegmentState* TickStoreWriter::state_for(InstrumentId instrument_id) {
+    if (instrument_id >= segments_.size()) {
+        segments_.resize(std::max<size_t>(instrument_id + 1, segments_.size() * 2));
+    }
+    auto& slot = segments_[instrument_id];
+    if (!slot) {
+        slot = std::make_unique<SegmentState>();
+        slot->code = instrument_code(instrument_id);
+
+        // 文件头定长保存代码，超长代码截断后会与其他证券混淆；只报告一次，之后直接拒绝
+        if (slot->code.size() > sizeof(SegmentHeader::code)) {
+            std::cerr << "证券代码超过 " << sizeof(SegmentHeader::code) << " 字节，无法写入Tick存储: "
+                      << slot->code << std::endl;
+            slot->rejected = true;
+            return nullptr;
+        }
+        slot->price_scale = options_.price_scale;
+        slot->volume_scale = options_.volume_scale;
+        slot->amount_scale = options_.amount_scale;
+
+        // 续写已有数据段: 沿用文件中的精度，并从索引恢复时间戳下界
+        const std::string path = segment_path(root_, slot->code);
+        SegmentHeader header{};
+        if (read_header(path, header)) {
+            slot->price_scale = header.price_scale;
+            slot->volume_scale = header.volume_scale;
+            slot->amount_scale = header.amount_scale;
+            auto entries = read_index(index_path(root_, slot->code), std::filesystem::file_size(path));
+            if (!entries.empty()) {
+                slot->last_timestamp_ns = entries.back().last_timestamp_ns;
+            }
+        }
+    }
+    return slot->rejected ? nullptr : slot.get();
+}
+
+bool TickStoreWriter::append(InstrumentId instrument_id, const StoredTick& tick) {
+    if (instrument_id == INVALID_INSTRUMENT_ID) {
+        return false;
+    }
+
+    SegmentState* segment = state_for(instrument_id);
+    if (!segment || tick.timestamp_ns < segment->last_timestamp_ns) {
+        return false;
+    }
+    SegmentState& state = *segment;
+
+    if (state.count == 0) {
+        state.block.clear();
+        state.previous = FixedTick();
+        state.first_timestamp_ns = tick.timestamp_ns;
+    }
+
+    FixedTick& prev = state.previous;
+    put_delta(state.block, tick.timestamp_ns, prev.timestamp_ns);
+    put_delta(state.block, to_fixed(tick.last_price, state.price_scale), prev.last_price);
+    put_delta(state.block, to_fixed(tick.bid_price, state.price_scale), prev.bid_price);
+    put_delta(state.block, to_fixed(tick.ask_price, state.price_scale), prev.ask_price);
+    put_delta(state.block, to_fixed(tick.volume, state.volume_scale), prev.volume);
+    put_delta(state.block, to_fixed(tick.amount, state.amount_scale), prev.amount);
+
+    state.count++;
+    state.last_timestamp_ns = tick.timestamp_ns;
+
+    if (state.count >= options_.block_ticks) {
+        return flush_block(state);
+    }
+    return true;
+}
+
+bool TickStoreWriter::append(const std::string& code, const StoredTick& tick) {
+    return append(intern_instrument(code), tick);
+}
+
+bool TickStoreWriter::flush() {
+    bool ok = true;
+    for (auto& state : segments_) {
+        if (state && state->count > 0) {
+            ok &= flush_block(*state);
+        }
+    }
+    return ok;
+}
+
+bool TickStoreWriter::flush_block(SegmentState& state) {
+    if (state.count == 0) {
+        return true;
+    }
+
+    // 按块打开/关闭文件，全市场数千证券也不会占用过多文件描述符
+    const std::string path = segment_path(root_, state.code);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        std::cerr << "无法打开Tick数据段: " << path << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+
+    struct stat st {};
+    ::fstat(fd, &st);
+    uint64_t offset = static_cast<uint64_t>(st.st_size);
+
+    std::vector<uint8_t> out;
+    out.reserve(sizeof(SegmentHeader) + sizeof(BlockHeader) + state.block.size());
+
+    if (offset == 0) {
+        SegmentHeader header{};
+        std::memcpy(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+        header.version = SEGMENT_VERSION;
+        header.price_scale = state.price_scale;
+        header.volume_scale = state.volume_scale;
+        header.amount_scale = state.amount_scale;
+        std::memcpy(header.code, state.code.data(), state.code.size());   // 长度已在 state_for 校验
+        const auto* raw = reinterpret_cast<const uint8_t*>(&header);
+        out.insert(out.end(), raw, raw + sizeof(header));
+    }
+
+    BlockHeader block_header{state.count, static_cast<uint32_t>(state.block.size()), state.first_timestamp_ns};
+    const auto* raw = reinterpret_cast<const uint8_t*>(&block_header);
+    out.insert(out.end(), raw, raw + sizeof(block_header));
+    const uint64_t payload_offset = offset + out.size();
+    out.insert(out.end(), state.block.begin(), state.block.end());
+
+    bool ok = write_all(fd, out.data(), out.size());
+    // 回退到写入前的长度，避免半个块 (尤其是新文件的文件头) 残留，重试时从原位置续写
+    if (!ok && ::ftruncate(fd, static_cast<off_t>(offset)) != 0) {
+        std::cerr << "无法回退Tick数据段: " << path << " (" << std::strerror(errno) << ")" << std::endl;
+    }
+    ::close(fd);
+
+    // 数据先落盘，再登记索引: 中断时索引不会指向不完整的块
+    if (ok) {
+        IndexEntry entry{state.first_timestamp_ns, state.last_timestamp_ns, payload_offset,
+                         state.count, static_cast<uint32_t>(state.block.size())};
+        const std::string idx = index_path(root_, state.code);
+        int idx_fd = ::open(idx.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        ok = idx_fd >= 0 && write_all(idx_fd, &entry, sizeof(entry));
+        if (idx_fd >= 0) {
+            ::close(idx_fd);
+        }
+    }
+
+    // 失败时保留缓冲的 Tick (与打开失败一致)，下次 flush 重试；未登记索引的数据不会被读取
+    if (!ok) {
+        std::cerr << "写入Tick数据段失败: " << path << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+
+    state.count = 0;
+    state.block.clear();
+    return true;
+}
+
+// ========== MappedTickSegment ==========
+
+/**
+ * @brief 只读映射的数据段 (索引常驻内存，数据按需分页)
+ */
+class MappedTickSegment {
+public:
+    static std::shared_ptr<const MappedTickSegment> open(const std::string& root, const std::string& code) {
+        const std::string path = segment_path(root, code);
+        SegmentHeader header{};
+        if (!read_header(path, header)) {
+            return nullptr;
+        }
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return nullptr;
+        }
+
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            std::cerr << "无法映射Tick数据段: " << path << " (" << std::strerror(errno) << ")" << std::endl;
+            return nullptr;
+        }
+        ::madvise(data, size, MADV_SEQUENTIAL);
+
+        auto segment = std::shared_ptr<MappedTickSegment>(new MappedTickSegment());
+        segment->data_ = static_cast<const uint8_t*>(data);
+        segment->size_ = size;
+        segment->header_ = header;
+        segment->code_ = std::string(header.code, strnlen(header.code, sizeof(header.code)));
+        segment->instrument_id_ = intern_instrument(segment->code_);
+        segment->index_ = read_index(index_path(root, code), size);
+        return segment;
+    }
+
+    ~MappedTickSegment() {
+        if (data_) {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+        }
+    }
+
+    /**
+     * @brief 第一个可能包含 >= start_ns 的数据块
+     */
+    size_t seek(int64_t start_ns) const {
+        auto it = std::lower_bound(index_.begin(), index_.end(), start_ns,
+            [](const IndexEntry& entry, int64_t ts) { return entry.last_timestamp_ns < ts; });
+        return static_cast<size_t>(it - index_.begin());
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    const SegmentHeader& header() const { return header_; }
+    const std::vector<IndexEntry>& index() const { return index_; }
+    const std::string& code() const { return code_; }
+    InstrumentId instrument_id() const { return instrument_id_; }
+
+private:
+    MappedTickSegment() = default;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    SegmentHeader header_{};
+    std::string code_;
+    InstrumentId instrument_id_ = INVALID_INSTRUMENT_ID;
+    std::vector<IndexEntry> index_;
+};
+
+// ========== TickCursor ==========
+
+struct TickCursor::Stream {
+    std::shared_ptr<const MappedTickSegment> segment;
+    size_t block = 0;
+    const uint8_t* p = nullptr;
+    const uint8_t* end = nullptr;
+    uint32_t remaining = 0;
+    FixedTick state;
+    int64_t start_ns = 0;
+    int64_t end_ns = 0;
+    StoredTick current;
+
+    bool open_block() {
+        const auto& index = segment->index();
+        if (block >= index.size() || index[block].first_timestamp_ns >= end_ns) {
+            return false;
+        }
+        const IndexEntry& entry = index[block];
+        p = segment->data() + entry.offset;
+        end = p + entry.bytes;
+        remaining = entry.count;
+        state = FixedTick();
+        return true;
+    }
+
+    /**
+     * @brief 解码下一条区间内记录到 current
+     */
+    bool advance() {
+        const SegmentHeader& header = segment->header();
+        while (true) {
+            if (remaining == 0) {
+                ++block;
+                if (!open_block()) {
+                    return false;
+                }
+            }
+
+            if (!get_delta(p, end, state.timestamp_ns) ||
+                !get_delta(p, end, state.last_price) ||
+                !get_delta(p, end, state.bid_price) ||
+                !get_delta(p, end, state.ask_price) ||
+                !get_delta(p, end, state.volume) ||
+                !get_delta(p, end, state.amount)) {
+                std::cerr << "Tick数据块损坏: " << segment->code() << " block " << block << std::endl;
+                return false;
+            }
+            --remaining;
+
+            if (state.timestamp_ns >= end_ns) {
+                return false;
+            }
+            if (state.timestamp_ns < start_ns) {
+                continue;
+            }
+
+            current.timestamp_ns = state.timestamp_ns;
+            current.last_price = static_cast<double>(state.last_price) / header.price_scale;
+            current.bid_price = static_cast<double>(state.bid_price) / header.price_scale;
+            current.ask_price = static_cast<double>(state.ask_price) / header.price_scale;
+            current.volume = static_cast<double>(state.volume) / header.volume_scale;
+            current.amount = static_cast<double>(state.amount) / header.amount_scale;
+            return true;
+        }
+    }
+};
+
+namespace {
+
+struct StreamLater {
+    template <typename Stream>
+    bool operator()(const Stream* a, const Stream* b) const {
+        if (a->current.timestamp_ns != b->current.timestamp_ns) {
+            return a->current.timestamp_ns > b->current.timestamp_ns;
+        }
+        return a->segment->instrument_id() > b->segment->instrument_id();
+    }
+};
+
+} // namespace
+
+TickCursor::TickCursor(TickCursor&&) noexcept = default;
+TickCursor& TickCursor::operator=(TickCursor&&) noexcept = default;
+TickCursor::~TickCursor() = default;
+
+void TickCursor::push_stream(std::unique_ptr<Stream> stream) {
+    if (!stream->advance()) {
+        return;
+    }
+    heap_.push_back(stream.get());
+    std::push_heap(heap_.begin(), heap_.end(), StreamLater());
+    streams_.push_back(std::move(stream));
+}
+
+bool TickCursor::next(TickRecord& record) {
+    if (heap_.empty()) {
+        return false;
+    }
+
+    std::pop_heap(heap_.begin(), heap_.end(), StreamLater());
+    Stream* stream = heap_.back();
+    record.instrument_id = stream->segment->instrument_id();
+    record.tick = stream->current;
+
+    if (stream->advance()) {
+        std::push_heap(heap_.begin(), heap_.end(), StreamLater());
+    } else {
+        heap_.pop_back();
+    }
+    return true;
+}
+
+size_t TickCursor::next_batch(std::vector<TickRecord>& records, size_t max_records) {
+    records.clear();
+    TickRecord record;
+    while (records.size() < max_records && next(record)) {
+        records.push_back(record);
+    }
+    return records.size();
+}
+
+// ========== TickStore ==========
+
+TickStore::TickStore(const std::string& root)
+    : root_(root) {
+}
+
+std::vector<std::string> TickStore::instruments() const {
+    std::vector<std::string> codes;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(root_, ec)) {
+        if (entry.path().extension() != SEGMENT_SUFFIX) {
+            continue;
+        }
+        SegmentHeader header{};
+        if (read_header(entry.path().string(), header)) {
+            codes.emplace_back(header.code, strnlen(header.code, sizeof(header.code)));
+        }
+    }
+    std::sort(codes.begin(), codes.end());
+    return codes;
+}
+
+TickSegmentInfo TickStore::info(const std::string& code) const {
+    TickSegmentInfo info;
+    info.code = code;
+
+    auto segment = MappedTickSegment::open(root_, code);
+    if (!segment || segment->index().empty()) {
+        return info;
+    }
+
+    const auto& index = segment->index();
+    info.block_count = index.size();
+    info.bytes = segment->size();
+    info.first_timestamp_ns = index.front().first_timestamp_ns;
+    info.last_timestamp_ns = index.back().last_timestamp_ns;
+    for (const auto& entry : index) {
+        info.tick_count += entry.count;
+    }
+    return info;
+}
+
+TickCursor TickStore::scan_all(int64_t start_ns, int64_t end_ns) const {
+    return scan(instruments(), start_ns, end_ns);
+}
+
+TickCursor TickStore::scan(const std::vector<std::string>& instruments,
+                           int64_t start_ns, int64_t end_ns) const {
+    // 去重: 同一代码只打开一次数据段，否则每个 Tick 会输出两次
+    std::vector<std::string> codes = instruments.empty() ? this->instruments() : instruments;
+    std::sort(codes.begin(), codes.end());
+    codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+
+    TickCursor cursor;
+    if (start_ns >= end_ns) {
+        return cursor;
+    }
+
+    for (const auto& code : codes) {
+        auto segment = MappedTickSegment::open(root_, code);
+        if (!segment) {
+            continue;
+        }
+
+        auto stream = std::make_unique<TickCursor::Stream>();
+        stream->block = segment->seek(start_ns);
+        stream->start_ns = start_ns;
+        stream->end_ns = end_ns;
+        stream->segment = std::move(segment);
+        if (stream->open_block()) {
+            cursor.push_stream(std::move(stream));
+        }
+    }
+    return cursor;
+}
+
+TickCursor TickStore::scan(std::initializer_list<std::string> instruments,
+                           int64_t start_ns, int64_t end_ns) const {
+    return scan(std::vector<std::string>(instruments), start_ns, end_ns);
+}
+
+TickCursor TickStore::scan(const std::vector<InstrumentId>& instruments,
+                           int64_t start_ns, int64_t end_ns) const {
+    std::vector<std::string> codes;
+    codes.reserve(instruments.size());
+    for (InstrumentId instrument_id : instruments) {
+        const std::string& code = instrument_code(instrument_id);
+        if (!code.empty()) {
+            codes.push_back(code);
+        }
+    }
+    if (codes.empty() && !instruments.empty()) {
+        return TickCursor();
+    }
+    return scan(codes, start_ns, end_ns);
+}
+
+} // namespace qaultra::data
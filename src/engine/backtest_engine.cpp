@@ -0,0 +1,869 @@
+#include "qaultra/engine/backtest_engine.hpp"
+#include "qaultra/account/position.hpp"
+#include "qaultra/analysis/performance_analyzer.hpp"
+#include "qaultra/simd/simd_math.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace qaultra::engine {
+
+using simd::FinancialMath;
+using simd::SimdMath;
+
+namespace {
+
+constexpr int TRADING_DAYS = 252;
+
+BarField parse_field(const std::string& field) {
+    if (field == "close") return BarField::Close;
+    if (field == "open") return BarField::Open;
+    if (field == "high") return BarField::High;
+    if (field == "low") return BarField::Low;
+    if (field == "volume") return BarField::Volume;
+    throw std::invalid_argument("unknown bar field: " + field);
+}
+
+std::vector<std::string> split_csv_line(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, ',')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+int find_column(const std::vector<std::string>& header, std::initializer_list<const char*> names) {
+    for (const char* name : names) {
+        auto it = std::find(header.begin(), header.end(), name);
+        if (it != header.end()) {
+            return static_cast<int>(it - header.begin());
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+// ==================== BarPanel ====================
+
+size_t BarPanel::find_symbol(const std::string& symbol) const {
+    auto it = symbol_index.find(symbol);
+    return it == symbol_index.end() ? npos : it->second;
+}
+
+const double* BarPanel::column(BarField field, size_t symbol) const {
+    const size_t offset = symbol * bars();
+    switch (field) {
+        case BarField::Open: return open.data() + offset;
+        case BarField::High: return high.data() + offset;
+        case BarField::Low: return low.data() + offset;
+        case BarField::Volume: return volume.data() + offset;
+        case BarField::Close:
+        default: return close.data() + offset;
+    }
+}
+
+BarPanel BarPanel::from_records(const std::vector<BarRecord>& records) {
+    BarPanel panel;
+    std::unordered_map<std::string, size_t> date_index;
+    for (const auto& record : records) {
+        if (date_index.emplace(record.date, 0).second) {
+            panel.dates.push_back(record.date);
+        }
+        if (panel.symbol_index.emplace(record.symbol, 0).second) {
+            panel.symbols.push_back(record.symbol);
+        }
+    }
+    std::sort(panel.dates.begin(), panel.dates.end());
+    std::sort(panel.symbols.begin(), panel.symbols.end());
+    for (size_t t = 0; t < panel.dates.size(); ++t) {
+        date_index[panel.dates[t]] = t;
+    }
+    for (size_t s = 0; s < panel.symbols.size(); ++s) {
+        panel.symbol_index[panel.symbols[s]] = s;
+    }
+
+    const size_t bars = panel.bars();
+    const size_t symbols = panel.symbol_count();
+    for (auto* field : {&panel.open, &panel.high, &panel.low, &panel.close, &panel.volume}) {
+        field->assign(symbols * bars, 0.0);
+    }
+
+    std::vector<uint8_t> present(symbols * bars, 0);
+    for (const auto& record : records) {
+        const size_t i = panel.symbol_index[record.symbol] * bars + date_index[record.date];
+        panel.open[i] = record.open;
+        panel.high[i] = record.high;
+        panel.low[i] = record.low;
+        panel.close[i] = record.close;
+        panel.volume[i] = record.volume;
+        present[i] = 1;
+    }
+
+    // 首根有效 bar 之后的缺失值用前收盘价填充
+    panel.first_bar.assign(symbols, bars);
+    for (size_t s = 0; s < symbols; ++s) {
+        for (size_t t = 0, i = s * bars; t < bars; ++t, ++i) {
+            if (present[i]) {
+                panel.first_bar[s] = std::min(panel.first_bar[s], t);
+            } else if (panel.first_bar[s] < t) {
+                panel.open[i] = panel.high[i] = panel.low[i] = panel.close[i] = panel.close[i - 1];
+            }
+        }
+    }
+
+    panel.close_rows.resize(symbols * bars);
+    for (size_t s = 0; s < symbols; ++s) {
+        for (size_t t = 0; t < bars; ++t) {
+            panel.close_rows[t * symbols + s] = panel.close[s * bars + t];
+        }
+    }
+
+    return panel;
+}
+
+// ==================== StrategyContext ====================
+
+double StrategyContext::get_price(const std::string& symbol) const {
+    return engine ? get_price(engine->market_data_->find_symbol(symbol)) : 0.0;
+}
+
+SeriesView StrategyContext::get_history(const std::string& symbol, int window, const std::string& field) const {
+    const BarField bar_field = parse_field(field);
+    return engine ? get_history(engine->market_data_->find_symbol(symbol), window, bar_field) : SeriesView();
+}
+
+std::shared_ptr<account::QA_Position> StrategyContext::get_position(const std::string& symbol) const {
+    if (!engine) {
+        return nullptr;
+    }
+    const size_t index = engine->market_data_->find_symbol(symbol);
+    if (index == BarPanel::npos || index >= engine->holdings_.size() || engine->holdings_[index] <= 0.0) {
+        return nullptr;
+    }
+
+    auto position = std::make_shared<account::QA_Position>();
+    position->code = symbol;
+    position->instrument_id = symbol;
+    position->volume_long_his = engine->holdings_[index];
+    position->position_cost_long = engine->cost_basis_[index];
+    position->position_price_long = engine->cost_basis_[index] / engine->holdings_[index];
+    position->open_cost_long = position->position_cost_long;
+    position->open_price_long = position->position_price_long;
+    position->lastest_price = get_price(index);
+    position->lastest_datetime = current_date;
+    return position;
+}
+
+double StrategyContext::get_cash() const {
+    return engine ? engine->cash_ : 0.0;
+}
+
+double StrategyContext::get_portfolio_value() const {
+    return engine ? engine->portfolio_value(bar_index) : 0.0;
+}
+
+void StrategyContext::log(const std::string& message) const {
+    if (engine && !engine->config_.enable_logging) {
+        return;
+    }
+    std::cout << "[" << current_date << "] " << message << std::endl;
+}
+
+size_t StrategyContext::symbol_count() const {
+    return engine ? engine->market_data_->symbol_count() : 0;
+}
+
+double StrategyContext::get_price(size_t symbol) const {
+    if (!engine || symbol >= engine->market_data_->symbol_count()) {
+        return 0.0;
+    }
+    const BarPanel& panel = *engine->market_data_;
+    return panel.close[symbol * panel.bars() + bar_index];
+}
+
+SeriesView StrategyContext::get_history(size_t symbol, int window, BarField field) const {
+    if (!engine || window <= 0 || symbol >= engine->market_data_->symbol_count()) {
+        return SeriesView();
+    }
+    const BarPanel& panel = *engine->market_data_;
+    const size_t end = bar_index + 1;
+    const size_t first = panel.first_bar[symbol];
+    if (first >= end) {
+        return SeriesView();
+    }
+    const size_t begin = std::max(first, end - std::min<size_t>(static_cast<size_t>(window), end));
+    return SeriesView(panel.column(field, symbol) + begin, end - begin);
+}
+
+double StrategyContext::get_holding(size_t symbol) const {
+    if (!engine || symbol >= engine->holdings_.size()) {
+        return 0.0;
+    }
+    return engine->holdings_[symbol];
+}
+
+SeriesView StrategyContext::get_cross_section() const {
+    if (!engine || engine->market_data_->symbol_count() == 0) {
+        return SeriesView();
+    }
+    const BarPanel& panel = *engine->market_data_;
+    return SeriesView(panel.close_rows.data() + bar_index * panel.symbol_count(), panel.symbol_count());
+}
+
+bool StrategyContext::buy(size_t symbol, double volume) {
+    return engine && engine->execute_order(symbol, volume, true);
+}
+
+bool StrategyContext::sell(size_t symbol, double volume) {
+    return engine && engine->execute_order(symbol, volume, false);
+}
+
+bool StrategyContext::buy(const std::string& symbol, double volume) {
+    return engine && engine->execute_order(engine->market_data_->find_symbol(symbol), volume, true);
+}
+
+bool StrategyContext::sell(const std::string& symbol, double volume) {
+    return engine && engine->execute_order(engine->market_data_->find_symbol(symbol), volume, false);
+}
+
+bool StrategyContext::order_target_value(size_t symbol, double value) {
+    const double price = get_price(symbol);
+    if (!engine || !(price > 0.0)) {
+        return false;
+    }
+    const double lot = engine->config_.lot_size;
+    const double target = std::floor(std::max(value, 0.0) / price / lot) * lot;
+    const double delta = target - get_holding(symbol);
+    if (delta > 0) {
+        return buy(symbol, delta);
+    }
+    if (delta < 0) {
+        return sell(symbol, -delta);
+    }
+    return true;
+}
+
+bool StrategyContext::order_target_percent(size_t symbol, double percent) {
+    return order_target_value(symbol, get_portfolio_value() * percent);
+}
+
+// ==================== 内置策略 ====================
+
+void SMAStrategy::initialize(StrategyContext& context) {
+    if (fast_window_ <= 0 || slow_window_ <= fast_window_) {
+        throw std::invalid_argument("SMAStrategy requires 0 < fast_window < slow_window");
+    }
+    fast_sma_.reset();
+    slow_sma_.reset();
+    if (context.symbol_count() > 0) {
+        fast_sma_ = std::make_unique<analysis::IncrementalSMA>(context.symbol_count(), fast_window_);
+        slow_sma_ = std::make_unique<analysis::IncrementalSMA>(context.symbol_count(), slow_window_);
+    }
+}
+
+void SMAStrategy::handle_data(StrategyContext& context) {
+    if (!slow_sma_) {
+        return;
+    }
+    // 每根 bar 用当前截面更新全部标的的均线，O(1) / 标的
+    const SeriesView row = context.get_cross_section();
+    fast_sma_->update(row.data());
+    slow_sma_->update(row.data());
+
+    const size_t symbols = context.symbol_count();
+    const double weight = 1.0 / static_cast<double>(symbols);
+    for (size_t s = 0; s < symbols; ++s) {
+        // 上市不足 slow_window 根时窗口内含上市前的 0，跳过
+        if (context.get_history(s, slow_window_).size() < static_cast<size_t>(slow_window_)) {
+            continue;
+        }
+        const double slow = slow_sma_->value()[s];
+        const double fast = fast_sma_->value()[s];
+        const bool held = context.get_holding(s) > 0;
+        if (fast > slow && !held) {
+            context.order_target_percent(s, weight);
+        } else if (fast < slow && held) {
+            context.order_target_value(s, 0.0);
+        }
+    }
+}
+
+std::map<std::string, double> SMAStrategy::get_parameters() const {
+    return {{"fast_window", fast_window_}, {"slow_window", slow_window_}};
+}
+
+void SMAStrategy::set_parameter(const std::string& name, double value) {
+    if (name == "fast_window") {
+        fast_window_ = static_cast<int>(value);
+    } else if (name == "slow_window") {
+        slow_window_ = static_cast<int>(value);
+    } else {
+        throw std::invalid_argument("unknown SMAStrategy parameter: " + name);
+    }
+}
+
+void MomentumStrategy::initialize(StrategyContext& /* context */) {
+    if (lookback_window_ <= 0) {
+        throw std::invalid_argument("MomentumStrategy lookback_window must be positive");
+    }
+}
+
+void MomentumStrategy::handle_data(StrategyContext& context) {
+    const size_t symbols = context.symbol_count();
+    const double weight = 1.0 / static_cast<double>(symbols);
+    for (size_t s = 0; s < symbols; ++s) {
+        const SeriesView history = context.get_history(s, lookback_window_ + 1);
+        if (history.size() <= static_cast<size_t>(lookback_window_) || !(history.front() > 0.0)) {
+            continue;
+        }
+        const double momentum = history.back() / history.front() - 1.0;
+        const bool held = context.get_holding(s) > 0;
+        if (momentum > threshold_ && !held) {
+            context.order_target_percent(s, weight);
+        } else if (momentum < -threshold_ && held) {
+            context.order_target_value(s, 0.0);
+        }
+    }
+}
+
+std::map<std::string, double> MomentumStrategy::get_parameters() const {
+    return {{"lookback_window", lookback_window_}, {"threshold", threshold_}};
+}
+
+void MomentumStrategy::set_parameter(const std::string& name, double value) {
+    if (name == "lookback_window") {
+        lookback_window_ = static_cast<int>(value);
+    } else if (name == "threshold") {
+        threshold_ = value;
+    } else {
+        throw std::invalid_argument("unknown MomentumStrategy parameter: " + name);
+    }
+}
+
+void MeanReversionStrategy::initialize(StrategyContext& context) {
+    if (window_ <= 1) {
+        throw std::invalid_argument("MeanReversionStrategy window must be greater than 1");
+    }
+    z_score_.reset();
+    if (context.symbol_count() > 0) {
+        z_score_ = std::make_unique<analysis::IncrementalZScore>(context.symbol_count(), window_);
+    }
+}
+
+void MeanReversionStrategy::handle_data(StrategyContext& context) {
+    if (!z_score_) {
+        return;
+    }
+    z_score_->update(context.get_cross_section().data());
+
+    const size_t symbols = context.symbol_count();
+    const double weight = 1.0 / static_cast<double>(symbols);
+    for (size_t s = 0; s < symbols; ++s) {
+        if (context.get_history(s, window_).size() < static_cast<size_t>(window_) ||
+            !(z_score_->stddev()[s] > 0.0)) {
+            continue;
+        }
+        // 跌破均值 threshold 个标准差时买入，回到均值上方时平仓
+        const double z_score = z_score_->value()[s];
+        const bool held = context.get_holding(s) > 0;
+        if (z_score < -z_score_threshold_ && !held) {
+            context.order_target_percent(s, weight);
+        } else if (z_score >= 0.0 && held) {
+            context.order_target_value(s, 0.0);
+        }
+    }
+}
+
+std::map<std::string, double> MeanReversionStrategy::get_parameters() const {
+    return {{"window", window_}, {"z_score_threshold", z_score_threshold_}};
+}
+
+void MeanReversionStrategy::set_parameter(const std::string& name, double value) {
+    if (name == "window") {
+        window_ = static_cast<int>(value);
+    } else if (name == "z_score_threshold") {
+        z_score_threshold_ = value;
+    } else {
+        throw std::invalid_argument("unknown MeanReversionStrategy parameter: " + name);
+    }
+}
+
+// ==================== BacktestEngine ====================
+
+BacktestEngine::BacktestEngine(const BacktestConfig& config)
+    : config_(config)
+    , market_data_(std::make_shared<const BarPanel>())
+{
+    if (!(config_.initial_cash > 0.0)) {
+        throw std::invalid_argument("BacktestEngine initial_cash must be positive");
+    }
+    if (!(config_.lot_size > 0.0)) {
+        throw std::invalid_argument("BacktestEngine lot_size must be positive");
+    }
+    reset_book();
+}
+
+BacktestEngine::~BacktestEngine() = default;
+
+void BacktestEngine::add_strategy(std::shared_ptr<Strategy> strategy) {
+    if (!strategy) {
+        throw std::invalid_argument("BacktestEngine strategy must not be null");
+    }
+    strategies_.push_back(std::move(strategy));
+}
+
+void BacktestEngine::clear_strategies() {
+    strategies_.clear();
+}
+
+void BacktestEngine::set_universe(const std::vector<std::string>& symbols) {
+    universe_ = symbols;
+}
+
+bool BacktestEngine::load_data(const std::string& data_source) {
+    return data_source.empty() ? load_data_from_database() : load_data_from_file(data_source);
+}
+
+bool BacktestEngine::load_bars(const std::vector<BarRecord>& records) {
+    const std::unordered_set<std::string> universe(universe_.begin(), universe_.end());
+    std::vector<BarRecord> selected;
+    selected.reserve(records.size());
+    for (const auto& record : records) {
+        if (!config_.start_date.empty() && record.date < config_.start_date) continue;
+        if (!config_.end_date.empty() && record.date > config_.end_date) continue;
+        if (!universe.empty() && universe.count(record.symbol) == 0) continue;
+        selected.push_back(record);
+    }
+    if (selected.empty()) {
+        std::cerr << "回测区间内没有行情数据" << std::endl;
+        return false;
+    }
+
+    set_market_data(std::make_shared<const BarPanel>(BarPanel::from_records(selected)));
+    return true;
+}
+
+void BacktestEngine::set_market_data(std::shared_ptr<const BarPanel> data) {
+    if (!data) {
+        throw std::invalid_argument("BacktestEngine market data must not be null");
+    }
+    market_data_ = std::move(data);
+}
+
+BacktestResults BacktestEngine::run() {
+    return run_in_place();
+}
+
+const BacktestResults& BacktestEngine::run_in_place() {
+    // 只重置标量指标，序列沿用上次运行的缓冲区
+    std::vector<double> equity_curve = std::move(results_.equity_curve);
+    std::vector<double> daily_returns = std::move(results_.daily_returns);
+    results_ = BacktestResults{};
+    results_.equity_curve = std::move(equity_curve);
+    results_.daily_returns = std::move(daily_returns);
+    results_.equity_curve.clear();
+    results_.daily_returns.clear();
+
+    const size_t bars = market_data_->bars();
+    if (bars == 0) {
+        std::cerr << "未加载行情数据，无法运行回测" << std::endl;
+        return results_;
+    }
+
+    reset_book();
+    daily_equity_.assign(bars, 0.0);
+
+    StrategyContext context;
+    context.universe = &market_data_->symbols;
+    context.engine = this;
+
+    is_running_ = true;
+    try {
+        update_market_data(context, 0);
+        for (auto& strategy : strategies_) {
+            strategy->initialize(context);
+        }
+        for (size_t bar = 0; bar < bars; ++bar) {
+            run_single_day(context, bar);
+        }
+    } catch (...) {
+        is_running_ = false;
+        throw;
+    }
+    is_running_ = false;
+
+    calculate_performance_metrics();
+    return results_;
+}
+
+bool BacktestEngine::save_results(const std::string& filename) const {
+    try {
+        nlohmann::json j;
+        j["summary"] = get_performance_summary();
+        j["dates"] = market_data_->dates;
+        j["equity_curve"] = results_.equity_curve;
+        j["daily_returns"] = results_.daily_returns;
+        j["trades"] = nlohmann::json::array();
+        for (size_t i = 0; i < trade_pnl_.size(); ++i) {
+            j["trades"].push_back({{"date", market_data_->dates[trade_bars_[i]]}, {"pnl", trade_pnl_[i]}});
+        }
+
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "无法写入回测结果: " << filename << std::endl;
+            return false;
+        }
+        file << j.dump(2);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "保存回测结果失败: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+std::map<std::string, double> BacktestEngine::get_performance_summary() const {
+    return {
+        {"total_return", results_.total_return},
+        {"annual_return", results_.annual_return},
+        {"sharpe_ratio", results_.sharpe_ratio},
+        {"max_drawdown", results_.max_drawdown},
+        {"volatility", results_.volatility},
+        {"win_rate", results_.win_rate},
+        {"profit_factor", results_.profit_factor},
+        {"total_trades", static_cast<double>(results_.total_trades)},
+        {"final_value", results_.final_value}
+    };
+}
+
+std::vector<std::pair<std::string, double>> BacktestEngine::plot_equity_curve() const {
+    std::vector<std::pair<std::string, double>> curve;
+    const size_t size = std::min(market_data_->bars(), results_.equity_curve.size());
+    curve.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        curve.emplace_back(market_data_->dates[i], results_.equity_curve[i]);
+    }
+    return curve;
+}
+
+std::map<std::string, std::vector<double>> BacktestEngine::get_trade_analysis() const {
+    std::map<std::string, std::vector<double>> analysis;
+    analysis["realized_pnl"] = trade_pnl_;
+
+    auto& drawdown = analysis["drawdown"];
+    drawdown.reserve(results_.equity_curve.size());
+    double peak = 0.0;
+    for (double equity : results_.equity_curve) {
+        peak = std::max(peak, equity);
+        drawdown.push_back(peak > 0 ? (peak - equity) / peak : 0.0);
+    }
+
+    analysis["equity_curve"] = results_.equity_curve;
+    analysis["daily_returns"] = results_.daily_returns;
+    return analysis;
+}
+
+void BacktestEngine::reset_book() {
+    cash_ = config_.initial_cash;
+    holdings_.assign(market_data_->symbol_count(), 0.0);
+    cost_basis_.assign(market_data_->symbol_count(), 0.0);
+    total_fills_ = 0;
+    trade_bars_.clear();
+    trade_pnl_.clear();
+}
+
+bool BacktestEngine::load_data_from_file(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "无法打开行情文件: " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line)) {
+        std::cerr << "行情文件为空: " << filename << std::endl;
+        return false;
+    }
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+
+    // 按表头定位列
+    const auto header = split_csv_line(line);
+    const int date_col = find_column(header, {"date", "datetime", "trade_date"});
+    const int symbol_col = find_column(header, {"code", "symbol", "order_book_id"});
+    const int open_col = find_column(header, {"open"});
+    const int high_col = find_column(header, {"high"});
+    const int low_col = find_column(header, {"low"});
+    const int close_col = find_column(header, {"close"});
+    const int volume_col = find_column(header, {"volume", "vol"});
+    if (std::min({date_col, symbol_col, open_col, high_col, low_col, close_col}) < 0) {
+        std::cerr << "行情文件缺少必需的列 (date, code, open, high, low, close): " << filename << std::endl;
+        return false;
+    }
+    const size_t width = static_cast<size_t>(std::max({date_col, symbol_col, open_col, high_col,
+                                                       low_col, close_col, volume_col})) + 1;
+
+    std::vector<BarRecord> records;
+    size_t line_number = 1;
+    while (std::getline(file, line)) {
+        line_number++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        const auto fields = split_csv_line(line);
+        if (fields.size() < width) {
+            std::cerr << "行情文件第 " << line_number << " 行列数不足" << std::endl;
+            return false;
+        }
+        try {
+            BarRecord record;
+            record.date = fields[date_col];
+            record.symbol = fields[symbol_col];
+            record.open = std::stod(fields[open_col]);
+            record.high = std::stod(fields[high_col]);
+            record.low = std::stod(fields[low_col]);
+            record.close = std::stod(fields[close_col]);
+            record.volume = volume_col >= 0 ? std::stod(fields[volume_col]) : 0.0;
+            records.push_back(std::move(record));
+        } catch (const std::exception& e) {
+            std::cerr << "行情文件第 " << line_number << " 行解析失败: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    return load_bars(records);
+}
+
+bool BacktestEngine::load_data_from_database() {
+    std::cerr << "未配置数据库行情源，请通过 CSV 文件或 load_bars 加载数据" << std::endl;
+    return false;
+}
+
+void BacktestEngine::run_single_day(StrategyContext& context, size_t bar) {
+    update_market_data(context, bar);
+    execute_strategies(context);
+    record_daily_performance();
+}
+
+void BacktestEngine::update_market_data(StrategyContext& context, size_t bar) {
+    current_index_ = bar;
+    current_date_ = market_data_->dates[bar];
+    context.bar_index = bar;
+    context.current_date = current_date_;
+    if (market_data_->symbol_count() == 1) {
+        context.current_price = market_data_->close[bar];
+    }
+}
+
+void BacktestEngine::execute_strategies(StrategyContext& context) {
+    for (auto& strategy : strategies_) {
+        strategy->before_market_open(context);
+        strategy->handle_data(context);
+        strategy->after_market_close(context);
+    }
+}
+
+void BacktestEngine::record_daily_performance() {
+    daily_equity_[current_index_] = portfolio_value(current_index_);
+}
+
+void BacktestEngine::calculate_performance_metrics() {
+    results_.equity_curve.assign(daily_equity_.begin(), daily_equity_.end());
+    calculate_returns_simd(daily_equity_, results_.daily_returns);
+    results_.final_value = daily_equity_.empty() ? config_.initial_cash : daily_equity_.back();
+    results_.total_return = results_.final_value / config_.initial_cash - 1.0;
+    results_.annual_return = calculate_annual_return();
+    results_.volatility = calculate_volatility();
+    results_.sharpe_ratio = calculate_sharpe_ratio();
+    results_.max_drawdown = calculate_max_drawdown();
+    results_.win_rate = calculate_win_rate();
+    results_.profit_factor = calculate_profit_factor();
+    results_.total_trades = total_fills_;
+}
+
+bool BacktestEngine::execute_order(size_t symbol, double volume, bool is_buy) {
+    if (symbol >= market_data_->symbol_count() || !(volume > 0.0) || current_index_ < market_data_->first_bar[symbol]) {
+        return false;
+    }
+    if (!is_buy && volume > holdings_[symbol]) {
+        return false;
+    }
+    const double price = market_data_->close[symbol * market_data_->bars() + current_index_];
+    if (!(price > 0.0)) {
+        return false;
+    }
+
+    // 收盘价立即成交，成本与已实现盈亏均含手续费
+    const double amount = price * volume;
+    const double commission = amount * config_.commission_rate;
+    if (is_buy) {
+        if (amount + commission > cash_) {
+            return false;
+        }
+        cash_ -= amount + commission;
+        holdings_[symbol] += volume;
+        cost_basis_[symbol] += amount + commission;
+    } else {
+        const double released = cost_basis_[symbol] * (volume / holdings_[symbol]);
+        cash_ += amount - commission;
+        holdings_[symbol] -= volume;
+        cost_basis_[symbol] = holdings_[symbol] > 0.0 ? cost_basis_[symbol] - released : 0.0;
+        trade_bars_.push_back(current_index_);
+        trade_pnl_.push_back(amount - commission - released);
+    }
+    total_fills_++;
+    return true;
+}
+
+double BacktestEngine::portfolio_value(size_t bar) const {
+    const size_t symbols = market_data_->symbol_count();
+    if (holdings_.size() != symbols || bar >= market_data_->bars()) {
+        return cash_;
+    }
+    return cash_ +
+           SimdMath::dot_product(holdings_.data(), market_data_->close_rows.data() + bar * symbols, symbols);
+}
+
+double BacktestEngine::calculate_sharpe_ratio() const {
+    return FinancialMath::sharpe_ratio(results_.daily_returns.data(), results_.daily_returns.size());
+}
+
+double BacktestEngine::calculate_max_drawdown() const {
+    return FinancialMath::max_drawdown(daily_equity_.data(), daily_equity_.size());
+}
+
+double BacktestEngine::calculate_annual_return() const {
+    if (daily_equity_.empty() || !(results_.final_value > 0.0)) {
+        return 0.0;
+    }
+    const double years = static_cast<double>(daily_equity_.size()) / TRADING_DAYS;
+    return std::pow(results_.final_value / config_.initial_cash, 1.0 / years) - 1.0;
+}
+
+double BacktestEngine::calculate_volatility() const {
+    return calculate_volatility_simd(results_.daily_returns);
+}
+
+double BacktestEngine::calculate_win_rate() const {
+    return utils::calculate_win_rate(trade_pnl_);
+}
+
+double BacktestEngine::calculate_profit_factor() const {
+    return utils::calculate_profit_factor(trade_pnl_);
+}
+
+void BacktestEngine::calculate_returns_simd(const std::vector<double>& prices, std::vector<double>& returns) const {
+    if (prices.size() < 2) {
+        returns.clear();
+        return;
+    }
+    returns.resize(prices.size() - 1);
+    SimdMath::returns(prices.data(), returns.data(), prices.size());
+}
+
+double BacktestEngine::calculate_volatility_simd(const std::vector<double>& returns) const {
+    return utils::calculate_volatility(returns, true);
+}
+
+// ==================== 工具函数 ====================
+
+namespace utils {
+
+double calculate_sharpe_ratio(const std::vector<double>& returns, double risk_free_rate) {
+    return FinancialMath::sharpe_ratio(returns.data(), returns.size(), risk_free_rate);
+}
+
+double calculate_max_drawdown(const std::vector<double>& equity_curve) {
+    return FinancialMath::max_drawdown(equity_curve.data(), equity_curve.size());
+}
+
+double calculate_annual_return(const std::vector<double>& equity_curve, int trading_days) {
+    if (equity_curve.size() < 2 || !(equity_curve.front() > 0.0) || !(equity_curve.back() > 0.0)) {
+        return 0.0;
+    }
+    const double periods = static_cast<double>(equity_curve.size() - 1);
+    return std::pow(equity_curve.back() / equity_curve.front(), trading_days / periods) - 1.0;
+}
+
+double calculate_volatility(const std::vector<double>& returns, bool annualized) {
+    if (returns.empty()) {
+        return 0.0;
+    }
+    const double mean = SimdMath::sum(returns.data(), returns.size()) / static_cast<double>(returns.size());
+    const double volatility = SimdMath::std_dev(returns.data(), returns.size(), mean);
+    return annualized ? volatility * std::sqrt(static_cast<double>(TRADING_DAYS)) : volatility;
+}
+
+double calculate_win_rate(const std::vector<double>& trade_returns) {
+    if (trade_returns.empty()) {
+        return 0.0;
+    }
+    const auto wins = std::count_if(trade_returns.begin(), trade_returns.end(), [](double r) { return r > 0.0; });
+    return static_cast<double>(wins) / static_cast<double>(trade_returns.size());
+}
+
+double calculate_profit_factor(const std::vector<double>& trade_returns) {
+    double gross_profit = 0.0;
+    double gross_loss = 0.0;
+    for (double r : trade_returns) {
+        if (r > 0.0) {
+            gross_profit += r;
+        } else {
+            gross_loss -= r;
+        }
+    }
+    if (gross_loss > 0.0) {
+        return gross_profit / gross_loss;
+    }
+    // 只有盈利交易时盈亏比无上界
+    return gross_profit > 0.0 ? std::numeric_limits<double>::infinity() : 0.0;
+}
+
+std::vector<double> calculate_rolling_sharpe(const std::vector<double>& returns, int window) {
+    return analysis::RiskCalculator::calculate_rolling_sharpe(returns, window);
+}
+
+double calculate_beta(const std::vector<double>& strategy_returns, const std::vector<double>& benchmark_returns) {
+    return analysis::RiskCalculator::calculate_beta(strategy_returns, benchmark_returns);
+}
+
+double calculate_alpha(const std::vector<double>& strategy_returns, const std::vector<double>& benchmark_returns,
+                       double risk_free_rate) {
+    return analysis::RiskCalculator::calculate_alpha(strategy_returns, benchmark_returns, risk_free_rate);
+}
+
+} // namespace utils
+
+// ==================== 策略工厂 ====================
+
+namespace factory {
+
+std::shared_ptr<Strategy> create_sma_strategy(int fast_window, int slow_window) {
+    return std::make_shared<SMAStrategy>(fast_window, slow_window);
+}
+
+std::shared_ptr<Strategy> create_momentum_strategy(int lookback_window, double threshold) {
+    return std::make_shared<MomentumStrategy>(lookback_window, threshold);
+}
+
+std::shared_ptr<Strategy> create_mean_reversion_strategy(int window, double z_score_threshold) {
+    return std::make_shared<MeanReversionStrategy>(window, z_score_threshold);
+}
+
+} // namespace factory
+
+} // namespace qaultra::engine
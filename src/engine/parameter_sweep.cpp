@@ -0,0 +1,261 @@
+#include "qaultra/engine/parameter_sweep.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace qaultra::engine {
+
+// ==================== ParameterGrid ====================
+
+ParameterGrid ParameterGrid::cartesian(const std::vector<std::pair<std::string, std::vector<double>>>& axes) {
+    ParameterGrid grid;
+    size_t total = axes.empty() ? 0 : 1;
+    for (const auto& [name, values] : axes) {
+        grid.names.push_back(name);
+        total *= values.size();
+    }
+
+    grid.values.resize(total * axes.size());
+    for (size_t i = 0; i < total; ++i) {
+        double* point = grid.values.data() + i * axes.size();
+        size_t rest = i;
+        for (size_t a = axes.size(); a-- > 0;) {
+            const auto& values = axes[a].second;
+            point[a] = values[rest % values.size()];
+            rest /= values.size();
+        }
+    }
+    return grid;
+}
+
+ParameterGrid ParameterGrid::random(const std::vector<ParameterRange>& ranges, size_t samples, uint64_t seed) {
+    ParameterGrid grid;
+    for (const auto& range : ranges) {
+        if (range.min > range.max || (range.integer && std::ceil(range.min) > std::floor(range.max))) {
+            throw std::invalid_argument("ParameterRange is empty: " + range.name);
+        }
+        grid.names.push_back(range.name);
+    }
+
+    std::mt19937_64 rng(seed);
+    grid.values.resize(samples * ranges.size());
+    for (size_t i = 0; i < samples; ++i) {
+        double* point = grid.values.data() + i * ranges.size();
+        for (size_t r = 0; r < ranges.size(); ++r) {
+            const auto& range = ranges[r];
+            if (range.integer) {
+                std::uniform_int_distribution<long long> dist(static_cast<long long>(std::ceil(range.min)),
+                                                              static_cast<long long>(std::floor(range.max)));
+                point[r] = static_cast<double>(dist(rng));
+            } else {
+                std::uniform_real_distribution<double> dist(range.min, range.max);
+                point[r] = dist(rng);
+            }
+        }
+    }
+    return grid;
+}
+
+// ==================== SweepResultTable ====================
+
+void SweepResultTable::resize(size_t rows) {
+    for (auto* column : {&total_return, &annual_return, &sharpe_ratio, &max_drawdown,
+                         &volatility, &win_rate, &profit_factor, &final_value}) {
+        column->assign(rows, 0.0);
+    }
+    total_trades.assign(rows, 0);
+    completed.assign(rows, 0);
+    errors.assign(rows, std::string());
+    for (auto& column : parameters) {
+        column.resize(rows);
+    }
+}
+
+void SweepResultTable::set_row(size_t row, const BacktestResults& results) {
+    total_return[row] = results.total_return;
+    annual_return[row] = results.annual_return;
+    sharpe_ratio[row] = results.sharpe_ratio;
+    max_drawdown[row] = results.max_drawdown;
+    volatility[row] = results.volatility;
+    win_rate[row] = results.win_rate;
+    profit_factor[row] = results.profit_factor;
+    final_value[row] = results.final_value;
+    total_trades[row] = results.total_trades;
+}
+
+size_t SweepResultTable::best(const std::vector<double>& column) const {
+    size_t best_row = size();
+    for (size_t row = 0; row < std::min(size(), column.size()); ++row) {
+        if (!completed[row] || std::isnan(column[row])) {
+            continue;
+        }
+        if (best_row == size() || column[row] > column[best_row]) {
+            best_row = row;
+        }
+    }
+    return best_row;
+}
+
+// ==================== ParameterSweep ====================
+
+namespace {
+
+/**
+ * @brief 单个工作线程的任务区间 [next, end)
+ */
+struct WorkRange {
+    std::mutex mutex;
+    size_t next = 0;
+    size_t end = 0;
+};
+
+bool take_own(WorkRange& range, size_t& index) {
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.next >= range.end) {
+        return false;
+    }
+    index = range.next++;
+    return true;
+}
+
+/**
+ * @brief 从其他线程剩余区间的后半段窃取任务，窃得的首个下标直接返回，其余放入自己的区间
+ */
+bool steal(std::vector<WorkRange>& ranges, size_t self, size_t& index) {
+    const size_t count = ranges.size();
+    for (size_t k = 1; k < count; ++k) {
+        WorkRange& victim = ranges[(self + k) % count];
+        size_t begin = 0;
+        size_t end = 0;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            const size_t remaining = victim.end - victim.next;
+            if (remaining == 0) {
+                continue;
+            }
+            begin = victim.next + remaining / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+        std::lock_guard<std::mutex> lock(ranges[self].mutex);
+        ranges[self].next = begin + 1;
+        ranges[self].end = end;
+        index = begin;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+ParameterSweep::ParameterSweep(const BacktestConfig& config, std::shared_ptr<const BarPanel> data)
+    : config_(config)
+    , data_(std::move(data))
+{
+    if (!data_) {
+        throw std::invalid_argument("ParameterSweep market data must not be null");
+    }
+    BacktestEngine probe(config_);   // 提前校验配置
+}
+
+SweepResultTable ParameterSweep::run(const StrategyFactory& factory, const ParameterGrid& grid,
+                                     const SweepOptions& options) const {
+    SweepResultTable table;
+    table.parameter_names = grid.names;
+    table.parameters.assign(grid.names.size(), std::vector<double>());
+    const size_t points = grid.size();
+    table.resize(points);
+    for (size_t row = 0; row < points; ++row) {
+        for (size_t p = 0; p < grid.names.size(); ++p) {
+            table.parameters[p][row] = grid.point(row)[p];
+        }
+    }
+    if (points == 0) {
+        return table;
+    }
+
+    // 每个工作线程复用一个引擎: 行情共享，资金簿与结果缓冲区在各参数点之间沿用
+    const auto make_engine = [this] {
+        auto engine = std::make_unique<BacktestEngine>(config_);
+        engine->set_market_data(data_);
+        return engine;
+    };
+
+    std::mutex callback_mutex;
+    const auto run_point = [&](size_t row, BacktestEngine& engine) {
+        const BacktestResults* results = nullptr;
+        try {
+            std::shared_ptr<Strategy> strategy = factory();
+            if (!strategy) {
+                throw std::invalid_argument("strategy factory returned null");
+            }
+            const double* point = grid.point(row);
+            for (size_t p = 0; p < grid.names.size(); ++p) {
+                strategy->set_parameter(grid.names[p], point[p]);
+            }
+
+            engine.clear_strategies();
+            engine.add_strategy(std::move(strategy));
+            results = &engine.run_in_place();
+            table.set_row(row, *results);
+            table.completed[row] = 1;
+        } catch (const std::exception& e) {
+            table.errors[row] = e.what();
+            return;
+        }
+
+        // 回测已完成，回调失败只记录原因，不影响该行结果
+        if (options.on_result) {
+            try {
+                std::lock_guard<std::mutex> lock(callback_mutex);
+                options.on_result(row, *results);
+            } catch (const std::exception& e) {
+                table.errors[row] = std::string("on_result: ") + e.what();
+            }
+        }
+    };
+
+    size_t num_threads = options.threads > 0 ? options.threads
+        : config_.max_threads > 0 ? static_cast<size_t>(config_.max_threads)
+        : std::max<size_t>(1, std::thread::hardware_concurrency());
+    num_threads = std::min(num_threads, points);
+
+    if (num_threads == 1) {
+        const auto engine = make_engine();
+        for (size_t row = 0; row < points; ++row) {
+            run_point(row, *engine);
+        }
+        return table;
+    }
+
+    // 初始按连续区间均分，空闲线程再窃取
+    std::vector<WorkRange> ranges(num_threads);
+    const size_t chunk_size = (points + num_threads - 1) / num_threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+        ranges[i].next = std::min(points, i * chunk_size);
+        ranges[i].end = std::min(points, (i + 1) * chunk_size);
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&, i]() {
+            const auto engine = make_engine();
+            size_t row = 0;
+            while (take_own(ranges[i], row) || steal(ranges, i, row)) {
+                run_point(row, *engine);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return table;
+}
+
+} // namespace qaultra::engine
@@ -0,0 +1,182 @@
+#include "qaultra/engine/vectorized_backtest.hpp"
+#include "qaultra/account/marketpreset.hpp"
+#include "qaultra/simd/simd_math.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace qaultra::engine {
+
+using simd::SimdMath;
+
+namespace {
+
+constexpr double TRADING_DAYS = 252.0;
+
+} // namespace
+
+// ==================== InstrumentCosts ====================
+
+InstrumentCosts InstrumentCosts::uniform(size_t symbols, double commission_rate) {
+    InstrumentCosts costs;
+    costs.multiplier.assign(symbols, 1.0);
+    costs.commission_rate.assign(symbols, commission_rate);
+    costs.commission_per_volume.assign(symbols, 0.0);
+    costs.sell_tax_rate.assign(symbols, 0.0);
+    return costs;
+}
+
+InstrumentCosts InstrumentCosts::from_preset(account::MarketPreset& preset, const std::vector<std::string>& symbols) {
+    InstrumentCosts costs;
+    for (const auto& symbol : symbols) {
+        const account::CodePreset code = preset.get(symbol);
+        costs.multiplier.push_back(static_cast<double>(code.unit_table));
+        costs.commission_rate.push_back(code.commission_coeff_peramount);
+        costs.commission_per_volume.push_back(code.commission_coeff_pervol);
+        // 税率取单位市值的卖出税额 (towards = -1 为卖出)
+        costs.sell_tax_rate.push_back(code.calc_tax(1.0, 1.0, -1) / code.calc_marketvalue(1.0, 1.0));
+    }
+    return costs;
+}
+
+// ==================== VectorizedBacktest ====================
+
+VectorizedBacktest::VectorizedBacktest(const BacktestConfig& config, std::shared_ptr<const BarPanel> data)
+    : config_(config)
+    , data_(std::move(data))
+{
+    if (!data_) {
+        throw std::invalid_argument("VectorizedBacktest market data must not be null");
+    }
+    if (!(config_.initial_cash > 0.0)) {
+        throw std::invalid_argument("VectorizedBacktest initial_cash must be positive");
+    }
+    if (!(config_.lot_size > 0.0)) {
+        throw std::invalid_argument("VectorizedBacktest lot_size must be positive");
+    }
+    costs_ = InstrumentCosts::uniform(data_->symbol_count(), config_.commission_rate);
+}
+
+void VectorizedBacktest::set_costs(InstrumentCosts costs) {
+    const size_t symbols = data_->symbol_count();
+    if (costs.multiplier.size() != symbols || costs.commission_rate.size() != symbols ||
+        costs.commission_per_volume.size() != symbols || costs.sell_tax_rate.size() != symbols) {
+        throw std::invalid_argument("InstrumentCosts size does not match the market data");
+    }
+    costs_ = std::move(costs);
+}
+
+void VectorizedBacktest::set_market_preset(account::MarketPreset& preset) {
+    set_costs(InstrumentCosts::from_preset(preset, data_->symbols));
+}
+
+VectorizedResults VectorizedBacktest::run(const std::vector<double>& target_weights, bool record_holdings) const {
+    const BarPanel& panel = *data_;
+    const size_t bars = panel.bars();
+    const size_t n = panel.symbol_count();
+    if (target_weights.size() != bars * n) {
+        throw std::invalid_argument("target weight matrix must be bars x symbols");
+    }
+
+    VectorizedResults results;
+    results.equity_curve.assign(bars, 0.0);
+    results.cash.assign(bars, 0.0);
+    results.turnover.assign(bars, 0.0);
+    results.costs.assign(bars, 0.0);
+    if (record_holdings) {
+        results.holdings.assign(bars * n, 0.0);
+    }
+
+    std::vector<double> holdings(n, 0.0);
+    std::vector<double> cost_basis(n, 0.0);
+    std::vector<double> unit_value(n);                 // 价格 × 合约乘数
+    std::vector<double> target(n);
+    std::vector<double> delta(n);
+    std::vector<double> realized;
+    double cash = config_.initial_cash;
+    int fills = 0;
+    const double lot = config_.lot_size;
+
+    for (size_t t = 0; t < bars; ++t) {
+        SimdMath::multiply(panel.close_rows.data() + t * n, costs_.multiplier.data(), unit_value.data(), n);
+        const double value = cash + SimdMath::dot_product(holdings.data(), unit_value.data(), n);
+
+        // 目标持仓 (不可交易或 NaN 权重时保持原持仓)
+        const double* weights = target_weights.data() + t * n;
+        for (size_t s = 0; s < n; ++s) {
+            const double w = weights[s];
+            const bool tradable = t >= panel.first_bar[s] && unit_value[s] > 0.0 && !std::isnan(w);
+            target[s] = tradable ? std::floor(std::max(w * value, 0.0) / unit_value[s] / lot) * lot : holdings[s];
+        }
+        SimdMath::subtract(target.data(), holdings.data(), delta.data(), n);
+
+        // 成交额、费用与成本 / 已实现盈亏: 先卖后买，卖出回笼的资金可用于同一根 bar 的买入
+        double turnover = 0.0;
+        double fees = 0.0;
+        for (size_t s = 0; s < n; ++s) {
+            const double d = delta[s];
+            if (!(d < 0.0)) {
+                continue;
+            }
+            const double amount = -d * unit_value[s];
+            double fee = amount * costs_.commission_rate[s] - d * costs_.commission_per_volume[s];
+            fee += amount * costs_.sell_tax_rate[s];
+            const double released = cost_basis[s] * (-d / holdings[s]);
+            cost_basis[s] = target[s] > 0.0 ? cost_basis[s] - released : 0.0;
+            cash += amount - fee;
+            realized.push_back(amount - fee - released);
+            turnover += amount;
+            fees += fee;
+            fills++;
+        }
+        for (size_t s = 0; s < n; ++s) {
+            const double d = delta[s];
+            if (!(d > 0.0)) {
+                continue;
+            }
+            const double amount = d * unit_value[s];
+            const double fee = amount * costs_.commission_rate[s] + d * costs_.commission_per_volume[s];
+            if (amount + fee > cash) {
+                // 资金不足: 与 BacktestEngine::execute_order 相同，整笔拒绝并保持原持仓
+                target[s] = holdings[s];
+                continue;
+            }
+            cost_basis[s] += amount + fee;
+            cash -= amount + fee;
+            turnover += amount;
+            fees += fee;
+            fills++;
+        }
+        holdings.swap(target);
+
+        results.cash[t] = cash;
+        results.turnover[t] = turnover;
+        results.costs[t] = fees;
+        results.equity_curve[t] = cash + SimdMath::dot_product(holdings.data(), unit_value.data(), n);
+        if (record_holdings) {
+            std::copy(holdings.begin(), holdings.end(), results.holdings.begin() + t * n);
+        }
+    }
+
+    // 汇总指标 (与 BacktestEngine::calculate_performance_metrics 相同)
+    if (bars > 1) {
+        results.daily_returns.resize(bars - 1);
+        SimdMath::returns(results.equity_curve.data(), results.daily_returns.data(), bars);
+    }
+    results.final_value = bars == 0 ? config_.initial_cash : results.equity_curve.back();
+    results.total_return = results.final_value / config_.initial_cash - 1.0;
+    if (bars > 0 && results.final_value > 0.0) {
+        const double years = static_cast<double>(bars) / TRADING_DAYS;
+        results.annual_return = std::pow(results.final_value / config_.initial_cash, 1.0 / years) - 1.0;
+    }
+    results.volatility = utils::calculate_volatility(results.daily_returns, true);
+    results.sharpe_ratio = utils::calculate_sharpe_ratio(results.daily_returns);
+    results.max_drawdown = utils::calculate_max_drawdown(results.equity_curve);
+    results.win_rate = utils::calculate_win_rate(realized);
+    results.profit_factor = utils::calculate_profit_factor(realized);
+    results.total_trades = fills;
+    return results;
+}
+
+} // namespace qaultra::engine
@@ -0,0 +1,546 @@
+#include "qaultra/ipc/arrow_stream.hpp"
+
+#include <arrow/io/memory.h>
+#include <arrow/ipc/api.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace qaultra::ipc {
+
+namespace {
+
+std::string errno_message() {
+    return std::strerror(errno);
+}
+
+const arrow::ipc::IpcWriteOptions& write_options() {
+    static const arrow::ipc::IpcWriteOptions options = arrow::ipc::IpcWriteOptions::Defaults();
+    return options;
+}
+
+/**
+ * @brief 序列化一条封装格式的 IPC 消息 (仅用于目录，环上的消息直接写入槽位)
+ */
+arrow::Result<std::shared_ptr<arrow::Buffer>> serialize_payload(const arrow::ipc::IpcPayload& payload) {
+    ARROW_ASSIGN_OR_RAISE(auto sink, arrow::io::BufferOutputStream::Create());
+    int32_t metadata_length = 0;
+    ARROW_RETURN_NOT_OK(arrow::ipc::WriteIpcPayload(payload, write_options(), sink.get(), &metadata_length));
+    return sink->Finish();
+}
+
+bool is_instrument_type(const arrow::DataType& type) {
+    if (type.id() != arrow::Type::DICTIONARY) {
+        return false;
+    }
+    const auto& dictionary = static_cast<const arrow::DictionaryType&>(type);
+    return dictionary.index_type()->id() == arrow::Type::INT32 &&
+           dictionary.value_type()->id() == arrow::Type::STRING;
+}
+
+} // namespace
+
+std::string arrow_catalog_name(const BroadcastConfig& config, const std::string& stream_name) {
+    return shm::shm_object_name(config, stream_name) + "_arrow";
+}
+
+//==============================================================================
+// 目录段 (发布端)
+//==============================================================================
+
+class ArrowStreamPublisher::Catalog {
+public:
+    Catalog(const std::string& shm_name, size_t capacity)
+        : shm_name_(shm_name)
+        , capacity_(capacity)
+        , mapped_size_(sizeof(ArrowCatalogHeader) + capacity)
+    {
+        ::shm_unlink(shm_name_.c_str());
+        int fd = ::shm_open(shm_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create shared memory " + shm_name_ + ": " + errno_message());
+        }
+        if (::ftruncate(fd, static_cast<off_t>(mapped_size_)) != 0) {
+            const std::string error = errno_message();
+            ::close(fd);
+            ::shm_unlink(shm_name_.c_str());
+            throw std::runtime_error("Failed to size shared memory " + shm_name_ + ": " + error);
+        }
+
+        void* memory = ::mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            const std::string error = errno_message();
+            ::shm_unlink(shm_name_.c_str());
+            throw std::runtime_error("Failed to map shared memory " + shm_name_ + ": " + error);
+        }
+
+        // magic 在第一次写入目录后才发布，订阅者不会看到空目录
+        header_ = new (memory) ArrowCatalogHeader();
+        header_->version = ArrowCatalogHeader::VERSION;
+        header_->capacity = capacity_;
+        header_->closed.store(0, std::memory_order_relaxed);
+        header_->sequence.store(0, std::memory_order_relaxed);
+        data_ = static_cast<uint8_t*>(memory) + sizeof(ArrowCatalogHeader);
+    }
+
+    ~Catalog() {
+        header_->closed.store(1, std::memory_order_release);
+        ::munmap(header_, mapped_size_);
+        ::shm_unlink(shm_name_.c_str());
+    }
+
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+
+    bool write(const arrow::Buffer& schema, const arrow::Buffer& dictionary, size_t length) {
+        const auto schema_size = static_cast<size_t>(schema.size());
+        const auto dictionary_size = static_cast<size_t>(dictionary.size());
+        if (schema_size + dictionary_size > capacity_) {
+            return false;
+        }
+
+        const uint64_t sequence = header_->sequence.load(std::memory_order_relaxed);
+        header_->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(data_, schema.data(), schema_size);
+        std::memcpy(data_ + schema_size, dictionary.data(), dictionary_size);
+        header_->schema_size = schema_size;
+        header_->dictionary_size = dictionary_size;
+        header_->dictionary_length = length;
+
+        header_->sequence.store(sequence + 2, std::memory_order_release);
+        if (sequence == 0) {
+            reinterpret_cast<std::atomic<uint64_t>*>(&header_->magic)
+                ->store(ArrowCatalogHeader::MAGIC, std::memory_order_release);
+        }
+        return true;
+    }
+
+private:
+    std::string shm_name_;
+    size_t capacity_;
+    size_t mapped_size_;
+    ArrowCatalogHeader* header_ = nullptr;
+    uint8_t* data_ = nullptr;
+};
+
+//==============================================================================
+// 槽位输出流: WriteIpcPayload 的字节直接写入借出的槽位，写满后作为分片发布
+//==============================================================================
+
+class ArrowStreamPublisher::MessageStream : public arrow::io::OutputStream {
+public:
+    explicit MessageStream(shm::LargeShmRingBroadcaster& ring) : ring_(ring) {}
+
+    /**
+     * @brief 将一条 IPC 消息作为一条逻辑消息发布
+     * @return 消息字节数，失败时返回 -1
+     */
+    int64_t write_message(const arrow::ipc::IpcPayload& payload, uint8_t kind, uint64_t records) {
+        kind_ = kind;
+        fragmented_ = false;
+        position_ = 0;
+
+        int32_t metadata_length = 0;
+        const arrow::Status status =
+            arrow::ipc::WriteIpcPayload(payload, write_options(), this, &metadata_length);
+        if (!writer_.valid()) {
+            return -1;
+        }
+        if (!status.ok()) {
+            // 已借出的槽位必须归还: 作为残缺分片发布，订阅端重组器会将其丢弃
+            std::cerr << "Failed to write Arrow IPC message: " << status.ToString() << std::endl;
+            ring_.publish(writer_, MarketDataType::ArrowIpc, block_flags::FRAGMENT);
+            return -1;
+        }
+
+        writer_.commit(0, records);
+        const uint8_t flags = fragmented_ ? block_flags::FRAGMENT | block_flags::FRAGMENT_LAST : 0;
+        return publish_current(flags) ? position_ : -1;
+    }
+
+    arrow::Status Write(const void* data, int64_t nbytes) override {
+        const auto* src = static_cast<const uint8_t*>(data);
+        while (nbytes > 0) {
+            if (!writer_.valid()) {
+                writer_ = ring_.loan();
+                if (!writer_.valid()) {
+                    return arrow::Status::IOError("shared memory ring slot unavailable");
+                }
+            }
+            if (writer_.remaining() == 0) {
+                // 还有数据时才发布已写满的槽位，末片由 write_message 标记
+                const uint8_t flags = fragmented_ ? block_flags::FRAGMENT
+                                                  : block_flags::FRAGMENT | block_flags::FRAGMENT_FIRST;
+                if (!publish_current(flags)) {
+                    return arrow::Status::IOError("failed to publish Arrow IPC fragment");
+                }
+                fragmented_ = true;
+                continue;
+            }
+            const size_t chunk = std::min(writer_.remaining(), static_cast<size_t>(nbytes));
+            std::memcpy(writer_.cursor(), src, chunk);
+            writer_.commit(chunk, 0);
+            src += chunk;
+            nbytes -= static_cast<int64_t>(chunk);
+            position_ += static_cast<int64_t>(chunk);
+        }
+        return arrow::Status::OK();
+    }
+
+    using arrow::io::OutputStream::Write;
+
+    arrow::Status Close() override {
+        closed_ = true;
+        return arrow::Status::OK();
+    }
+
+    bool closed() const override { return closed_; }
+    arrow::Result<int64_t> Tell() const override { return position_; }
+
+private:
+    bool publish_current(uint8_t flags) {
+        return ring_.publish(writer_, MarketDataType::ArrowIpc, static_cast<uint8_t>(flags | kind_));
+    }
+
+    shm::LargeShmRingBroadcaster& ring_;
+    shm::LargeShmRingBroadcaster::Writer writer_;
+    uint8_t kind_ = 0;
+    bool fragmented_ = false;
+    int64_t position_ = 0;
+    bool closed_ = false;
+};
+
+//==============================================================================
+// ArrowStreamPublisher
+//==============================================================================
+
+ArrowStreamPublisher::ArrowStreamPublisher(const BroadcastConfig& config,
+                                           const std::string& stream_name,
+                                           std::shared_ptr<arrow::Schema> schema,
+                                           size_t catalog_capacity)
+    : ring_(config, stream_name)
+    , schema_(std::move(schema))
+{
+    if (!schema_) {
+        throw std::invalid_argument("ArrowStreamPublisher requires a schema");
+    }
+    for (int i = 0; i < schema_->num_fields(); ++i) {
+        const auto& type = *schema_->field(i)->type();
+        if (is_instrument_type(type)) {
+            if (instrument_field_ >= 0) {
+                throw std::invalid_argument("Schema has more than one instrument column");
+            }
+            instrument_field_ = i;
+        } else if (type.id() == arrow::Type::DICTIONARY || type.num_fields() > 0) {
+            // 嵌套类型可能包含字典，字典只支持证券代码列
+            throw std::invalid_argument("Unsupported column type: " + type.ToString());
+        }
+    }
+    if (instrument_field_ < 0) {
+        throw std::invalid_argument("Schema has no dictionary<int32, utf8> instrument column");
+    }
+
+    arrow::ipc::DictionaryFieldMapper mapper(*schema_);
+    dictionary_id_ = mapper.GetFieldId({instrument_field_}).ValueOr(0);
+
+    arrow::ipc::IpcPayload payload;
+    arrow::Status status = arrow::ipc::GetSchemaPayload(*schema_, write_options(), mapper, &payload);
+    auto serialized = status.ok() ? serialize_payload(payload)
+                                  : arrow::Result<std::shared_ptr<arrow::Buffer>>(status);
+    if (!serialized.ok()) {
+        throw std::runtime_error("Failed to serialize Arrow schema: " + serialized.status().ToString());
+    }
+    schema_message_ = serialized.MoveValueUnsafe();
+
+    catalog_ = std::make_unique<Catalog>(arrow_catalog_name(config, stream_name), catalog_capacity);
+    stream_ = std::make_unique<MessageStream>(ring_);
+
+    // 初始状态: 目录先于环上的 schema 与全量字典写入
+    const size_t length = data::InstrumentRegistry::instance().size();
+    if (!write_catalog(length)) {
+        throw std::runtime_error("Arrow stream catalog capacity too small");
+    }
+    arrow::ipc::IpcPayload schema_payload;
+    if (!arrow::ipc::GetSchemaPayload(*schema_, write_options(), mapper, &schema_payload).ok() ||
+        stream_->write_message(schema_payload, arrow_message_flags::SCHEMA, 0) < 0 ||
+        !send_dictionary(false, 0, length)) {
+        throw std::runtime_error("Failed to publish Arrow stream header");
+    }
+    sent_length_ = length;
+}
+
+ArrowStreamPublisher::~ArrowStreamPublisher() = default;
+
+std::shared_ptr<arrow::DataType> ArrowStreamPublisher::instrument_type() {
+    return arrow::dictionary(arrow::int32(), arrow::utf8());
+}
+
+std::shared_ptr<arrow::Array> ArrowStreamPublisher::dictionary_array(size_t from, size_t to) const {
+    const auto& registry = data::InstrumentRegistry::instance();
+    arrow::StringBuilder builder;
+    if (!builder.Reserve(static_cast<int64_t>(to - from)).ok()) {
+        return nullptr;
+    }
+    for (size_t id = from; id < to; ++id) {
+        if (!builder.Append(registry.code(static_cast<data::InstrumentId>(id))).ok()) {
+            return nullptr;
+        }
+    }
+    std::shared_ptr<arrow::Array> array;
+    return builder.Finish(&array).ok() ? array : nullptr;
+}
+
+std::shared_ptr<arrow::Array> ArrowStreamPublisher::instrument_column(const std::vector<data::InstrumentId>& ids) {
+    const size_t length = data::InstrumentRegistry::instance().size();
+    if (!dictionary_ || static_cast<size_t>(dictionary_->length()) < length) {
+        dictionary_ = dictionary_array(0, length);
+    }
+
+    arrow::Int32Builder indices;
+    if (!indices.Reserve(static_cast<int64_t>(ids.size())).ok()) {
+        return nullptr;
+    }
+    for (data::InstrumentId id : ids) {
+        if (id < length) {
+            indices.UnsafeAppend(static_cast<int32_t>(id));
+        } else {
+            indices.UnsafeAppendNull();
+        }
+    }
+    std::shared_ptr<arrow::Array> index_array;
+    if (!indices.Finish(&index_array).ok() || !dictionary_) {
+        return nullptr;
+    }
+    return std::make_shared<arrow::DictionaryArray>(instrument_type(), index_array, dictionary_);
+}
+
+bool ArrowStreamPublisher::write_catalog(size_t length) {
+    auto dictionary = dictionary_array(0, length);
+    arrow::ipc::IpcPayload payload;
+    if (!dictionary ||
+        !arrow::ipc::GetDictionaryPayload(dictionary_id_, false, dictionary, write_options(), &payload).ok()) {
+        return false;
+    }
+    auto serialized = serialize_payload(payload);
+    if (!serialized.ok() || !catalog_->write(*schema_message_, **serialized, length)) {
+        return false;
+    }
+    dictionary_ = std::move(dictionary);
+    return true;
+}
+
+bool ArrowStreamPublisher::send_dictionary(bool is_delta, size_t from, size_t to) {
+    auto dictionary = dictionary_array(from, to);
+    arrow::ipc::IpcPayload payload;
+    if (!dictionary ||
+        !arrow::ipc::GetDictionaryPayload(dictionary_id_, is_delta, dictionary, write_options(), &payload).ok()) {
+        return false;
+    }
+    // record_count 为应用后的字典长度，订阅端据此跳过目录中已包含的增量
+    const int64_t bytes = stream_->write_message(payload, arrow_message_flags::DICTIONARY, to);
+    if (bytes < 0) {
+        return false;
+    }
+    stats_.message_bytes += static_cast<uint64_t>(bytes);
+    if (is_delta) {
+        stats_.dictionary_deltas++;
+    }
+    return true;
+}
+
+bool ArrowStreamPublisher::publish(const arrow::RecordBatch& batch) {
+    if (!batch.schema()->Equals(*schema_, false)) {
+        std::cerr << "Arrow stream batch schema mismatch" << std::endl;
+        stats_.errors++;
+        return false;
+    }
+
+    // 批次中的证券ID都已注册，注册表只增不改，发送到当前长度即可覆盖
+    const size_t length = data::InstrumentRegistry::instance().size();
+    if (length > sent_length_) {
+        if (!write_catalog(length)) {
+            std::cerr << "Arrow stream catalog capacity too small for " << length << " codes" << std::endl;
+            stats_.errors++;
+            return false;
+        }
+        if (!send_dictionary(true, sent_length_, length)) {
+            stats_.errors++;
+            return false;
+        }
+        sent_length_ = length;
+    }
+
+    arrow::ipc::IpcPayload payload;
+    if (!arrow::ipc::GetRecordBatchPayload(batch, write_options(), &payload).ok()) {
+        stats_.errors++;
+        return false;
+    }
+    const int64_t bytes = stream_->write_message(payload, arrow_message_flags::RECORD_BATCH,
+                                                 static_cast<uint64_t>(batch.num_rows()));
+    if (bytes < 0) {
+        stats_.errors++;
+        return false;
+    }
+    stats_.batches_sent++;
+    stats_.rows_sent += static_cast<uint64_t>(batch.num_rows());
+    stats_.message_bytes += static_cast<uint64_t>(bytes);
+    return true;
+}
+
+//==============================================================================
+// ArrowStreamSubscriber
+//==============================================================================
+
+class ArrowStreamSubscriber::Listener : public arrow::ipc::Listener {
+public:
+    arrow::Status OnRecordBatchDecoded(std::shared_ptr<arrow::RecordBatch> record_batch) override {
+        batch = std::move(record_batch);
+        return arrow::Status::OK();
+    }
+
+    std::shared_ptr<arrow::RecordBatch> batch;
+};
+
+ArrowStreamSubscriber::ArrowStreamSubscriber(const BroadcastConfig& config,
+                                             const std::string& stream_name,
+                                             StartPosition start)
+    : catalog_name_(arrow_catalog_name(config, stream_name))
+    , ring_(config, stream_name, start)
+    , listener_(std::make_shared<Listener>())
+{
+    int fd = ::shm_open(catalog_name_.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open shared memory " + catalog_name_ + ": " + errno_message());
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ArrowCatalogHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Shared memory " + catalog_name_ + " is not initialized");
+    }
+    catalog_mapped_size_ = static_cast<size_t>(st.st_size);
+
+    void* memory = ::mmap(nullptr, catalog_mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        throw std::runtime_error("Failed to map shared memory " + catalog_name_ + ": " + errno_message());
+    }
+    catalog_ = static_cast<const ArrowCatalogHeader*>(memory);
+    const uint64_t magic =
+        reinterpret_cast<const std::atomic<uint64_t>*>(&catalog_->magic)->load(std::memory_order_acquire);
+    if (magic != ArrowCatalogHeader::MAGIC || catalog_->version != ArrowCatalogHeader::VERSION ||
+        sizeof(ArrowCatalogHeader) + catalog_->capacity > catalog_mapped_size_) {
+        ::munmap(memory, catalog_mapped_size_);
+        catalog_ = nullptr;
+        throw std::runtime_error("Shared memory " + catalog_name_ + " has an incompatible layout");
+    }
+
+    // 环的读游标已确定: 游标之前发布的增量字典都已写入此后读到的目录
+    bootstrap();
+}
+
+ArrowStreamSubscriber::~ArrowStreamSubscriber() {
+    if (catalog_) {
+        ::munmap(const_cast<ArrowCatalogHeader*>(catalog_), catalog_mapped_size_);
+    }
+}
+
+void ArrowStreamSubscriber::bootstrap() {
+    const auto* data = reinterpret_cast<const uint8_t*>(catalog_) + sizeof(ArrowCatalogHeader);
+    std::vector<uint8_t> schema_bytes;
+    std::vector<uint8_t> dictionary_bytes;
+    uint64_t length = 0;
+    uint64_t sequence = 0;
+
+    while (true) {
+        sequence = catalog_->sequence.load(std::memory_order_acquire);
+        if (sequence & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        const size_t schema_size = std::min<size_t>(catalog_->schema_size, catalog_->capacity);
+        const size_t dictionary_size = std::min<size_t>(catalog_->dictionary_size, catalog_->capacity - schema_size);
+        length = catalog_->dictionary_length;
+        schema_bytes.assign(data, data + schema_size);
+        dictionary_bytes.assign(data + schema_size, data + schema_size + dictionary_size);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (catalog_->sequence.load(std::memory_order_relaxed) == sequence) {
+            break;
+        }
+    }
+
+    // 目录消息需要在解码器中长期保存，使用自有缓冲区
+    decoder_ = std::make_unique<arrow::ipc::StreamDecoder>(listener_);
+    arrow::Status status = decoder_->Consume(arrow::Buffer::FromVector(std::move(schema_bytes)));
+    if (status.ok()) {
+        status = decoder_->Consume(arrow::Buffer::FromVector(std::move(dictionary_bytes)));
+    }
+    if (!status.ok()) {
+        throw std::runtime_error("Invalid Arrow stream catalog " + catalog_name_ + ": " + status.ToString());
+    }
+    schema_ = decoder_->schema();
+    dictionary_length_ = length;
+    catalog_sequence_ = sequence;
+}
+
+std::shared_ptr<arrow::RecordBatch> ArrowStreamSubscriber::decode(const MessageView& message) {
+    if (message.data_type != MarketDataType::ArrowIpc) {
+        return nullptr;
+    }
+
+    const uint8_t kind = message.flags & arrow_message_flags::MASK;
+    if (kind == arrow_message_flags::RECORD_BATCH) {
+        // 零拷贝: 批次的列缓冲区指向共享内存或重组缓冲区
+        listener_->batch.reset();
+        const arrow::Status status =
+            decoder_->Consume(arrow::Buffer::Wrap(message.data, static_cast<int64_t>(message.size)));
+        if (!status.ok()) {
+            stats_.decode_errors++;
+            bootstrap();
+            return nullptr;
+        }
+        return std::move(listener_->batch);
+    }
+
+    if (kind == arrow_message_flags::DICTIONARY && message.record_count > dictionary_length_) {
+        // 字典由解码器长期保存，拷贝出共享内存
+        std::vector<uint8_t> bytes(message.data, message.data + message.size);
+        const arrow::Status status = decoder_->Consume(arrow::Buffer::FromVector(std::move(bytes)));
+        if (!status.ok()) {
+            stats_.decode_errors++;
+            bootstrap();
+            return nullptr;
+        }
+        dictionary_length_ = message.record_count;
+        stats_.dictionary_deltas++;
+        return nullptr;
+    }
+
+    // schema 与目录中已包含的字典
+    stats_.skipped_messages++;
+    return nullptr;
+}
+
+void ArrowStreamSubscriber::after_read(uint64_t overruns_before) {
+    if (ring_.get_receive_stats().overruns == overruns_before) {
+        return;
+    }
+    // 被跳过的消息中可能有增量字典；增量字典发布前必定先更新目录
+    if (catalog_->sequence.load(std::memory_order_acquire) != catalog_sequence_) {
+        bootstrap();
+        stats_.resyncs++;
+    }
+}
+
+} // namespace qaultra::ipc
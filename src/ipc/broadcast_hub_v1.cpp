@@ -1,9 +1,12 @@
 #include "qaultra/ipc/broadcast_hub_v1.hpp"
+#include "qaultra/ipc/numa_placement.hpp"
+#include "qaultra/ipc/latency_tracker.hpp"
 #include "iox/signal_watcher.hpp"
 
 #include <iostream>
 #include <thread>
 #include <cstring>
+#include <algorithm>
 
 namespace qaultra::ipc::v1 {
 
@@ -22,6 +25,15 @@ DataBroadcaster::DataBroadcaster(const BroadcastConfig& config, const std::strin
         throw std::invalid_argument("Invalid BroadcastConfig");
     }
 
+    // 共享内存池由 iceoryx 管理，这里只绑定发布线程 (cpu_affinity)
+    stats_.placement = place_current_thread(config_);
+
+    if (!config_.journal_dir.empty()) {
+        journal_ = std::make_unique<MarketJournalWriter>(journal_directory(config_, stream_name_),
+                                                         config_.journal_segment_mb << 20);
+        sequence_number_.store(journal_->next_sequence(), std::memory_order_relaxed);
+    }
+
     // 创建 IceOryx Publisher
     // Service: config_.service_name, Instance: stream_name, Event: "Data"
     try {
@@ -73,7 +85,8 @@ bool DataBroadcaster::initialize_runtime(const std::string& app_name) {
 bool DataBroadcaster::broadcast(const uint8_t* data,
                                 size_t data_size,
                                 size_t record_count,
-                                MarketDataType type)
+                                MarketDataType type,
+                                uint32_t instrument_id)
 {
     if (!publisher_) {
         return false;
@@ -92,17 +105,28 @@ bool DataBroadcaster::broadcast(const uint8_t* data,
     publisher_->loan()
         .and_then([&](auto& sample) {
             // 填充数据块
-            sample->sequence_number = sequence_number_++;
-            sample->timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                std::chrono::system_clock::now().time_since_epoch()
-            ).count();
+            sample->timestamp_ns = latency_clock_ns();
             sample->record_count = record_count;
             sample->data_type = type;
             sample->flags = 0;
+            sample->payload_size = static_cast<uint16_t>(data_size);
+            sample->set_instrument(instrument_id);
 
             // 拷贝数据
             std::memcpy(sample->data, data, data_size);
 
+            // 编号；启用日志时先写日志再发布
+            if (journal_) {
+                std::lock_guard<std::mutex> lock(journal_mutex_);
+                sample->sequence_number = sequence_number_++;
+                if (!journal_->append(*sample.get())) {
+                    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+                    stats_.errors++;
+                }
+            } else {
+                sample->sequence_number = sequence_number_++;
+            }
+
             // 计算延迟 (before publish, since publish consumes the sample)
             auto end = std::chrono::steady_clock::now();
             uint64_t latency_ns = static_cast<uint64_t>(
@@ -227,6 +251,10 @@ DataSubscriber::DataSubscriber(const BroadcastConfig& config, const std::string&
     if (!config_.validate()) {
         throw std::invalid_argument("Invalid BroadcastConfig");
     }
+    placement_ = place_current_thread(config_);
+    if (config_.latency_tracking) {
+        latency_ = std::make_unique<LatencyTracker>();
+    }
 
     // 创建 IceOryx Subscriber
     try {
@@ -263,31 +291,48 @@ std::optional<std::vector<uint8_t>> DataSubscriber::receive() {
     }
 
     std::optional<std::vector<uint8_t>> result;
-
-    subscriber_->take()
-        .and_then([&](auto& sample) {
-            // 拷贝数据
-            size_t data_size = sample->record_count > 0
-                ? ZeroCopyMarketBlock::DATA_SIZE
-                : 0;
-
-            std::vector<uint8_t> data(sample->data, sample->data + data_size);
-            result = std::move(data);
-
-            // 更新统计
-            std::lock_guard<std::mutex> lock(stats_mutex_);
-            receive_stats_.blocks_received++;
-            receive_stats_.records_received += sample->record_count;
-            receive_stats_.bytes_received += ZeroCopyMarketBlock::BLOCK_SIZE;
-        })
-        .or_else([&](auto& error) {
-            // NO_CHUNK_AVAILABLE 不是错误
-            if (error != iox::popo::ChunkReceiveResult::NO_CHUNK_AVAILABLE) {
-                std::cerr << "Error receiving chunk: " << static_cast<uint64_t>(error) << std::endl;
+    bool filtered = true;
+
+    while (filtered) {
+        filtered = false;
+        subscriber_->take()
+            .and_then([&](auto& sample) {
+                // 按元数据过滤: 不匹配的样本不拷贝负载，释放后取下一个
+                const uint64_t received_ns = latency_ ? latency_clock_ns() : 0;
+                if (!filter_.accepts_all() && !filter_.matches(*sample)) {
+                    filtered = true;
+                    std::lock_guard<std::mutex> lock(stats_mutex_);
+                    receive_stats_.blocks_filtered++;
+                    if (latency_) {
+                        latency_->record_sequence(sample->sequence_number);
+                    }
+                    return;
+                }
+
+                // 只拷贝有效负载 (兼容未填写 payload_size 的发布端)
+                const size_t data_size = sample->effective_payload_size();
+
+                std::vector<uint8_t> data(sample->data, sample->data + data_size);
+                result = std::move(data);
+
+                // 更新统计
                 std::lock_guard<std::mutex> lock(stats_mutex_);
-                receive_stats_.missed_samples++;
-            }
-        });
+                receive_stats_.blocks_received++;
+                receive_stats_.records_received += sample->record_count;
+                receive_stats_.bytes_received += ZeroCopyMarketBlock::BLOCK_SIZE;
+                if (latency_) {
+                    latency_->record(sample->sequence_number, sample->timestamp_ns, received_ns);
+                }
+            })
+            .or_else([&](auto& error) {
+                // NO_CHUNK_AVAILABLE 不是错误
+                if (error != iox::popo::ChunkReceiveResult::NO_CHUNK_AVAILABLE) {
+                    std::cerr << "Error receiving chunk: " << static_cast<uint64_t>(error) << std::endl;
+                    std::lock_guard<std::mutex> lock(stats_mutex_);
+                    receive_stats_.missed_samples++;
+                }
+            });
+    }
 
     return result;
 }
@@ -315,6 +360,9 @@ std::optional<const ZeroCopyMarketBlock*> DataSubscriber::receive_block() {
             receive_stats_.blocks_received++;
             receive_stats_.records_received += sample->record_count;
             receive_stats_.bytes_received += ZeroCopyMarketBlock::BLOCK_SIZE;
+            if (latency_) {
+                latency_->record(sample->sequence_number, sample->timestamp_ns, latency_clock_ns());
+            }
         })
         .or_else([&](auto& error) {
             if (error != iox::popo::ChunkReceiveResult::NO_CHUNK_AVAILABLE) {
@@ -341,6 +389,14 @@ DataSubscriber::ReceiveStats DataSubscriber::get_receive_stats() const {
 void DataSubscriber::reset_receive_stats() {
     std::lock_guard<std::mutex> lock(stats_mutex_);
     receive_stats_ = ReceiveStats{};
+    if (latency_) {
+        latency_->reset();
+    }
+}
+
+LatencySummary DataSubscriber::get_latency() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return latency_ ? latency_->summary() : LatencySummary{};
 }
 
 //==============================================================================
@@ -397,6 +453,10 @@ std::unordered_map<std::string, BroadcastStats> BroadcastManager::get_all_stats(
     for (const auto& [name, broadcaster] : broadcasters_) {
         all_stats[name] = broadcaster->get_stats();
     }
+    // 本进程订阅端测得的延迟并入同名流 (只订阅不发布的流只有延迟字段)
+    for (const auto& [name, subscriber] : subscribers_) {
+        all_stats[name].latency = subscriber->get_latency();
+    }
 
     return all_stats;
 }
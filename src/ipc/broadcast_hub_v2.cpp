@@ -1,8 +1,12 @@
 #include "qaultra/ipc/broadcast_hub_v2.hpp"
+#include "qaultra/ipc/numa_placement.hpp"
+#include "qaultra/ipc/latency_tracker.hpp"
 
 #include <iostream>
 #include <thread>
 #include <cstring>
+#include <cstddef>
+#include <algorithm>
 
 namespace qaultra::ipc::v2 {
 
@@ -19,6 +23,15 @@ DataBroadcaster::DataBroadcaster(const BroadcastConfig& config, const std::strin
         throw std::invalid_argument("Invalid BroadcastConfig");
     }
 
+    // 共享内存池由 iceoryx 管理，这里只绑定发布线程 (cpu_affinity)
+    stats_.placement = place_current_thread(config_);
+
+    if (!config_.journal_dir.empty()) {
+        journal_ = std::make_unique<MarketJournalWriter>(journal_directory(config_, stream_name_),
+                                                         config_.journal_segment_mb << 20);
+        sequence_number_.store(journal_->next_sequence(), std::memory_order_relaxed);
+    }
+
     try {
         // 创建 iceoryx2 Node
         auto node_result = iox2::NodeBuilder().create<iox2::ServiceType::Ipc>();
@@ -63,76 +76,131 @@ DataBroadcaster::~DataBroadcaster() {
     // iceoryx2 handles cleanup automatically
 }
 
-ZeroCopyMarketBlock DataBroadcaster::create_block(const uint8_t* data,
-                                                   size_t data_size,
-                                                   size_t record_count,
-                                                   MarketDataType type) {
-    ZeroCopyMarketBlock block{};
-    block.sequence_number = sequence_number_.fetch_add(1, std::memory_order_relaxed);
-    block.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::steady_clock::now().time_since_epoch()
-    ).count();
-    block.record_count = record_count;
-    block.data_type = type;
-    block.flags = 0;
+LoanedBlock DataBroadcaster::loan(MarketDataType type) {
+    LoanedBlock block;
 
-    // 拷贝数据
-    size_t copy_size = std::min(data_size, ZeroCopyMarketBlock::DATA_SIZE);
-    std::memcpy(block.data, data, copy_size);
+    auto sample_result = publisher_->loan_uninit();
+    if (sample_result.has_error()) {
+        std::cerr << "Failed to loan sample" << std::endl;
+        update_stats(0, 0, 0, false);
+        return block;
+    }
 
+    block.sample_.emplace(std::move(sample_result.value()));
+    block.writer_ = BlockWriter(block.sample_->payload_mut());
+    block.type_ = type;
+    block.loaned_at_ = std::chrono::steady_clock::now();
     return block;
 }
 
-bool DataBroadcaster::broadcast(const uint8_t* data,
-                               size_t data_size,
-                               size_t record_count,
-                               MarketDataType type) {
-    if (data_size > ZeroCopyMarketBlock::DATA_SIZE) {
-        std::cerr << "Data size " << data_size << " exceeds maximum "
-                  << ZeroCopyMarketBlock::DATA_SIZE << std::endl;
+bool DataBroadcaster::publish(LoanedBlock&& block) {
+    if (!block.valid()) {
         return false;
     }
 
-    auto start = std::chrono::steady_clock::now();
-
     try {
-        // Loan sample from iceoryx2
-        auto sample_result = publisher_->loan_uninit();
-        if (sample_result.has_error()) {
-            std::cerr << "Failed to loan sample" << std::endl;
-            return false;
+        // 只写元数据，负载已由生产者原位写入
+        std::unique_lock<std::mutex> journal_lock;
+        if (journal_) {
+            journal_lock = std::unique_lock<std::mutex>(journal_mutex_);
+        }
+        block.writer_.finish(
+            sequence_number_.fetch_add(1, std::memory_order_relaxed),
+            latency_clock_ns(),
+            block.type_,
+            block.flags_);
+        if (journal_ && !journal_->append(block.sample_->payload_mut())) {
+            update_stats(0, 0, 0, false);
         }
 
-        // Create block
-        auto block = create_block(data, data_size, record_count, type);
-
-        // Write payload and initialize
-        auto initialized_sample = sample_result.value().write_payload(block);
+        const size_t record_count = block.records();
+        const size_t bytes = sizeof(MarketBlockHeader) + block.size();
 
-        // Send sample
-        auto send_result = iox2::send(std::move(initialized_sample));
+        auto send_result = iox2::send(iox2::assume_init(std::move(*block.sample_)));
+        block.sample_.reset();
         if (send_result.has_error()) {
             std::cerr << "Failed to send sample" << std::endl;
+            update_stats(0, 0, 0, false);
             return false;
         }
 
-        // Calculate latency
         auto end = std::chrono::steady_clock::now();
         uint64_t latency_ns = static_cast<uint64_t>(
-            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - block.loaned_at_).count()
         );
 
-        // Update stats
-        update_stats(block, latency_ns, true);
-
+        update_stats(record_count, bytes, latency_ns, true);
         return true;
 
     } catch (const std::exception& e) {
-        std::cerr << "Exception in broadcast: " << e.what() << std::endl;
+        std::cerr << "Exception in publish: " << e.what() << std::endl;
         return false;
     }
 }
 
+bool DataBroadcaster::broadcast(const uint8_t* data,
+                               size_t data_size,
+                               size_t record_count,
+                               MarketDataType type,
+                               uint32_t instrument_id) {
+    if (data_size > ZeroCopyMarketBlock::DATA_SIZE) {
+        std::cerr << "Data size " << data_size << " exceeds maximum "
+                  << ZeroCopyMarketBlock::DATA_SIZE << std::endl;
+        return false;
+    }
+
+    // 借出样本后直接拷贝到共享内存 (只拷贝 data_size 字节)
+    auto block = loan(type);
+    if (!block) {
+        return false;
+    }
+    block.append(data, data_size, record_count);
+    block.set_instrument(instrument_id);
+    return publish(std::move(block));
+}
+
+bool DataBroadcaster::broadcast_message(const uint8_t* data,
+                                        size_t data_size,
+                                        size_t record_count,
+                                        MarketDataType type,
+                                        uint32_t instrument_id) {
+    if (data_size <= ZeroCopyMarketBlock::DATA_SIZE) {
+        return broadcast(data, data_size, record_count, type, instrument_id);
+    }
+
+    size_t offset = 0;
+    size_t records_sent = 0;
+    while (offset < data_size) {
+        const size_t chunk_size = std::min(ZeroCopyMarketBlock::DATA_SIZE, data_size - offset);
+        const bool last = offset + chunk_size == data_size;
+        // 按字节比例分摊记录数，末片补齐余数
+        const size_t chunk_records = last ? record_count - records_sent
+                                          : ((offset + chunk_size) * record_count) / data_size - records_sent;
+
+        uint8_t flags = block_flags::FRAGMENT;
+        if (offset == 0) {
+            flags |= block_flags::FRAGMENT_FIRST;
+        }
+        if (last) {
+            flags |= block_flags::FRAGMENT_LAST;
+        }
+
+        LoanedBlock block = loan(type);
+        if (!block.valid()) {
+            return false;
+        }
+        block.append(data + offset, chunk_size, chunk_records);
+        block.set_flags(flags);
+        block.set_instrument(instrument_id);
+        if (!publish(std::move(block))) {
+            return false;
+        }
+        offset += chunk_size;
+        records_sent += chunk_records;
+    }
+    return true;
+}
+
 size_t DataBroadcaster::broadcast_batch(const uint8_t* data,
                                        size_t data_size,
                                        size_t record_count,
@@ -157,13 +225,13 @@ size_t DataBroadcaster::broadcast_batch(const uint8_t* data,
     return total_sent;
 }
 
-void DataBroadcaster::update_stats(const ZeroCopyMarketBlock& block, uint64_t latency_ns, bool success) {
+void DataBroadcaster::update_stats(size_t record_count, size_t bytes, uint64_t latency_ns, bool success) {
     std::lock_guard<std::mutex> lock(stats_mutex_);
 
     if (success) {
         stats_.blocks_sent++;
-        stats_.records_sent += block.record_count;
-        stats_.bytes_sent += ZeroCopyMarketBlock::BLOCK_SIZE;
+        stats_.records_sent += record_count;
+        stats_.bytes_sent += bytes;
 
         // 更新延迟统计
         if (stats_.blocks_sent == 1) {
@@ -187,7 +255,9 @@ BroadcastStats DataBroadcaster::get_stats() const {
 
 void DataBroadcaster::reset_stats() {
     std::lock_guard<std::mutex> lock(stats_mutex_);
+    const MemoryPlacement placement = stats_.placement;
     stats_ = BroadcastStats{};
+    stats_.placement = placement;
     stats_.start_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
         start_time_.time_since_epoch()
     ).count();
@@ -210,6 +280,10 @@ DataSubscriber::DataSubscriber(const BroadcastConfig& config, const std::string&
     if (!config_.validate()) {
         throw std::invalid_argument("Invalid BroadcastConfig");
     }
+    placement_ = place_current_thread(config_);
+    if (config_.latency_tracking) {
+        latency_ = std::make_unique<LatencyTracker>();
+    }
 
     try {
         // 创建 iceoryx2 Node
@@ -267,16 +341,41 @@ std::optional<std::vector<uint8_t>> DataSubscriber::receive_nowait() {
             return std::nullopt;
         }
 
-        // 获取数据并拷贝
+        // 按元数据过滤: 不匹配的样本不拷贝负载，直接归还并取下一个
+        while (!filter_.accepts_all() && !filter_.matches(sample->payload().header())) {
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                receive_stats_.blocks_filtered++;
+                if (latency_) {
+                    latency_->record_sequence(sample->payload().sequence_number);
+                }
+            }
+            sample_result = subscriber_->receive();
+            if (sample_result.has_error()) {
+                return std::nullopt;
+            }
+            sample = std::move(sample_result.value());
+            if (!sample.has_value()) {
+                return std::nullopt;
+            }
+        }
+
+        const uint64_t received_ns = latency_ ? latency_clock_ns() : 0;
+
+        // 只拷贝有效负载 (兼容未填写 payload_size 的发布端)
         const auto& block = sample->payload();
-        std::vector<uint8_t> data(block.data, block.data + ZeroCopyMarketBlock::DATA_SIZE);
+        const size_t payload_size = block.effective_payload_size();
+        std::vector<uint8_t> data(block.data, block.data + payload_size);
 
         // 更新统计
         {
             std::lock_guard<std::mutex> lock(stats_mutex_);
             receive_stats_.blocks_received++;
             receive_stats_.records_received += block.record_count;
-            receive_stats_.bytes_received += ZeroCopyMarketBlock::BLOCK_SIZE;
+            receive_stats_.bytes_received += sizeof(MarketBlockHeader) + payload_size;
+            if (latency_) {
+                latency_->record(block.sequence_number, block.timestamp_ns, received_ns);
+            }
         }
 
         return data;
@@ -308,6 +407,14 @@ DataSubscriber::ReceiveStats DataSubscriber::get_receive_stats() const {
 void DataSubscriber::reset_receive_stats() {
     std::lock_guard<std::mutex> lock(stats_mutex_);
     receive_stats_ = ReceiveStats{};
+    if (latency_) {
+        latency_->reset();
+    }
+}
+
+LatencySummary DataSubscriber::get_latency() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return latency_ ? latency_->summary() : LatencySummary{};
 }
 
 //==============================================================================
@@ -364,6 +471,10 @@ std::unordered_map<std::string, BroadcastStats> BroadcastManager::get_all_stats(
     for (const auto& [name, broadcaster] : broadcasters_) {
         all_stats[name] = broadcaster->get_stats();
     }
+    // 本进程订阅端测得的延迟并入同名流 (只订阅不发布的流只有延迟字段)
+    for (const auto& [name, subscriber] : subscribers_) {
+        all_stats[name].latency = subscriber->get_latency();
+    }
 
     return all_stats;
 }
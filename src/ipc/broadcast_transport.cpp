@@ -0,0 +1,258 @@
+#include "qaultra/ipc/broadcast_transport.hpp"
+#include "qaultra/ipc/shm_ring.hpp"
+
+#ifdef QAULTRA_HAVE_ICEORYX
+#include "qaultra/ipc/broadcast_hub_v1.hpp"
+#endif
+
+#ifdef QAULTRA_HAVE_ICEORYX2
+#include "qaultra/ipc/broadcast_hub_v2.hpp"
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace qaultra::ipc {
+
+namespace {
+
+/**
+ * @brief 将具体广播器适配到 Broadcaster 接口 (各后端的方法签名一致)
+ */
+template <typename Impl, BroadcastTransport Kind>
+class BroadcasterAdapter final : public Broadcaster {
+public:
+    BroadcasterAdapter(const BroadcastConfig& config, const std::string& stream_name)
+        : impl_(config, stream_name) {}
+
+    bool broadcast(const uint8_t* data, size_t data_size, size_t record_count, MarketDataType type,
+                   uint32_t instrument_id) override {
+        return impl_.broadcast(data, data_size, record_count, type, instrument_id);
+    }
+
+    size_t broadcast_batch(const uint8_t* data, size_t data_size, size_t record_count, MarketDataType type) override {
+        return impl_.broadcast_batch(data, data_size, record_count, type);
+    }
+
+    BroadcastStats get_stats() const override { return impl_.get_stats(); }
+    void reset_stats() override { impl_.reset_stats(); }
+    bool has_subscribers() const override { return impl_.has_subscribers(); }
+    size_t get_subscriber_count() const override { return impl_.get_subscriber_count(); }
+    BroadcastTransport transport() const override { return Kind; }
+
+private:
+    Impl impl_;
+};
+
+template <typename Impl, BroadcastTransport Kind>
+class SubscriberAdapter final : public Subscriber {
+public:
+    SubscriberAdapter(const BroadcastConfig& config, const std::string& stream_name)
+        : impl_(config, stream_name) {}
+
+    std::optional<std::vector<uint8_t>> receive() override { return impl_.receive(); }
+    std::optional<std::vector<uint8_t>> receive_nowait() override { return impl_.receive_nowait(); }
+    bool has_data() const override { return impl_.has_data(); }
+    void set_filter(const SubscriptionFilter& filter) override { impl_.set_filter(filter); }
+    LatencySummary get_latency() const override { return impl_.get_latency(); }
+    BroadcastTransport transport() const override { return Kind; }
+
+private:
+    Impl impl_;
+};
+
+template <template <typename, BroadcastTransport> class Adapter, typename Interface,
+          typename ShmImpl, typename V1Impl, typename V2Impl>
+std::unique_ptr<Interface> create_endpoint(const BroadcastConfig& config, const std::string& stream_name) {
+    const BroadcastTransport transport = resolve_transport(config.transport);
+    if (!transport_available(transport)) {
+        std::cerr << "Broadcast transport not available in this build: "
+                  << transport_name(transport) << std::endl;
+        return nullptr;
+    }
+
+    try {
+        switch (transport) {
+            case BroadcastTransport::SharedMemoryRing:
+                return std::make_unique<Adapter<ShmImpl, BroadcastTransport::SharedMemoryRing>>(config, stream_name);
+#ifdef QAULTRA_HAVE_ICEORYX
+            case BroadcastTransport::IceOryx:
+                return std::make_unique<Adapter<V1Impl, BroadcastTransport::IceOryx>>(config, stream_name);
+#endif
+#ifdef QAULTRA_HAVE_ICEORYX2
+            case BroadcastTransport::IceOryx2:
+                return std::make_unique<Adapter<V2Impl, BroadcastTransport::IceOryx2>>(config, stream_name);
+#endif
+            default:
+                break;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create " << transport_name(transport)
+                  << " endpoint for " << stream_name << ": " << e.what() << std::endl;
+    }
+    return nullptr;
+}
+
+#ifdef QAULTRA_HAVE_ICEORYX
+using V1Broadcaster = v1::DataBroadcaster;
+using V1Subscriber = v1::DataSubscriber;
+#else
+using V1Broadcaster = void;
+using V1Subscriber = void;
+#endif
+
+#ifdef QAULTRA_HAVE_ICEORYX2
+using V2Broadcaster = v2::DataBroadcaster;
+using V2Subscriber = v2::DataSubscriber;
+#else
+using V2Broadcaster = void;
+using V2Subscriber = void;
+#endif
+
+} // namespace
+
+BroadcastTransport resolve_transport(BroadcastTransport requested) {
+    if (requested != BroadcastTransport::Auto) {
+        return requested;
+    }
+#if defined(QAULTRA_HAVE_ICEORYX2)
+    return BroadcastTransport::IceOryx2;
+#elif defined(QAULTRA_HAVE_ICEORYX)
+    return BroadcastTransport::IceOryx;
+#else
+    return BroadcastTransport::SharedMemoryRing;
+#endif
+}
+
+bool transport_available(BroadcastTransport transport) {
+    switch (transport) {
+        case BroadcastTransport::Auto:
+        case BroadcastTransport::SharedMemoryRing:
+            return true;
+        case BroadcastTransport::IceOryx:
+#ifdef QAULTRA_HAVE_ICEORYX
+            return true;
+#else
+            return false;
+#endif
+        case BroadcastTransport::IceOryx2:
+#ifdef QAULTRA_HAVE_ICEORYX2
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+const char* transport_name(BroadcastTransport transport) {
+    switch (transport) {
+        case BroadcastTransport::Auto: return "auto";
+        case BroadcastTransport::IceOryx: return "iceoryx";
+        case BroadcastTransport::IceOryx2: return "iceoryx2";
+        case BroadcastTransport::SharedMemoryRing: return "shm_ring";
+    }
+    return "unknown";
+}
+
+std::unique_ptr<Broadcaster> create_broadcaster(const BroadcastConfig& config, const std::string& stream_name) {
+    return create_endpoint<BroadcasterAdapter, Broadcaster,
+                           shm::ShmRingBroadcaster, V1Broadcaster, V2Broadcaster>(config, stream_name);
+}
+
+std::unique_ptr<Subscriber> create_subscriber(const BroadcastConfig& config, const std::string& stream_name) {
+    return create_endpoint<SubscriberAdapter, Subscriber,
+                           shm::ShmRingSubscriber, V1Subscriber, V2Subscriber>(config, stream_name);
+}
+
+//==============================================================================
+// PartitionedBroadcaster / PartitionedSubscriber
+//==============================================================================
+
+PartitionedBroadcaster::PartitionedBroadcaster(const BroadcastConfig& config,
+                                               const std::string& stream_name,
+                                               uint32_t partition_count)
+    : partition_count_(std::max<uint32_t>(partition_count, 1))
+{
+    partitions_.reserve(partition_count_);
+    for (uint32_t p = 0; p < partition_count_; ++p) {
+        auto broadcaster = create_broadcaster(config, partition_stream_name(stream_name, p));
+        if (!broadcaster) {
+            throw std::runtime_error("Failed to create partition " + std::to_string(p) + " of " + stream_name);
+        }
+        partitions_.push_back(std::move(broadcaster));
+    }
+}
+
+bool PartitionedBroadcaster::broadcast(uint32_t instrument_id, const uint8_t* data, size_t data_size,
+                                       size_t record_count, MarketDataType type) {
+    return partitions_[partition_of(instrument_id)]->broadcast(data, data_size, record_count, type, instrument_id);
+}
+
+BroadcastStats PartitionedBroadcaster::get_stats() const {
+    BroadcastStats total;
+    for (const auto& partition : partitions_) {
+        const BroadcastStats stats = partition->get_stats();
+        total.blocks_sent += stats.blocks_sent;
+        total.records_sent += stats.records_sent;
+        total.bytes_sent += stats.bytes_sent;
+        total.errors += stats.errors;
+        total.active_subscribers += stats.active_subscribers;
+        total.memory_usage_bytes += stats.memory_usage_bytes;
+        total.elapsed_time_ns = std::max(total.elapsed_time_ns, stats.elapsed_time_ns);
+        total.placement.prefaulted_bytes += stats.placement.prefaulted_bytes;
+        total.placement.locked_bytes += stats.placement.locked_bytes;
+    }
+    if (!partitions_.empty()) {
+        // 各分区由同一线程创建，线程与节点相同
+        const MemoryPlacement first = partitions_.front()->get_stats().placement;
+        total.placement.cpu = first.cpu;
+        total.placement.numa_node = first.numa_node;
+        total.placement.thread_pinned = first.thread_pinned;
+        total.placement.memory_node = first.memory_node;
+    }
+    return total;
+}
+
+PartitionedSubscriber::PartitionedSubscriber(const BroadcastConfig& config,
+                                             const std::string& stream_name,
+                                             uint32_t partition_count,
+                                             const SubscriptionFilter& filter)
+{
+    partition_count = std::max<uint32_t>(partition_count, 1);
+    const std::vector<uint32_t> instruments = filter.instruments();
+    if (instruments.empty()) {
+        for (uint32_t p = 0; p < partition_count; ++p) {
+            partition_ids_.push_back(p);
+        }
+    } else {
+        for (uint32_t id : instruments) {
+            partition_ids_.push_back(instrument_partition(id, partition_count));
+        }
+        std::sort(partition_ids_.begin(), partition_ids_.end());
+        partition_ids_.erase(std::unique(partition_ids_.begin(), partition_ids_.end()), partition_ids_.end());
+    }
+
+    for (uint32_t p : partition_ids_) {
+        auto subscriber = create_subscriber(config, partition_stream_name(stream_name, p));
+        if (!subscriber) {
+            throw std::runtime_error("Failed to subscribe partition " + std::to_string(p) + " of " + stream_name);
+        }
+        subscriber->set_filter(filter);
+        partitions_.push_back(std::move(subscriber));
+    }
+}
+
+std::optional<std::vector<uint8_t>> PartitionedSubscriber::receive() {
+    for (size_t i = 0; i < partitions_.size(); ++i) {
+        auto& subscriber = partitions_[next_];
+        next_ = (next_ + 1) % partitions_.size();
+        if (auto payload = subscriber->receive_nowait()) {
+            return payload;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace qaultra::ipc
@@ -0,0 +1,266 @@
+#include "qaultra/ipc/last_value_cache.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace qaultra::ipc::shm {
+
+namespace {
+
+constexpr size_t CACHE_LINE = 64;
+
+size_t round_up(size_t value, size_t align) {
+    return (value + align - 1) / align * align;
+}
+
+size_t bitmap_bytes(size_t words) {
+    return round_up(words * sizeof(uint64_t), CACHE_LINE);
+}
+
+size_t cache_mapping_size(size_t capacity, size_t slot_size, size_t bitmap_words) {
+    return sizeof(CacheHeader) + LastValueCacheWriter::MAX_READERS * bitmap_bytes(bitmap_words) +
+           capacity * slot_size;
+}
+
+std::atomic<uint64_t>* lane_bitmap(CacheHeader* header, size_t bitmap_words, size_t lane) {
+    auto* base = reinterpret_cast<uint8_t*>(header) + sizeof(CacheHeader);
+    return reinterpret_cast<std::atomic<uint64_t>*>(base + lane * bitmap_bytes(bitmap_words));
+}
+
+std::string errno_message() {
+    return std::strerror(errno);
+}
+
+} // namespace
+
+//==============================================================================
+// LastValueCacheWriter
+//==============================================================================
+
+LastValueCacheWriter::LastValueCacheWriter(const std::string& shm_name, size_t capacity, size_t value_size)
+    : shm_name_(shm_name)
+    , capacity_(capacity)
+    , value_size_(value_size)
+    , slot_size_(sizeof(CacheSlotHeader) + round_up(value_size, CACHE_LINE))
+    , bitmap_words_((capacity + 63) / 64)
+{
+    if (capacity_ == 0 || capacity_ > UINT32_MAX || value_size_ == 0 || value_size_ > UINT16_MAX) {
+        throw std::invalid_argument("Invalid last value cache geometry");
+    }
+    mapped_size_ = cache_mapping_size(capacity_, slot_size_, bitmap_words_);
+
+    ::shm_unlink(shm_name_.c_str());
+    int fd = ::shm_open(shm_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create shared memory " + shm_name_ + ": " + errno_message());
+    }
+    if (::ftruncate(fd, static_cast<off_t>(mapped_size_)) != 0) {
+        const std::string error = errno_message();
+        ::close(fd);
+        ::shm_unlink(shm_name_.c_str());
+        throw std::runtime_error("Failed to size shared memory " + shm_name_ + ": " + error);
+    }
+
+    void* memory = ::mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        const std::string error = errno_message();
+        ::shm_unlink(shm_name_.c_str());
+        throw std::runtime_error("Failed to map shared memory " + shm_name_ + ": " + error);
+    }
+
+    // ftruncate 得到的页已清零: 槽位序号为0 (从未写入)，脏位图为空
+    header_ = new (memory) CacheHeader();
+    header_->version = CacheHeader::VERSION;
+    header_->slot_size = static_cast<uint32_t>(slot_size_);
+    header_->capacity = capacity_;
+    header_->value_size = static_cast<uint32_t>(value_size_);
+    header_->bitmap_words = static_cast<uint32_t>(bitmap_words_);
+    header_->closed.store(0, std::memory_order_relaxed);
+    header_->reader_mask.store(0, std::memory_order_relaxed);
+    header_->updates.store(0, std::memory_order_relaxed);
+    slots_ = reinterpret_cast<uint8_t*>(lane_bitmap(header_, bitmap_words_, MAX_READERS));
+    std::atomic_thread_fence(std::memory_order_release);
+    reinterpret_cast<std::atomic<uint64_t>*>(&header_->magic)->store(CacheHeader::MAGIC, std::memory_order_release);
+}
+
+LastValueCacheWriter::~LastValueCacheWriter() {
+    if (header_) {
+        header_->closed.store(1, std::memory_order_release);
+        ::munmap(header_, mapped_size_);
+        ::shm_unlink(shm_name_.c_str());
+    }
+}
+
+bool LastValueCacheWriter::update(uint32_t instrument_id, const uint8_t* data, size_t size,
+                                  const MarketBlockHeader& meta) {
+    if (instrument_id >= capacity_ || size > value_size_) {
+        return false;
+    }
+
+    auto* slot = reinterpret_cast<CacheSlotHeader*>(slots_ + instrument_id * slot_size_);
+    const uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->timestamp_ns = meta.timestamp_ns;
+    slot->record_count = meta.record_count;
+    slot->source_sequence = meta.sequence_number;
+    slot->data_type = meta.data_type;
+    slot->flags = meta.flags;
+    slot->payload_size = static_cast<uint16_t>(size);
+    slot->instrument_id = instrument_id;
+    std::memcpy(reinterpret_cast<uint8_t*>(slot) + sizeof(CacheSlotHeader), data, size);
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+
+    // 通知已注册读者 (每个读者一次 fetch_or)
+    const uint64_t word = instrument_id / 64;
+    const uint64_t bit = uint64_t{1} << (instrument_id % 64);
+    for (uint64_t readers = header_->reader_mask.load(std::memory_order_acquire); readers != 0;
+         readers &= readers - 1) {
+        const size_t lane = static_cast<size_t>(__builtin_ctzll(readers));
+        lane_bitmap(header_, bitmap_words_, lane)[word].fetch_or(bit, std::memory_order_release);
+    }
+    header_->updates.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+uint64_t LastValueCacheWriter::get_update_count() const {
+    return header_->updates.load(std::memory_order_relaxed);
+}
+
+size_t LastValueCacheWriter::get_reader_count() const {
+    return static_cast<size_t>(__builtin_popcountll(header_->reader_mask.load(std::memory_order_relaxed)));
+}
+
+//==============================================================================
+// LastValueCacheReader
+//==============================================================================
+
+LastValueCacheReader::LastValueCacheReader(const std::string& shm_name)
+    : shm_name_(shm_name)
+{
+    int fd = ::shm_open(shm_name_.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open shared memory " + shm_name_ + ": " + errno_message());
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CacheHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Shared memory " + shm_name_ + " is not initialized");
+    }
+    mapped_size_ = static_cast<size_t>(st.st_size);
+
+    // 读者需要写权限以取走脏位
+    void* memory = ::mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        throw std::runtime_error("Failed to map shared memory " + shm_name_ + ": " + errno_message());
+    }
+
+    header_ = static_cast<CacheHeader*>(memory);
+    const uint64_t magic = reinterpret_cast<std::atomic<uint64_t>*>(&header_->magic)->load(std::memory_order_acquire);
+    if (magic != CacheHeader::MAGIC || header_->version != CacheHeader::VERSION ||
+        cache_mapping_size(header_->capacity, header_->slot_size, header_->bitmap_words) > mapped_size_) {
+        ::munmap(memory, mapped_size_);
+        header_ = nullptr;
+        throw std::runtime_error("Shared memory " + shm_name_ + " has an incompatible layout");
+    }
+
+    capacity_ = header_->capacity;
+    value_size_ = header_->value_size;
+    slot_size_ = header_->slot_size;
+    bitmap_words_ = header_->bitmap_words;
+    slots_ = reinterpret_cast<const uint8_t*>(lane_bitmap(header_, bitmap_words_, LastValueCacheWriter::MAX_READERS));
+    buffer_.resize(value_size_);
+
+    // 申请读者位
+    uint64_t mask = header_->reader_mask.load(std::memory_order_relaxed);
+    while (true) {
+        if (mask == ~uint64_t{0}) {
+            ::munmap(memory, mapped_size_);
+            header_ = nullptr;
+            throw std::runtime_error("Too many readers on " + shm_name_);
+        }
+        lane_ = static_cast<size_t>(__builtin_ctzll(~mask));
+        bitmap_ = lane_bitmap(header_, bitmap_words_, lane_);
+        // 上一个使用该读者位的进程可能留下脏位
+        for (size_t word = 0; word < bitmap_words_; ++word) {
+            bitmap_[word].store(0, std::memory_order_relaxed);
+        }
+        if (header_->reader_mask.compare_exchange_weak(mask, mask | (uint64_t{1} << lane_),
+                                                       std::memory_order_acq_rel)) {
+            break;
+        }
+    }
+}
+
+LastValueCacheReader::~LastValueCacheReader() {
+    if (header_) {
+        header_->reader_mask.fetch_and(~(uint64_t{1} << lane_), std::memory_order_acq_rel);
+        ::munmap(header_, mapped_size_);
+    }
+}
+
+bool LastValueCacheReader::read(uint32_t instrument_id, LastValueView& out) {
+    if (instrument_id >= capacity_) {
+        return false;
+    }
+
+    const CacheSlotHeader& slot = slot_at(instrument_id);
+    const uint8_t* payload = reinterpret_cast<const uint8_t*>(&slot) + sizeof(CacheSlotHeader);
+    for (uint32_t attempt = 0; attempt < MAX_READ_RETRIES; ++attempt) {
+        if (attempt >= 64) {
+            std::this_thread::yield();   // 写端可能被调度出去
+        }
+        const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before == 0) {
+            return false;
+        }
+        if (before & 1) {
+            // 写入中: 写端只做 memcpy，很快完成；已关闭的写端不会再完成这次写入
+            if (is_closed()) {
+                return false;
+            }
+            continue;
+        }
+
+        out.instrument_id = slot.instrument_id;
+        out.data_type = slot.data_type;
+        out.flags = slot.flags;
+        out.timestamp_ns = slot.timestamp_ns;
+        out.record_count = slot.record_count;
+        out.source_sequence = slot.source_sequence;
+        out.size = std::min<size_t>(slot.payload_size, value_size_);
+        std::memcpy(buffer_.data(), payload, out.size);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            out.version = before / 2;
+            out.data = buffer_.data();
+            return true;
+        }
+    }
+    return false;
+}
+
+void LastValueCacheReader::clear_dirty() {
+    for (size_t word = 0; word < bitmap_words_; ++word) {
+        bitmap_[word].store(0, std::memory_order_release);
+    }
+}
+
+bool LastValueCacheReader::is_closed() const {
+    return header_->closed.load(std::memory_order_acquire) != 0;
+}
+
+} // namespace qaultra::ipc::shm
@@ -0,0 +1,153 @@
+#include "qaultra/ipc/latency_tracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+namespace qaultra::ipc {
+
+namespace {
+
+constexpr size_t SUB_BUCKET_COUNT = size_t{1} << LatencyHistogram::SUB_BUCKET_BITS;
+constexpr size_t HALF_BUCKET_COUNT = SUB_BUCKET_COUNT / 2;
+constexpr uint64_t MAX_TRACKABLE = (uint64_t{1} << LatencyHistogram::MAX_VALUE_BITS) - 1;
+
+// 0 ~ 127 各一个桶，之后每个二进制数量级 64 个桶
+constexpr size_t BUCKET_COUNT =
+    SUB_BUCKET_COUNT + (LatencyHistogram::MAX_VALUE_BITS - LatencyHistogram::SUB_BUCKET_BITS) * HALF_BUCKET_COUNT;
+
+} // namespace
+
+uint64_t latency_clock_ns() {
+    timespec ts {};
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+//==============================================================================
+// LatencyHistogram
+//==============================================================================
+
+LatencyHistogram::LatencyHistogram()
+    : counts_(BUCKET_COUNT, 0)
+{}
+
+size_t LatencyHistogram::index_of(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+    value = std::min(value, MAX_TRACKABLE);
+    const unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(value));
+    const unsigned shift = msb - (SUB_BUCKET_BITS - 1);       // value >> shift 落在 [64, 128)
+    return SUB_BUCKET_COUNT + (shift - 1) * HALF_BUCKET_COUNT +
+           static_cast<size_t>((value >> shift) - HALF_BUCKET_COUNT);
+}
+
+uint64_t LatencyHistogram::highest_equivalent(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    const size_t offset = index - SUB_BUCKET_COUNT;
+    const unsigned shift = static_cast<unsigned>(offset / HALF_BUCKET_COUNT) + 1;
+    const uint64_t sub = offset % HALF_BUCKET_COUNT + HALF_BUCKET_COUNT;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value_ns) {
+    counts_[index_of(value_ns)]++;
+    count_++;
+    sum_ += value_ns;
+    min_ = std::min(min_, value_ns);
+    max_ = std::max(max_, value_ns);
+}
+
+uint64_t LatencyHistogram::value_at_percentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    const double clamped = std::clamp(percentile, 0.0, 100.0);
+    const uint64_t target = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count_))));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= target) {
+            return std::min(highest_equivalent(i), max_);
+        }
+    }
+    return max_;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+}
+
+//==============================================================================
+// SequenceGapDetector
+//==============================================================================
+
+void SequenceGapDetector::observe(uint64_t sequence) {
+    if (!started_) {
+        started_ = true;
+    } else if (sequence > expected_) {
+        gaps_++;
+        missing_ += sequence - expected_;
+    } else if (sequence < expected_) {
+        // 重复或发布端重启: 以新序号重新对齐
+        out_of_order_++;
+    }
+    expected_ = sequence + 1;
+}
+
+//==============================================================================
+// LatencyTracker
+//==============================================================================
+
+void LatencyTracker::record(uint64_t sequence, uint64_t publish_ns, uint64_t receive_ns) {
+    gaps_.observe(sequence);
+    if (receive_ns >= publish_ns) {
+        histogram_.record(receive_ns - publish_ns);
+    } else {
+        negative_samples_++;
+    }
+}
+
+LatencySummary LatencyTracker::summary() const {
+    LatencySummary summary;
+    summary.samples = histogram_.count();
+    summary.min_ns = histogram_.min();
+    summary.max_ns = histogram_.max();
+    summary.mean_ns = histogram_.mean();
+    summary.p50_ns = histogram_.value_at_percentile(50.0);
+    summary.p90_ns = histogram_.value_at_percentile(90.0);
+    summary.p99_ns = histogram_.value_at_percentile(99.0);
+    summary.p999_ns = histogram_.value_at_percentile(99.9);
+    summary.negative_samples = negative_samples_;
+    summary.sequence_gaps = gaps_.gaps();
+    summary.missing_sequences = gaps_.missing();
+    summary.out_of_order = gaps_.out_of_order();
+    return summary;
+}
+
+void LatencyTracker::reset() {
+    histogram_.reset();
+    gaps_.reset();
+    negative_samples_ = 0;
+}
+
+} // namespace qaultra::ipc
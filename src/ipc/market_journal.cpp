@@ -0,0 +1,398 @@
+#include "qaultra/ipc/market_journal.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace qaultra::ipc {
+
+namespace {
+
+constexpr const char* SEGMENT_SUFFIX = ".qjournal";
+constexpr size_t RECORD_ALIGNMENT = 64;
+constexpr size_t PAGE_ALIGNMENT = 4096;
+constexpr size_t MIN_SEGMENT_BYTES = size_t{1} << 20;
+
+size_t round_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t record_size(size_t payload_size) {
+    return round_up(sizeof(MarketBlockHeader) + payload_size, RECORD_ALIGNMENT);
+}
+
+/**
+ * @brief 索引区之后的数据区偏移 (页对齐)
+ */
+size_t data_offset(uint64_t index_capacity) {
+    return round_up(sizeof(JournalSegmentHeader) + index_capacity * sizeof(JournalIndexEntry), PAGE_ALIGNMENT);
+}
+
+std::string segment_path(const std::string& directory, uint64_t first_sequence) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%020llu", static_cast<unsigned long long>(first_sequence));
+    return (std::filesystem::path(directory) / (std::string(name) + SEGMENT_SUFFIX)).string();
+}
+
+/**
+ * @brief 目录中的段文件 (按首序列号排序)
+ */
+std::vector<std::pair<uint64_t, std::string>> list_segments(const std::string& directory) {
+    std::vector<std::pair<uint64_t, std::string>> segments;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.path().extension() != SEGMENT_SUFFIX) {
+            continue;
+        }
+        const std::string stem = entry.path().stem().string();
+        char* end = nullptr;
+        const unsigned long long first = std::strtoull(stem.c_str(), &end, 10);
+        if (end == stem.c_str() || *end != '\0') {
+            continue;
+        }
+        segments.emplace_back(first, entry.path().string());
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+uint64_t wall_clock_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+bool valid_header(const JournalSegmentHeader& header, size_t file_size) {
+    return header.magic == JournalSegmentHeader::MAGIC &&
+           header.version == JournalSegmentHeader::VERSION &&
+           data_offset(header.index_capacity) + header.data_capacity <= file_size;
+}
+
+} // namespace
+
+std::string journal_directory(const BroadcastConfig& config, const std::string& stream_name) {
+    std::string name = config.service_name + "_" + stream_name;
+    std::replace(name.begin(), name.end(), '/', '_');
+    return (std::filesystem::path(config.journal_dir) / name).string();
+}
+
+//==============================================================================
+// MarketJournalWriter
+//==============================================================================
+
+MarketJournalWriter::MarketJournalWriter(const std::string& directory, size_t segment_bytes)
+    : directory_(directory)
+    , segment_bytes_(std::max(segment_bytes, MIN_SEGMENT_BYTES))
+{
+    // 每条记录至少占 64 字节数据区 + 一个索引条目，索引不会先于数据区用尽
+    index_capacity_ = (segment_bytes_ - sizeof(JournalSegmentHeader)) / (RECORD_ALIGNMENT + sizeof(JournalIndexEntry));
+    data_capacity_ = (segment_bytes_ - data_offset(index_capacity_)) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+    if (data_capacity_ < record_size(LargeMarketBlock::DATA_SIZE)) {
+        throw std::invalid_argument("Journal segment too small: " + std::to_string(segment_bytes));
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        throw std::runtime_error("Failed to create journal directory " + directory_ + ": " + ec.message());
+    }
+
+    // 从最后一段续接序列号，并封存该段 (异常退出的写入端不会封存)
+    const auto segments = list_segments(directory_);
+    if (!segments.empty()) {
+        MarketJournalReader reader(directory_);
+        next_sequence_ = reader.end_sequence();
+
+        const std::string& last = segments.back().second;
+        int fd = ::open(last.c_str(), O_RDWR);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open journal segment " + last + ": " + std::strerror(errno));
+        }
+        void* memory = ::mmap(nullptr, sizeof(JournalSegmentHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory != MAP_FAILED) {
+            static_cast<JournalSegmentHeader*>(memory)->sealed.store(1, std::memory_order_release);
+            ::munmap(memory, sizeof(JournalSegmentHeader));
+        }
+    }
+}
+
+MarketJournalWriter::~MarketJournalWriter() {
+    close_segment();
+}
+
+bool MarketJournalWriter::open_segment(uint64_t first_sequence) {
+    close_segment();
+
+    const std::string path = segment_path(directory_, first_sequence);
+    // 同名段只可能是未写入任何记录的旧段 (首序列号相同)
+    int fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to create journal segment " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(segment_bytes_)) != 0) {
+        std::cerr << "Failed to size journal segment " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* memory = ::mmap(nullptr, segment_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        std::cerr << "Failed to map journal segment " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    ::madvise(memory, segment_bytes_, MADV_SEQUENTIAL);
+
+    // ftruncate 得到的页已清零，只需写入头部
+    mapping_ = memory;
+    header_ = new (memory) JournalSegmentHeader();
+    index_ = reinterpret_cast<JournalIndexEntry*>(static_cast<uint8_t*>(memory) + sizeof(JournalSegmentHeader));
+    data_ = static_cast<uint8_t*>(memory) + data_offset(index_capacity_);
+    data_used_ = 0;
+
+    header_->version = JournalSegmentHeader::VERSION;
+    header_->sealed.store(0, std::memory_order_relaxed);
+    header_->first_sequence = first_sequence;
+    header_->index_capacity = index_capacity_;
+    header_->data_capacity = data_capacity_;
+    header_->record_count.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    reinterpret_cast<std::atomic<uint64_t>*>(&header_->magic)->store(JournalSegmentHeader::MAGIC,
+                                                                      std::memory_order_release);
+    segments_created_++;
+    return true;
+}
+
+void MarketJournalWriter::close_segment() {
+    if (!mapping_) {
+        return;
+    }
+    header_->sealed.store(1, std::memory_order_release);
+    ::munmap(mapping_, segment_bytes_);
+    mapping_ = nullptr;
+    header_ = nullptr;
+    index_ = nullptr;
+    data_ = nullptr;
+}
+
+bool MarketJournalWriter::append(const MarketBlockHeader& header, const uint8_t* payload) {
+    const uint64_t sequence = header.sequence_number;
+    if (sequence < next_sequence_) {
+        rejected_++;
+        return false;
+    }
+
+    const size_t size = record_size(header.payload_size);
+    uint64_t count = header_ ? header_->record_count.load(std::memory_order_relaxed) : 0;
+    const bool contiguous = header_ && sequence == header_->first_sequence + count;
+    if (!contiguous || count == index_capacity_ || data_used_ + size > data_capacity_) {
+        if (!open_segment(sequence)) {
+            rejected_++;
+            return false;
+        }
+        count = 0;
+    }
+
+    uint8_t* record = data_ + data_used_;
+    std::memcpy(record, &header, sizeof(MarketBlockHeader));
+    std::memcpy(record + sizeof(MarketBlockHeader), payload, header.payload_size);
+    index_[count] = JournalIndexEntry{data_used_, wall_clock_ns()};
+    header_->record_count.store(count + 1, std::memory_order_release);
+
+    data_used_ += size;
+    next_sequence_ = sequence + 1;
+    records_appended_++;
+    bytes_appended_ += sizeof(MarketBlockHeader) + header.payload_size;
+    return true;
+}
+
+bool MarketJournalWriter::sync() {
+    if (!mapping_) {
+        return true;
+    }
+    const size_t used = data_offset(index_capacity_) + data_used_;
+    return ::msync(mapping_, std::min(used, segment_bytes_), MS_SYNC) == 0;
+}
+
+//==============================================================================
+// MarketJournalReader
+//==============================================================================
+
+MarketJournalReader::MarketJournalReader(const std::string& directory)
+    : directory_(directory)
+{
+    refresh();
+}
+
+MarketJournalReader::~MarketJournalReader() {
+    for (auto& segment : segments_) {
+        if (segment.mapping) {
+            ::munmap(segment.mapping, segment.mapped_size);
+        }
+    }
+}
+
+size_t MarketJournalReader::refresh() {
+    const auto listed = list_segments(directory_);
+    std::vector<Segment> refreshed;
+    refreshed.reserve(listed.size());
+    for (const auto& [first, path] : listed) {
+        auto existing = std::find_if(segments_.begin(), segments_.end(), [&](const Segment& segment) {
+            return segment.path == path;
+        });
+        if (existing != segments_.end()) {
+            refreshed.push_back(*existing);
+            existing->mapping = nullptr;    // 所有权转移
+        } else {
+            Segment segment;
+            segment.first_sequence = first;
+            segment.path = path;
+            refreshed.push_back(segment);
+        }
+    }
+    for (auto& segment : segments_) {
+        if (segment.mapping) {
+            ::munmap(segment.mapping, segment.mapped_size);
+        }
+    }
+    segments_ = std::move(refreshed);
+    hint_ = 0;
+    return segments_.size();
+}
+
+bool MarketJournalReader::map(Segment& segment) const {
+    if (segment.mapping) {
+        return true;
+    }
+    int fd = ::open(segment.path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(JournalSegmentHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* memory = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        std::cerr << "Failed to map journal segment " << segment.path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    const auto* header = static_cast<const JournalSegmentHeader*>(memory);
+    const uint64_t magic = reinterpret_cast<const std::atomic<uint64_t>*>(&header->magic)->load(std::memory_order_acquire);
+    if (magic != JournalSegmentHeader::MAGIC || !valid_header(*header, size) ||
+        header->first_sequence != segment.first_sequence) {
+        // 写入端可能尚未完成头部初始化
+        ::munmap(memory, size);
+        return false;
+    }
+    ::madvise(memory, size, MADV_SEQUENTIAL);
+
+    segment.mapping = memory;
+    segment.mapped_size = size;
+    segment.header = header;
+    segment.index = reinterpret_cast<const JournalIndexEntry*>(static_cast<const uint8_t*>(memory) +
+                                                               sizeof(JournalSegmentHeader));
+    segment.data = static_cast<const uint8_t*>(memory) + data_offset(header->index_capacity);
+    return true;
+}
+
+uint64_t MarketJournalReader::committed(const Segment& segment) const {
+    return std::min(segment.header->record_count.load(std::memory_order_acquire), segment.header->index_capacity);
+}
+
+size_t MarketJournalReader::segment_for(uint64_t sequence) const {
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), sequence,
+                               [](uint64_t value, const Segment& segment) { return value < segment.first_sequence; });
+    return it == segments_.begin() ? segments_.size() : static_cast<size_t>(it - segments_.begin() - 1);
+}
+
+uint64_t MarketJournalReader::first_sequence() const {
+    for (auto& segment : segments_) {
+        if (map(segment) && committed(segment) > 0) {
+            return segment.first_sequence;
+        }
+    }
+    return end_sequence();
+}
+
+uint64_t MarketJournalReader::end_sequence() const {
+    for (auto it = segments_.rbegin(); it != segments_.rend(); ++it) {
+        if (map(*it) && committed(*it) > 0) {
+            return it->first_sequence + committed(*it);
+        }
+    }
+    return segments_.empty() ? 0 : segments_.back().first_sequence;
+}
+
+uint64_t MarketJournalReader::next_available(uint64_t sequence) const {
+    size_t s = segment_for(sequence);
+    if (s == segments_.size()) {
+        s = 0;
+    }
+    for (; s < segments_.size(); ++s) {
+        Segment& segment = segments_[s];
+        if (!map(segment)) {
+            continue;
+        }
+        const uint64_t end = segment.first_sequence + committed(segment);
+        if (sequence < end) {
+            return std::max(sequence, segment.first_sequence);
+        }
+    }
+    return end_sequence();
+}
+
+uint64_t MarketJournalReader::sequence_at_time(uint64_t wall_time_ns) const {
+    // 写入时刻按追加顺序不减，先按段再在段内二分
+    for (auto& segment : segments_) {
+        if (!map(segment)) {
+            continue;
+        }
+        const uint64_t count = committed(segment);
+        if (count == 0 || segment.index[count - 1].wall_time_ns < wall_time_ns) {
+            continue;
+        }
+        const JournalIndexEntry* found = std::lower_bound(
+            segment.index, segment.index + count, wall_time_ns,
+            [](const JournalIndexEntry& entry, uint64_t value) { return entry.wall_time_ns < value; });
+        return segment.first_sequence + static_cast<uint64_t>(found - segment.index);
+    }
+    return end_sequence();
+}
+
+const MarketJournalReader::Segment* MarketJournalReader::locate(uint64_t sequence, uint64_t& position) {
+    // 顺序读取时命中上一次的段
+    if (hint_ >= segments_.size() || sequence < segments_[hint_].first_sequence ||
+        (hint_ + 1 < segments_.size() && sequence >= segments_[hint_ + 1].first_sequence)) {
+        hint_ = segment_for(sequence);
+        if (hint_ == segments_.size()) {
+            hint_ = 0;
+            return nullptr;
+        }
+    }
+    Segment& segment = segments_[hint_];
+    if (!map(segment)) {
+        return nullptr;
+    }
+    position = sequence - segment.first_sequence;
+    return position < committed(segment) ? &segment : nullptr;
+}
+
+} // namespace qaultra::ipc
@@ -0,0 +1,144 @@
+#include "qaultra/ipc/numa_placement.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace qaultra::ipc {
+
+namespace {
+
+// <numaif.h> 属于 libnuma，这里直接使用系统调用
+constexpr int MPOL_BIND_MODE = 2;
+constexpr unsigned MPOL_MF_MOVE_FLAG = 1u << 1;
+constexpr int MAX_NUMA_NODES = 1024;
+#ifndef MADV_POPULATE_WRITE
+constexpr int MADV_POPULATE_WRITE = 23;     // Linux 5.14
+#endif
+
+size_t page_size() {
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+std::string errno_message() {
+    return std::strerror(errno);
+}
+
+} // namespace
+
+int current_cpu() {
+    return ::sched_getcpu();
+}
+
+int cpu_numa_node(int cpu) {
+    if (cpu < 0) {
+        return -1;
+    }
+    DIR* dir = ::opendir(("/sys/devices/system/cpu/cpu" + std::to_string(cpu)).c_str());
+    if (!dir) {
+        return -1;
+    }
+    int node = -1;
+    while (dirent* entry = ::readdir(dir)) {
+        if (std::strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = std::atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    ::closedir(dir);
+    // 未启用 NUMA 的内核没有 nodeN 链接，视为单节点
+    return node < 0 ? 0 : node;
+}
+
+bool pin_current_thread(int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool bind_memory_to_node(void* addr, size_t size, int node) {
+    if (node < 0 || node >= MAX_NUMA_NODES || size == 0) {
+        return false;
+    }
+    constexpr size_t BITS = 8 * sizeof(unsigned long);
+    unsigned long mask[MAX_NUMA_NODES / BITS] = {};
+    mask[static_cast<size_t>(node) / BITS] = 1UL << (static_cast<size_t>(node) % BITS);
+    return ::syscall(SYS_mbind, addr, size, MPOL_BIND_MODE, mask,
+                     static_cast<unsigned long>(MAX_NUMA_NODES + 1), MPOL_MF_MOVE_FLAG) == 0;
+}
+
+size_t prefault_memory(void* addr, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    if (::madvise(addr, size, MADV_POPULATE_WRITE) == 0) {
+        return size;
+    }
+    // 旧内核: 逐页读写同一值触发分配 (不改变内容)
+    auto* bytes = static_cast<volatile uint8_t*>(addr);
+    for (size_t offset = 0; offset < size; offset += page_size()) {
+        bytes[offset] = bytes[offset];
+    }
+    return size;
+}
+
+size_t lock_memory(void* addr, size_t size, size_t limit) {
+    const size_t length = std::min(size, limit);
+    if (length == 0) {
+        return 0;
+    }
+    if (::mlock(addr, length) != 0) {
+        std::cerr << "mlock of " << length << " bytes failed: " << errno_message()
+                  << " (check RLIMIT_MEMLOCK)" << std::endl;
+        return 0;
+    }
+    return length;
+}
+
+MemoryPlacement place_current_thread(const BroadcastConfig& config) {
+    MemoryPlacement placement;
+    if (config.cpu_affinity) {
+        placement.thread_pinned = pin_current_thread(*config.cpu_affinity);
+        if (!placement.thread_pinned) {
+            std::cerr << "Failed to pin thread to CPU " << *config.cpu_affinity << std::endl;
+        }
+    }
+    placement.cpu = current_cpu();
+    placement.numa_node = cpu_numa_node(placement.cpu);
+    return placement;
+}
+
+void place_shared_memory(const BroadcastConfig& config, void* addr, size_t size, bool owner,
+                         MemoryPlacement& placement) {
+    if (owner && config.numa_aware) {
+        // 先设定策略再首次访问，页面直接分配在发布线程所在节点
+        if (placement.numa_node >= 0 && bind_memory_to_node(addr, size, placement.numa_node)) {
+            placement.memory_node = placement.numa_node;
+        } else if (placement.numa_node >= 0) {
+            std::cerr << "mbind to NUMA node " << placement.numa_node << " failed: " << errno_message()
+                      << " (falling back to first-touch)" << std::endl;
+        }
+        placement.prefaulted_bytes += prefault_memory(addr, size);
+    }
+    if (config.lock_memory) {
+        placement.locked_bytes += lock_memory(addr, size, config.memory_pool_size_mb * 1024 * 1024);
+    }
+}
+
+} // namespace qaultra::ipc
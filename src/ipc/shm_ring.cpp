@@ -0,0 +1,481 @@
+#include "qaultra/ipc/shm_ring.hpp"
+#include "qaultra/ipc/numa_placement.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace qaultra::ipc::shm {
+
+namespace {
+
+template <typename Block>
+size_t mapping_size(size_t slot_count) {
+    return sizeof(RingHeader) + slot_count * sizeof(RingSlot<Block>);
+}
+
+std::string errno_message() {
+    return std::strerror(errno);
+}
+
+} // namespace
+
+std::string shm_object_name(const BroadcastConfig& config, const std::string& stream_name) {
+    std::string name = "/qaultra_" + config.service_name + "_" + stream_name;
+    // POSIX shm 名称只允许开头一个 '/'
+    std::replace(name.begin() + 1, name.end(), '/', '_');
+    return name;
+}
+
+std::string lvc_object_name(const BroadcastConfig& config, const std::string& stream_name) {
+    return shm_object_name(config, stream_name) + "_lvc";
+}
+
+size_t ring_slot_count(const BroadcastConfig& config) {
+    size_t count = 2;
+    while (count < config.queue_capacity) {
+        count <<= 1;
+    }
+    return count;
+}
+
+//==============================================================================
+// ShmRingBroadcaster
+//==============================================================================
+
+template <typename Block>
+BasicShmRingBroadcaster<Block>::BasicShmRingBroadcaster(const BroadcastConfig& config, const std::string& stream_name)
+    : config_(config)
+    , stream_name_(stream_name)
+    , shm_name_(shm_object_name(config, stream_name))
+    , slot_count_(ring_slot_count(config))
+    , mask_(slot_count_ - 1)
+    , mapped_size_(mapping_size<Block>(slot_count_))
+    , start_time_(std::chrono::steady_clock::now())
+{
+    if (!config_.validate()) {
+        throw std::invalid_argument("Invalid BroadcastConfig");
+    }
+    placement_ = place_current_thread(config_);
+
+    if (!config_.journal_dir.empty()) {
+        journal_ = std::make_unique<MarketJournalWriter>(journal_directory(config_, stream_name_),
+                                                         config_.journal_segment_mb << 20);
+        next_sequence_ = journal_->next_sequence();
+    }
+
+    // 替换残留的同名段: 仍映射旧段的订阅者看到 closed 标志后应重新连接
+    ::shm_unlink(shm_name_.c_str());
+    int fd = ::shm_open(shm_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create shared memory " + shm_name_ + ": " + errno_message());
+    }
+    if (::ftruncate(fd, static_cast<off_t>(mapped_size_)) != 0) {
+        const std::string error = errno_message();
+        ::close(fd);
+        ::shm_unlink(shm_name_.c_str());
+        throw std::runtime_error("Failed to size shared memory " + shm_name_ + ": " + error);
+    }
+
+    void* memory = ::mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        const std::string error = errno_message();
+        ::shm_unlink(shm_name_.c_str());
+        throw std::runtime_error("Failed to map shared memory " + shm_name_ + ": " + error);
+    }
+
+    // 首次访问之前: 绑定 NUMA 节点、预先缺页、锁定
+    place_shared_memory(config_, memory, mapped_size_, true, placement_);
+
+    // ftruncate 得到的页已清零，只需写入头部
+    header_ = new (memory) RingHeader();
+    slots_ = reinterpret_cast<Slot*>(static_cast<uint8_t*>(memory) + sizeof(RingHeader));
+    header_->slot_size = sizeof(Slot);
+    header_->slot_count = slot_count_;
+    header_->closed.store(0, std::memory_order_relaxed);
+    header_->subscribers.store(0, std::memory_order_relaxed);
+    header_->first_sequence = next_sequence_;
+    header_->write_sequence.store(next_sequence_, std::memory_order_relaxed);
+    header_->version = RingHeader::VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    reinterpret_cast<std::atomic<uint64_t>*>(&header_->magic)->store(RingHeader::MAGIC, std::memory_order_release);
+
+    if (config_.conflation_enabled) {
+        try {
+            lvc_ = std::make_unique<LastValueCacheWriter>(lvc_object_name(config_, stream_name_),
+                                                          config_.conflation_capacity,
+                                                          config_.conflation_value_size);
+        } catch (...) {
+            ::munmap(header_, mapped_size_);
+            ::shm_unlink(shm_name_.c_str());
+            throw;
+        }
+    }
+}
+
+template <typename Block>
+BasicShmRingBroadcaster<Block>::~BasicShmRingBroadcaster() {
+    if (header_) {
+        header_->closed.store(1, std::memory_order_release);
+        ::munmap(header_, mapped_size_);
+        ::shm_unlink(shm_name_.c_str());
+    }
+}
+
+template <typename Block>
+typename BasicShmRingBroadcaster<Block>::Writer BasicShmRingBroadcaster<Block>::loan() {
+    if (loaned_) {
+        return Writer();
+    }
+    Slot& slot = slot_at(next_sequence_);
+    slot.sequence.store(next_sequence_ * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    loaned_ = true;
+    return Writer(slot.block);
+}
+
+template <typename Block>
+bool BasicShmRingBroadcaster<Block>::publish(Writer& writer, MarketDataType type, uint8_t flags) {
+    if (!loaned_ || !writer.valid()) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    const uint64_t sequence = next_sequence_++;
+    writer.finish(sequence, latency_clock_ns(), type, flags);
+
+    // 先更新最新值缓存再发布，保证追赶的订阅者不会漏掉游标之前的状态
+    const Block& block = slot_at(sequence).block;
+    if (lvc_ && block.has_instrument() && !(flags & block_flags::FRAGMENT)) {
+        lvc_->update(block.instrument(), block.data, block.payload_size, block.header());
+    }
+    // 先写日志: 订阅者可见的序号都已在日志中，回放可以无缝切换到实时
+    if (journal_ && !journal_->append(block)) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    slot_at(sequence).sequence.store(sequence * 2 + 2, std::memory_order_release);
+    header_->write_sequence.store(sequence + 1, std::memory_order_release);
+    loaned_ = false;
+
+    blocks_sent_.fetch_add(1, std::memory_order_relaxed);
+    records_sent_.fetch_add(writer.records(), std::memory_order_relaxed);
+    bytes_sent_.fetch_add(sizeof(MarketBlockHeader) + writer.size(), std::memory_order_relaxed);
+    writer = Writer();
+    return true;
+}
+
+template <typename Block>
+bool BasicShmRingBroadcaster<Block>::broadcast(const uint8_t* data,
+                                               size_t data_size,
+                                               size_t record_count,
+                                               MarketDataType type,
+                                               uint32_t instrument_id) {
+    if (data_size > Block::DATA_SIZE) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Writer writer = loan();
+    if (!writer.valid()) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    writer.append(data, data_size, record_count);
+    writer.set_instrument(instrument_id);
+    return publish(writer, type);
+}
+
+template <typename Block>
+bool BasicShmRingBroadcaster<Block>::broadcast_message(const uint8_t* data,
+                                                       size_t data_size,
+                                                       size_t record_count,
+                                                       MarketDataType type,
+                                                       uint32_t instrument_id) {
+    if (data_size <= Block::DATA_SIZE) {
+        return broadcast(data, data_size, record_count, type, instrument_id);
+    }
+
+    size_t offset = 0;
+    size_t records_sent = 0;
+    while (offset < data_size) {
+        const size_t chunk_size = std::min(Block::DATA_SIZE, data_size - offset);
+        const bool first = offset == 0;
+        const bool last = offset + chunk_size == data_size;
+        // 按字节比例分摊记录数，末片补齐余数
+        const size_t chunk_records = last ? record_count - records_sent
+                                          : ((offset + chunk_size) * record_count) / data_size - records_sent;
+
+        uint8_t flags = block_flags::FRAGMENT;
+        if (first) {
+            flags |= block_flags::FRAGMENT_FIRST;
+        }
+        if (last) {
+            flags |= block_flags::FRAGMENT_LAST;
+        }
+
+        Writer writer = loan();
+        if (!writer.valid()) {
+            errors_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        writer.append(data + offset, chunk_size, chunk_records);
+        writer.set_instrument(instrument_id);
+        if (!publish(writer, type, flags)) {
+            return false;
+        }
+        offset += chunk_size;
+        records_sent += chunk_records;
+    }
+    return true;
+}
+
+template <typename Block>
+size_t BasicShmRingBroadcaster<Block>::broadcast_batch(const uint8_t* data,
+                                                       size_t data_size,
+                                                       size_t record_count,
+                                                       MarketDataType type) {
+    size_t sent = 0;
+    size_t offset = 0;
+
+    while (offset < data_size) {
+        const size_t chunk_size = std::min(Block::DATA_SIZE, data_size - offset);
+        // 按累计字节比例分摊记录数，末块补齐余数，各块之和等于 record_count
+        const size_t chunk_records = offset + chunk_size == data_size
+                                         ? record_count - sent
+                                         : ((offset + chunk_size) * record_count) / data_size - sent;
+
+        if (!broadcast(data + offset, chunk_size, chunk_records, type)) {
+            break;
+        }
+        sent += chunk_records;
+        offset += chunk_size;
+    }
+
+    return sent;
+}
+
+template <typename Block>
+BroadcastStats BasicShmRingBroadcaster<Block>::get_stats() const {
+    BroadcastStats stats;
+    stats.blocks_sent = blocks_sent_.load(std::memory_order_relaxed);
+    stats.records_sent = records_sent_.load(std::memory_order_relaxed);
+    stats.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+    stats.errors = errors_.load(std::memory_order_relaxed);
+    stats.active_subscribers = get_subscriber_count();
+    stats.memory_usage_bytes = mapped_size_;
+    stats.placement = placement_;
+    stats.start_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        start_time_.time_since_epoch()).count();
+    stats.elapsed_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_time_).count();
+    return stats;
+}
+
+template <typename Block>
+void BasicShmRingBroadcaster<Block>::reset_stats() {
+    blocks_sent_.store(0, std::memory_order_relaxed);
+    records_sent_.store(0, std::memory_order_relaxed);
+    bytes_sent_.store(0, std::memory_order_relaxed);
+    errors_.store(0, std::memory_order_relaxed);
+    start_time_ = std::chrono::steady_clock::now();
+}
+
+template <typename Block>
+size_t BasicShmRingBroadcaster<Block>::get_subscriber_count() const {
+    return header_ ? header_->subscribers.load(std::memory_order_relaxed) : 0;
+}
+
+//==============================================================================
+// ShmRingSubscriber
+//==============================================================================
+
+template <typename Block>
+BasicShmRingSubscriber<Block>::BasicShmRingSubscriber(const BroadcastConfig& config,
+                                                      const std::string& stream_name,
+                                                      StartPosition start)
+    : config_(config)
+    , stream_name_(stream_name)
+    , placement_(place_current_thread(config))
+{
+    const std::string name = shm_object_name(config, stream_name);
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open shared memory " + name + ": " + errno_message());
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(RingHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Shared memory " + name + " is not initialized");
+    }
+    mapped_size_ = static_cast<size_t>(st.st_size);
+
+    // 订阅者需要写权限以维护订阅计数
+    void* memory = ::mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        throw std::runtime_error("Failed to map shared memory " + name + ": " + errno_message());
+    }
+
+    header_ = static_cast<RingHeader*>(memory);
+    const uint64_t magic = reinterpret_cast<std::atomic<uint64_t>*>(&header_->magic)->load(std::memory_order_acquire);
+    if (magic != RingHeader::MAGIC || header_->version != RingHeader::VERSION ||
+        header_->slot_size != sizeof(Slot) ||
+        mapping_size<Block>(header_->slot_count) > mapped_size_) {
+        ::munmap(memory, mapped_size_);
+        header_ = nullptr;
+        throw std::runtime_error("Shared memory " + name + " has an incompatible layout");
+    }
+
+    slot_count_ = header_->slot_count;
+    mask_ = slot_count_ - 1;
+    slots_ = reinterpret_cast<const Slot*>(static_cast<uint8_t*>(memory) + sizeof(RingHeader));
+    place_shared_memory(config_, memory, mapped_size_, false, placement_);
+    header_->subscribers.fetch_add(1, std::memory_order_relaxed);
+
+    // 合并模式: 连接即注册读者位，此后的更新都会记入脏位图
+    if (config_.conflation_enabled) {
+        try {
+            lvc_ = std::make_unique<LastValueCacheReader>(lvc_object_name(config_, stream_name_));
+        } catch (const std::exception& e) {
+            std::cerr << "Conflation disabled for " << name << ": " << e.what() << std::endl;
+        }
+    }
+
+    if (config_.latency_tracking) {
+        latency_ = std::make_unique<LatencyTracker>();
+    }
+
+    const uint64_t written = header_->write_sequence.load(std::memory_order_acquire);
+    if (start == StartPosition::Oldest) {
+        cursor_ = oldest_retained(written);
+    } else {
+        cursor_ = written;
+    }
+}
+
+template <typename Block>
+BasicShmRingSubscriber<Block>::~BasicShmRingSubscriber() {
+    if (header_) {
+        header_->subscribers.fetch_sub(1, std::memory_order_relaxed);
+        ::munmap(header_, mapped_size_);
+    }
+}
+
+template <typename Block>
+typename BasicShmRingSubscriber<Block>::SlotState BasicShmRingSubscriber<Block>::begin_read(uint64_t& observed) {
+    const uint64_t expected = cursor_ * 2 + 2;
+    observed = slot_at(cursor_).sequence.load(std::memory_order_acquire);
+    if (observed == expected) {
+        return SlotState::Ready;
+    }
+    return observed > expected ? SlotState::Overrun : SlotState::Empty;
+}
+
+template <typename Block>
+bool BasicShmRingSubscriber<Block>::end_read(uint64_t observed) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot_at(cursor_).sequence.load(std::memory_order_relaxed) == observed;
+}
+
+template <typename Block>
+void BasicShmRingSubscriber<Block>::skip_overrun() {
+    // 跳到最旧的完整槽位 (write_sequence 对应的槽位可能正在被改写)
+    const uint64_t written = header_->write_sequence.load(std::memory_order_acquire);
+    const uint64_t target = std::max(oldest_retained(written), cursor_ + 1);
+    stats_.missed_samples += target - cursor_;
+    stats_.overruns++;
+    cursor_ = target;
+}
+
+template <typename Block>
+uint64_t BasicShmRingSubscriber<Block>::oldest_retained(uint64_t written) const {
+    const uint64_t first = header_->first_sequence;
+    return written >= first + slot_count_ ? written - slot_count_ + 1 : first;
+}
+
+template <typename Block>
+bool BasicShmRingSubscriber<Block>::seek(uint64_t sequence) {
+    const uint64_t written = header_->write_sequence.load(std::memory_order_acquire);
+    if (sequence < oldest_retained(written)) {
+        return false;
+    }
+    cursor_ = sequence;
+    assembler_.reset();
+    if (latency_) {
+        latency_->resync();
+    }
+    return true;
+}
+
+template <typename Block>
+void BasicShmRingSubscriber<Block>::account(uint64_t records, size_t payload_size) {
+    stats_.blocks_received++;
+    stats_.records_received += records;
+    stats_.bytes_received += sizeof(MarketBlockHeader) + payload_size;
+}
+
+template <typename Block>
+void BasicShmRingSubscriber<Block>::reset_receive_stats() {
+    stats_ = ReceiveStats{};
+    if (latency_) {
+        latency_->reset();
+    }
+}
+
+template <typename Block>
+bool BasicShmRingSubscriber<Block>::receive_block(Block& out) {
+    return read([&out](const Block& block) {
+        const size_t payload_size = std::min<size_t>(block.payload_size, Block::DATA_SIZE);
+        static_cast<MarketBlockHeader&>(out) = block.header();
+        std::memcpy(out.data, block.data, payload_size);
+        out.payload_size = static_cast<uint16_t>(payload_size);
+    });
+}
+
+template <typename Block>
+std::optional<std::vector<uint8_t>> BasicShmRingSubscriber<Block>::receive() {
+    std::vector<uint8_t> payload;
+    const bool ok = read([&payload](const Block& block) {
+        const size_t payload_size = std::min<size_t>(block.payload_size, Block::DATA_SIZE);
+        payload.assign(block.data, block.data + payload_size);
+    });
+    if (!ok) {
+        return std::nullopt;
+    }
+    return payload;
+}
+
+template <typename Block>
+bool BasicShmRingSubscriber<Block>::has_data() const {
+    return header_->write_sequence.load(std::memory_order_acquire) > cursor_;
+}
+
+template <typename Block>
+bool BasicShmRingSubscriber<Block>::is_closed() const {
+    return header_->closed.load(std::memory_order_acquire) != 0;
+}
+
+template <typename Block>
+uint64_t BasicShmRingSubscriber<Block>::lag() const {
+    const uint64_t written = header_->write_sequence.load(std::memory_order_acquire);
+    return written > cursor_ ? written - cursor_ : 0;
+}
+
+template class BasicShmRingBroadcaster<SmallMarketBlock>;
+template class BasicShmRingBroadcaster<ZeroCopyMarketBlock>;
+template class BasicShmRingBroadcaster<LargeMarketBlock>;
+template class BasicShmRingSubscriber<SmallMarketBlock>;
+template class BasicShmRingSubscriber<ZeroCopyMarketBlock>;
+template class BasicShmRingSubscriber<LargeMarketBlock>;
+
+} // namespace qaultra::ipc::shm
@@ -400,10 +400,14 @@ MarketType get_market_type_from_instrument(const std::string& instrument_id) {
 }
 
 std::string standardize_datetime(const std::string& datetime) {
-    // 简化实现：假设输入已经是ISO 8601格式
-    // 实际项目中可以添加更复杂的日期时间解析和标准化
+    // 定长快速路径: "YYYY-MM-DD HH:MM:SS[.f]" 只需替换第11个字符
+    if (datetime.size() >= 19 && datetime[10] == ' ' && datetime[13] == ':') {
+        std::string result = datetime;
+        result[10] = 'T';
+        return result;
+    }
     if (datetime.find('T') == std::string::npos && datetime.find(' ') != std::string::npos) {
-        // 将 "YYYY-MM-DD HH:MM:SS" 转换为 "YYYY-MM-DDTHH:MM:SS"
+        // 非定长输入: 将所有空格替换为 'T'
         std::string result = datetime;
         std::replace(result.begin(), result.end(), ' ', 'T');
         return result;
@@ -0,0 +1,67 @@
+/**
+ * @file kernels_avx2.cpp
+ * @brief AVX2 + FMA 内核 (编译选项见 CMakeLists.txt，仅在 x86_64 上启用)
+ */
+
+#include "qaultra/simd/simd_kernels.hpp"
+
+#if defined(QAULTRA_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+namespace qaultra::simd {
+
+#if defined(QAULTRA_SIMD_X86)
+
+namespace {
+
+struct Avx2F64 {
+    using value_type = double;
+    using reg = __m256d;
+    static constexpr size_t LANES = 4;
+
+    static reg load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, reg r) { _mm256_storeu_pd(p, r); }
+    static reg set1(double x) { return _mm256_set1_pd(x); }
+    static reg zero() { return _mm256_setzero_pd(); }
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+    static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+};
+
+struct Avx2F32 {
+    using value_type = float;
+    using reg = __m256;
+    static constexpr size_t LANES = 8;
+
+    static reg load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, reg r) { _mm256_storeu_ps(p, r); }
+    static reg set1(float x) { return _mm256_set1_ps(x); }
+    static reg zero() { return _mm256_setzero_ps(); }
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+    static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+};
+
+} // namespace
+
+const KernelTable* avx2_kernels() {
+    static const KernelTable table = detail::make_kernel_table<Avx2F64, Avx2F32>(SimdLevel::AVX2);
+    return &table;
+}
+
+#else
+
+const KernelTable* avx2_kernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace qaultra::simd
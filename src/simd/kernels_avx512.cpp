@@ -0,0 +1,69 @@
+/**
+ * @file kernels_avx512.cpp
+ * @brief AVX-512F 内核 (编译选项见 CMakeLists.txt，仅在 x86_64 上启用)
+ */
+
+#include "qaultra/simd/simd_kernels.hpp"
+
+#if defined(QAULTRA_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+namespace qaultra::simd {
+
+#if defined(QAULTRA_SIMD_X86)
+
+namespace {
+
+struct Avx512F64 {
+    using value_type = double;
+    using reg = __m512d;
+    static constexpr size_t LANES = 8;
+
+    static reg load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, reg r) { _mm512_storeu_pd(p, r); }
+    static reg set1(double x) { return _mm512_set1_pd(x); }
+    static reg zero() { return _mm512_setzero_pd(); }
+    static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+    // GCC 的非掩码 min/max 以 _mm512_undefined_pd() 作直通寄存器，内联进归约循环后触发
+    // -Wmaybe-uninitialized；全掩码形式显式以 a 作直通，生成同一条 vminpd/vmaxpd
+    static reg min(reg a, reg b) { return _mm512_mask_min_pd(a, 0xFF, a, b); }
+    static reg max(reg a, reg b) { return _mm512_mask_max_pd(a, 0xFF, a, b); }
+};
+
+struct Avx512F32 {
+    using value_type = float;
+    using reg = __m512;
+    static constexpr size_t LANES = 16;
+
+    static reg load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, reg r) { _mm512_storeu_ps(p, r); }
+    static reg set1(float x) { return _mm512_set1_ps(x); }
+    static reg zero() { return _mm512_setzero_ps(); }
+    static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+    static reg min(reg a, reg b) { return _mm512_mask_min_ps(a, 0xFFFF, a, b); }
+    static reg max(reg a, reg b) { return _mm512_mask_max_ps(a, 0xFFFF, a, b); }
+};
+
+} // namespace
+
+const KernelTable* avx512_kernels() {
+    static const KernelTable table = detail::make_kernel_table<Avx512F64, Avx512F32>(SimdLevel::AVX512);
+    return &table;
+}
+
+#else
+
+const KernelTable* avx512_kernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace qaultra::simd
@@ -0,0 +1,38 @@
+/**
+ * @file kernels_scalar.cpp
+ * @brief 标量参考内核 (确定性模式的参考顺序)
+ */
+
+#include "qaultra/simd/simd_kernels.hpp"
+
+namespace qaultra::simd {
+
+namespace {
+
+template <typename T>
+struct ScalarTraits {
+    using value_type = T;
+    using reg = T;
+    static constexpr size_t LANES = 1;
+
+    static reg load(const T* p) { return *p; }
+    static void store(T* p, reg r) { *p = r; }
+    static reg set1(T x) { return x; }
+    static reg zero() { return T(0); }
+    static reg add(reg a, reg b) { return a + b; }
+    static reg sub(reg a, reg b) { return a - b; }
+    static reg mul(reg a, reg b) { return a * b; }
+    static reg fmadd(reg a, reg b, reg c) { return a * b + c; }
+    static reg min(reg a, reg b) { return a < b ? a : b; }
+    static reg max(reg a, reg b) { return a > b ? a : b; }
+};
+
+} // namespace
+
+const KernelTable* scalar_kernels() {
+    static const KernelTable table =
+        detail::make_kernel_table<ScalarTraits<double>, ScalarTraits<float>>(SimdLevel::Scalar);
+    return &table;
+}
+
+} // namespace qaultra::simd
@@ -0,0 +1,67 @@
+/**
+ * @file kernels_sse42.cpp
+ * @brief SSE4.2 内核 (编译选项见 CMakeLists.txt，仅在 x86_64 上启用)
+ */
+
+#include "qaultra/simd/simd_kernels.hpp"
+
+#if defined(QAULTRA_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+namespace qaultra::simd {
+
+#if defined(QAULTRA_SIMD_X86)
+
+namespace {
+
+struct Sse42F64 {
+    using value_type = double;
+    using reg = __m128d;
+    static constexpr size_t LANES = 2;
+
+    static reg load(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, reg r) { _mm_storeu_pd(p, r); }
+    static reg set1(double x) { return _mm_set1_pd(x); }
+    static reg zero() { return _mm_setzero_pd(); }
+    static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+};
+
+struct Sse42F32 {
+    using value_type = float;
+    using reg = __m128;
+    static constexpr size_t LANES = 4;
+
+    static reg load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, reg r) { _mm_storeu_ps(p, r); }
+    static reg set1(float x) { return _mm_set1_ps(x); }
+    static reg zero() { return _mm_setzero_ps(); }
+    static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+    static reg fmadd(reg a, reg b, reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+};
+
+} // namespace
+
+const KernelTable* sse42_kernels() {
+    static const KernelTable table = detail::make_kernel_table<Sse42F64, Sse42F32>(SimdLevel::SSE42);
+    return &table;
+}
+
+#else
+
+const KernelTable* sse42_kernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace qaultra::simd
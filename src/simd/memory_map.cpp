@@ -0,0 +1,236 @@
+#include "qaultra/simd/simd_math.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace qaultra::simd::detail {
+
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+
+size_t page_size() {
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+size_t round_up(size_t bytes, size_t granularity) {
+    return (bytes + granularity - 1) / granularity * granularity;
+}
+
+[[noreturn]] void fail(const std::string& what, int error) {
+    throw std::runtime_error(what + ": " + std::strerror(error));
+}
+
+int map_flags(const Mapping& mapping, const MemoryMapOptions& options) {
+    int flags = mapping.fd >= 0 ? MAP_SHARED : (MAP_PRIVATE | MAP_ANONYMOUS);
+#ifdef MAP_POPULATE
+    if (options.populate) {
+        flags |= MAP_POPULATE;
+    }
+#else
+    (void)options;
+#endif
+#ifdef MAP_HUGETLB
+    if (mapping.huge_tlb) {
+        flags |= MAP_HUGETLB;
+    }
+#endif
+    return flags;
+}
+
+void* map_region(const Mapping& mapping, size_t bytes, const MemoryMapOptions& options) {
+    const int protection = options.read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+    void* memory = ::mmap(nullptr, bytes, protection, map_flags(mapping, options), mapping.fd, 0);
+    return memory == MAP_FAILED ? nullptr : memory;
+}
+
+int advice_flag(MemoryAdvice advice) {
+    switch (advice) {
+        case MemoryAdvice::Normal: return MADV_NORMAL;
+        case MemoryAdvice::Sequential: return MADV_SEQUENTIAL;
+        case MemoryAdvice::Random: return MADV_RANDOM;
+        case MemoryAdvice::WillNeed: return MADV_WILLNEED;
+        case MemoryAdvice::DontNeed: return MADV_DONTNEED;
+    }
+    return MADV_NORMAL;
+}
+
+// 每次 (重新) 映射后都要重新下发提示；失败只影响性能
+void apply_hints(const Mapping& mapping, const MemoryMapOptions& options) {
+#ifdef MADV_HUGEPAGE
+    if (options.huge_pages && !mapping.huge_tlb) {
+        ::madvise(mapping.memory, mapping.bytes, MADV_HUGEPAGE);
+    }
+#endif
+    if (options.advice != MemoryAdvice::Normal) {
+        advise(mapping, 0, mapping.bytes, options.advice);
+    }
+}
+
+} // namespace
+
+// ==================== 映射 / 扩容 / 释放 ====================
+
+Mapping map_anonymous(size_t bytes, const MemoryMapOptions& options) {
+    if (options.read_only) {
+        throw std::invalid_argument("read_only requires a file-backed MemoryMappedArray");
+    }
+    Mapping mapping;
+    if (bytes == 0) {
+        return mapping;
+    }
+#ifdef MAP_HUGETLB
+    if (options.huge_pages) {
+        mapping.huge_tlb = true;
+        mapping.bytes = round_up(bytes, HUGE_PAGE_SIZE);
+        mapping.memory = map_region(mapping, mapping.bytes, options);
+        // 未预留 hugetlb 页时退回普通页 + 透明大页
+        mapping.huge_tlb = mapping.memory != nullptr;
+    }
+#endif
+    if (!mapping.memory) {
+        mapping.bytes = round_up(bytes, page_size());
+        mapping.memory = map_region(mapping, mapping.bytes, options);
+        if (!mapping.memory) {
+            fail("Failed to map " + std::to_string(mapping.bytes) + " bytes", errno);
+        }
+    }
+    apply_hints(mapping, options);
+    return mapping;
+}
+
+Mapping map_file(const std::string& filename, size_t bytes, const MemoryMapOptions& options) {
+    Mapping mapping;
+    mapping.fd = options.read_only ? ::open(filename.c_str(), O_RDONLY | O_CLOEXEC)
+                                   : ::open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (mapping.fd < 0) {
+        fail("Failed to open " + filename, errno);
+    }
+
+    const auto close_and_fail = [&](const std::string& what) {
+        const int error = errno;
+        ::close(mapping.fd);
+        fail(what + " " + filename, error);
+    };
+
+    struct stat st {};
+    if (::fstat(mapping.fd, &st) != 0) {
+        close_and_fail("Failed to stat");
+    }
+    const size_t length = static_cast<size_t>(st.st_size);
+    if (bytes == KEEP_FILE_LENGTH) {
+        bytes = length;
+    } else if (bytes != length) {
+        if (options.read_only) {
+            ::close(mapping.fd);
+            throw std::invalid_argument("Cannot resize read-only file " + filename);
+        }
+        if (::ftruncate(mapping.fd, static_cast<off_t>(bytes)) != 0) {
+            close_and_fail("Failed to size");
+        }
+    }
+
+    mapping.bytes = bytes;
+    if (bytes > 0) {
+        mapping.memory = map_region(mapping, bytes, options);
+        if (!mapping.memory) {
+            close_and_fail("Failed to map");
+        }
+        apply_hints(mapping, options);
+    }
+    return mapping;
+}
+
+void grow(Mapping& mapping, size_t bytes, const MemoryMapOptions& options) {
+    if (mapping.fd < 0 && !mapping.memory) {
+        mapping = map_anonymous(bytes, options);
+        return;
+    }
+    const size_t new_bytes = round_up(bytes, mapping.huge_tlb ? HUGE_PAGE_SIZE : page_size());
+    if (new_bytes <= mapping.bytes) {
+        return;
+    }
+    // 文件先扩展到新长度 (新增部分为 0)，映射超出文件末尾的页访问会 SIGBUS
+    if (mapping.fd >= 0 && ::ftruncate(mapping.fd, static_cast<off_t>(new_bytes)) != 0) {
+        fail("Failed to extend mapped file", errno);
+    }
+
+    void* memory = nullptr;
+#ifdef MREMAP_MAYMOVE
+    if (mapping.memory) {
+        memory = ::mremap(mapping.memory, mapping.bytes, new_bytes, MREMAP_MAYMOVE);
+        memory = memory == MAP_FAILED ? nullptr : memory;
+    }
+#endif
+    if (!memory) {
+        // 无 mremap (或 hugetlb 映射不可移动) 时新建映射；文件映射共享页缓存，只有匿名映射需要复制
+        memory = map_region(mapping, new_bytes, options);
+        if (!memory && mapping.huge_tlb) {
+            mapping.huge_tlb = false;
+            memory = map_region(mapping, new_bytes, options);
+        }
+        if (!memory) {
+            fail("Failed to remap " + std::to_string(new_bytes) + " bytes", errno);
+        }
+        if (mapping.memory) {
+            if (mapping.fd < 0) {
+                std::memcpy(memory, mapping.memory, mapping.bytes);
+            }
+            ::munmap(mapping.memory, mapping.bytes);
+        }
+    }
+    mapping.memory = memory;
+    mapping.bytes = new_bytes;
+    apply_hints(mapping, options);
+}
+
+void release(Mapping& mapping, size_t used_bytes, const MemoryMapOptions& options) noexcept {
+    if (mapping.memory) {
+        ::munmap(mapping.memory, mapping.bytes);
+    }
+    if (mapping.fd >= 0) {
+        // 去掉扩容时预留的尾部，文件长度与元素个数一致
+        if (!options.read_only && used_bytes != mapping.bytes &&
+            ::ftruncate(mapping.fd, static_cast<off_t>(used_bytes)) != 0) {
+            std::cerr << "Failed to trim mapped file: " << std::strerror(errno) << std::endl;
+        }
+        ::close(mapping.fd);
+    }
+    mapping = Mapping();
+}
+
+// ==================== 同步与访问提示 ====================
+
+bool flush(const Mapping& mapping, size_t bytes) {
+    if (mapping.fd < 0 || !mapping.memory || bytes == 0) {
+        return true;
+    }
+    if (::msync(mapping.memory, bytes, MS_SYNC) != 0) {
+        std::cerr << "msync of " << bytes << " bytes failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool advise(const Mapping& mapping, size_t offset, size_t bytes, MemoryAdvice advice) {
+    // 匿名私有映射上 MADV_DONTNEED 会清零数据，只对文件映射生效
+    if (!mapping.memory || bytes == 0 || offset >= mapping.bytes ||
+        (advice == MemoryAdvice::DontNeed && mapping.fd < 0)) {
+        return false;
+    }
+    const size_t start = offset / page_size() * page_size();
+    const size_t end = std::min(offset + bytes, mapping.bytes);
+    return ::madvise(static_cast<unsigned char*>(mapping.memory) + start, end - start, advice_flag(advice)) == 0;
+}
+
+} // namespace qaultra::simd::detail
@@ -0,0 +1,580 @@
+#include "qaultra/simd/simd_math.hpp"
+#include "qaultra/simd/simd_kernels.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace qaultra::simd {
+
+// ==================== 运行时分派 ====================
+
+namespace {
+
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+std::atomic<const KernelTable*> g_active_kernels{nullptr};
+std::atomic<bool> g_deterministic{false};
+std::once_flag g_init_flag;
+
+bool cpu_supports(SimdLevel level) {
+#if defined(QAULTRA_SIMD_X86)
+    __builtin_cpu_init();
+    switch (level) {
+        case SimdLevel::Scalar:
+            return true;
+        case SimdLevel::SSE42:
+            return __builtin_cpu_supports("sse4.2");
+        case SimdLevel::AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case SimdLevel::AVX512:
+            return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#else
+    return level == SimdLevel::Scalar;
+#endif
+}
+
+const KernelTable* kernels_for(SimdLevel level) {
+    if (!cpu_supports(level)) {
+        return nullptr;
+    }
+    switch (level) {
+        case SimdLevel::Scalar: return scalar_kernels();
+        case SimdLevel::SSE42: return sse42_kernels();
+        case SimdLevel::AVX2: return avx2_kernels();
+        case SimdLevel::AVX512: return avx512_kernels();
+    }
+    return nullptr;
+}
+
+bool parse_level(std::string name, SimdLevel& level) {
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    name.erase(std::remove(name.begin(), name.end(), '.'), name.end());
+    if (name == "scalar") {
+        level = SimdLevel::Scalar;
+    } else if (name == "sse42") {
+        level = SimdLevel::SSE42;
+    } else if (name == "avx2") {
+        level = SimdLevel::AVX2;
+    } else if (name == "avx512") {
+        level = SimdLevel::AVX512;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 首次使用时选择内核: 默认取检测到的最高级别，可由环境变量降级
+ */
+void initialize_dispatch() {
+    std::call_once(g_init_flag, [] {
+        SimdLevel level = detected_simd_level();
+        if (const char* env = std::getenv("QAULTRA_SIMD_LEVEL")) {
+            SimdLevel requested = level;
+            if (!parse_level(env, requested)) {
+                std::cerr << "Unknown QAULTRA_SIMD_LEVEL '" << env << "', using "
+                          << simd_level_name(level) << std::endl;
+            } else if (requested > level) {
+                std::cerr << "QAULTRA_SIMD_LEVEL " << env << " is not supported on this host, using "
+                          << simd_level_name(level) << std::endl;
+            } else {
+                level = requested;
+            }
+        }
+        if (const char* env = std::getenv("QAULTRA_SIMD_DETERMINISTIC")) {
+            g_deterministic.store(env[0] != '\0' && env[0] != '0', std::memory_order_relaxed);
+        }
+
+        const KernelTable* expected = nullptr;
+        g_active_kernels.compare_exchange_strong(expected, kernels_for(level), std::memory_order_acq_rel);
+    });
+}
+
+inline bool deterministic() {
+    return g_deterministic.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+SimdLevel detected_simd_level() {
+    static const SimdLevel level = [] {
+        for (SimdLevel candidate : {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE42}) {
+            if (kernels_for(candidate)) {
+                return candidate;
+            }
+        }
+        return SimdLevel::Scalar;
+    }();
+    return level;
+}
+
+const KernelTable& active_kernels() {
+    const KernelTable* table = g_active_kernels.load(std::memory_order_acquire);
+    if (!table) {
+        initialize_dispatch();
+        table = g_active_kernels.load(std::memory_order_acquire);
+    }
+    return *table;
+}
+
+SimdLevel active_simd_level() {
+    return active_kernels().level;
+}
+
+bool set_simd_level(SimdLevel level) {
+    initialize_dispatch();
+    if (level > detected_simd_level()) {
+        return false;
+    }
+    const KernelTable* table = kernels_for(level);
+    if (!table) {
+        return false;
+    }
+    g_active_kernels.store(table, std::memory_order_release);
+    return true;
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::SSE42: return "sse4.2";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+void set_simd_deterministic(bool enabled) {
+    initialize_dispatch();
+    g_deterministic.store(enabled, std::memory_order_relaxed);
+}
+
+bool simd_deterministic() {
+    initialize_dispatch();
+    return deterministic();
+}
+
+// ==================== SimdMath ====================
+
+namespace {
+
+double centered_dot(const double* x, const double* y, size_t n, double mx, double my) {
+    const KernelTable& k = active_kernels();
+    return deterministic() ? k.centered_dot_f64_det(x, y, n, mx, my) : k.centered_dot_f64(x, y, n, mx, my);
+}
+
+float centered_dot(const float* x, const float* y, size_t n, float mx, float my) {
+    const KernelTable& k = active_kernels();
+    return deterministic() ? k.centered_dot_f32_det(x, y, n, mx, my) : k.centered_dot_f32(x, y, n, mx, my);
+}
+
+template <typename T>
+void moving_average_impl(const T* data, T* result, size_t size, size_t window) {
+    if (window == 0 || window > size) {
+        std::fill(result, result + size, std::numeric_limits<T>::quiet_NaN());
+        return;
+    }
+    std::fill(result, result + window - 1, std::numeric_limits<T>::quiet_NaN());
+    // 首个窗口用向量归约，之后滚动更新
+    T window_sum = SimdMath::sum(data, window);
+    const T inv = T(1) / static_cast<T>(window);
+    result[window - 1] = window_sum * inv;
+    for (size_t i = window; i < size; ++i) {
+        window_sum += data[i] - data[i - window];
+        result[i] = window_sum * inv;
+    }
+}
+
+template <typename T>
+void ema_impl(const T* data, T* result, size_t size, T alpha) {
+    if (size == 0) {
+        return;
+    }
+    // 递推依赖前一项，无法向量化
+    result[0] = data[0];
+    const T keep = T(1) - alpha;
+    for (size_t i = 1; i < size; ++i) {
+        result[i] = alpha * data[i] + keep * result[i - 1];
+    }
+}
+
+} // namespace
+
+size_t SimdMath::get_simd_stride() {
+    return active_kernels().f64_lanes;
+}
+
+size_t SimdMath::get_simd_stride_f32() {
+    return active_kernels().f32_lanes;
+}
+
+void SimdMath::add(const double* a, const double* b, double* result, size_t size) {
+    active_kernels().add_f64(a, b, result, size);
+}
+
+void SimdMath::add(const float* a, const float* b, float* result, size_t size) {
+    active_kernels().add_f32(a, b, result, size);
+}
+
+void SimdMath::subtract(const double* a, const double* b, double* result, size_t size) {
+    active_kernels().sub_f64(a, b, result, size);
+}
+
+void SimdMath::subtract(const float* a, const float* b, float* result, size_t size) {
+    active_kernels().sub_f32(a, b, result, size);
+}
+
+void SimdMath::multiply(const double* a, const double* b, double* result, size_t size) {
+    active_kernels().mul_f64(a, b, result, size);
+}
+
+void SimdMath::multiply(const float* a, const float* b, float* result, size_t size) {
+    active_kernels().mul_f32(a, b, result, size);
+}
+
+void SimdMath::multiply_scalar(const double* a, double scalar, double* result, size_t size) {
+    active_kernels().mul_scalar_f64(a, scalar, result, size);
+}
+
+void SimdMath::multiply_scalar(const float* a, float scalar, float* result, size_t size) {
+    active_kernels().mul_scalar_f32(a, scalar, result, size);
+}
+
+double SimdMath::dot_product(const double* a, const double* b, size_t size) {
+    const KernelTable& k = active_kernels();
+    return deterministic() ? k.dot_f64_det(a, b, size) : k.dot_f64(a, b, size);
+}
+
+float SimdMath::dot_product(const float* a, const float* b, size_t size) {
+    const KernelTable& k = active_kernels();
+    return deterministic() ? k.dot_f32_det(a, b, size) : k.dot_f32(a, b, size);
+}
+
+double SimdMath::sum(const double* data, size_t size) {
+    const KernelTable& k = active_kernels();
+    return deterministic() ? k.sum_f64_det(data, size) : k.sum_f64(data, size);
+}
+
+float SimdMath::sum(const float* data, size_t size) {
+    const KernelTable& k = active_kernels();
+    return deterministic() ? k.sum_f32_det(data, size) : k.sum_f32(data, size);
+}
+
+double SimdMath::min(const double* data, size_t size) {
+    return active_kernels().min_f64(data, size);
+}
+
+double SimdMath::max(const double* data, size_t size) {
+    return active_kernels().max_f64(data, size);
+}
+
+float SimdMath::min(const float* data, size_t size) {
+    return active_kernels().min_f32(data, size);
+}
+
+float SimdMath::max(const float* data, size_t size) {
+    return active_kernels().max_f32(data, size);
+}
+
+void SimdMath::moving_average(const double* data, double* result, size_t size, size_t window) {
+    moving_average_impl(data, result, size, window);
+}
+
+void SimdMath::moving_average(const float* data, float* result, size_t size, size_t window) {
+    moving_average_impl(data, result, size, window);
+}
+
+double SimdMath::std_dev(const double* data, size_t size, double mean) {
+    if (size == 0) {
+        return 0.0;
+    }
+    return std::sqrt(centered_dot(data, data, size, mean, mean) / static_cast<double>(size));
+}
+
+float SimdMath::std_dev(const float* data, size_t size, float mean) {
+    if (size == 0) {
+        return 0.0f;
+    }
+    return std::sqrt(centered_dot(data, data, size, mean, mean) / static_cast<float>(size));
+}
+
+void SimdMath::ema(const double* data, double* result, size_t size, double alpha) {
+    ema_impl(data, result, size, alpha);
+}
+
+void SimdMath::ema(const float* data, float* result, size_t size, float alpha) {
+    ema_impl(data, result, size, alpha);
+}
+
+void SimdMath::returns(const double* prices, double* returns, size_t size) {
+    for (size_t i = 1; i < size; ++i) {
+        returns[i - 1] = prices[i] / prices[i - 1] - 1.0;
+    }
+}
+
+void SimdMath::log_returns(const double* prices, double* returns, size_t size) {
+    for (size_t i = 1; i < size; ++i) {
+        returns[i - 1] = std::log(prices[i] / prices[i - 1]);
+    }
+}
+
+void SimdMath::price_change(const double* prices, double* changes, size_t size) {
+    if (size > 1) {
+        subtract(prices + 1, prices, changes, size - 1);
+    }
+}
+
+void SimdMath::price_change_percent(const double* prices, double* changes, size_t size) {
+    for (size_t i = 1; i < size; ++i) {
+        changes[i - 1] = (prices[i] - prices[i - 1]) / prices[i - 1] * 100.0;
+    }
+}
+
+void SimdMath::bollinger_bands(const double* prices, double* upper, double* lower,
+                               size_t size, size_t period, double std_multiplier) {
+    const size_t warmup = (period == 0 || period > size) ? size : period - 1;
+    std::fill(upper, upper + warmup, NaN);
+    std::fill(lower, lower + warmup, NaN);
+    if (warmup == size) {
+        return;
+    }
+
+    const double inv = 1.0 / static_cast<double>(period);
+    for (size_t i = warmup; i < size; ++i) {
+        const double* window = prices + i + 1 - period;
+        const double mean = sum(window, period) * inv;
+        const double band = std_multiplier * std::sqrt(centered_dot(window, window, period, mean, mean) * inv);
+        upper[i] = mean + band;
+        lower[i] = mean - band;
+    }
+}
+
+void SimdMath::rsi(const double* prices, double* rsi_values, size_t size, size_t period) {
+    const size_t warmup = (period == 0 || period >= size) ? size : period;
+    std::fill(rsi_values, rsi_values + warmup, NaN);
+    if (warmup == size) {
+        return;
+    }
+
+    std::vector<double> changes(size - 1);
+    price_change(prices, changes.data(), size);
+
+    const auto to_rsi = [](double avg_gain, double avg_loss) {
+        return avg_loss == 0.0 ? 100.0 : 100.0 - 100.0 / (1.0 + avg_gain / avg_loss);
+    };
+
+    // 首个值取前 period 个变动的简单平均，之后按 Wilder 平滑
+    double avg_gain = 0.0;
+    double avg_loss = 0.0;
+    for (size_t i = 0; i < period; ++i) {
+        avg_gain += std::max(changes[i], 0.0);
+        avg_loss += std::max(-changes[i], 0.0);
+    }
+    avg_gain /= static_cast<double>(period);
+    avg_loss /= static_cast<double>(period);
+    rsi_values[period] = to_rsi(avg_gain, avg_loss);
+
+    const double n = static_cast<double>(period);
+    for (size_t i = period + 1; i < size; ++i) {
+        const double change = changes[i - 1];
+        avg_gain = (avg_gain * (n - 1.0) + std::max(change, 0.0)) / n;
+        avg_loss = (avg_loss * (n - 1.0) + std::max(-change, 0.0)) / n;
+        rsi_values[i] = to_rsi(avg_gain, avg_loss);
+    }
+}
+
+void SimdMath::macd(const double* prices, double* macd_line, double* signal_line,
+                    double* histogram, size_t size, size_t fast_period,
+                    size_t slow_period, size_t signal_period) {
+    if (size == 0) {
+        return;
+    }
+    const auto alpha = [](size_t period) { return 2.0 / (static_cast<double>(period) + 1.0); };
+
+    std::vector<double> slow(size);
+    ema(prices, macd_line, size, alpha(fast_period));
+    ema(prices, slow.data(), size, alpha(slow_period));
+    subtract(macd_line, slow.data(), macd_line, size);
+    ema(macd_line, signal_line, size, alpha(signal_period));
+    subtract(macd_line, signal_line, histogram, size);
+}
+
+// ==================== FinancialMath ====================
+
+namespace {
+
+constexpr double TRADING_DAYS = 252.0;
+
+double mean_of(const double* data, size_t size) {
+    return size == 0 ? 0.0 : SimdMath::sum(data, size) / static_cast<double>(size);
+}
+
+double population_std(const double* data, size_t size) {
+    return SimdMath::std_dev(data, size, mean_of(data, size));
+}
+
+std::vector<double> sorted_copy(const double* data, size_t size) {
+    std::vector<double> sorted(data, data + size);
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+/**
+ * @brief 左尾分位数下标: floor(size * (1 - confidence))，限制在 [0, size)
+ */
+size_t tail_index(size_t size, double confidence) {
+    const double position = std::floor(static_cast<double>(size) * (1.0 - confidence));
+    if (position <= 0.0) {
+        return 0;
+    }
+    return std::min(static_cast<size_t>(position), size - 1);
+}
+
+} // namespace
+
+double FinancialMath::portfolio_value(const double* prices, const double* quantities, size_t size) {
+    return SimdMath::dot_product(prices, quantities, size);
+}
+
+void FinancialMath::position_values(const double* prices, const double* quantities,
+                                    double* values, size_t size) {
+    SimdMath::multiply(prices, quantities, values, size);
+}
+
+void FinancialMath::portfolio_weights(const double* values, double* weights, size_t size) {
+    const double total = SimdMath::sum(values, size);
+    if (total == 0.0) {
+        std::fill(weights, weights + size, 0.0);
+        return;
+    }
+    SimdMath::multiply_scalar(values, 1.0 / total, weights, size);
+}
+
+double FinancialMath::portfolio_return(const double* weights, const double* returns, size_t size) {
+    return SimdMath::dot_product(weights, returns, size);
+}
+
+double FinancialMath::portfolio_variance(const double* weights, const double* covariance_matrix, size_t size) {
+    // w' Σ w，协方差矩阵按行主序存储
+    double variance = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        variance += weights[i] * SimdMath::dot_product(covariance_matrix + i * size, weights, size);
+    }
+    return variance;
+}
+
+double FinancialMath::sharpe_ratio(const double* returns, size_t size, double risk_free_rate) {
+    if (size == 0) {
+        return 0.0;
+    }
+    const double excess_return = mean_of(returns, size) - risk_free_rate / TRADING_DAYS;
+    const double volatility = population_std(returns, size);
+    return volatility > 0 ? excess_return / volatility * std::sqrt(TRADING_DAYS) : 0.0;
+}
+
+double FinancialMath::max_drawdown(const double* cumulative_returns, size_t size) {
+    if (size == 0) {
+        return 0.0;
+    }
+    double peak = cumulative_returns[0];
+    double drawdown = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        peak = std::max(peak, cumulative_returns[i]);
+        drawdown = std::max(drawdown, (peak - cumulative_returns[i]) / peak);
+    }
+    return drawdown;
+}
+
+double FinancialMath::value_at_risk(const double* returns, size_t size, double confidence) {
+    if (size == 0) {
+        return 0.0;
+    }
+    const std::vector<double> sorted = sorted_copy(returns, size);
+    return -sorted[tail_index(size, confidence)];
+}
+
+double FinancialMath::expected_shortfall(const double* returns, size_t size, double confidence) {
+    if (size == 0) {
+        return 0.0;
+    }
+    const std::vector<double> sorted = sorted_copy(returns, size);
+    const size_t count = tail_index(size, confidence) + 1;
+    return -SimdMath::sum(sorted.data(), count) / static_cast<double>(count);
+}
+
+double FinancialMath::beta(const double* asset_returns, const double* market_returns, size_t size) {
+    if (size == 0) {
+        return 0.0;
+    }
+    const double asset_mean = mean_of(asset_returns, size);
+    const double market_mean = mean_of(market_returns, size);
+    const double covariance = centered_dot(asset_returns, market_returns, size, asset_mean, market_mean);
+    const double market_variance = centered_dot(market_returns, market_returns, size, market_mean, market_mean);
+    return market_variance > 0 ? covariance / market_variance : 0.0;
+}
+
+double FinancialMath::correlation(const double* x, const double* y, size_t size) {
+    if (size == 0) {
+        return 0.0;
+    }
+    const double mx = mean_of(x, size);
+    const double my = mean_of(y, size);
+    const double sxy = centered_dot(x, y, size, mx, my);
+    const double sxx = centered_dot(x, x, size, mx, mx);
+    const double syy = centered_dot(y, y, size, my, my);
+    return (sxx > 0 && syy > 0) ? sxy / std::sqrt(sxx * syy) : 0.0;
+}
+
+double FinancialMath::information_ratio(const double* portfolio_returns,
+                                        const double* benchmark_returns, size_t size) {
+    if (size == 0) {
+        return 0.0;
+    }
+    std::vector<double> excess(size);
+    SimdMath::subtract(portfolio_returns, benchmark_returns, excess.data(), size);
+    const double tracking_error = population_std(excess.data(), size);
+    return tracking_error > 0 ? mean_of(excess.data(), size) / tracking_error * std::sqrt(TRADING_DAYS) : 0.0;
+}
+
+double FinancialMath::calmar_ratio(const double* returns, size_t size) {
+    if (size == 0) {
+        return 0.0;
+    }
+    // 与 RiskCalculator::calculate_calmar_ratio 口径一致: 净值从 1 开始
+    std::vector<double> cumulative(size + 1);
+    cumulative[0] = 1.0;
+    for (size_t i = 0; i < size; ++i) {
+        cumulative[i + 1] = cumulative[i] * (1.0 + returns[i]);
+    }
+    const double annual_return =
+        std::pow(cumulative[size], TRADING_DAYS / static_cast<double>(size)) - 1.0;
+    const double max_dd = max_drawdown(cumulative.data(), cumulative.size());
+    return max_dd > 0 ? annual_return / max_dd : 0.0;
+}
+
+double FinancialMath::sortino_ratio(const double* returns, size_t size, double target_return) {
+    if (size == 0) {
+        return 0.0;
+    }
+    double downside_sq = 0.0;
+    size_t downside_count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (returns[i] < target_return) {
+            const double deviation = returns[i] - target_return;
+            downside_sq += deviation * deviation;
+            downside_count++;
+        }
+    }
+    const double downside_risk = downside_count > 0 ? std::sqrt(downside_sq / static_cast<double>(downside_count)) : 0.0;
+    const double excess_return = mean_of(returns, size) - target_return;
+    return downside_risk > 0 ? excess_return / downside_risk * std::sqrt(TRADING_DAYS) : 0.0;
+}
+
+} // namespace qaultra::simd
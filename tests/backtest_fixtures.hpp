@@ -0,0 +1,40 @@
+#pragma once
+
+#include "qaultra/engine/backtest_engine.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace qaultra::engine::fixtures {
+
+/**
+ * @brief 第 index 个交易日 (每月按 28 天排列)
+ */
+inline std::string day(int index) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "2024-%02d-%02d", 1 + index / 28, 1 + index % 28);
+    return buffer;
+}
+
+/**
+ * @brief 随机游走行情，代码为 S1000、S1001…
+ * @param staggered 为 true 时第 s 个标的从第 s 根开始上市
+ */
+inline std::vector<BarRecord> random_walk(size_t symbols, size_t bars, uint32_t seed, bool staggered = false) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> dist(0.0005, 0.02);
+    std::vector<BarRecord> records;
+    for (size_t s = 0; s < symbols; ++s) {
+        double price = 10.0 + static_cast<double>(s);
+        for (size_t t = staggered ? s : 0; t < bars; ++t) {
+            price *= 1.0 + dist(rng);
+            records.push_back({day(static_cast<int>(t)), "S" + std::to_string(1000 + s),
+                               price, price, price, price, 1000.0});
+        }
+    }
+    return records;
+}
+
+} // namespace qaultra::engine::fixtures
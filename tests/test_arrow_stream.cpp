@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "qaultra/ipc/arrow_stream.hpp"
+#include "qaultra/ipc/broadcast_transport.hpp"
+#include <string>
+#include <unistd.h>
+
+using namespace qaultra;
+using namespace qaultra::ipc;
+
+namespace {
+
+BroadcastConfig stream_config(size_t capacity) {
+    BroadcastConfig config;
+    config.transport = BroadcastTransport::SharedMemoryRing;
+    config.service_name = "arrow" + std::to_string(::getpid());
+    config.queue_capacity = capacity;
+    return config;
+}
+
+std::shared_ptr<arrow::Schema> bar_schema() {
+    return arrow::schema({arrow::field("instrument", ArrowStreamPublisher::instrument_type()),
+                          arrow::field("close", arrow::float64())});
+}
+
+std::vector<data::InstrumentId> intern_codes(const std::string& prefix, size_t count) {
+    std::vector<data::InstrumentId> ids;
+    for (size_t i = 0; i < count; ++i) {
+        ids.push_back(data::intern_instrument(prefix + std::to_string(i)));
+    }
+    return ids;
+}
+
+std::shared_ptr<arrow::RecordBatch> make_batch(ArrowStreamPublisher& pub,
+                                               const std::vector<data::InstrumentId>& ids) {
+    arrow::DoubleBuilder close;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        EXPECT_TRUE(close.Append(static_cast<double>(i) + 0.5).ok());
+    }
+    std::shared_ptr<arrow::Array> close_array;
+    EXPECT_TRUE(close.Finish(&close_array).ok());
+    return arrow::RecordBatch::Make(pub.schema(), static_cast<int64_t>(ids.size()),
+                                    {pub.instrument_column(ids), close_array});
+}
+
+std::string code_at(const arrow::RecordBatch& batch, int64_t row) {
+    const auto& column = static_cast<const arrow::DictionaryArray&>(*batch.column(0));
+    const auto& dictionary = static_cast<const arrow::StringArray&>(*column.dictionary());
+    return dictionary.GetString(column.GetValueIndex(row));
+}
+
+double close_at(const arrow::RecordBatch& batch, int64_t row) {
+    return static_cast<const arrow::DoubleArray&>(*batch.column(1)).Value(row);
+}
+
+} // namespace
+
+TEST(ArrowStreamTest, RoundTripSharesSchema) {
+    auto config = stream_config(16);
+    auto ids = intern_codes("AS_RT", 4);
+    ArrowStreamPublisher pub(config, "roundtrip", bar_schema());
+    ArrowStreamSubscriber sub(config, "roundtrip");
+    EXPECT_TRUE(sub.schema()->Equals(*pub.schema()));
+    EXPECT_EQ(sub.dictionary_length(), pub.dictionary_length());
+
+    ASSERT_TRUE(pub.publish(*make_batch(pub, ids)));
+    ASSERT_TRUE(pub.publish(*make_batch(pub, ids)));
+
+    size_t batches = 0;
+    while (sub.read([&](const std::shared_ptr<arrow::RecordBatch>& batch) {
+        ASSERT_EQ(batch->num_rows(), 4);
+        EXPECT_EQ(code_at(*batch, 2), "AS_RT2");
+        EXPECT_DOUBLE_EQ(close_at(*batch, 3), 3.5);
+        ++batches;
+    })) {}
+    EXPECT_EQ(batches, 2u);
+    EXPECT_EQ(sub.get_read_stats().rows_received, 8u);
+    EXPECT_EQ(pub.get_publish_stats().batches_sent, 2u);
+    EXPECT_EQ(pub.get_publish_stats().dictionary_deltas, 0u);
+}
+
+TEST(ArrowStreamTest, SendsDictionaryDeltaForNewCodes) {
+    auto config = stream_config(16);
+    intern_codes("AS_DD", 2);
+    ArrowStreamPublisher pub(config, "delta", bar_schema());
+    ArrowStreamSubscriber sub(config, "delta");
+
+    auto ids = intern_codes("AS_DD_NEW", 3);
+    ASSERT_TRUE(pub.publish(*make_batch(pub, ids)));
+    EXPECT_EQ(pub.get_publish_stats().dictionary_deltas, 1u);
+
+    std::string last_code;
+    ASSERT_TRUE(sub.read([&](const std::shared_ptr<arrow::RecordBatch>& batch) {
+        last_code = code_at(*batch, 2);
+    }));
+    EXPECT_EQ(last_code, "AS_DD_NEW2");
+    EXPECT_EQ(sub.get_read_stats().dictionary_deltas, 1u);
+    EXPECT_EQ(sub.dictionary_length(), pub.dictionary_length());
+}
+
+TEST(ArrowStreamTest, LateJoinerBootstrapsFromCatalog) {
+    auto config = stream_config(16);
+    ArrowStreamPublisher pub(config, "late", bar_schema());
+    auto ids = intern_codes("AS_LJ", 5);
+    ASSERT_TRUE(pub.publish(*make_batch(pub, ids)));
+
+    // 订阅者错过了 schema 与增量字典
+    ArrowStreamSubscriber sub(config, "late");
+    EXPECT_EQ(sub.dictionary_length(), pub.dictionary_length());
+    EXPECT_FALSE(sub.read([](const std::shared_ptr<arrow::RecordBatch>&) {}));
+
+    ASSERT_TRUE(pub.publish(*make_batch(pub, ids)));
+    std::string code;
+    ASSERT_TRUE(sub.read([&](const std::shared_ptr<arrow::RecordBatch>& batch) {
+        code = code_at(*batch, 4);
+    }));
+    EXPECT_EQ(code, "AS_LJ4");
+    EXPECT_EQ(sub.get_read_stats().dictionary_deltas, 0u);
+}
+
+TEST(ArrowStreamTest, LargeBatchIsFragmented) {
+    auto config = stream_config(16);
+    ArrowStreamPublisher pub(config, "large", bar_schema());
+    ArrowStreamSubscriber sub(config, "large");
+
+    auto codes = intern_codes("AS_LB", 8);
+    std::vector<data::InstrumentId> ids;
+    for (size_t i = 0; i < 20000; ++i) {
+        ids.push_back(codes[i % codes.size()]);
+    }
+    const uint64_t blocks_before = pub.ring().get_stats().blocks_sent;
+    ASSERT_TRUE(pub.publish(*make_batch(pub, ids)));
+    EXPECT_GT(pub.ring().get_stats().blocks_sent - blocks_before, 3u);
+
+    int64_t rows = 0;
+    ASSERT_TRUE(sub.read([&](const std::shared_ptr<arrow::RecordBatch>& batch) {
+        rows = batch->num_rows();
+        EXPECT_EQ(code_at(*batch, 19999), "AS_LB7");
+        EXPECT_DOUBLE_EQ(close_at(*batch, 19999), 19999.5);
+    }));
+    EXPECT_EQ(rows, 20000);
+}
+
+TEST(ArrowStreamTest, RejectsSchemaWithoutInstrumentColumn) {
+    auto config = stream_config(4);
+    auto schema = arrow::schema({arrow::field("close", arrow::float64())});
+    EXPECT_THROW(ArrowStreamPublisher(config, "invalid", schema), std::invalid_argument);
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include "qaultra/engine/backtest_engine.hpp"
+#include "qaultra/account/position.hpp"
+#include "qaultra/analysis/performance_analyzer.hpp"
+#include "backtest_fixtures.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace qaultra::engine;
+using namespace qaultra::engine::fixtures;
+
+namespace {
+
+BacktestConfig test_config() {
+    BacktestConfig config;
+    config.initial_cash = 100000.0;
+    config.enable_logging = false;
+    return config;
+}
+
+/**
+ * @brief 第 0 根买入 A，第 2 根卖出，并记录 B 的历史视图
+ */
+class ScriptedStrategy : public Strategy {
+public:
+    void initialize(StrategyContext& context) override {
+        initial_date = context.current_date;
+    }
+
+    void handle_data(StrategyContext& context) override {
+        if (context.bar_index == 0) {
+            EXPECT_TRUE(context.get_history(1, 5).empty());       // B 尚未上市
+            EXPECT_TRUE(context.buy("A", 100));
+            EXPECT_FALSE(context.sell(1, 100));                   // 无持仓
+        } else if (context.bar_index == 1) {
+            const auto position = context.get_position("A");
+            ASSERT_NE(position, nullptr);
+            EXPECT_EQ(position->volume_long_his, 100.0);
+            EXPECT_NEAR(position->position_price_long, 10.003, 1e-12);
+            EXPECT_EQ(context.get_position("B"), nullptr);
+            EXPECT_NEAR(context.get_cash(), 100000.0 - 1000.3, 1e-9);
+        } else if (context.bar_index == 2) {
+            history = context.get_history(1, 5);
+            volumes = context.get_history(1, 5, BarField::Volume);
+            EXPECT_DOUBLE_EQ(context.get_price("B"), 20.0);
+            EXPECT_TRUE(context.sell(0, 100));
+        }
+    }
+
+    std::map<std::string, double> get_parameters() const override { return {}; }
+    void set_parameter(const std::string&, double) override {}
+
+    std::string initial_date;
+    SeriesView history;
+    SeriesView volumes;
+};
+
+} // namespace
+
+TEST(BacktestEngineTest, PanelAlignsAndForwardFills) {
+    const std::vector<BarRecord> records = {
+        {"2024-01-03", "B", 20, 20, 20, 20, 500},
+        {"2024-01-02", "A", 10, 10, 10, 10, 100},
+        {"2024-01-03", "A", 11, 11, 11, 11, 100},
+        {"2024-01-04", "A", 12, 12, 12, 12, 100},
+        {"2024-01-05", "A", 13, 13, 13, 13, 100},
+        {"2024-01-05", "B", 22, 22, 22, 22, 500},
+    };
+    const BarPanel panel = BarPanel::from_records(records);
+    ASSERT_EQ(panel.bars(), 4u);
+    ASSERT_EQ(panel.symbol_count(), 2u);
+    EXPECT_EQ(panel.find_symbol("B"), 1u);
+    EXPECT_EQ(panel.find_symbol("C"), BarPanel::npos);
+    EXPECT_EQ(panel.first_bar[0], 0u);
+    EXPECT_EQ(panel.first_bar[1], 1u);
+
+    const double* close_b = panel.column(BarField::Close, 1);
+    EXPECT_EQ(close_b[0], 0.0);
+    EXPECT_EQ(close_b[2], 20.0);                                  // 停牌前值填充
+    EXPECT_EQ(panel.column(BarField::Volume, 1)[2], 0.0);
+    EXPECT_EQ(close_b[3], 22.0);
+    EXPECT_EQ(panel.close_rows[3 * 2 + 1], 22.0);
+
+    BacktestConfig config = test_config();
+    BacktestEngine engine(config);
+    ASSERT_TRUE(engine.load_bars(records));
+    auto strategy = std::make_shared<ScriptedStrategy>();
+    engine.add_strategy(strategy);
+    const BacktestResults results = engine.run();
+
+    EXPECT_EQ(strategy->initial_date, "2024-01-02");
+    // 零拷贝: 视图直接指向面板内存，且只覆盖上市以来的 bar
+    ASSERT_EQ(strategy->history.size(), 2u);
+    EXPECT_EQ(strategy->history.data(), engine.market_data().column(BarField::Close, 1) + 1);
+    EXPECT_EQ(strategy->history.back(), 20.0);
+    EXPECT_EQ(strategy->volumes[0], 500.0);
+
+    // 买入 100 股 @10 与卖出 100 股 @12，手续费均为成交额的万分之三
+    ASSERT_EQ(results.equity_curve.size(), 4u);
+    EXPECT_NEAR(results.equity_curve[0], 100000.0 - 0.3, 1e-9);
+    EXPECT_NEAR(results.equity_curve[1], 100000.0 - 0.3 + 100.0, 1e-9);
+    EXPECT_NEAR(results.equity_curve[2], 100000.0 - 0.3 + 200.0 - 0.36, 1e-9);
+    EXPECT_NEAR(results.final_value, results.equity_curve[2], 1e-9);
+    EXPECT_EQ(results.total_trades, 2);
+    EXPECT_DOUBLE_EQ(results.win_rate, 1.0);
+
+    const auto analysis = engine.get_trade_analysis();
+    ASSERT_EQ(analysis.at("realized_pnl").size(), 1u);
+    EXPECT_NEAR(analysis.at("realized_pnl")[0], 1200.0 - 0.36 - 1000.3, 1e-9);
+    EXPECT_EQ(engine.plot_equity_curve()[3].first, "2024-01-05");
+}
+
+TEST(BacktestEngineTest, BuiltinStrategiesAndMetrics) {
+    const auto records = random_walk(20, 250, 7);
+    for (auto strategy : {factory::create_sma_strategy(5, 20),
+                          factory::create_momentum_strategy(10, 0.02),
+                          factory::create_mean_reversion_strategy(20, 1.5)}) {
+        BacktestEngine engine(test_config());
+        ASSERT_TRUE(engine.load_bars(records));
+        engine.add_strategy(strategy);
+        const BacktestResults results = engine.run();
+
+        ASSERT_EQ(results.equity_curve.size(), 250u);
+        ASSERT_EQ(results.daily_returns.size(), 249u);
+        EXPECT_GT(results.total_trades, 0);
+        EXPECT_NEAR(results.total_return, results.final_value / 100000.0 - 1.0, 1e-15);
+        EXPECT_DOUBLE_EQ(results.sharpe_ratio, utils::calculate_sharpe_ratio(results.daily_returns));
+        EXPECT_NEAR(results.volatility,
+                    qaultra::analysis::RiskCalculator::calculate_volatility(results.daily_returns, true), 1e-12);
+        EXPECT_NEAR(results.max_drawdown,
+                    qaultra::analysis::RiskCalculator::calculate_max_drawdown(results.equity_curve), 1e-15);
+        EXPECT_GE(results.win_rate, 0.0);
+        EXPECT_LE(results.win_rate, 1.0);
+
+        // 重复运行从初始状态开始，结果一致
+        const BacktestResults again = engine.run();
+        EXPECT_EQ(again.equity_curve, results.equity_curve);
+        EXPECT_EQ(again.total_trades, results.total_trades);
+    }
+
+    // 盈亏比: 无亏损时为 +inf，无盈利时为 0
+    EXPECT_DOUBLE_EQ(utils::calculate_profit_factor({3.0, -1.0, 1.0, -1.0}), 2.0);
+    EXPECT_EQ(utils::calculate_profit_factor({1.0, 2.0}), std::numeric_limits<double>::infinity());
+    EXPECT_EQ(utils::calculate_profit_factor({-1.0}), 0.0);
+    EXPECT_EQ(utils::calculate_profit_factor({}), 0.0);
+
+    SMAStrategy sma;
+    sma.set_parameter("fast_window", 30);
+    EXPECT_EQ(sma.get_parameters().at("fast_window"), 30.0);
+    EXPECT_THROW(sma.set_parameter("unknown", 1.0), std::invalid_argument);
+
+    BacktestEngine engine(test_config());
+    ASSERT_TRUE(engine.load_bars(records));
+    engine.add_strategy(std::make_shared<SMAStrategy>(30, 20));
+    EXPECT_THROW(engine.run(), std::invalid_argument);
+    EXPECT_THROW(engine.add_strategy(nullptr), std::invalid_argument);
+}
+
+TEST(BacktestEngineTest, LoadsCsvWithDateRangeAndUniverse) {
+    const auto path = std::filesystem::temp_directory_path() /
+        ("qaultra_backtest_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + ".csv");
+    {
+        std::ofstream file(path);
+        file << "code,date,open,high,low,close,volume\r\n";
+        file << "000001,2023-12-29,9,9,9,9,1\r\n";
+        file << "000001,2024-01-02,10,10.5,9.5,10.2,100\r\n";
+        file << "000002,2024-01-02,5,5,5,5,100\r\n";
+        file << "600000,2024-01-02,8,8,8,8,100\r\n";
+        file << "000001,2024-01-03,10.2,10.8,10.1,10.6,120\r\n";
+    }
+
+    BacktestConfig config = test_config();
+    config.start_date = "2024-01-01";
+    BacktestEngine engine(config);
+    engine.set_universe({"000001", "000002"});
+    ASSERT_TRUE(engine.load_data(path.string()));
+    const BarPanel& panel = engine.market_data();
+    EXPECT_EQ(panel.dates, (std::vector<std::string>{"2024-01-02", "2024-01-03"}));
+    EXPECT_EQ(panel.symbols, (std::vector<std::string>{"000001", "000002"}));
+    EXPECT_EQ(panel.column(BarField::High, 0)[0], 10.5);
+    EXPECT_EQ(panel.column(BarField::Close, 0)[1], 10.6);
+    EXPECT_EQ(panel.column(BarField::Close, 1)[1], 5.0);
+
+    {
+        std::ofstream file(path);
+        file << "code,date,close\n000001,2024-01-02,10\n";
+    }
+    EXPECT_FALSE(engine.load_data(path.string()));
+    std::filesystem::remove(path);
+    EXPECT_FALSE(engine.load_data(path.string()));
+}
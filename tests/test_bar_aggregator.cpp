@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include "qaultra/data/bar_aggregator.hpp"
+#include "qaultra/ipc/cross_lang_data.hpp"
+#include <vector>
+
+using namespace qaultra::data;
+
+namespace {
+
+constexpr int64_t NS = 1000000000LL;
+
+AggregatorTick make_tick(InstrumentId id, int64_t ts, double price, double cum_volume) {
+    AggregatorTick tick;
+    tick.instrument_id = id;
+    tick.timestamp_ns = ts;
+    tick.last_price = price;
+    tick.volume = cum_volume;
+    tick.amount = cum_volume * price;
+    return tick;
+}
+
+} // namespace
+
+class BarAggregatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        aggregator.set_publisher([this](const BarCrossSection& section) {
+            sections.push_back(section);
+        });
+        a = intern_instrument("AGG.A");
+        b = intern_instrument("AGG.B");
+        base = BarAggregator::parse_datetime("2024-01-02 09:30:00");
+    }
+
+    std::vector<BarCrossSection> finals(BarPeriod period) const {
+        std::vector<BarCrossSection> result;
+        for (const auto& section : sections) {
+            if (section.period == period && section.final) {
+                result.push_back(section);
+            }
+        }
+        return result;
+    }
+
+    BarAggregator aggregator;
+    std::vector<BarCrossSection> sections;
+    InstrumentId a = 0;
+    InstrumentId b = 0;
+    int64_t base = 0;
+};
+
+TEST_F(BarAggregatorTest, ParseDatetime) {
+    EXPECT_EQ(BarAggregator::parse_datetime("1970-01-01 00:00:00"), 0);
+    EXPECT_EQ(BarAggregator::parse_datetime("1970-01-02"), 86400 * NS);
+    EXPECT_EQ(BarAggregator::parse_datetime("2024-01-02 09:30:00.5"),
+              BarAggregator::parse_datetime("2024-01-02 09:30:00") + NS / 2);
+    EXPECT_EQ(BarAggregator::parse_datetime("2000-03-01 00:00:00"), 951868800LL * NS);
+    EXPECT_EQ(BarAggregator::parse_datetime("bad"), 0);
+}
+
+TEST_F(BarAggregatorTest, OneMinuteBarsCloseOnBoundary) {
+    aggregator.update(make_tick(a, base + 1 * NS, 10.0, 100));
+    aggregator.update(make_tick(a, base + 20 * NS, 10.5, 150));
+    aggregator.update(make_tick(b, base + 30 * NS, 20.0, 10));
+    aggregator.update(make_tick(a, base + 40 * NS, 9.8, 200));
+    EXPECT_TRUE(finals(BarPeriod::Min1).empty());
+
+    // 进入下一分钟，上一分钟截面发布
+    aggregator.update(make_tick(a, base + 61 * NS, 10.1, 260));
+
+    auto closed = finals(BarPeriod::Min1);
+    ASSERT_EQ(closed.size(), 1u);
+    EXPECT_EQ(closed[0].timestamp_ns, base);
+    ASSERT_EQ(closed[0].bars->size(), 2u);
+
+    const Kline& bar = closed[0].bars->at(a);
+    EXPECT_DOUBLE_EQ(bar.open, 10.0);
+    EXPECT_DOUBLE_EQ(bar.high, 10.5);
+    EXPECT_DOUBLE_EQ(bar.low, 9.8);
+    EXPECT_DOUBLE_EQ(bar.close, 9.8);
+    EXPECT_DOUBLE_EQ(bar.volume, 200.0);   // 累计量 200 (自开盘)
+    EXPECT_EQ(bar.order_book_id(), "AGG.A");
+
+    auto current = aggregator.current_bar(a, BarPeriod::Min1);
+    ASSERT_TRUE(current.has_value());
+    EXPECT_DOUBLE_EQ(current->volume, 60.0);
+}
+
+TEST_F(BarAggregatorTest, HigherPeriodsAndPartialDaily) {
+    for (int minute = 0; minute < 6; ++minute) {
+        aggregator.update(make_tick(a, base + minute * 60 * NS, 10.0 + minute, 100.0 * (minute + 1)));
+    }
+
+    EXPECT_EQ(finals(BarPeriod::Min1).size(), 5u);
+    auto five = finals(BarPeriod::Min5);
+    ASSERT_EQ(five.size(), 1u);
+    const Kline& bar = five[0].bars->at(a);
+    EXPECT_DOUBLE_EQ(bar.open, 10.0);
+    EXPECT_DOUBLE_EQ(bar.high, 14.0);
+    EXPECT_DOUBLE_EQ(bar.close, 14.0);
+    EXPECT_DOUBLE_EQ(bar.volume, 500.0);
+
+    // 每根1分钟收盘时发布盘中日线快照
+    size_t partial = 0;
+    for (const auto& section : sections) {
+        if (section.period == BarPeriod::Day && !section.final) {
+            partial++;
+        }
+    }
+    EXPECT_EQ(partial, 5u);
+    EXPECT_TRUE(finals(BarPeriod::Day).empty());
+
+    aggregator.flush_all();
+    auto day = finals(BarPeriod::Day);
+    ASSERT_EQ(day.size(), 1u);
+    EXPECT_DOUBLE_EQ(day[0].bars->at(a).volume, 600.0);
+    EXPECT_DOUBLE_EQ(day[0].bars->at(a).high, 15.0);
+}
+
+TEST_F(BarAggregatorTest, LateTicksAreIgnored) {
+    aggregator.update(make_tick(a, base + 61 * NS, 10.0, 100));
+    aggregator.update(make_tick(a, base + 1 * NS, 99.0, 120));
+
+    EXPECT_EQ(aggregator.get_stats().late_ticks, 1u);
+    auto current = aggregator.current_bar(a, BarPeriod::Min1);
+    ASSERT_TRUE(current.has_value());
+    EXPECT_DOUBLE_EQ(current->high, 10.0);
+
+    // 对1分钟迟到的 Tick 也不进入仍在进行中的5分钟K线
+    auto five = aggregator.current_bar(a, BarPeriod::Min5);
+    ASSERT_TRUE(five.has_value());
+    EXPECT_DOUBLE_EQ(five->high, 10.0);
+    EXPECT_DOUBLE_EQ(five->volume, 100.0);
+
+    // 迟到 Tick 的累计量不生效，增量计入下一个 Tick
+    aggregator.update(make_tick(a, base + 62 * NS, 10.0, 130));
+    EXPECT_DOUBLE_EQ(aggregator.current_bar(a, BarPeriod::Min1)->volume, 130.0);
+}
+
+TEST_F(BarAggregatorTest, FlushClosesIdlePeriods) {
+    aggregator.update(make_tick(a, base, 10.0, 100));
+    aggregator.flush(base + 30 * NS);
+    EXPECT_TRUE(finals(BarPeriod::Min1).empty());
+
+    aggregator.flush(base + 60 * NS);
+    EXPECT_EQ(finals(BarPeriod::Min1).size(), 1u);
+
+    // 已 flush 的周期内再到达的 Tick 按迟到处理，不会修改已发布的K线
+    aggregator.update(make_tick(a, base + 50 * NS, 12.0, 105));
+    EXPECT_EQ(aggregator.get_stats().late_ticks, 1u);
+    EXPECT_FALSE(aggregator.current_bar(a, BarPeriod::Min1).has_value());
+    EXPECT_DOUBLE_EQ(finals(BarPeriod::Min1)[0].bars->at(a).high, 10.0);
+
+    // 再次推进不会重复发布空截面
+    aggregator.update(make_tick(a, base + 121 * NS, 10.0, 110));
+    EXPECT_EQ(finals(BarPeriod::Min1).size(), 1u);
+}
+
+TEST_F(BarAggregatorTest, AcceptsProtocolTicks) {
+    qaultra::protocol::mifi::Tick tick;
+    tick.instrument_id = "AGG.MIFI";
+    tick.datetime = "2024-01-02 09:30:05";
+    tick.last_price = 5.0;
+    tick.volume = 10;
+    aggregator.update(tick);
+
+    qaultra::ipc::MarketTick raw;
+    std::strncpy(raw.symbol, "AGG.RAW", sizeof(raw.symbol) - 1);
+    raw.timestamp_ns = base + 6 * NS;
+    raw.last_price = 7.0;
+    raw.volume = 3;
+    aggregator.update(raw);
+
+    auto mifi_bar = aggregator.current_bar(intern_instrument("AGG.MIFI"), BarPeriod::Min1);
+    auto raw_bar = aggregator.current_bar(intern_instrument("AGG.RAW"), BarPeriod::Min1);
+    ASSERT_TRUE(mifi_bar.has_value());
+    ASSERT_TRUE(raw_bar.has_value());
+    EXPECT_DOUBLE_EQ(mifi_bar->close, 5.0);
+    EXPECT_DOUBLE_EQ(raw_bar->volume, 3.0);
+}
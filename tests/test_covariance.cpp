@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include "qaultra/analysis/covariance.hpp"
+#include "qaultra/simd/simd_math.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace qaultra::analysis;
+using qaultra::simd::FinancialMath;
+
+namespace {
+
+// 带公共因子的收益率矩阵 (periods × series)，第 0 个标的恒为 0 (停牌)
+std::vector<double> random_returns(size_t periods, size_t series, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> dist(0.0, 0.01);
+    std::vector<double> returns(periods * series);
+    for (size_t t = 0; t < periods; ++t) {
+        const double factor = dist(rng);
+        for (size_t s = 0; s < series; ++s) {
+            returns[t * series + s] = s == 0 ? 0.0 : 0.0003 * static_cast<double>(s % 5) + factor * (s % 3) + dist(rng);
+        }
+    }
+    return returns;
+}
+
+double naive_covariance(const std::vector<double>& returns, size_t begin, size_t end, size_t series,
+                        size_t i, size_t j, bool sample) {
+    double mean_i = 0.0;
+    double mean_j = 0.0;
+    for (size_t t = begin; t < end; ++t) {
+        mean_i += returns[t * series + i];
+        mean_j += returns[t * series + j];
+    }
+    const double n = static_cast<double>(end - begin);
+    mean_i /= n;
+    mean_j /= n;
+    double total = 0.0;
+    for (size_t t = begin; t < end; ++t) {
+        total += (returns[t * series + i] - mean_i) * (returns[t * series + j] - mean_j);
+    }
+    return total / (sample ? n - 1.0 : n);
+}
+
+} // namespace
+
+TEST(CovarianceTest, PackedLayout) {
+    PackedSymmetricMatrix matrix(4);
+    EXPECT_EQ(matrix.size(), 10u);
+    EXPECT_EQ(matrix.index(0, 0), 0u);
+    EXPECT_EQ(matrix.index(1, 1), 4u);
+    EXPECT_EQ(matrix.index(3, 2), matrix.index(2, 3));
+    EXPECT_EQ(matrix.index(3, 3), 9u);
+    matrix(2, 1) = 5.0;
+    EXPECT_EQ(matrix(1, 2), 5.0);
+    EXPECT_EQ(matrix.row(1)[1], 5.0);
+    const auto dense = matrix.to_dense();
+    EXPECT_EQ(dense[1 * 4 + 2], 5.0);
+    EXPECT_EQ(dense[2 * 4 + 1], 5.0);
+}
+
+TEST(CovarianceTest, BatchMatchesPairwise) {
+    constexpr size_t T = 120;
+    constexpr size_t N = 150;                // 非 block_size 整数倍
+    const auto returns = random_returns(T, N, 7);
+
+    CovarianceOptions options;
+    options.threads = 1;
+    options.block_size = 32;
+    const PackedSymmetricMatrix cov = covariance_matrix(returns.data(), T, N, options);
+    for (size_t i = 0; i < N; i += 7) {
+        for (size_t j = 0; j < N; j += 11) {
+            ASSERT_NEAR(cov(i, j), naive_covariance(returns, 0, T, N, i, j, false), 1e-15) << i << "," << j;
+        }
+    }
+
+    // 多线程、不同分块结果逐位一致
+    options.threads = 4;
+    options.block_size = 64;
+    const PackedSymmetricMatrix threaded = covariance_matrix(returns.data(), T, N, options);
+    for (size_t k = 0; k < cov.size(); ++k) {
+        ASSERT_EQ(cov.data()[k], threaded.data()[k]);
+    }
+
+    options.sample = true;
+    const PackedSymmetricMatrix sample = covariance_matrix(returns.data(), T, N, options);
+    EXPECT_NEAR(sample(3, 8), naive_covariance(returns, 0, T, N, 3, 8, true), 1e-15);
+
+    // 相关系数与 FinancialMath::correlation 一致，常数序列所在行列为 0
+    const PackedSymmetricMatrix corr = correlation_matrix(cov);
+    std::vector<double> x(T);
+    std::vector<double> y(T);
+    for (size_t t = 0; t < T; ++t) {
+        x[t] = returns[t * N + 4];
+        y[t] = returns[t * N + 10];
+    }
+    EXPECT_NEAR(corr(4, 10), FinancialMath::correlation(x.data(), y.data(), T), 1e-12);
+    EXPECT_EQ(corr(5, 5), 1.0);
+    EXPECT_EQ(corr(0, 0), 0.0);
+    EXPECT_EQ(corr(0, 9), 0.0);
+}
+
+TEST(CovarianceTest, QuadraticFormMatchesPortfolioVariance) {
+    constexpr size_t T = 80;
+    constexpr size_t N = 37;
+    constexpr size_t PORTFOLIOS = 9;
+    const auto returns = random_returns(T, N, 3);
+    const PackedSymmetricMatrix cov = covariance_matrix(returns.data(), T, N);
+    const auto dense = cov.to_dense();
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<double> weights(PORTFOLIOS * N);
+    for (double& w : weights) {
+        w = dist(rng);
+    }
+
+    std::vector<double> variances(PORTFOLIOS);
+    quadratic_forms(cov, weights.data(), PORTFOLIOS, variances.data(), 3);
+    for (size_t p = 0; p < PORTFOLIOS; ++p) {
+        const double expected = FinancialMath::portfolio_variance(weights.data() + p * N, dense.data(), N);
+        EXPECT_NEAR(variances[p], expected, 1e-12 * std::abs(expected));
+        EXPECT_EQ(variances[p], quadratic_form(cov, weights.data() + p * N));
+    }
+}
+
+TEST(CovarianceTest, EwmaMatchesRecursion) {
+    constexpr size_t T = 60;
+    constexpr size_t N = 9;
+    constexpr double LAMBDA = 0.94;
+    const auto returns = random_returns(T, N, 5);
+
+    EwmaCovariance ewma(N, LAMBDA);
+    std::vector<double> mean(returns.begin(), returns.begin() + N);
+    std::vector<double> cov(N * N, 0.0);
+    ewma.update(returns.data());
+    for (size_t t = 1; t < T; ++t) {
+        const double* x = returns.data() + t * N;
+        ewma.update(x);
+        std::vector<double> d(N);
+        for (size_t i = 0; i < N; ++i) {
+            d[i] = x[i] - mean[i];
+            mean[i] += (1.0 - LAMBDA) * d[i];
+        }
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                cov[i * N + j] = LAMBDA * (cov[i * N + j] + (1.0 - LAMBDA) * d[i] * d[j]);
+            }
+        }
+    }
+
+    EXPECT_EQ(ewma.count(), T);
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_NEAR(ewma.mean()[i], mean[i], 1e-15);
+        for (size_t j = i; j < N; ++j) {
+            EXPECT_NEAR(ewma.covariance()(i, j), cov[i * N + j], 1e-16);
+        }
+    }
+
+    ewma.reset();
+    EXPECT_EQ(ewma.count(), 0u);
+    EXPECT_EQ(ewma.covariance()(1, 2), 0.0);
+    EXPECT_THROW(EwmaCovariance(N, 1.0), std::invalid_argument);
+    EXPECT_THROW(EwmaCovariance(0, 0.9), std::invalid_argument);
+}
+
+TEST(CovarianceTest, RollingMatchesBatchWindow) {
+    constexpr size_t T = 130;
+    constexpr size_t N = 23;
+    constexpr size_t WINDOW = 20;
+    const auto returns = random_returns(T, N, 13);
+
+    CovarianceOptions options;
+    options.sample = true;
+    RollingCovariance rolling(N, WINDOW, options);
+    PackedSymmetricMatrix cov;
+    for (size_t t = 0; t < T; ++t) {
+        rolling.update(returns.data() + t * N);
+        if (t == 0) {
+            continue;
+        }
+        // 预热阶段、重算前后均与窗口内直接计算一致
+        const size_t begin = t + 1 > WINDOW ? t + 1 - WINDOW : 0;
+        rolling.covariance(cov);
+        ASSERT_EQ(cov.dimension(), N);
+        for (size_t i = 0; i < N; i += 4) {
+            for (size_t j = i; j < N; j += 3) {
+                ASSERT_NEAR(cov(i, j), naive_covariance(returns, begin, t + 1, N, i, j, true), 1e-14)
+                    << "t=" << t << " (" << i << "," << j << ")";
+            }
+        }
+    }
+    EXPECT_TRUE(rolling.full());
+
+    // 满窗口时与批量结果一致
+    const PackedSymmetricMatrix batch = covariance_matrix(returns.data() + (T - WINDOW) * N, WINDOW, N, options);
+    for (size_t k = 0; k < batch.size(); ++k) {
+        ASSERT_NEAR(cov.data()[k], batch.data()[k], 1e-14);
+    }
+
+    rolling.reset();
+    EXPECT_EQ(rolling.count(), 0u);
+    EXPECT_THROW(RollingCovariance(N, 0), std::invalid_argument);
+}
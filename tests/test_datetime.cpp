@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "qaultra/util/datetime.hpp"
+#include "qaultra/protocol/mifi.hpp"
+#include <cstdio>
+
+using namespace qaultra::util::datetime;
+
+namespace {
+
+constexpr int64_t NS = NANOS_PER_SECOND;
+
+std::string reference_date(int64_t days) {
+    int year = 0;
+    unsigned month = 0, day = 0;
+    // 公式版本作为参照
+    int64_t z = days + 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(yoe + era * 400 + (month <= 2));
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u", year, month, day);
+    return buffer;
+}
+
+} // namespace
+
+TEST(DatetimeTest, DateRoundTripMatchesReference) {
+    // 1899..2160: 覆盖查表区间两端与公式回退
+    const int64_t first = days_from_civil(1899, 1, 1);
+    const int64_t last = days_from_civil(2160, 12, 31);
+    for (int64_t days = first; days <= last; ++days) {
+        const std::string text = reference_date(days);
+        ASSERT_EQ(format_date(days), text);
+        int64_t parsed = 0;
+        ASSERT_TRUE(parse_date_days(text, parsed)) << text;
+        ASSERT_EQ(parsed, days) << text;
+    }
+}
+
+TEST(DatetimeTest, ParsesDatetimeVariants) {
+    EXPECT_EQ(parse_datetime_nanos("1970-01-01 00:00:00"), 0);
+    EXPECT_EQ(parse_datetime_nanos("1970-01-02"), 86400 * NS);
+    EXPECT_EQ(parse_datetime_nanos("2000-03-01 00:00:00"), 951868800LL * NS);
+    EXPECT_EQ(parse_datetime_nanos("2024-01-02T09:30:00"), parse_datetime_nanos("2024-01-02 09:30:00"));
+    EXPECT_EQ(parse_datetime_nanos("2024-01-02 09:30:00.000123"),
+              parse_datetime_nanos("2024-01-02 09:30:00") + 123000);
+    EXPECT_EQ(parse_datetime_nanos("2024-01-02 23:59:59"),
+              parse_datetime_nanos("2024-01-03") - NS);
+}
+
+TEST(DatetimeTest, RejectsMalformedInput) {
+    int64_t value = 0;
+    EXPECT_FALSE(parse_datetime_nanos("", value));
+    EXPECT_FALSE(parse_datetime_nanos("bad", value));
+    EXPECT_FALSE(parse_datetime_nanos("2024/01/02", value));
+    EXPECT_FALSE(parse_datetime_nanos("2024-13-02", value));
+    EXPECT_FALSE(parse_datetime_nanos("2024-01-0x", value));
+    EXPECT_FALSE(parse_datetime_nanos("2024-01-02 09-30-00", value));
+    EXPECT_FALSE(parse_datetime_nanos("2024-01-02 09:3a:00", value));
+    EXPECT_FALSE(parse_datetime_nanos("2024-01-02 09:30", value));
+    EXPECT_FALSE(parse_datetime_nanos("2024-01-02 24:00:00", value));
+    EXPECT_FALSE(parse_datetime_nanos("2024-01-02 09:60:00", value));
+    EXPECT_FALSE(parse_datetime_nanos("2024-01-02 09:30:61", value));
+    EXPECT_TRUE(parse_datetime_nanos("2024-12-31 23:59:60", value));   // 闰秒
+    EXPECT_FALSE(parse_datetime_nanos("2\xB0""24-01-02", value));
+    EXPECT_EQ(parse_datetime_nanos("bad"), 0);
+}
+
+TEST(DatetimeTest, FormatsDatetime) {
+    const int64_t ts = parse_datetime_nanos("2024-02-29 14:05:09.5");
+    EXPECT_EQ(format_datetime(ts), "2024-02-29 14:05:09");
+    EXPECT_EQ(format_datetime(ts, 'T'), "2024-02-29T14:05:09");
+    EXPECT_EQ(format_datetime(-NS), "1969-12-31 23:59:59");
+    EXPECT_EQ(days_from_nanos(-1), -1);
+    EXPECT_EQ(days_from_nanos(ts), days_from_civil(2024, 2, 29));
+}
+
+TEST(DatetimeTest, StandardizeMifiDatetime) {
+    using qaultra::protocol::mifi::utils::standardize_datetime;
+    EXPECT_EQ(standardize_datetime("2024-01-02 09:30:00"), "2024-01-02T09:30:00");
+    EXPECT_EQ(standardize_datetime("2024-01-02T09:30:00"), "2024-01-02T09:30:00");
+    EXPECT_EQ(standardize_datetime("2024-01-02"), "2024-01-02");
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "qaultra/analysis/incremental_indicators.hpp"
+#include "qaultra/simd/simd_math.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace qaultra::analysis;
+using qaultra::simd::SimdMath;
+
+namespace {
+
+constexpr size_t SERIES = 11;
+constexpr size_t LENGTH = 300;
+
+// 时间主序的价格面板 [t * SERIES + s]，第 0 列为常数
+std::vector<double> price_panel(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> dist(0.0005, 0.02);
+    std::vector<double> panel(LENGTH * SERIES);
+    for (size_t s = 0; s < SERIES; ++s) {
+        double price = 10.0 + static_cast<double>(s);
+        for (size_t t = 0; t < LENGTH; ++t) {
+            if (s > 0) {
+                price *= 1.0 + dist(rng);
+            }
+            panel[t * SERIES + s] = price;
+        }
+    }
+    return panel;
+}
+
+std::vector<double> column(const std::vector<double>& panel, size_t s) {
+    std::vector<double> values(LENGTH);
+    for (size_t t = 0; t < LENGTH; ++t) {
+        values[t] = panel[t * SERIES + s];
+    }
+    return values;
+}
+
+// NaN 与 NaN 视为相等
+void expect_close(double actual, double expected, double tolerance) {
+    if (std::isnan(expected)) {
+        ASSERT_TRUE(std::isnan(actual));
+    } else {
+        ASSERT_NEAR(actual, expected, tolerance * std::max(1.0, std::abs(expected)));
+    }
+}
+
+} // namespace
+
+TEST(IncrementalIndicatorsTest, MatchesArrayIndicators) {
+    const std::vector<double> panel = price_panel(3);
+    std::vector<std::vector<double>> sma(SERIES), ema(SERIES), rsi(SERIES), macd(SERIES), signal(SERIES),
+        hist(SERIES), upper(SERIES), lower(SERIES);
+    for (size_t s = 0; s < SERIES; ++s) {
+        const std::vector<double> prices = column(panel, s);
+        for (auto* out : {&sma, &ema, &rsi, &macd, &signal, &hist, &upper, &lower}) {
+            (*out)[s].resize(LENGTH);
+        }
+        SimdMath::moving_average(prices.data(), sma[s].data(), LENGTH, 7);
+        SimdMath::ema(prices.data(), ema[s].data(), LENGTH, 2.0 / 11.0);
+        SimdMath::rsi(prices.data(), rsi[s].data(), LENGTH, 14);
+        SimdMath::macd(prices.data(), macd[s].data(), signal[s].data(), hist[s].data(), LENGTH, 12, 26, 9);
+        SimdMath::bollinger_bands(prices.data(), upper[s].data(), lower[s].data(), LENGTH, 20, 2.0);
+    }
+
+    IncrementalSMA inc_sma(SERIES, 7);
+    IncrementalEMA inc_ema = IncrementalEMA::from_period(SERIES, 10);
+    IncrementalRSI inc_rsi(SERIES, 14);
+    IncrementalMACD inc_macd(SERIES, 12, 26, 9);
+    IncrementalBollinger inc_bb(SERIES, 20, 2.0);
+    for (size_t t = 0; t < LENGTH; ++t) {
+        const double* row = panel.data() + t * SERIES;
+        inc_sma.update(row);
+        inc_ema.update(row);
+        inc_rsi.update(row);
+        inc_macd.update(row);
+        inc_bb.update(row);
+        EXPECT_EQ(inc_sma.ready(), t + 1 >= 7);
+        EXPECT_EQ(inc_rsi.ready(), t >= 14);
+        for (size_t s = 0; s < SERIES; ++s) {
+            expect_close(inc_sma.value()[s], sma[s][t], 1e-12);
+            expect_close(inc_ema.value()[s], ema[s][t], 1e-14);
+            expect_close(inc_rsi.value()[s], rsi[s][t], 1e-12);
+            expect_close(inc_macd.macd()[s], macd[s][t], 1e-14);
+            expect_close(inc_macd.signal()[s], signal[s][t], 1e-14);
+            expect_close(inc_macd.histogram()[s], hist[s][t], 1e-14);
+            expect_close(inc_bb.upper()[s], upper[s][t], 1e-10);
+            expect_close(inc_bb.lower()[s], lower[s][t], 1e-10);
+        }
+    }
+    EXPECT_EQ(inc_rsi.value()[0], 100.0);                         // 常数序列无下跌
+    EXPECT_EQ(inc_bb.upper()[0], inc_bb.middle()[0]);
+
+    inc_sma.reset();
+    EXPECT_FALSE(inc_sma.ready());
+    EXPECT_TRUE(std::isnan(inc_sma.value()[1]));
+}
+
+TEST(IncrementalIndicatorsTest, AtrAndZScoreMatchNaive) {
+    const std::vector<double> close = price_panel(5);
+    std::vector<double> high(close.size()), low(close.size());
+    for (size_t i = 0; i < close.size(); ++i) {
+        high[i] = close[i] * (1.0 + 0.01 * static_cast<double>(i % 3));
+        low[i] = close[i] * (1.0 - 0.01 * static_cast<double>(i % 5));
+    }
+
+    constexpr size_t PERIOD = 14;
+    constexpr size_t WINDOW = 20;
+    IncrementalATR atr(SERIES, PERIOD);
+    IncrementalZScore z_score(SERIES, WINDOW);
+    for (size_t t = 0; t < LENGTH; ++t) {
+        const size_t offset = t * SERIES;
+        atr.update(high.data() + offset, low.data() + offset, close.data() + offset);
+        z_score.update(close.data() + offset);
+        EXPECT_EQ(atr.ready(), t + 1 >= PERIOD);
+        EXPECT_EQ(z_score.ready(), t + 1 >= WINDOW);
+
+        for (size_t s = 0; s < SERIES; ++s) {
+            // 参考实现: 逐根重算真实波幅与 Wilder 平滑
+            double expected_atr = 0.0;
+            for (size_t i = 0; i <= t; ++i) {
+                const size_t k = i * SERIES + s;
+                double tr = high[k] - low[k];
+                if (i > 0) {
+                    const double pc = close[k - SERIES];
+                    tr = std::max({tr, std::abs(high[k] - pc), std::abs(low[k] - pc)});
+                }
+                if (i < PERIOD) {
+                    expected_atr += tr;
+                    if (i + 1 == PERIOD) expected_atr /= PERIOD;
+                } else {
+                    expected_atr = (expected_atr * (PERIOD - 1) + tr) / PERIOD;
+                }
+            }
+            expect_close(atr.value()[s], t + 1 >= PERIOD ? expected_atr : NAN, 1e-12);
+
+            if (t + 1 < WINDOW) {
+                ASSERT_TRUE(std::isnan(z_score.value()[s]));
+                continue;
+            }
+            const double* window = close.data();
+            double mean = 0.0, ss = 0.0;
+            for (size_t i = t + 1 - WINDOW; i <= t; ++i) mean += window[i * SERIES + s];
+            mean /= WINDOW;
+            for (size_t i = t + 1 - WINDOW; i <= t; ++i) {
+                ss += (window[i * SERIES + s] - mean) * (window[i * SERIES + s] - mean);
+            }
+            const double stddev = std::sqrt(ss / WINDOW);
+            const double expected = stddev > 0.0 ? (close[t * SERIES + s] - mean) / stddev : 0.0;
+            ASSERT_NEAR(z_score.value()[s], expected, 1e-8);
+        }
+    }
+    EXPECT_EQ(z_score.value()[0], 0.0);                           // 常数列标准差为 0
+
+    EXPECT_THROW(IncrementalSMA(0, 5), std::invalid_argument);
+    EXPECT_THROW(IncrementalEMA(3, 0.0), std::invalid_argument);
+    EXPECT_THROW(IncrementalMACD(3, 12, 0, 9), std::invalid_argument);
+    EXPECT_THROW(IncrementalATR(3, 0), std::invalid_argument);
+    EXPECT_THROW(IncrementalZScore(3, 0), std::invalid_argument);
+}
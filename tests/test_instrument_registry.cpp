@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "qaultra/data/instrument_registry.hpp"
+#include "qaultra/data/datatype.hpp"
+#include <thread>
+#include <vector>
+
+using namespace qaultra::data;
+
+TEST(InstrumentRegistryTest, InternIsStable) {
+    InstrumentRegistry registry;
+
+    auto a = registry.intern("000001.XSHE");
+    auto b = registry.intern("600000.XSHG");
+
+    EXPECT_EQ(a, 0u);
+    EXPECT_EQ(b, 1u);
+    EXPECT_EQ(registry.intern("000001.XSHE"), a);
+    EXPECT_EQ(registry.size(), 2u);
+
+    EXPECT_EQ(registry.code(a), "000001.XSHE");
+    EXPECT_EQ(registry.code(b), "600000.XSHG");
+    EXPECT_EQ(registry.find("600000.XSHG"), b);
+}
+
+TEST(InstrumentRegistryTest, UnknownCodes) {
+    InstrumentRegistry registry;
+
+    EXPECT_EQ(registry.find("999999.XSHE"), INVALID_INSTRUMENT_ID);
+    EXPECT_EQ(registry.code(INVALID_INSTRUMENT_ID), "");
+    EXPECT_EQ(registry.code(42), "");
+    EXPECT_EQ(intern_instrument(""), INVALID_INSTRUMENT_ID);
+}
+
+TEST(InstrumentRegistryTest, GrowsAcrossSegments) {
+    InstrumentRegistry registry;
+
+    const int count = 10000;
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(registry.intern("CODE" + std::to_string(i)), static_cast<InstrumentId>(i));
+    }
+    for (int i = 0; i < count; i += 997) {
+        EXPECT_EQ(registry.code(static_cast<InstrumentId>(i)), "CODE" + std::to_string(i));
+    }
+}
+
+TEST(InstrumentRegistryTest, ConcurrentIntern) {
+    InstrumentRegistry registry;
+
+    const int threads = 4;
+    const int codes = 2000;
+    std::vector<std::vector<InstrumentId>> results(threads);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < codes; ++i) {
+                results[t].push_back(registry.intern("SYM" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(registry.size(), static_cast<size_t>(codes));
+    for (int t = 1; t < threads; ++t) {
+        EXPECT_EQ(results[t], results[0]);
+    }
+    for (int i = 0; i < codes; ++i) {
+        EXPECT_EQ(registry.code(results[0][i]), "SYM" + std::to_string(i));
+    }
+}
+
+TEST(InstrumentRegistryTest, KlineCarriesInstrumentId) {
+    Kline kline("000001.XSHE", 10.0, 10.5, 10.8, 9.9, 1000.0, 11.0, 9.0, 10250.0);
+
+    EXPECT_EQ(kline.instrument_id, InstrumentRegistry::instance().find("000001.XSHE"));
+    EXPECT_EQ(kline.order_book_id(), "000001.XSHE");
+
+    auto restored = Kline::from_json(kline.to_json());
+    EXPECT_EQ(restored.instrument_id, kline.instrument_id);
+    EXPECT_EQ(restored, kline);
+
+    KlineMap bars;
+    bars[kline.instrument_id] = kline;
+    EXPECT_EQ(bars.count(intern_instrument("000001.XSHE")), 1u);
+}
+
+TEST(InstrumentRegistryTest, StockBarsShareIds) {
+    StockCnDay day(Date(2024, 1, 2), "600000.XSHG", 100, 11.0, 9.0, 10.0, 10.5, 9.8, 10.2, 1e6, 1e7);
+    StockCn1Min minute(std::chrono::system_clock::time_point{}, "600000.XSHG",
+                       10.0, 10.1, 9.9, 10.05, 1e4, 1e5);
+
+    EXPECT_EQ(day.instrument_id, minute.instrument_id);
+    EXPECT_EQ(day.order_book_id(), "600000.XSHG");
+    EXPECT_EQ(StockCnDay::from_json(day.to_json()).instrument_id, day.instrument_id);
+}
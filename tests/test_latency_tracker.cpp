@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "qaultra/ipc/latency_tracker.hpp"
+#include "qaultra/ipc/shm_ring.hpp"
+#include <string>
+#include <unistd.h>
+
+using namespace qaultra::ipc;
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100; ++value) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.count(), 100u);
+    EXPECT_EQ(histogram.min(), 1u);
+    EXPECT_EQ(histogram.max(), 100u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 50.5);
+    EXPECT_EQ(histogram.value_at_percentile(50.0), 50u);
+    EXPECT_EQ(histogram.value_at_percentile(99.0), 99u);
+    EXPECT_EQ(histogram.value_at_percentile(100.0), 100u);
+}
+
+TEST(LatencyHistogramTest, LargeValuesWithinRelativeError) {
+    LatencyHistogram histogram;
+    for (uint64_t i = 1; i <= 10000; ++i) {
+        histogram.record(i * 1000);
+    }
+    const auto within = [](uint64_t actual, uint64_t expected) {
+        return actual >= expected && actual <= expected + expected / 64;
+    };
+    EXPECT_TRUE(within(histogram.value_at_percentile(50.0), 5000000));
+    EXPECT_TRUE(within(histogram.value_at_percentile(99.0), 9900000));
+    EXPECT_TRUE(within(histogram.value_at_percentile(99.9), 9990000));
+    EXPECT_EQ(histogram.value_at_percentile(100.0), 10000000u);
+
+    // 超出范围的值记入最高桶
+    histogram.record(uint64_t{1} << 50);
+    EXPECT_EQ(histogram.max(), uint64_t{1} << 50);
+
+    LatencyHistogram other;
+    other.record(1);
+    histogram.merge(other);
+    EXPECT_EQ(histogram.count(), 10002u);
+    EXPECT_EQ(histogram.min(), 1u);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.value_at_percentile(50.0), 0u);
+}
+
+TEST(SequenceGapDetectorTest, CountsGapsAndReordering) {
+    SequenceGapDetector detector;
+    for (uint64_t sequence : {5, 6, 7, 10, 11, 11, 3, 4}) {
+        detector.observe(sequence);
+    }
+    EXPECT_EQ(detector.gaps(), 1u);
+    EXPECT_EQ(detector.missing(), 2u);
+    EXPECT_EQ(detector.out_of_order(), 2u);
+
+    detector.resync();
+    detector.observe(100);
+    EXPECT_EQ(detector.gaps(), 1u);
+}
+
+TEST(LatencyTrackerTest, ShmRingSubscriberRecordsLatencyAndGaps) {
+    BroadcastConfig config;
+    config.transport = BroadcastTransport::SharedMemoryRing;
+    config.service_name = "latency" + std::to_string(::getpid());
+    config.queue_capacity = 4;
+    config.latency_tracking = true;
+
+    shm::ShmRingBroadcaster pub(config, "latency");
+    shm::ShmRingSubscriber sub(config, "latency");
+    ASSERT_NE(sub.get_latency_tracker(), nullptr);
+
+    const uint64_t value = 1;
+    const auto publish = [&] {
+        return pub.broadcast(reinterpret_cast<const uint8_t*>(&value), sizeof(value), 1, MarketDataType::Tick);
+    };
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(publish());
+    }
+    while (sub.receive()) {}
+    LatencySummary summary = sub.get_latency();
+    EXPECT_EQ(summary.samples, 3u);
+    EXPECT_GT(summary.max_ns, 0u);
+    EXPECT_LE(summary.p50_ns, summary.p99_ns);
+    EXPECT_EQ(summary.sequence_gaps, 0u);
+
+    // 覆盖造成的丢失体现为序号缺口
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(publish());
+    }
+    while (sub.receive()) {}
+    summary = sub.get_latency();
+    EXPECT_EQ(summary.sequence_gaps, 1u);
+    EXPECT_EQ(summary.missing_sequences, sub.get_receive_stats().missed_samples);
+    EXPECT_EQ(summary.samples, sub.get_receive_stats().blocks_received);
+
+    sub.reset_receive_stats();
+    EXPECT_EQ(sub.get_latency().samples, 0u);
+
+    BroadcastConfig disabled = config;
+    disabled.latency_tracking = false;
+    shm::ShmRingSubscriber plain(disabled, "latency");
+    EXPECT_EQ(plain.get_latency_tracker(), nullptr);
+    EXPECT_EQ(plain.get_latency().samples, 0u);
+}
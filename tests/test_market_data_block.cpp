@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "qaultra/ipc/market_data_block.hpp"
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace qaultra::ipc;
+
+namespace {
+
+struct PackedTick {
+    uint32_t instrument_id;
+    uint32_t volume;
+    double price;
+};
+
+/**
+ * @brief 模拟借出的未初始化共享内存样本
+ */
+std::unique_ptr<ZeroCopyMarketBlock> dirty_block() {
+    auto block = std::make_unique<ZeroCopyMarketBlock>();
+    std::memset(static_cast<void*>(block.get()), 0xAB, sizeof(ZeroCopyMarketBlock));
+    return block;
+}
+
+} // namespace
+
+TEST(BlockWriterTest, WritesOnlyUsedBytes) {
+    auto block = dirty_block();
+    BlockWriter writer(*block);
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        auto* tick = writer.emplace<PackedTick>();
+        ASSERT_NE(tick, nullptr);
+        tick->instrument_id = i;
+        tick->volume = 100 * i;
+        tick->price = 10.0 + i;
+    }
+    writer.finish(7, 123456789, MarketDataType::Tick);
+
+    EXPECT_EQ(block->sequence_number, 7u);
+    EXPECT_EQ(block->timestamp_ns, 123456789u);
+    EXPECT_EQ(block->record_count, 3u);
+    EXPECT_EQ(block->data_type, MarketDataType::Tick);
+    EXPECT_EQ(block->flags, 0);
+    EXPECT_EQ(block->payload_size, 3 * sizeof(PackedTick));
+
+    const auto* ticks = reinterpret_cast<const PackedTick*>(block->get_data());
+    EXPECT_EQ(ticks[2].instrument_id, 2u);
+    EXPECT_DOUBLE_EQ(ticks[2].price, 12.0);
+
+    // 有效负载之后的字节未被触及 (无清零)
+    EXPECT_EQ(block->data[block->payload_size], 0xAB);
+    EXPECT_EQ(block->data[ZeroCopyMarketBlock::DATA_SIZE - 1], 0xAB);
+}
+
+TEST(BlockWriterTest, RejectsOverflowWithoutPartialWrite) {
+    auto block = dirty_block();
+    BlockWriter writer(*block);
+
+    std::vector<uint8_t> chunk(ZeroCopyMarketBlock::DATA_SIZE - 8, 0x11);
+    ASSERT_TRUE(writer.append(chunk.data(), chunk.size(), 10));
+    EXPECT_EQ(writer.remaining(), 8u);
+
+    uint8_t extra[16] = {};
+    EXPECT_FALSE(writer.append(extra, sizeof(extra)));
+    EXPECT_EQ(writer.emplace<PackedTick>(), nullptr);
+    EXPECT_EQ(writer.size(), chunk.size());
+
+    // 外部序列化器直接写入 cursor() 后登记
+    std::memset(writer.cursor(), 0x22, 8);
+    EXPECT_TRUE(writer.commit(8, 1));
+    EXPECT_EQ(writer.remaining(), 0u);
+
+    writer.finish(1, 2, MarketDataType::Trade);
+    EXPECT_EQ(block->payload_size, ZeroCopyMarketBlock::DATA_SIZE);
+    EXPECT_EQ(block->record_count, 11u);
+}
+
+TEST(BlockWriterTest, CopyDataRecordsPayloadSize) {
+    ZeroCopyMarketBlock block;
+    const char payload[] = "tick";
+    ASSERT_TRUE(block.copy_data(payload, sizeof(payload)));
+    EXPECT_EQ(block.payload_size, sizeof(payload));
+
+    BlockWriter invalid;
+    EXPECT_FALSE(invalid.valid());
+    EXPECT_FALSE(invalid.append(payload, sizeof(payload)));
+}
+
+TEST(BlockWriterTest, LegacyHeaderWithZeroedReservedBytes) {
+    // 旧版发布端 / Rust 端: 保留字节 (现 payload_size、instrument_tag) 全部置零
+    ZeroCopyMarketBlock block;
+    std::memset(reinterpret_cast<uint8_t*>(&block), 0, sizeof(MarketBlockHeader));
+    block.sequence_number = 7;
+    block.record_count = 3;
+    block.data_type = MarketDataType::Tick;
+    block.data[ZeroCopyMarketBlock::DATA_SIZE - 1] = 0x5A;
+
+    EXPECT_EQ(block.payload_size, 0u);
+    EXPECT_FALSE(block.has_instrument());
+    ASSERT_EQ(block.effective_payload_size(), ZeroCopyMarketBlock::DATA_SIZE);
+    const std::vector<uint8_t> received(block.data, block.data + block.effective_payload_size());
+    EXPECT_EQ(received.back(), 0x5A);
+
+    block.record_count = 0;
+    EXPECT_EQ(block.effective_payload_size(), 0u);
+
+    block.record_count = 1;
+    block.payload_size = 24;
+    EXPECT_EQ(block.effective_payload_size(), 24u);
+}
+
+TEST(BlockSizeClassTest, SelectsSmallestFittingClass) {
+    EXPECT_EQ(sizeof(SmallMarketBlock), 256u);
+    EXPECT_EQ(sizeof(LargeMarketBlock), 65536u);
+    EXPECT_EQ(select_size_class(sizeof(PackedTick)), BlockSizeClass::Small);
+    EXPECT_EQ(select_size_class(SmallMarketBlock::DATA_SIZE + 1), BlockSizeClass::Standard);
+    EXPECT_EQ(select_size_class(ZeroCopyMarketBlock::DATA_SIZE + 1), BlockSizeClass::Large);
+    EXPECT_EQ(fragment_count<ZeroCopyMarketBlock>(0), 1u);
+    EXPECT_EQ(fragment_count<ZeroCopyMarketBlock>(ZeroCopyMarketBlock::DATA_SIZE), 1u);
+    EXPECT_EQ(fragment_count<ZeroCopyMarketBlock>(ZeroCopyMarketBlock::DATA_SIZE * 2 + 1), 3u);
+
+    SmallMarketBlock block;
+    BasicBlockWriter<SmallMarketBlock> writer(block);
+    size_t count = 0;
+    while (writer.emplace<PackedTick>()) {
+        ++count;
+    }
+    EXPECT_EQ(count, SmallMarketBlock::DATA_SIZE / sizeof(PackedTick));
+}
+
+TEST(FragmentAssemblerTest, ReassemblesConsecutiveFragments) {
+    std::vector<SmallMarketBlock> blocks(3);
+    const uint8_t fragment_flags[] = {
+        block_flags::FRAGMENT | block_flags::FRAGMENT_FIRST,
+        block_flags::FRAGMENT,
+        block_flags::FRAGMENT | block_flags::FRAGMENT_LAST | 0x3,
+    };
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        BasicBlockWriter<SmallMarketBlock> writer(blocks[i]);
+        std::vector<uint8_t> bytes(i == 2 ? 10 : SmallMarketBlock::DATA_SIZE, static_cast<uint8_t>(i + 1));
+        writer.append(bytes.data(), bytes.size(), 2);
+        writer.finish(100 + i, 1000 + i, MarketDataType::Tick, fragment_flags[i]);
+    }
+
+    FragmentAssembler assembler;
+    MessageView message;
+    EXPECT_FALSE(assembler.feed(blocks[0], message));
+    EXPECT_TRUE(assembler.in_progress());
+    EXPECT_FALSE(assembler.feed(blocks[1], message));
+    ASSERT_TRUE(assembler.feed(blocks[2], message));
+    EXPECT_EQ(message.size, SmallMarketBlock::DATA_SIZE * 2 + 10);
+    EXPECT_EQ(message.record_count, 6u);
+    EXPECT_EQ(message.first_sequence, 100u);
+    EXPECT_EQ(message.timestamp_ns, 1002u);
+    EXPECT_EQ(message.fragments, 3u);
+    EXPECT_EQ(message.flags, 0x3);
+    EXPECT_EQ(message.data[0], 1);
+    EXPECT_EQ(message.data[SmallMarketBlock::DATA_SIZE], 2);
+    EXPECT_EQ(message.data[message.size - 1], 3);
+
+    // 缺少中间分片: 整条消息丢弃
+    EXPECT_FALSE(assembler.feed(blocks[0], message));
+    EXPECT_FALSE(assembler.feed(blocks[2], message));
+    EXPECT_FALSE(assembler.in_progress());
+    EXPECT_EQ(assembler.dropped_messages(), 1u);
+
+    // 未分片消息直接指向数据块
+    SmallMarketBlock whole;
+    whole.copy_data("abc", 3);
+    whole.record_count = 1;
+    ASSERT_TRUE(assembler.feed(whole, message));
+    EXPECT_EQ(message.data, whole.data);
+    EXPECT_EQ(message.fragments, 1u);
+}
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include "qaultra/ipc/market_journal.hpp"
+#include "qaultra/ipc/journal_replay.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace qaultra::ipc;
+
+namespace {
+
+constexpr size_t SEGMENT_BYTES = size_t{1} << 20;
+
+ZeroCopyMarketBlock make_block(uint64_t sequence, size_t payload_size = 64) {
+    ZeroCopyMarketBlock block;
+    block.sequence_number = sequence;
+    block.timestamp_ns = sequence * 10;
+    block.record_count = 1;
+    block.data_type = MarketDataType::Tick;
+    block.payload_size = static_cast<uint16_t>(payload_size);
+    std::memcpy(block.data, &sequence, sizeof(sequence));
+    return block;
+}
+
+uint64_t payload_value(const uint8_t* payload) {
+    uint64_t value = 0;
+    std::memcpy(&value, payload, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+class MarketJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = (std::filesystem::temp_directory_path() /
+                ("qaultra_journal_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name())))
+                   .string();
+        std::filesystem::remove_all(root);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+
+    BroadcastConfig ring_config() const {
+        BroadcastConfig config;
+        config.transport = BroadcastTransport::SharedMemoryRing;
+        config.service_name = "journal" + std::to_string(::getpid());
+        config.queue_capacity = 4;
+        config.journal_dir = root;
+        config.journal_segment_mb = 1;
+        return config;
+    }
+
+    std::string root;
+};
+
+TEST_F(MarketJournalTest, AppendRotatesSegmentsAndReplays) {
+    constexpr uint64_t COUNT = 20000;
+    const auto before = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    {
+        MarketJournalWriter writer(root, SEGMENT_BYTES);
+        EXPECT_EQ(writer.next_sequence(), 0u);
+        for (uint64_t seq = 0; seq < COUNT; ++seq) {
+            ASSERT_TRUE(writer.append(make_block(seq)));
+        }
+        EXPECT_EQ(writer.get_records_appended(), COUNT);
+        EXPECT_GT(writer.get_segments_created(), 1u);
+        EXPECT_FALSE(writer.append(make_block(5)));
+        EXPECT_EQ(writer.get_rejected(), 1u);
+        EXPECT_TRUE(writer.sync());
+    }
+
+    MarketJournalReader reader(root);
+    EXPECT_GT(reader.segment_count(), 1u);
+    EXPECT_EQ(reader.first_sequence(), 0u);
+    EXPECT_EQ(reader.end_sequence(), COUNT);
+
+    uint64_t expected = 100;
+    const uint64_t replayed = reader.replay(100, COUNT, [&](const MarketBlockHeader& header, const uint8_t* payload) {
+        EXPECT_EQ(header.sequence_number, expected);
+        EXPECT_EQ(header.timestamp_ns, expected * 10);
+        EXPECT_EQ(header.payload_size, 64u);
+        EXPECT_EQ(payload_value(payload), expected);
+        expected++;
+    });
+    EXPECT_EQ(replayed, COUNT - 100);
+
+    // 随机读取跨段的记录
+    for (uint64_t seq : std::vector<uint64_t>{0, 6000, 13000, COUNT - 1}) {
+        bool found = false;
+        EXPECT_TRUE(reader.read(seq, [&](const MarketBlockHeader& header, const uint8_t* payload) {
+            found = header.sequence_number == seq && payload_value(payload) == seq;
+        }));
+        EXPECT_TRUE(found);
+    }
+    EXPECT_FALSE(reader.read(COUNT, [](const MarketBlockHeader&, const uint8_t*) {}));
+
+    EXPECT_EQ(reader.sequence_at_time(0), 0u);
+    EXPECT_EQ(reader.sequence_at_time(before), 0u);
+    EXPECT_EQ(reader.sequence_at_time(UINT64_MAX), COUNT);
+}
+
+TEST_F(MarketJournalTest, ReopenContinuesAfterLastSequence) {
+    {
+        MarketJournalWriter writer(root, SEGMENT_BYTES);
+        for (uint64_t seq = 0; seq < 10; ++seq) {
+            ASSERT_TRUE(writer.append(make_block(seq)));
+        }
+    }
+
+    MarketJournalWriter writer(root, SEGMENT_BYTES);
+    EXPECT_EQ(writer.next_sequence(), 10u);
+    EXPECT_FALSE(writer.append(make_block(9)));
+
+    // 序号跳跃开启新段，回放跨过缺口
+    ASSERT_TRUE(writer.append(make_block(20, 8000)));
+    ASSERT_TRUE(writer.append(make_block(21)));
+
+    MarketJournalReader reader(root);
+    EXPECT_EQ(reader.segment_count(), 2u);
+    EXPECT_EQ(reader.end_sequence(), 22u);
+    EXPECT_EQ(reader.next_available(12), 20u);
+
+    std::vector<uint64_t> sequences;
+    reader.replay(0, reader.end_sequence(), [&](const MarketBlockHeader& header, const uint8_t*) {
+        sequences.push_back(header.sequence_number);
+    });
+    ASSERT_EQ(sequences.size(), 12u);
+    EXPECT_EQ(sequences[9], 9u);
+    EXPECT_EQ(sequences[10], 20u);
+    EXPECT_EQ(sequences[11], 21u);
+}
+
+TEST_F(MarketJournalTest, ShmRingBroadcasterJournalsAndContinuesSequence) {
+    const BroadcastConfig config = ring_config();
+    const uint64_t value = 7;
+    {
+        shm::ShmRingBroadcaster pub(config, "journaled");
+        ASSERT_NE(pub.get_journal(), nullptr);
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_TRUE(pub.broadcast(reinterpret_cast<const uint8_t*>(&value), sizeof(value), 1, MarketDataType::Tick));
+        }
+    }
+
+    // 重启的发布端从日志末尾续接序号，迟到订阅者从新段的第一条开始
+    shm::ShmRingBroadcaster pub(config, "journaled");
+    shm::ShmRingSubscriber sub(config, "journaled", shm::ShmRingSubscriber::StartPosition::Oldest);
+    EXPECT_EQ(sub.position(), 3u);
+    ASSERT_TRUE(pub.broadcast(reinterpret_cast<const uint8_t*>(&value), sizeof(value), 1, MarketDataType::Tick));
+
+    ZeroCopyMarketBlock block;
+    ASSERT_TRUE(sub.receive_block(block));
+    EXPECT_EQ(block.sequence_number, 3u);
+
+    MarketJournalReader reader(journal_directory(config, "journaled"));
+    EXPECT_EQ(reader.first_sequence(), 0u);
+    EXPECT_EQ(reader.end_sequence(), 4u);
+}
+
+TEST_F(MarketJournalTest, ReplaySubscriberSwitchesToLiveWithoutGapsOrDuplicates) {
+    const BroadcastConfig config = ring_config();
+    shm::ShmRingBroadcaster pub(config, "replay");
+    const auto publish = [&](uint64_t value) {
+        return pub.broadcast(reinterpret_cast<const uint8_t*>(&value), sizeof(value), 1, MarketDataType::Tick);
+    };
+
+    // 远超环容量的历史只能从日志取得
+    for (uint64_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(publish(i));
+    }
+
+    shm::ReplaySubscriber sub(config, "replay", 10);
+    std::vector<uint64_t> received;
+    const auto drain = [&] {
+        while (sub.read([&](const MarketBlockHeader& header, const uint8_t* payload) {
+            EXPECT_EQ(header.sequence_number, payload_value(payload));
+            received.push_back(payload_value(payload));
+        })) {
+            // 回放过程中继续发布
+            if (received.size() == 50) {
+                for (uint64_t i = 100; i < 103; ++i) {
+                    ASSERT_TRUE(publish(i));
+                }
+            }
+        }
+    };
+    drain();
+    EXPECT_FALSE(sub.replaying());
+    EXPECT_EQ(sub.get_replayed(), 93u);
+
+    for (uint64_t i = 103; i < 106; ++i) {
+        ASSERT_TRUE(publish(i));
+    }
+    drain();
+
+    ASSERT_EQ(received.size(), 96u);
+    for (size_t i = 0; i < received.size(); ++i) {
+        EXPECT_EQ(received[i], i + 10);
+    }
+    EXPECT_EQ(sub.position(), 106u);
+    EXPECT_EQ(sub.live().get_receive_stats().missed_samples, 0u);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "qaultra/simd/simd_math.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <numeric>
+#include <string>
+
+using namespace qaultra::simd;
+
+namespace {
+
+struct Bar {
+    int64_t timestamp;
+    double close;
+    double volume;
+};
+
+} // namespace
+
+class MemoryMappedArrayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() /
+                ("qaultra_mmap_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name())))
+                   .string();
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    std::string path;
+};
+
+TEST_F(MemoryMappedArrayTest, InMemoryGrowthKeepsContents) {
+    MemoryMapOptions options;
+    options.huge_pages = true;               // 无 hugetlb 页时自动退回普通页
+    options.advice = MemoryAdvice::Sequential;
+    MemoryMappedArray<double> array(10, options);
+    EXPECT_FALSE(array.file_backed());
+    ASSERT_EQ(array.size(), 10u);
+    EXPECT_GE(array.capacity(), 10u);
+    EXPECT_EQ(array[9], 0.0);
+
+    std::iota(array.begin(), array.end(), 0.0);
+    for (int i = 10; i < 200000; ++i) {
+        array.push_back(static_cast<double>(i));
+    }
+    ASSERT_EQ(array.size(), 200000u);
+    for (size_t i = 0; i < array.size(); i += 997) {
+        ASSERT_EQ(array[i], static_cast<double>(i));
+    }
+    EXPECT_EQ(SimdMath::sum(array.data(), array.size()), 199999.0 * 200000.0 / 2.0);
+
+    // 缩小后再扩大，新元素为 0
+    array.resize(5);
+    array.resize(8);
+    EXPECT_EQ(array[4], 4.0);
+    EXPECT_EQ(array[5], 0.0);
+    EXPECT_EQ(array[7], 0.0);
+    EXPECT_TRUE(array.advise(MemoryAdvice::WillNeed));
+    EXPECT_FALSE(array.advise(MemoryAdvice::DontNeed));     // 匿名映射上会丢数据，不下发
+    EXPECT_EQ(array[4], 4.0);
+
+    MemoryMappedArray<double> moved(std::move(array));
+    EXPECT_EQ(moved.size(), 8u);
+    EXPECT_TRUE(array.empty());
+    EXPECT_EQ(array.data(), nullptr);
+
+    MemoryMappedArray<double> grown;
+    grown.push_back(1.5);
+    EXPECT_EQ(grown[0], 1.5);
+    EXPECT_THROW(MemoryMappedArray<double>(4, MemoryMapOptions{false, true}), std::invalid_argument);
+}
+
+TEST_F(MemoryMappedArrayTest, FileBackedRoundTrip) {
+    {
+        MemoryMappedArray<Bar> bars(path, 3);
+        EXPECT_TRUE(bars.file_backed());
+        bars[0] = {1, 10.0, 100.0};
+        bars[2] = {3, 12.0, 300.0};
+        for (int64_t i = 3; i < 5000; ++i) {
+            bars.push_back({i + 1, 10.0 + static_cast<double>(i), 100.0});
+        }
+        EXPECT_GT(bars.capacity(), bars.size());
+        EXPECT_TRUE(bars.flush());
+    }
+    // 关闭时去掉预留尾部
+    EXPECT_EQ(std::filesystem::file_size(path), 5000 * sizeof(Bar));
+
+    MemoryMapOptions options;
+    options.read_only = true;
+    options.advice = MemoryAdvice::Sequential;
+    const MemoryMappedArray<Bar> reopened(path, options);
+    ASSERT_EQ(reopened.size(), 5000u);
+    EXPECT_EQ(reopened[0].timestamp, 1);
+    EXPECT_EQ(reopened[1].timestamp, 0);
+    EXPECT_EQ(reopened[2].close, 12.0);
+    EXPECT_EQ(reopened[4999].timestamp, 5000);
+    EXPECT_TRUE(reopened.advise(MemoryAdvice::DontNeed, 1000, 2000));
+    EXPECT_EQ(reopened[1500].close, 1510.0);
+
+    // 类型视图: 记录中的某一列、子区间
+    const ArrayView<const Bar> window = reopened.view(4990);
+    ASSERT_EQ(window.size(), 10u);
+    EXPECT_EQ(window[9].timestamp, 5000);
+    const ArrayView<const int64_t> first = reopened.view_as<const int64_t>(sizeof(Bar), 1);
+    EXPECT_EQ(first[0], 0);
+    const ArrayView<const double> raw = reopened.view_as<const double>(0, 3 * sizeof(Bar) / sizeof(double));
+    EXPECT_EQ(raw[7], 12.0);
+    EXPECT_THROW(reopened.view_as<const double>(4, 1), std::out_of_range);
+    EXPECT_THROW(reopened.view_as<const double>(0, 5000 * 3 + 1), std::out_of_range);
+}
+
+TEST_F(MemoryMappedArrayTest, ReadOnlyAndMissingFiles) {
+    {
+        MemoryMappedArray<double> empty(path);
+        EXPECT_TRUE(empty.empty());
+        empty.resize(1000);
+        empty[999] = 2.0;
+    }
+    EXPECT_EQ(std::filesystem::file_size(path), 1000 * sizeof(double));
+
+    MemoryMapOptions options;
+    options.read_only = true;
+    MemoryMappedArray<double> read_only(path, options);
+    EXPECT_EQ(read_only[999], 2.0);
+    EXPECT_TRUE(read_only.flush());
+    EXPECT_THROW(read_only.resize(2000), std::runtime_error);
+    EXPECT_THROW(read_only.push_back(1.0), std::runtime_error);
+    EXPECT_THROW(MemoryMappedArray<double>(path, 10, options), std::invalid_argument);
+    EXPECT_THROW(MemoryMappedArray<double>(path + ".missing", options), std::runtime_error);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "qaultra/engine/parameter_sweep.hpp"
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace qaultra::engine;
+
+namespace {
+
+std::shared_ptr<const BarPanel> random_panel(size_t symbols, size_t bars, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> dist(0.0005, 0.02);
+    std::vector<BarRecord> records;
+    for (size_t s = 0; s < symbols; ++s) {
+        double price = 10.0 + static_cast<double>(s);
+        for (size_t t = 0; t < bars; ++t) {
+            price *= 1.0 + dist(rng);
+            records.push_back({"D" + std::to_string(10000 + t), "S" + std::to_string(s),
+                               price, price, price, price, 1000.0});
+        }
+    }
+    return std::make_shared<const BarPanel>(BarPanel::from_records(records));
+}
+
+BacktestConfig sweep_config() {
+    BacktestConfig config;
+    config.start_date.clear();
+    config.end_date.clear();
+    config.enable_logging = false;
+    return config;
+}
+
+} // namespace
+
+TEST(ParameterSweepTest, GridAndRandomSearch) {
+    const auto grid = ParameterGrid::cartesian({{"fast_window", {3, 5}}, {"slow_window", {20, 30, 40}}});
+    ASSERT_EQ(grid.size(), 6u);
+    EXPECT_EQ(grid.point(0)[0], 3.0);
+    EXPECT_EQ(grid.point(0)[1], 20.0);
+    EXPECT_EQ(grid.point(1)[1], 30.0);                      // 最后一个轴变化最快
+    EXPECT_EQ(grid.point(5)[0], 5.0);
+    EXPECT_EQ(grid.point(5)[1], 40.0);
+    EXPECT_EQ(ParameterGrid::cartesian({{"a", {1}}, {"b", {}}}).size(), 0u);
+
+    const std::vector<ParameterRange> ranges = {{"window", 5, 30, true}, {"z_score_threshold", 0.5, 2.5, false}};
+    const auto sampled = ParameterGrid::random(ranges, 200, 7);
+    ASSERT_EQ(sampled.size(), 200u);
+    for (size_t i = 0; i < sampled.size(); ++i) {
+        const double window = sampled.point(i)[0];
+        EXPECT_EQ(window, std::floor(window));
+        EXPECT_GE(window, 5.0);
+        EXPECT_LE(window, 30.0);
+        EXPECT_GE(sampled.point(i)[1], 0.5);
+        EXPECT_LT(sampled.point(i)[1], 2.5);
+    }
+    EXPECT_EQ(ParameterGrid::random(ranges, 200, 7).values, sampled.values);
+    EXPECT_THROW(ParameterGrid::random({{"x", 2, 1, false}}, 1), std::invalid_argument);
+}
+
+TEST(ParameterSweepTest, MatchesStandaloneRunsOnSharedData) {
+    const auto panel = random_panel(15, 300, 11);
+    const BacktestConfig config = sweep_config();
+    ParameterSweep sweep(config, panel);
+
+    // 第 0 组参数 fast >= slow，初始化失败
+    const auto grid = ParameterGrid::cartesian({{"fast_window", {30, 3, 5, 8}}, {"slow_window", {20, 30}}});
+    std::atomic<size_t> callbacks{0};
+    SweepOptions options;
+    options.threads = 3;
+    options.on_result = [&](size_t, const BacktestResults&) { callbacks++; };
+    const auto factory = [] { return factory::create_sma_strategy(); };
+    const SweepResultTable table = sweep.run(factory, grid, options);
+
+    ASSERT_EQ(table.size(), grid.size());
+    EXPECT_EQ(table.parameter_names, grid.names);
+    EXPECT_EQ(table.completed[0], 0);
+    EXPECT_FALSE(table.errors[0].empty());
+    EXPECT_EQ(table.completed[1], 0);                       // 30 / 30
+    EXPECT_EQ(callbacks.load(), grid.size() - 2);
+
+    for (size_t row = 2; row < grid.size(); ++row) {
+        ASSERT_EQ(table.completed[row], 1) << table.errors[row];
+        BacktestEngine engine(config);
+        engine.set_market_data(panel);
+        engine.add_strategy(factory::create_sma_strategy(static_cast<int>(table.parameters[0][row]),
+                                                         static_cast<int>(table.parameters[1][row])));
+        const BacktestResults expected = engine.run();
+        EXPECT_EQ(table.final_value[row], expected.final_value);
+        EXPECT_EQ(table.sharpe_ratio[row], expected.sharpe_ratio);
+        EXPECT_EQ(table.total_trades[row], expected.total_trades);
+        EXPECT_EQ(&engine.market_data(), panel.get());         // 共享同一份行情
+    }
+
+    options.threads = 1;
+    options.on_result = nullptr;
+    const SweepResultTable serial = sweep.run(factory, grid, options);
+    EXPECT_EQ(serial.final_value, table.final_value);
+    EXPECT_EQ(serial.sharpe_ratio, table.sharpe_ratio);
+    EXPECT_EQ(serial.completed, table.completed);
+
+    // 回调抛出异常不影响已完成的行
+    options.on_result = [](size_t, const BacktestResults&) { throw std::runtime_error("sink full"); };
+    const SweepResultTable failed_sink = sweep.run(factory, grid, options);
+    EXPECT_EQ(failed_sink.completed, table.completed);
+    EXPECT_EQ(failed_sink.final_value, table.final_value);
+    EXPECT_EQ(failed_sink.errors[2], "on_result: sink full");
+    EXPECT_EQ(failed_sink.errors[0], table.errors[0]);
+    options.on_result = nullptr;
+
+    const size_t best = table.best(table.sharpe_ratio);
+    ASSERT_LT(best, table.size());
+    for (size_t row = 0; row < table.size(); ++row) {
+        if (table.completed[row]) {
+            EXPECT_GE(table.sharpe_ratio[best], table.sharpe_ratio[row]);
+        }
+    }
+
+    // 多于参数点的线程数、未知参数名
+    options.threads = 16;
+    const auto bad = sweep.run(factory, ParameterGrid::cartesian({{"unknown", {1, 2}}}), options);
+    EXPECT_EQ(bad.completed, (std::vector<uint8_t>{0, 0}));
+    EXPECT_EQ(bad.best(bad.sharpe_ratio), bad.size());
+    EXPECT_THROW(ParameterSweep(config, nullptr), std::invalid_argument);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "qaultra/analysis/performance_analyzer.hpp"
+#include <random>
+#include <vector>
+
+using namespace qaultra::analysis;
+
+namespace {
+
+std::vector<double> nav_curve(const std::vector<double>& returns) {
+    std::vector<double> nav{1.0};
+    for (double r : returns) {
+        nav.push_back(nav.back() * (1.0 + r));
+    }
+    return nav;
+}
+
+} // namespace
+
+TEST(RiskBatchTest, MatchesSingleSeriesFunctions) {
+    constexpr size_t PERIODS = 503;
+    constexpr size_t SERIES = 37;
+    std::mt19937 rng(7);
+    std::vector<double> matrix(PERIODS * SERIES);
+    for (size_t s = 0; s < SERIES; ++s) {
+        std::student_t_distribution<double> dist(3.0 + s % 5);
+        for (size_t t = 0; t < PERIODS; ++t) {
+            matrix[s * PERIODS + t] = 0.0003 * s + 0.01 * dist(rng);
+        }
+    }
+
+    BatchRiskOptions options;
+    options.risk_free_rate = 0.02;
+    options.threads = 4;
+    const RiskMetricsTable table = RiskCalculator::calculate_batch_metrics(matrix.data(), PERIODS, SERIES, options);
+    ASSERT_EQ(table.size(), SERIES);
+
+    for (size_t s = 0; s < SERIES; ++s) {
+        SCOPED_TRACE(s);
+        const std::vector<double> r(matrix.begin() + s * PERIODS, matrix.begin() + (s + 1) * PERIODS);
+        EXPECT_NEAR(table.annual_return[s], RiskCalculator::calculate_annual_return(r), 1e-10);
+        EXPECT_NEAR(table.annual_volatility[s], RiskCalculator::calculate_volatility(r), 1e-12);
+        EXPECT_NEAR(table.sharpe_ratio[s], RiskCalculator::calculate_sharpe_ratio(r, 0.02), 1e-9);
+        EXPECT_NEAR(table.sortino_ratio[s], RiskCalculator::calculate_sortino_ratio(r, 0.02), 1e-9);
+        EXPECT_NEAR(table.calmar_ratio[s], RiskCalculator::calculate_calmar_ratio(r), 1e-9);
+        EXPECT_NEAR(table.omega_ratio[s], RiskCalculator::calculate_omega_ratio(r), 1e-12);
+        EXPECT_NEAR(table.downside_risk[s], RiskCalculator::calculate_downside_risk(r), 1e-15);
+        EXPECT_NEAR(table.max_drawdown[s], RiskCalculator::calculate_max_drawdown(nav_curve(r)), 1e-14);
+        EXPECT_NEAR(table.skew[s], RiskCalculator::calculate_skewness(r), 1e-9);
+        EXPECT_NEAR(table.kurtosis[s], RiskCalculator::calculate_kurtosis(r), 1e-8);
+        // 分位数为精确的次序统计量
+        EXPECT_EQ(table.value_at_risk[s], RiskCalculator::calculate_value_at_risk(r));
+        EXPECT_NEAR(table.conditional_var[s], RiskCalculator::calculate_conditional_var(r), 1e-15);
+        EXPECT_EQ(table.tail_ratio[s], RiskCalculator::calculate_tail_ratio(r));
+    }
+
+    const RiskMetrics row = table.row(3);
+    EXPECT_EQ(row.sharpe_ratio, table.sharpe_ratio[3]);
+    EXPECT_EQ(row.value_at_risk_95, table.value_at_risk[3]);
+}
+
+TEST(RiskBatchTest, SingleThreadAndEdgeCases) {
+    const std::vector<double> flat(10, 0.0);
+    const std::vector<double> tiny = {-0.01, 0.02};
+    std::vector<double> matrix = flat;
+    matrix.insert(matrix.end(), tiny.begin(), tiny.end());
+
+    BatchRiskOptions options;
+    options.threads = 1;
+    // 两个长度不同的序列分两次计算
+    const auto flat_table = RiskCalculator::calculate_batch_metrics(matrix.data(), 10, 1, options);
+    EXPECT_EQ(flat_table.sharpe_ratio[0], 0.0);
+    EXPECT_EQ(flat_table.max_drawdown[0], 0.0);
+    EXPECT_EQ(flat_table.kurtosis[0], 0.0);
+
+    const auto tiny_table = RiskCalculator::calculate_batch_metrics(matrix.data() + 10, 2, 1, options);
+    EXPECT_DOUBLE_EQ(tiny_table.value_at_risk[0], 0.01);
+    EXPECT_DOUBLE_EQ(tiny_table.conditional_var[0], 0.01);
+    EXPECT_DOUBLE_EQ(tiny_table.total_return[0], 0.99 * 1.02 - 1.0);
+
+    EXPECT_EQ(RiskCalculator::calculate_batch_metrics(matrix.data(), 0, 3).size(), 3u);
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "qaultra/analysis/rolling_stats.hpp"
+#include "qaultra/analysis/performance_analyzer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace qaultra::analysis;
+
+namespace {
+
+std::vector<double> random_returns(size_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> dist(0.0005, 0.01);
+    std::vector<double> returns(size);
+    for (auto& r : returns) {
+        r = dist(rng);
+    }
+    return returns;
+}
+
+std::vector<double> cumulative(const std::vector<double>& returns) {
+    std::vector<double> values;
+    double value = 1.0;
+    for (double r : returns) {
+        value *= 1.0 + r;
+        values.push_back(value);
+    }
+    return values;
+}
+
+// 逐窗口重算的参考实现
+double naive_std(const double* data, size_t n) {
+    double mean = 0.0;
+    for (size_t i = 0; i < n; ++i) mean += data[i];
+    mean /= n;
+    double ss = 0.0;
+    for (size_t i = 0; i < n; ++i) ss += (data[i] - mean) * (data[i] - mean);
+    return std::sqrt(ss / n);
+}
+
+} // namespace
+
+TEST(RollingStatsTest, MomentsMatchWindowRecomputation) {
+    const auto returns = random_returns(2000, 1);
+    RollingMoments moments(50);
+    for (size_t i = 0; i < returns.size(); ++i) {
+        moments.push(returns[i]);
+        const size_t n = std::min<size_t>(i + 1, 50);
+        const double* window = returns.data() + i + 1 - n;
+        double mean = 0.0;
+        for (size_t k = 0; k < n; ++k) mean += window[k];
+        mean /= n;
+        ASSERT_NEAR(moments.mean(), mean, 1e-15);
+        ASSERT_NEAR(moments.stddev(), naive_std(window, n), 1e-13);
+    }
+
+    // 常数窗口的方差精确为 0
+    for (int i = 0; i < 50; ++i) {
+        moments.push(0.0);
+    }
+    EXPECT_EQ(moments.variance(), 0.0);
+    EXPECT_EQ(moments.mean(), 0.0);
+}
+
+TEST(RollingStatsTest, ExtremumAndDrawdown) {
+    const auto values = cumulative(random_returns(1500, 2));
+    constexpr size_t WINDOW = 40;
+    RollingMax max(WINDOW);
+    RollingMin min(WINDOW);
+    RollingDrawdown drawdown(WINDOW);
+    for (size_t i = 0; i < values.size(); ++i) {
+        max.push(values[i]);
+        min.push(values[i]);
+        drawdown.push(values[i]);
+        const size_t begin = i + 1 >= WINDOW ? i + 1 - WINDOW : 0;
+        const std::vector<double> window(values.begin() + begin, values.begin() + i + 1);
+        ASSERT_EQ(max.value(), *std::max_element(window.begin(), window.end()));
+        ASSERT_EQ(min.value(), *std::min_element(window.begin(), window.end()));
+        ASSERT_NEAR(drawdown.max_drawdown(), RiskCalculator::calculate_max_drawdown(window), 1e-15);
+    }
+
+    RollingDrawdown single(3);
+    for (double v : {1.0, 2.0, 1.5}) {
+        single.push(v);
+    }
+    EXPECT_DOUBLE_EQ(single.current_drawdown(), 0.25);
+    single.push(1.0);
+    EXPECT_DOUBLE_EQ(single.max_drawdown(), 0.5);
+}
+
+TEST(RollingStatsTest, RiskCalculatorRollingMetrics) {
+    const auto returns = random_returns(600, 3);
+    const auto sharpe = RiskCalculator::calculate_rolling_sharpe(returns, 60);
+    const auto vol = RiskCalculator::calculate_rolling_volatility(returns, 60);
+    const auto values = cumulative(returns);
+    const auto dd = RiskCalculator::calculate_rolling_max_drawdown(values, 60);
+    ASSERT_EQ(sharpe.size(), returns.size() - 59);
+    ASSERT_EQ(vol.size(), returns.size() - 59);
+    ASSERT_EQ(dd.size(), values.size() - 59);
+
+    for (size_t i = 0; i < sharpe.size(); i += 37) {
+        const std::vector<double> window(returns.begin() + i, returns.begin() + i + 60);
+        EXPECT_NEAR(sharpe[i], RiskCalculator::calculate_sharpe_ratio(window), 1e-9);
+        EXPECT_NEAR(vol[i], RiskCalculator::calculate_volatility(window, true), 1e-12);
+        const std::vector<double> value_window(values.begin() + i, values.begin() + i + 60);
+        EXPECT_NEAR(dd[i], RiskCalculator::calculate_max_drawdown(value_window), 1e-15);
+    }
+
+    EXPECT_TRUE(RiskCalculator::calculate_rolling_sharpe(returns, 0).empty());
+    EXPECT_TRUE(RiskCalculator::calculate_rolling_sharpe(returns, 601).empty());
+}
+
+TEST(RollingStatsTest, BatchMatchesSingleSeries) {
+    constexpr size_t SERIES = 13;
+    constexpr size_t LENGTH = 400;
+    constexpr size_t WINDOW = 30;
+    std::vector<std::vector<double>> columns;
+    std::vector<double> panel(LENGTH * SERIES);
+    for (size_t s = 0; s < SERIES; ++s) {
+        columns.push_back(random_returns(LENGTH, 10 + static_cast<uint32_t>(s)));
+        for (size_t t = 0; t < LENGTH; ++t) {
+            panel[t * SERIES + s] = s == 0 ? 0.001 : columns[s][t];   // 第 0 列为常数
+        }
+    }
+
+    std::vector<double> mean(LENGTH * SERIES), stddev(LENGTH * SERIES), sharpe(LENGTH * SERIES);
+    rolling_moments_batch(panel.data(), LENGTH, SERIES, WINDOW, mean.data(), stddev.data());
+    rolling_sharpe_batch(panel.data(), LENGTH, SERIES, WINDOW, sharpe.data());
+
+    EXPECT_TRUE(std::isnan(mean[(WINDOW - 2) * SERIES + 3]));
+    for (size_t s = 0; s < SERIES; ++s) {
+        RollingMoments moments(WINDOW);
+        for (size_t t = 0; t < LENGTH; ++t) {
+            moments.push(panel[t * SERIES + s]);
+            if (!moments.full()) {
+                continue;
+            }
+            ASSERT_NEAR(mean[t * SERIES + s], moments.mean(), 1e-15);
+            ASSERT_NEAR(stddev[t * SERIES + s], moments.stddev(), 1e-14);
+        }
+    }
+    EXPECT_EQ(stddev[(LENGTH - 1) * SERIES], 0.0);
+    EXPECT_EQ(sharpe[(LENGTH - 1) * SERIES], 0.0);
+
+    const std::vector<double> last(columns[5].end() - WINDOW, columns[5].end());
+    EXPECT_NEAR(sharpe[(LENGTH - 1) * SERIES + 5], RiskCalculator::calculate_sharpe_ratio(last), 1e-9);
+}
@@ -0,0 +1,437 @@
+#include <gtest/gtest.h>
+#include "qaultra/ipc/shm_ring.hpp"
+#include "qaultra/ipc/broadcast_transport.hpp"
+#include "qaultra/ipc/numa_placement.hpp"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace qaultra::ipc;
+using namespace qaultra::ipc::shm;
+
+namespace {
+
+BroadcastConfig ring_config(size_t capacity) {
+    BroadcastConfig config;
+    config.transport = BroadcastTransport::SharedMemoryRing;
+    config.service_name = "test" + std::to_string(::getpid());
+    config.queue_capacity = capacity;
+    return config;
+}
+
+bool publish_value(ShmRingBroadcaster& pub, uint64_t value) {
+    return pub.broadcast(reinterpret_cast<const uint8_t*>(&value), sizeof(value), 1, MarketDataType::Tick);
+}
+
+uint64_t payload_value(const std::vector<uint8_t>& payload) {
+    uint64_t value = 0;
+    std::memcpy(&value, payload.data(), sizeof(value));
+    return value;
+}
+
+} // namespace
+
+TEST(ShmRingTest, PublishAndReceive) {
+    auto config = ring_config(8);
+    ShmRingBroadcaster pub(config, "basic");
+    ShmRingSubscriber sub(config, "basic");
+    EXPECT_EQ(pub.get_slot_count(), 8u);
+    EXPECT_EQ(pub.get_subscriber_count(), 1u);
+    EXPECT_FALSE(sub.receive().has_value());
+
+    for (uint64_t i = 0; i < 5; ++i) {
+        ASSERT_TRUE(publish_value(pub, i));
+    }
+    EXPECT_EQ(sub.lag(), 5u);
+
+    for (uint64_t i = 0; i < 5; ++i) {
+        auto payload = sub.receive();
+        ASSERT_TRUE(payload.has_value());
+        ASSERT_EQ(payload->size(), sizeof(uint64_t));
+        EXPECT_EQ(payload_value(*payload), i);
+    }
+    EXPECT_FALSE(sub.has_data());
+    EXPECT_EQ(sub.get_receive_stats().blocks_received, 5u);
+    EXPECT_EQ(pub.get_stats().blocks_sent, 5u);
+}
+
+TEST(ShmRingTest, LateJoinerCatchesUp) {
+    auto config = ring_config(4);
+    ShmRingBroadcaster pub(config, "late");
+    for (uint64_t i = 0; i < 10; ++i) {
+        publish_value(pub, i);
+    }
+
+    // 环中保留最近 slot_count-1 条完整消息
+    ShmRingSubscriber oldest(config, "late", ShmRingSubscriber::StartPosition::Oldest);
+    ShmRingSubscriber latest(config, "late", ShmRingSubscriber::StartPosition::Latest);
+    EXPECT_FALSE(latest.has_data());
+
+    std::vector<uint64_t> values;
+    while (auto payload = oldest.receive()) {
+        values.push_back(payload_value(*payload));
+    }
+    EXPECT_EQ(values, (std::vector<uint64_t>{7, 8, 9}));
+
+    publish_value(pub, 10);
+    auto payload = latest.receive();
+    ASSERT_TRUE(payload.has_value());
+    EXPECT_EQ(payload_value(*payload), 10u);
+}
+
+TEST(ShmRingTest, DetectsOverrun) {
+    auto config = ring_config(4);
+    ShmRingBroadcaster pub(config, "overrun");
+    ShmRingSubscriber sub(config, "overrun");
+
+    for (uint64_t i = 0; i < 11; ++i) {
+        publish_value(pub, i);
+    }
+
+    auto payload = sub.receive();
+    ASSERT_TRUE(payload.has_value());
+    EXPECT_EQ(payload_value(*payload), 8u);
+    const auto stats = sub.get_receive_stats();
+    EXPECT_EQ(stats.overruns, 1u);
+    EXPECT_EQ(stats.missed_samples, 8u);
+
+    EXPECT_EQ(payload_value(*sub.receive()), 9u);
+    EXPECT_EQ(payload_value(*sub.receive()), 10u);
+    EXPECT_FALSE(sub.receive().has_value());
+}
+
+TEST(ShmRingTest, LoanAndZeroCopyRead) {
+    auto config = ring_config(4);
+    ShmRingBroadcaster pub(config, "loan");
+    ShmRingSubscriber sub(config, "loan");
+
+    BlockWriter writer = pub.loan();
+    ASSERT_TRUE(writer.valid());
+    EXPECT_FALSE(pub.loan().valid());   // 同一时间只能借出一个槽位
+    EXPECT_FALSE(sub.has_data());
+    const char text[] = "zero-copy";
+    writer.append(text, sizeof(text), 3);
+    ASSERT_TRUE(pub.publish(writer, MarketDataType::Kline, 0x1));
+
+    std::string received;
+    uint64_t records = 0;
+    ASSERT_TRUE(sub.read([&](const ZeroCopyMarketBlock& block) {
+        received.assign(reinterpret_cast<const char*>(block.data));
+        records = block.record_count;
+        EXPECT_EQ(block.data_type, MarketDataType::Kline);
+        EXPECT_EQ(block.flags, 0x1);
+    }));
+    EXPECT_EQ(received, "zero-copy");
+    EXPECT_EQ(records, 3u);
+    EXPECT_FALSE(sub.read([](const ZeroCopyMarketBlock&) {}));
+}
+
+TEST(ShmRingTest, FactorySelectsSharedMemoryRing) {
+    auto config = ring_config(16);
+    auto pub = create_broadcaster(config, "factory");
+    ASSERT_NE(pub, nullptr);
+    EXPECT_EQ(pub->transport(), BroadcastTransport::SharedMemoryRing);
+
+    auto sub = create_subscriber(config, "factory");
+    ASSERT_NE(sub, nullptr);
+    EXPECT_TRUE(pub->has_subscribers());
+
+    const uint8_t bytes[] = {1, 2, 3};
+    ASSERT_TRUE(pub->broadcast(bytes, sizeof(bytes), 1, MarketDataType::Tick));
+    auto payload = sub->receive_nowait();
+    ASSERT_TRUE(payload.has_value());
+    EXPECT_EQ(*payload, (std::vector<uint8_t>{1, 2, 3}));
+
+}
+
+TEST(ShmRingTest, FragmentedMessageRoundTrip) {
+    auto config = ring_config(16);
+    ShmRingBroadcaster pub(config, "fragments");
+    ShmRingSubscriber sub(config, "fragments");
+
+    // 约 3.5 个数据块的快照
+    std::vector<uint8_t> snapshot(ZeroCopyMarketBlock::DATA_SIZE * 3 + ZeroCopyMarketBlock::DATA_SIZE / 2);
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        snapshot[i] = static_cast<uint8_t>(i * 31);
+    }
+    ASSERT_TRUE(pub.broadcast_message(snapshot.data(), snapshot.size(), 5000, MarketDataType::Tick));
+    ASSERT_TRUE(publish_value(pub, 42));
+    EXPECT_EQ(pub.get_stats().blocks_sent, 5u);
+
+    std::vector<uint8_t> received;
+    MessageView view;
+    ASSERT_TRUE(sub.read_message([&](const MessageView& message) {
+        view = message;
+        received.assign(message.data, message.data + message.size);
+    }));
+    EXPECT_EQ(received, snapshot);
+    EXPECT_EQ(view.record_count, 5000u);
+    EXPECT_EQ(view.fragments, 4u);
+
+    uint64_t value = 0;
+    ASSERT_TRUE(sub.read_message([&](const MessageView& message) {
+        std::memcpy(&value, message.data, sizeof(value));
+        EXPECT_EQ(message.fragments, 1u);
+    }));
+    EXPECT_EQ(value, 42u);
+    EXPECT_FALSE(sub.read_message([](const MessageView&) {}));
+}
+
+TEST(ShmRingTest, BatchSendsEveryRecord) {
+    auto config = ring_config(8);
+    ShmRingBroadcaster pub(config, "batch");
+    ShmRingSubscriber sub(config, "batch");
+
+    // 2.5 个数据块、7 条记录: 按块整除会丢掉余数
+    std::vector<uint8_t> batch(ZeroCopyMarketBlock::DATA_SIZE * 2 + ZeroCopyMarketBlock::DATA_SIZE / 2);
+    EXPECT_EQ(pub.broadcast_batch(batch.data(), batch.size(), 7, MarketDataType::Tick), 7u);
+    EXPECT_EQ(pub.get_stats().blocks_sent, 3u);
+    EXPECT_EQ(pub.get_stats().records_sent, 7u);
+
+    size_t received = 0;
+    while (sub.read_message([&](const MessageView& message) { received += message.record_count; })) {
+    }
+    EXPECT_EQ(received, 7u);
+}
+
+TEST(ShmRingTest, FragmentOverrunDropsMessage) {
+    auto config = ring_config(4);
+    LargeShmRingBroadcaster large(config, "large");
+    EXPECT_EQ(large.get_slot_count(), 4u);
+
+    SmallShmRingBroadcaster pub(config, "small");
+    SmallShmRingSubscriber sub(config, "small");
+    // 8个分片超过4个槽位，慢订阅者无法完整重组
+    std::vector<uint8_t> message(SmallMarketBlock::DATA_SIZE * 8, 0x5A);
+    ASSERT_TRUE(pub.broadcast_message(message.data(), message.size(), 8, MarketDataType::OrderBook));
+
+    EXPECT_FALSE(sub.read_message([](const MessageView&) { FAIL(); }));
+    EXPECT_GT(sub.get_receive_stats().overruns, 0u);
+    EXPECT_GT(sub.get_assembler().orphan_fragments(), 0u);
+}
+
+TEST(SubscriptionFilterTest, MatchesHeaderOnly) {
+    SubscriptionFilter filter;
+    MarketBlockHeader header;
+    header.data_type = MarketDataType::Tick;
+    EXPECT_TRUE(filter.accepts_all());
+    EXPECT_TRUE(filter.matches(header));
+
+    filter.add_instruments({3, 130}).add_type(MarketDataType::Tick);
+    EXPECT_EQ(filter.instruments(), (std::vector<uint32_t>{3, 130}));
+    EXPECT_TRUE(filter.matches(header));        // 未标注证券的混合数据块默认放行
+    header.set_instrument(130);
+    EXPECT_EQ(header.instrument(), 130u);
+    EXPECT_TRUE(filter.matches(header));
+    header.set_instrument(4);
+    EXPECT_FALSE(filter.matches(header));
+    header.set_instrument(3);
+    header.data_type = MarketDataType::Kline;
+    EXPECT_FALSE(filter.matches(header));
+
+    header.set_instrument(MarketBlockHeader::NO_INSTRUMENT);
+    header.data_type = MarketDataType::Tick;
+    EXPECT_FALSE(header.has_instrument());
+    filter.accept_untagged(false);
+    EXPECT_FALSE(filter.matches(header));
+}
+
+TEST(ShmRingTest, FilterSkipsNonMatchingBlocks) {
+    auto config = ring_config(64);
+    ShmRingBroadcaster pub(config, "filtered");
+    ShmRingSubscriber sub(config, "filtered");
+    sub.set_filter(SubscriptionFilter().add_instruments({7, 9}).add_type(MarketDataType::Tick));
+
+    for (uint32_t id = 0; id < 20; ++id) {
+        const uint64_t value = id;
+        pub.broadcast(reinterpret_cast<const uint8_t*>(&value), sizeof(value), 1, MarketDataType::Tick, id);
+    }
+    const uint64_t kline = 7;
+    pub.broadcast(reinterpret_cast<const uint8_t*>(&kline), sizeof(kline), 1, MarketDataType::Kline, 7);
+
+    std::vector<uint64_t> values;
+    while (auto payload = sub.receive()) {
+        values.push_back(payload_value(*payload));
+    }
+    EXPECT_EQ(values, (std::vector<uint64_t>{7, 9}));
+    EXPECT_EQ(sub.get_receive_stats().blocks_filtered, 19u);
+    EXPECT_EQ(sub.lag(), 0u);
+}
+
+TEST(ShmRingTest, PartitionedStreamsRouteByInstrument) {
+    auto config = ring_config(64);
+    PartitionedBroadcaster pub(config, "parted", 4);
+
+    const std::vector<uint32_t> wanted = {11, 12};
+    PartitionedSubscriber sub(config, "parted", 4, SubscriptionFilter().add_instruments(wanted));
+    EXPECT_LE(sub.get_partitions().size(), 2u);
+
+    for (uint32_t id = 0; id < 40; ++id) {
+        const uint64_t value = id;
+        ASSERT_TRUE(pub.broadcast(id, reinterpret_cast<const uint8_t*>(&value), sizeof(value), 1, MarketDataType::Tick));
+    }
+    EXPECT_EQ(pub.get_stats().blocks_sent, 40u);
+
+    std::vector<uint64_t> values;
+    while (auto payload = sub.receive()) {
+        values.push_back(payload_value(*payload));
+    }
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(values, (std::vector<uint64_t>{11, 12}));
+}
+
+TEST(LastValueCacheTest, ReadersSeeOnlyChangedInstruments) {
+    const std::string name = "/qaultra_test" + std::to_string(::getpid()) + "_lvc";
+    LastValueCacheWriter writer(name, 100, 16);
+    LastValueCacheReader first(name);
+    LastValueCacheReader second(name);
+    EXPECT_EQ(writer.get_reader_count(), 2u);
+    EXPECT_NE(first.get_reader_index(), second.get_reader_index());
+
+    MarketBlockHeader meta;
+    meta.data_type = MarketDataType::Tick;
+    for (uint64_t round = 0; round < 3; ++round) {
+        for (uint32_t id : {5u, 70u}) {
+            const uint64_t value = id * 100 + round;
+            meta.timestamp_ns = round;
+            ASSERT_TRUE(writer.update(id, reinterpret_cast<const uint8_t*>(&value), sizeof(value), meta));
+        }
+    }
+    const uint64_t too_big[3] = {};
+    EXPECT_FALSE(writer.update(6, reinterpret_cast<const uint8_t*>(too_big), sizeof(too_big), meta));
+    EXPECT_FALSE(writer.update(100, reinterpret_cast<const uint8_t*>(too_big), 8, meta));
+
+    std::vector<std::pair<uint32_t, uint64_t>> seen;
+    EXPECT_EQ(first.drain_dirty([&](const LastValueView& view) {
+        uint64_t value = 0;
+        std::memcpy(&value, view.data, sizeof(value));
+        seen.emplace_back(view.instrument_id, value);
+        EXPECT_EQ(view.version, 3u);
+    }), 2u);
+    EXPECT_EQ(seen, (std::vector<std::pair<uint32_t, uint64_t>>{{5, 502}, {70, 7002}}));
+    EXPECT_EQ(first.drain_dirty([](const LastValueView&) {}), 0u);
+
+    // 第二个读者的脏位独立
+    const uint64_t value = 999;
+    writer.update(70, reinterpret_cast<const uint8_t*>(&value), sizeof(value), meta);
+    EXPECT_EQ(second.drain_dirty([](const LastValueView&) {}), 2u);
+    EXPECT_EQ(first.drain_dirty([](const LastValueView&) {}), 1u);
+
+    LastValueView view;
+    EXPECT_FALSE(first.read(6, view));
+    ASSERT_TRUE(first.read(70, view));
+    EXPECT_EQ(view.version, 4u);
+}
+
+TEST(LastValueCacheTest, ReadGivesUpOnSlotStuckMidWrite) {
+    const std::string name = "/qaultra_test" + std::to_string(::getpid()) + "_lvc_stuck";
+    auto writer = std::make_unique<LastValueCacheWriter>(name, 8, 16);
+    LastValueCacheReader reader(name);
+
+    MarketBlockHeader meta;
+    const uint64_t value = 42;
+    ASSERT_TRUE(writer->update(3, reinterpret_cast<const uint8_t*>(&value), sizeof(value), meta));
+
+    // 模拟写端在写入中途崩溃: 槽位序号停在奇数 (槽位位于映射末尾)
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    struct stat st {};
+    ASSERT_EQ(::fstat(fd, &st), 0);
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    ASSERT_NE(memory, MAP_FAILED);
+    const auto* header = static_cast<const CacheHeader*>(memory);
+    auto* slot = reinterpret_cast<CacheSlotHeader*>(
+        static_cast<uint8_t*>(memory) + size - (header->capacity - 3) * header->slot_size);
+    ASSERT_EQ(slot->sequence.load(), 2u);
+    slot->sequence.store(3);
+
+    LastValueView view;
+    EXPECT_FALSE(reader.read(3, view));
+    EXPECT_EQ(reader.drain_dirty([](const LastValueView&) {}), 0u);
+
+    // 写端关闭后不再重试
+    writer.reset();
+    EXPECT_TRUE(reader.is_closed());
+    EXPECT_FALSE(reader.read(3, view));
+    ::munmap(memory, size);
+}
+
+TEST(ShmRingTest, SlowSubscriberConflatesBacklog) {
+    auto config = ring_config(8);
+    config.conflation_enabled = true;
+    config.conflation_capacity = 64;
+    ShmRingBroadcaster pub(config, "conflate");
+    ShmRingSubscriber slow(config, "conflate");
+    ASSERT_TRUE(slow.has_last_value_cache());
+    slow.set_filter(SubscriptionFilter().add_instruments({1, 2, 3}));
+
+    // 远超环容量的积压
+    for (uint64_t round = 0; round < 50; ++round) {
+        for (uint32_t id = 0; id < 10; ++id) {
+            const uint64_t value = round * 100 + id;
+            pub.broadcast(reinterpret_cast<const uint8_t*>(&value), sizeof(value), 1, MarketDataType::Tick, id);
+        }
+    }
+    EXPECT_EQ(pub.get_last_value_cache()->get_update_count(), 500u);
+
+    std::vector<uint64_t> latest;
+    EXPECT_EQ(slow.catch_up([&](const LastValueView& view) {
+        uint64_t value = 0;
+        std::memcpy(&value, view.data, sizeof(value));
+        latest.push_back(value);
+    }), 3u);
+    EXPECT_EQ(latest, (std::vector<uint64_t>{4901, 4902, 4903}));
+    EXPECT_EQ(slow.lag(), 0u);
+    EXPECT_EQ(slow.get_receive_stats().conflated_samples, 500u);
+
+    // 追赶后继续按序读取
+    const uint64_t value = 7;
+    pub.broadcast(reinterpret_cast<const uint8_t*>(&value), sizeof(value), 1, MarketDataType::Tick, 2);
+    auto payload = slow.receive();
+    ASSERT_TRUE(payload.has_value());
+    EXPECT_EQ(payload_value(*payload), 7u);
+}
+
+TEST(ShmRingTest, PlacementHonoursConfig) {
+    cpu_set_t original;
+    ASSERT_EQ(::sched_getaffinity(0, sizeof(original), &original), 0);
+    int cpu = 0;
+    while (!CPU_ISSET(cpu, &original)) {
+        ++cpu;
+    }
+
+    auto config = ring_config(8);
+    config.cpu_affinity = cpu;
+    config.numa_aware = true;
+    config.lock_memory = true;
+    {
+        ShmRingBroadcaster pub(config, "placement");
+        const BroadcastStats stats = pub.get_stats();
+        EXPECT_TRUE(stats.placement.thread_pinned);
+        EXPECT_EQ(stats.placement.cpu, cpu);
+        EXPECT_EQ(current_cpu(), cpu);
+        EXPECT_EQ(stats.placement.numa_node, cpu_numa_node(cpu));
+        EXPECT_EQ(stats.placement.prefaulted_bytes, stats.memory_usage_bytes);
+        // mlock 受 RLIMIT_MEMLOCK 限制，可能失败
+        EXPECT_TRUE(stats.placement.locked_bytes == 0 ||
+                    stats.placement.locked_bytes == stats.memory_usage_bytes);
+
+        ShmRingSubscriber sub(config, "placement");
+        EXPECT_EQ(sub.get_placement().cpu, cpu);
+        EXPECT_EQ(sub.get_placement().prefaulted_bytes, 0u);
+
+        ASSERT_TRUE(publish_value(pub, 42));
+        auto payload = sub.receive();
+        ASSERT_TRUE(payload.has_value());
+        EXPECT_EQ(payload_value(*payload), 42u);
+    }
+    ::sched_setaffinity(0, sizeof(original), &original);
+}
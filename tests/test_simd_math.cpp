@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include "qaultra/simd/simd_math.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace qaultra::simd;
+
+namespace {
+
+std::vector<SimdLevel> available_levels() {
+    std::vector<SimdLevel> levels;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (level <= detected_simd_level()) {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+template <typename T>
+std::vector<T> random_vector(size_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(-100.0, 100.0);
+    std::vector<T> data(size);
+    for (auto& value : data) {
+        value = static_cast<T>(dist(rng));
+    }
+    return data;
+}
+
+const std::vector<size_t> SIZES = {0, 1, 3, 7, 8, 15, 16, 17, 31, 33, 63, 64, 65, 127, 1001};
+
+} // namespace
+
+class SimdMathTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        saved_level = active_simd_level();
+        saved_deterministic = simd_deterministic();
+    }
+
+    void TearDown() override {
+        set_simd_level(saved_level);
+        set_simd_deterministic(saved_deterministic);
+    }
+
+    SimdLevel saved_level = SimdLevel::Scalar;
+    bool saved_deterministic = false;
+};
+
+TEST_F(SimdMathTest, LevelSelection) {
+    EXPECT_EQ(simd_level_name(SimdLevel::AVX2), std::string("avx2"));
+    EXPECT_LE(active_simd_level(), detected_simd_level());
+
+    ASSERT_TRUE(set_simd_level(SimdLevel::Scalar));
+    EXPECT_EQ(active_simd_level(), SimdLevel::Scalar);
+    EXPECT_EQ(SimdMath::get_simd_stride(), 1u);
+
+    ASSERT_TRUE(set_simd_level(detected_simd_level()));
+    if (detected_simd_level() < SimdLevel::AVX512) {
+        EXPECT_FALSE(set_simd_level(SimdLevel::AVX512));
+        EXPECT_EQ(active_simd_level(), detected_simd_level());
+    }
+}
+
+TEST_F(SimdMathTest, DeterministicReductionsMatchScalarBitForBit) {
+    set_simd_deterministic(true);
+    // 偏移 1 个元素，保证向量加载不对齐
+    const auto x = random_vector<double>(1002, 1);
+    const auto y = random_vector<double>(1002, 2);
+    const auto xf = random_vector<float>(1002, 3);
+    const auto yf = random_vector<float>(1002, 4);
+
+    for (size_t n : SIZES) {
+        ASSERT_TRUE(set_simd_level(SimdLevel::Scalar));
+        const double sum = SimdMath::sum(x.data() + 1, n);
+        const double dot = SimdMath::dot_product(x.data() + 1, y.data() + 1, n);
+        const double sd = SimdMath::std_dev(x.data() + 1, n, 1.5);
+        const float sum_f = SimdMath::sum(xf.data() + 1, n);
+        const float dot_f = SimdMath::dot_product(xf.data() + 1, yf.data() + 1, n);
+
+        for (SimdLevel level : available_levels()) {
+            ASSERT_TRUE(set_simd_level(level));
+            SCOPED_TRACE(std::string(simd_level_name(level)) + " n=" + std::to_string(n));
+            EXPECT_EQ(SimdMath::sum(x.data() + 1, n), sum);
+            EXPECT_EQ(SimdMath::dot_product(x.data() + 1, y.data() + 1, n), dot);
+            EXPECT_EQ(SimdMath::std_dev(x.data() + 1, n, 1.5), sd);
+            EXPECT_EQ(SimdMath::sum(xf.data() + 1, n), sum_f);
+            EXPECT_EQ(SimdMath::dot_product(xf.data() + 1, yf.data() + 1, n), dot_f);
+        }
+    }
+}
+
+TEST_F(SimdMathTest, KernelsMatchNaiveLoopsOnEveryLevel) {
+    set_simd_deterministic(false);
+    const auto a = random_vector<double>(1002, 5);
+    const auto b = random_vector<double>(1002, 6);
+
+    for (SimdLevel level : available_levels()) {
+        ASSERT_TRUE(set_simd_level(level));
+        for (size_t n : SIZES) {
+            SCOPED_TRACE(std::string(simd_level_name(level)) + " n=" + std::to_string(n));
+            const double* pa = a.data() + 1;
+            const double* pb = b.data() + 1;
+            std::vector<double> sum(n), diff(n), prod(n), scaled(n);
+            SimdMath::add(pa, pb, sum.data(), n);
+            SimdMath::subtract(pa, pb, diff.data(), n);
+            SimdMath::multiply(pa, pb, prod.data(), n);
+            SimdMath::multiply_scalar(pa, 0.5, scaled.data(), n);
+
+            double naive_sum = 0.0;
+            double naive_dot = 0.0;
+            double naive_min = n ? pa[0] : 0.0;
+            double naive_max = n ? pa[0] : 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                EXPECT_EQ(sum[i], pa[i] + pb[i]);
+                EXPECT_EQ(diff[i], pa[i] - pb[i]);
+                EXPECT_EQ(prod[i], pa[i] * pb[i]);
+                EXPECT_EQ(scaled[i], pa[i] * 0.5);
+                naive_sum += pa[i];
+                naive_dot += pa[i] * pb[i];
+                naive_min = std::min(naive_min, pa[i]);
+                naive_max = std::max(naive_max, pa[i]);
+            }
+            EXPECT_NEAR(SimdMath::sum(pa, n), naive_sum, 1e-9);
+            EXPECT_NEAR(SimdMath::dot_product(pa, pb, n), naive_dot, 1e-6);
+            EXPECT_EQ(SimdMath::min(pa, n), naive_min);
+            EXPECT_EQ(SimdMath::max(pa, n), naive_max);
+        }
+    }
+}
+
+TEST_F(SimdMathTest, Indicators) {
+    const std::vector<double> prices = {10, 11, 12, 11, 13, 14, 13, 15, 16, 15, 17, 18};
+    const size_t n = prices.size();
+
+    std::vector<double> ma(n);
+    SimdMath::moving_average(prices.data(), ma.data(), n, 3);
+    EXPECT_TRUE(std::isnan(ma[0]));
+    EXPECT_TRUE(std::isnan(ma[1]));
+    EXPECT_DOUBLE_EQ(ma[2], 11.0);
+    EXPECT_DOUBLE_EQ(ma[11], (15.0 + 17.0 + 18.0) / 3.0);
+
+    std::vector<double> upper(n), lower(n);
+    SimdMath::bollinger_bands(prices.data(), upper.data(), lower.data(), n, 3, 2.0);
+    EXPECT_TRUE(std::isnan(upper[1]));
+    EXPECT_NEAR(upper[2], 11.0 + 2.0 * std::sqrt(2.0 / 3.0), 1e-12);
+    EXPECT_NEAR(lower[2], 11.0 - 2.0 * std::sqrt(2.0 / 3.0), 1e-12);
+
+    std::vector<double> rsi(n);
+    SimdMath::rsi(prices.data(), rsi.data(), n, 3);
+    EXPECT_TRUE(std::isnan(rsi[2]));
+    // 前三个变动 +1 +1 -1: 平均涨幅 2/3，平均跌幅 1/3
+    EXPECT_NEAR(rsi[3], 100.0 - 100.0 / 3.0, 1e-12);
+    const double gain = (2.0 / 3.0 * 2.0 + 2.0) / 3.0;
+    const double loss = (1.0 / 3.0 * 2.0) / 3.0;
+    EXPECT_NEAR(rsi[4], 100.0 - 100.0 / (1.0 + gain / loss), 1e-12);
+
+    std::vector<double> macd(n), signal(n), hist(n);
+    SimdMath::macd(prices.data(), macd.data(), signal.data(), hist.data(), n, 3, 6, 4);
+    std::vector<double> fast(n), slow(n);
+    SimdMath::ema(prices.data(), fast.data(), n, 0.5);
+    SimdMath::ema(prices.data(), slow.data(), n, 2.0 / 7.0);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_DOUBLE_EQ(macd[i], fast[i] - slow[i]);
+        EXPECT_DOUBLE_EQ(hist[i], macd[i] - signal[i]);
+    }
+
+    std::vector<double> returns(n - 1);
+    SimdMath::returns(prices.data(), returns.data(), n);
+    EXPECT_NEAR(returns[0], 0.1, 1e-15);
+}
+
+TEST_F(SimdMathTest, FinancialMath) {
+    const std::vector<double> prices = {10.0, 20.0, 5.0};
+    const std::vector<double> quantities = {100.0, 50.0, 200.0};
+    EXPECT_DOUBLE_EQ(FinancialMath::portfolio_value(prices.data(), quantities.data(), 3), 3000.0);
+
+    std::vector<double> values(3), weights(3);
+    FinancialMath::position_values(prices.data(), quantities.data(), values.data(), 3);
+    FinancialMath::portfolio_weights(values.data(), weights.data(), 3);
+    EXPECT_DOUBLE_EQ(weights[0], 1.0 / 3.0);
+
+    const std::vector<double> covariance = {0.04, 0.01, 0.0,
+                                            0.01, 0.09, 0.0,
+                                            0.0, 0.0, 0.16};
+    const std::vector<double> w = {0.5, 0.3, 0.2};
+    EXPECT_NEAR(FinancialMath::portfolio_variance(w.data(), covariance.data(), 3),
+                0.25 * 0.04 + 0.09 * 0.09 + 0.04 * 0.16 + 2 * 0.5 * 0.3 * 0.01, 1e-15);
+
+    std::vector<double> returns(100);
+    for (size_t i = 0; i < returns.size(); ++i) {
+        returns[i] = (static_cast<double>(i) - 50.0) / 1000.0;
+    }
+    // 95% 置信度: 第 5 小的收益 (下标 5)
+    EXPECT_DOUBLE_EQ(FinancialMath::value_at_risk(returns.data(), 100, 0.95), 0.045);
+    EXPECT_NEAR(FinancialMath::expected_shortfall(returns.data(), 100, 0.95), 0.0475, 1e-15);
+
+    std::vector<double> market(100), asset(100);
+    for (size_t i = 0; i < 100; ++i) {
+        market[i] = std::sin(static_cast<double>(i)) / 100.0;
+        asset[i] = 1.5 * market[i] + 0.001;
+    }
+    EXPECT_NEAR(FinancialMath::beta(asset.data(), market.data(), 100), 1.5, 1e-12);
+    EXPECT_NEAR(FinancialMath::correlation(asset.data(), market.data(), 100), 1.0, 1e-12);
+
+    const std::vector<double> cumulative = {1.0, 1.2, 0.9, 1.1, 1.3};
+    EXPECT_DOUBLE_EQ(FinancialMath::max_drawdown(cumulative.data(), cumulative.size()), 0.25);
+}
@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+#include "qaultra/data/tick_store.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace qaultra::data;
+
+namespace {
+
+constexpr int64_t NS = 1000000000LL;
+
+StoredTick make_tick(int64_t ts, double price, double cum_volume) {
+    StoredTick tick;
+    tick.timestamp_ns = ts;
+    tick.last_price = price;
+    tick.bid_price = price - 0.01;
+    tick.ask_price = price + 0.01;
+    tick.volume = cum_volume;
+    tick.amount = cum_volume * price;
+    return tick;
+}
+
+std::vector<TickRecord> drain(TickCursor& cursor) {
+    std::vector<TickRecord> records;
+    TickRecord record;
+    while (cursor.next(record)) {
+        records.push_back(record);
+    }
+    return records;
+}
+
+} // namespace
+
+class TickStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = (std::filesystem::temp_directory_path() /
+                ("qaultra_tick_store_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name())))
+                   .string();
+        std::filesystem::remove_all(root);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+
+    TickStoreOptions small_blocks() const {
+        TickStoreOptions options;
+        options.block_ticks = 16;
+        return options;
+    }
+
+    std::string root;
+};
+
+TEST_F(TickStoreTest, RoundTripPreservesValues) {
+    {
+        TickStoreWriter writer(root, small_blocks());
+        for (int i = 0; i < 100; ++i) {
+            ASSERT_TRUE(writer.append("TS.A", make_tick(i * NS, 10.0 + 0.01 * (i % 7), 100.0 * i)));
+        }
+    }
+
+    TickStore store(root);
+    auto info = store.info("TS.A");
+    EXPECT_EQ(info.tick_count, 100u);
+    EXPECT_EQ(info.block_count, 7u);
+    EXPECT_EQ(info.first_timestamp_ns, 0);
+    EXPECT_EQ(info.last_timestamp_ns, 99 * NS);
+    // 增量编码后远小于定长存储 (6个8字节字段)
+    EXPECT_LT(info.bytes, 100u * 48u / 2u);
+
+    auto cursor = store.scan(std::vector<std::string>{"TS.A"});
+    auto records = drain(cursor);
+    ASSERT_EQ(records.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        const auto expected = make_tick(i * NS, 10.0 + 0.01 * (i % 7), 100.0 * i);
+        EXPECT_EQ(records[i].instrument_id, intern_instrument("TS.A"));
+        EXPECT_EQ(records[i].tick.timestamp_ns, expected.timestamp_ns);
+        EXPECT_DOUBLE_EQ(records[i].tick.last_price, expected.last_price);
+        EXPECT_DOUBLE_EQ(records[i].tick.bid_price, expected.bid_price);
+        EXPECT_DOUBLE_EQ(records[i].tick.ask_price, expected.ask_price);
+        EXPECT_DOUBLE_EQ(records[i].tick.volume, expected.volume);
+        EXPECT_NEAR(records[i].tick.amount, expected.amount, 0.005);
+    }
+}
+
+TEST_F(TickStoreTest, TimeRangeSeeksWithinBlocks) {
+    {
+        TickStoreWriter writer(root, small_blocks());
+        for (int i = 0; i < 200; ++i) {
+            writer.append("TS.A", make_tick(i * NS, 10.0, i));
+        }
+    }
+
+    TickStore store(root);
+    auto cursor = store.scan(std::vector<std::string>{"TS.A"}, 37 * NS, 150 * NS);
+    auto records = drain(cursor);
+    ASSERT_EQ(records.size(), 113u);
+    EXPECT_EQ(records.front().tick.timestamp_ns, 37 * NS);
+    EXPECT_EQ(records.back().tick.timestamp_ns, 149 * NS);
+
+    auto empty = store.scan(std::vector<std::string>{"TS.A"}, 500 * NS, 600 * NS);
+    TickRecord record;
+    EXPECT_FALSE(empty.next(record));
+}
+
+TEST_F(TickStoreTest, MergesInstrumentsByTime) {
+    {
+        TickStoreWriter writer(root, small_blocks());
+        for (int i = 0; i < 50; ++i) {
+            writer.append("TS.A", make_tick(i * 2 * NS, 10.0, i));
+            writer.append("TS.B", make_tick((i * 2 + 1) * NS, 20.0, i));
+            writer.append("TS.C", make_tick(i * 2 * NS, 30.0, i));
+        }
+    }
+
+    TickStore store(root);
+    EXPECT_EQ(store.instruments(), (std::vector<std::string>{"TS.A", "TS.B", "TS.C"}));
+
+    auto cursor = store.scan(std::vector<std::string>{"TS.A", "TS.B"});
+    auto records = drain(cursor);
+    ASSERT_EQ(records.size(), 100u);
+    for (size_t i = 1; i < records.size(); ++i) {
+        EXPECT_LE(records[i - 1].tick.timestamp_ns, records[i].tick.timestamp_ns);
+    }
+
+    // 空列表扫描全部证券，同一时间戳按 InstrumentId 排序
+    auto all = store.scan(std::vector<std::string>{});
+    auto merged = drain(all);
+    ASSERT_EQ(merged.size(), 150u);
+    EXPECT_EQ(merged[0].instrument_id, intern_instrument("TS.A"));
+    EXPECT_EQ(merged[1].instrument_id, intern_instrument("TS.C"));
+    EXPECT_EQ(merged[2].instrument_id, intern_instrument("TS.B"));
+
+    std::vector<TickRecord> batch;
+    auto by_id = store.scan(std::vector<InstrumentId>{intern_instrument("TS.C")}, 0, 10 * NS);
+    EXPECT_EQ(by_id.next_batch(batch, 3), 3u);
+    EXPECT_EQ(by_id.next_batch(batch, 100), 2u);
+}
+
+TEST_F(TickStoreTest, AppendsAcrossSessions) {
+    {
+        TickStoreWriter writer(root, small_blocks());
+        for (int i = 0; i < 20; ++i) {
+            writer.append("TS.A", make_tick(i * NS, 10.0, i));
+        }
+    }
+    {
+        // 续写时拒绝时间倒退
+        TickStoreWriter writer(root, small_blocks());
+        EXPECT_FALSE(writer.append("TS.A", make_tick(5 * NS, 10.0, 0)));
+        for (int i = 20; i < 40; ++i) {
+            EXPECT_TRUE(writer.append("TS.A", make_tick(i * NS, 11.0, i)));
+        }
+    }
+
+    TickStore store(root);
+    EXPECT_EQ(store.info("TS.A").tick_count, 40u);
+
+    auto cursor = store.scan(std::vector<std::string>{"TS.A"}, 15 * NS, 25 * NS);
+    auto records = drain(cursor);
+    ASSERT_EQ(records.size(), 10u);
+    EXPECT_DOUBLE_EQ(records[4].tick.last_price, 10.0);
+    EXPECT_DOUBLE_EQ(records[5].tick.last_price, 11.0);
+}
+
+TEST_F(TickStoreTest, IgnoresTruncatedTail) {
+    {
+        TickStoreWriter writer(root, small_blocks());
+        for (int i = 0; i < 32; ++i) {
+            writer.append("TS.A", make_tick(i * NS, 10.0, i));
+        }
+    }
+
+    // 模拟写入中断: 截断最后一个数据块
+    const auto path = std::filesystem::path(root) / "TS.A.qts";
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+
+    TickStore store(root);
+    EXPECT_EQ(store.info("TS.A").tick_count, 16u);
+    auto cursor = store.scan(std::vector<std::string>{"TS.A"});
+    EXPECT_EQ(drain(cursor).size(), 16u);
+}
+
+TEST_F(TickStoreTest, DistinctCodesUseDistinctFiles) {
+    const std::string max_code(32, 'L');
+    {
+        TickStoreWriter writer(root, small_blocks());
+        ASSERT_TRUE(writer.append("TS/X", make_tick(1 * NS, 10.0, 1)));
+        ASSERT_TRUE(writer.append("TS_X", make_tick(2 * NS, 20.0, 2)));
+        ASSERT_TRUE(writer.append("TS_X", make_tick(3 * NS, 21.0, 3)));
+        ASSERT_TRUE(writer.append(max_code, make_tick(4 * NS, 30.0, 4)));
+        // 超过文件头容量的代码直接拒绝，不截断
+        EXPECT_FALSE(writer.append(max_code + "M", make_tick(5 * NS, 40.0, 5)));
+    }
+
+    TickStore store(root);
+    EXPECT_EQ(store.instruments(), (std::vector<std::string>{max_code, "TS/X", "TS_X"}));
+    EXPECT_EQ(store.info("TS/X").tick_count, 1u);
+    EXPECT_EQ(store.info("TS_X").tick_count, 2u);
+    EXPECT_EQ(store.info(max_code).tick_count, 1u);
+    EXPECT_EQ(store.info(max_code + "M").tick_count, 0u);
+
+    // 拒绝只报告一次
+    {
+        TickStoreWriter writer(root, small_blocks());
+        ::testing::internal::CaptureStderr();
+        EXPECT_FALSE(writer.append(max_code + "M", make_tick(6 * NS, 40.0, 6)));
+        EXPECT_FALSE(writer.append(max_code + "M", make_tick(7 * NS, 40.0, 7)));
+        const std::string log = ::testing::internal::GetCapturedStderr();
+        EXPECT_EQ(log.find(max_code), log.rfind(max_code));
+        EXPECT_NE(log.find(max_code), std::string::npos);
+    }
+
+    auto cursor = store.scan(std::vector<std::string>{"TS/X"});
+    auto records = drain(cursor);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_DOUBLE_EQ(records[0].tick.last_price, 10.0);
+}
+
+TEST_F(TickStoreTest, ScanAllAndDuplicateCodes) {
+    {
+        TickStoreWriter writer(root, small_blocks());
+        for (int i = 0; i < 20; ++i) {
+            writer.append("TS.A", make_tick(i * NS, 10.0, i));
+            writer.append("TS.B", make_tick(i * NS, 20.0, i));
+        }
+    }
+
+    TickStore store(root);
+    auto all = store.scan_all();
+    EXPECT_EQ(drain(all).size(), 40u);
+    auto empty_list = store.scan({});
+    EXPECT_EQ(drain(empty_list).size(), 40u);
+    auto window = store.scan_all(5 * NS, 10 * NS);
+    EXPECT_EQ(drain(window).size(), 10u);
+
+    // 重复代码只打开一次
+    auto duplicated = store.scan({"TS.A", "TS.A"});
+    EXPECT_EQ(drain(duplicated).size(), 20u);
+    const InstrumentId a = intern_instrument("TS.A");
+    auto by_id = store.scan(std::vector<InstrumentId>{a, a});
+    EXPECT_EQ(drain(by_id).size(), 20u);
+}
+
+TEST_F(TickStoreTest, FailedFlushKeepsBufferedTicks) {
+    TickStoreWriter writer(root, small_blocks());
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(writer.append("TS.A", make_tick(i * NS, 10.0, i)));
+    }
+
+    // 目录消失时写入失败，缓冲的 Tick 保留到下次 flush
+    std::filesystem::remove_all(root);
+    EXPECT_FALSE(writer.flush());
+    std::filesystem::create_directories(root);
+    EXPECT_TRUE(writer.flush());
+
+    TickStore store(root);
+    EXPECT_EQ(store.info("TS.A").tick_count, 5u);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "qaultra/analysis/performance_analyzer.hpp"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace qaultra::analysis;
+
+namespace {
+
+std::vector<TradePair> random_trades(size_t count, size_t assets, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> move(0.0, 0.5);
+    std::uniform_int_distribution<size_t> pick(0, assets - 1);
+    std::vector<TradePair> trades;
+    for (size_t i = 0; i < count; ++i) {
+        const std::string code = "AS" + std::to_string(pick(rng));
+        const double open = 10.0 + static_cast<double>(i % 7);
+        TradePair trade(code, 100.0 * (1 + i % 3), open, "2024-01-02", i % 4 != 0);
+        trade.close_position(open + move(rng), "2024-01-05 14:30:00");
+        trade.hold_gap_days = static_cast<double>(1 + i % 9);
+        trades.push_back(trade);
+    }
+    return trades;
+}
+
+void expect_metrics_near(const RiskMetrics& actual, const RiskMetrics& expected) {
+    EXPECT_EQ(actual.total_trades, expected.total_trades);
+    EXPECT_EQ(actual.profitable_trades, expected.profitable_trades);
+    EXPECT_EQ(actual.loss_trades, expected.loss_trades);
+    EXPECT_DOUBLE_EQ(actual.win_rate, expected.win_rate);
+    EXPECT_DOUBLE_EQ(actual.largest_win, expected.largest_win);
+    EXPECT_DOUBLE_EQ(actual.largest_loss, expected.largest_loss);
+    EXPECT_NEAR(actual.average_win, expected.average_win, 1e-9);
+    EXPECT_NEAR(actual.average_loss, expected.average_loss, 1e-9);
+    EXPECT_NEAR(actual.profit_loss_ratio, expected.profit_loss_ratio, 1e-9);
+    EXPECT_NEAR(actual.average_holding_period, expected.average_holding_period, 1e-12);
+    EXPECT_NEAR(actual.total_return, expected.total_return, 1e-9 * std::max(1.0, std::abs(expected.total_return)));
+    EXPECT_NEAR(actual.annual_return, expected.annual_return, 1e-9 * std::max(1.0, std::abs(expected.annual_return)));
+    EXPECT_NEAR(actual.annual_volatility, expected.annual_volatility, 1e-12);
+    EXPECT_NEAR(actual.sharpe_ratio, expected.sharpe_ratio, 1e-9);
+    EXPECT_NEAR(actual.sortino_ratio, expected.sortino_ratio, 1e-9);
+    EXPECT_NEAR(actual.max_drawdown, expected.max_drawdown, 1e-12);
+    EXPECT_DOUBLE_EQ(actual.value_at_risk_95, expected.value_at_risk_95);
+    EXPECT_NEAR(actual.conditional_var_95, expected.conditional_var_95, 1e-15);
+    EXPECT_NEAR(actual.skew, expected.skew, 1e-9);
+    EXPECT_NEAR(actual.kurtosis, expected.kurtosis, 1e-9);
+}
+
+} // namespace
+
+TEST(TradePairStoreTest, InternsCodesAndRoundTrips) {
+    TradePairStore store;
+    TradePair first("000001", 100.0, 10.0, "2024-01-02");
+    first.close_position(11.0, "2024-01-05 14:30:00");
+    TradePair second("600000", 200.0, 8.0, "2024-01-03", false);
+    second.close_position(7.5, "2024-01-04");
+    store.append(first);
+    store.append(second);
+    store.append(first);
+
+    ASSERT_EQ(store.size(), 3u);
+    EXPECT_EQ(store.codes, (std::vector<std::string>{"000001", "600000"}));
+    EXPECT_EQ(store.code, (std::vector<uint32_t>{0, 1, 0}));
+    EXPECT_EQ(store.close_time[0] - store.open_time[0],
+              (3LL * 86400 + 14 * 3600 + 30 * 60) * 1000000000LL);
+
+    const TradePair restored = store.row(1);
+    EXPECT_EQ(restored.code, "600000");
+    EXPECT_EQ(restored.open_date, "2024-01-03");
+    EXPECT_FALSE(restored.is_buy_open);
+    EXPECT_EQ(restored.pnl_money, second.pnl_money);
+    EXPECT_EQ(store.row(0).close_date, "2024-01-05 14:30:00");
+}
+
+TEST(TradePairStoreTest, AccumulatorMatchesSingleAssetAnalyzer) {
+    const auto trades = random_trades(500, 1, 3);
+    TradeStatsAccumulator stats;
+    SingleAssetPerformanceAnalyzer reference("AS0");
+    for (size_t i = 0; i < trades.size(); ++i) {
+        stats.add(trades[i].pnl_money, trades[i].get_return_rate(), trades[i].hold_gap_days);
+        reference.add_trade_pair(trades[i]);
+        if (i == 0 || i == 2 || i == 3 || i + 1 == trades.size()) {
+            expect_metrics_near(stats.metrics(), reference.calculate_metrics());
+        }
+    }
+    EXPECT_EQ(TradeStatsAccumulator().metrics().total_trades, 0);
+
+    // 首笔收益率为 0 时总收益率无定义，记为 0
+    TradeStatsAccumulator flat;
+    flat.add(0.0, 0.0, 1.0);
+    flat.add(10.0, 0.1, 1.0);
+    EXPECT_EQ(flat.metrics().total_return, 0.0);
+    EXPECT_EQ(flat.metrics().value_at_risk_95, 0.0);
+}
+
+TEST(TradePairStoreTest, PortfolioReportIsIncremental) {
+    const auto trades = random_trades(900, 6, 9);
+    PortfolioPerformanceAnalyzer analyzer("acc");
+    std::vector<double> curve;
+    std::vector<std::string> dates;
+    for (int i = 0; i < 60; ++i) {
+        curve.push_back(1000000.0 * (1.0 + 0.001 * i + 0.01 * std::sin(i)));
+        dates.push_back("2024-01-" + std::to_string(10 + i % 20));
+    }
+    analyzer.add_account_curve(curve, dates);
+
+    analyzer.add_trade_pairs(std::vector<TradePair>(trades.begin(), trades.begin() + 600));
+    const PerformanceReport before = analyzer.generate_report(false);
+    EXPECT_TRUE(before.trade_pairs.empty());
+    EXPECT_EQ(before.metrics.total_trades, 600);
+
+    for (size_t i = 600; i < trades.size(); ++i) {
+        analyzer.add_trade_pair(trades[i]);
+    }
+    const PerformanceReport report = analyzer.generate_report();
+    ASSERT_EQ(report.trade_pairs.size(), trades.size());
+    EXPECT_EQ(report.trade_pairs[700].pnl_money, trades[700].pnl_money);
+    EXPECT_EQ(report.metrics.total_trades, 900);
+    EXPECT_EQ(report.metrics.sharpe_ratio, before.metrics.sharpe_ratio);    // 净值曲线未变
+    EXPECT_EQ(report.cumulative_returns.size(), curve.size());
+
+    // 分品种指标与逐品种全量重算一致
+    ASSERT_EQ(report.by_asset.size(), 6u);
+    for (const auto& [asset, metrics] : report.by_asset) {
+        SingleAssetPerformanceAnalyzer reference(asset);
+        for (const auto& trade : trades) {
+            if (trade.code == asset) {
+                reference.add_trade_pair(trade);
+            }
+        }
+        expect_metrics_near(metrics, reference.calculate_metrics());
+    }
+
+    EXPECT_EQ(analyzer.get_trade_count(), 900u);
+    const auto tail = analyzer.get_trade_pairs(895);
+    ASSERT_EQ(tail.size(), 5u);
+    EXPECT_EQ(tail[4].code, trades[899].code);
+}
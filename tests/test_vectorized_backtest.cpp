@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include "qaultra/engine/vectorized_backtest.hpp"
+#include "qaultra/account/marketpreset.hpp"
+#include "backtest_fixtures.hpp"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace qaultra::engine;
+using namespace qaultra::engine::fixtures;
+
+namespace {
+
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+/**
+ * @brief 事件驱动的参考实现: 按调仓前净值换算目标市值，先卖后买
+ */
+class TargetWeightStrategy : public Strategy {
+public:
+    explicit TargetWeightStrategy(const std::vector<double>& weights) : weights_(weights) {}
+
+    void initialize(StrategyContext&) override {}
+
+    void handle_data(StrategyContext& context) override {
+        const size_t n = context.symbol_count();
+        const double* weights = weights_.data() + context.bar_index * n;
+        const double value = context.get_portfolio_value();
+        for (bool selling : {true, false}) {
+            for (size_t s = 0; s < n; ++s) {
+                const double price = context.get_price(s);
+                if (std::isnan(weights[s]) || !(price > 0.0)) {
+                    continue;
+                }
+                const bool reduces = weights[s] * value / price < context.get_holding(s);
+                if (reduces == selling) {
+                    context.order_target_value(s, weights[s] * value);
+                }
+            }
+        }
+    }
+
+    std::map<std::string, double> get_parameters() const override { return {}; }
+    void set_parameter(const std::string&, double) override {}
+
+private:
+    const std::vector<double>& weights_;
+};
+
+/**
+ * @brief 每 5 根调仓一次的随机权重 (每次调仓权重和为 total)，其余行为 NaN (不调仓)
+ */
+std::vector<double> rebalance_weights(size_t bars, size_t symbols, double total, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    std::vector<double> weights(bars * symbols, NaN);
+    for (size_t t = 0; t < bars; t += 5) {
+        double sum = 0.0;
+        for (size_t s = 0; s < symbols; ++s) {
+            weights[t * symbols + s] = dist(rng) < 0.3 ? 0.0 : dist(rng);
+            sum += weights[t * symbols + s];
+        }
+        for (size_t s = 0; s < symbols; ++s) {
+            weights[t * symbols + s] *= total / sum;
+        }
+    }
+    return weights;
+}
+
+} // namespace
+
+TEST(VectorizedBacktestTest, ReconcilesWithEventDrivenEngine) {
+    constexpr size_t SYMBOLS = 12;
+    constexpr size_t BARS = 200;
+    BacktestConfig config;
+    config.initial_cash = 1000000.0;
+    config.enable_logging = false;
+
+    BacktestEngine loader(config);
+    ASSERT_TRUE(loader.load_bars(random_walk(SYMBOLS, BARS, 11, true)));
+    const auto panel = loader.shared_market_data();
+
+    // 每 5 根调仓一次，其余行不调仓；权重和 0.95
+    const std::vector<double> weights = rebalance_weights(BARS, SYMBOLS, 0.95, 5);
+
+    VectorizedBacktest vectorized(config, panel);
+    const VectorizedResults fast = vectorized.run(weights, true);
+
+    BacktestEngine engine(config);
+    engine.set_market_data(panel);
+    engine.add_strategy(std::make_shared<TargetWeightStrategy>(weights));
+    const BacktestResults slow = engine.run();
+
+    ASSERT_EQ(fast.equity_curve.size(), BARS);
+    for (size_t t = 0; t < BARS; ++t) {
+        ASSERT_NEAR(fast.equity_curve[t], slow.equity_curve[t], 1e-6) << "bar " << t;
+    }
+    EXPECT_EQ(fast.total_trades, slow.total_trades);
+    EXPECT_NEAR(fast.sharpe_ratio, slow.sharpe_ratio, 1e-9);
+    EXPECT_NEAR(fast.max_drawdown, slow.max_drawdown, 1e-12);
+    EXPECT_NEAR(fast.annual_return, slow.annual_return, 1e-12);
+    EXPECT_NEAR(fast.win_rate, slow.win_rate, 1e-12);
+    EXPECT_NEAR(fast.profit_factor, slow.profit_factor, 1e-9);
+    EXPECT_GT(fast.total_trades, 0);
+
+    // 未上市的标的不持仓；持仓按手取整；不调仓的行持仓不变
+    EXPECT_EQ(fast.holdings[3 * SYMBOLS + 5], 0.0);
+    for (double volume : fast.holdings) {
+        ASSERT_EQ(std::fmod(volume, config.lot_size), 0.0);
+    }
+    for (size_t s = 0; s < SYMBOLS; ++s) {
+        EXPECT_EQ(fast.holdings[7 * SYMBOLS + s], fast.holdings[5 * SYMBOLS + s]);
+    }
+    EXPECT_EQ(fast.turnover[6], 0.0);
+    EXPECT_NEAR(fast.costs[0], fast.turnover[0] * config.commission_rate, 1e-9);
+
+    EXPECT_THROW(vectorized.run(std::vector<double>(3)), std::invalid_argument);
+    EXPECT_THROW(VectorizedBacktest(config, nullptr), std::invalid_argument);
+}
+
+TEST(VectorizedBacktestTest, FullyInvestedRejectsUnaffordableBuys) {
+    constexpr size_t SYMBOLS = 12;
+    constexpr size_t BARS = 200;
+    BacktestConfig config;
+    config.initial_cash = 1000000.0;
+    config.commission_rate = 0.001;
+    config.lot_size = 1.0;   // 取整余量小于买入费用
+    config.enable_logging = false;
+
+    BacktestEngine loader(config);
+    ASSERT_TRUE(loader.load_bars(random_walk(SYMBOLS, BARS, 11, true)));
+    const auto panel = loader.shared_market_data();
+
+    // 权重和恰为 1: 买入费用使靠后的买单超出现金
+    const std::vector<double> weights = rebalance_weights(BARS, SYMBOLS, 1.0, 9);
+
+    VectorizedBacktest vectorized(config, panel);
+    const VectorizedResults fast = vectorized.run(weights, true);
+
+    BacktestEngine engine(config);
+    engine.set_market_data(panel);
+    engine.add_strategy(std::make_shared<TargetWeightStrategy>(weights));
+    const BacktestResults slow = engine.run();
+
+    ASSERT_EQ(fast.equity_curve.size(), BARS);
+    for (size_t t = 0; t < BARS; ++t) {
+        ASSERT_GE(fast.cash[t], 0.0) << "bar " << t;
+        ASSERT_NEAR(fast.equity_curve[t], slow.equity_curve[t], 1e-6) << "bar " << t;
+    }
+    EXPECT_EQ(fast.total_trades, slow.total_trades);
+
+    // 至少有一次买单因资金不足被拒: 持仓低于按权重换算的目标
+    bool rejected = false;
+    for (size_t t = 0; t < BARS && !rejected; t += 5) {
+        const double* prices = panel->close_rows.data() + t * SYMBOLS;
+        double value = t == 0 ? config.initial_cash : fast.cash[t - 1];
+        for (size_t s = 0; t > 0 && s < SYMBOLS; ++s) {
+            value += fast.holdings[(t - 1) * SYMBOLS + s] * prices[s];
+        }
+        for (size_t s = 0; s < SYMBOLS; ++s) {
+            const double w = weights[t * SYMBOLS + s];
+            if (t < panel->first_bar[s] || !(prices[s] > 0.0)) {
+                continue;
+            }
+            const double wanted = std::floor(w * value / prices[s] / config.lot_size) * config.lot_size;
+            if (fast.holdings[t * SYMBOLS + s] < wanted) {
+                rejected = true;
+                break;
+            }
+        }
+    }
+    EXPECT_TRUE(rejected);
+}
+
+TEST(VectorizedBacktestTest, MarketPresetCosts) {
+    const std::vector<BarRecord> records = {
+        {"2024-01-02", "000001", 10, 10, 10, 10, 100},
+        {"2024-01-02", "AG2401", 5000, 5000, 5000, 5000, 100},
+        {"2024-01-03", "000001", 11, 11, 11, 11, 100},
+        {"2024-01-03", "AG2401", 5100, 5100, 5100, 5100, 100},
+    };
+    BacktestConfig config;
+    config.initial_cash = 1000000.0;
+    config.lot_size = 1.0;
+    auto panel = std::make_shared<const BarPanel>(BarPanel::from_records(records));
+
+    auto preset = qaultra::account::MarketPreset::create_default();
+    VectorizedBacktest backtest(config, panel);
+    backtest.set_market_preset(preset);
+    const InstrumentCosts& costs = backtest.costs();
+    EXPECT_EQ(costs.multiplier[1], 15.0);                         // 白银 15 千克 / 手
+    EXPECT_DOUBLE_EQ(costs.sell_tax_rate[0], 0.001);              // 股票卖出印花税
+    EXPECT_EQ(costs.sell_tax_rate[1], 0.0);
+
+    // 第 0 根: 股票 10% (10000 股)、白银 15% (2 手，每手 75000)；第 1 根全部卖出
+    const std::vector<double> weights = {0.1, 0.15, 0.0, 0.0};
+    const VectorizedResults results = backtest.run(weights, true);
+    EXPECT_EQ(results.holdings[0], 10000.0);
+    EXPECT_EQ(results.holdings[1], 2.0);
+    EXPECT_EQ(results.holdings[2], 0.0);
+
+    const double buy_fee = 100000.0 * costs.commission_rate[0] + 150000.0 * costs.commission_rate[1] +
+                           2.0 * costs.commission_per_volume[1];
+    const double sell_fee = 110000.0 * (costs.commission_rate[0] + 0.001) + 153000.0 * costs.commission_rate[1] +
+                            2.0 * costs.commission_per_volume[1];
+    EXPECT_NEAR(results.costs[0], buy_fee, 1e-9);
+    EXPECT_NEAR(results.costs[1], sell_fee, 1e-9);
+    EXPECT_NEAR(results.final_value, 1000000.0 + 10000.0 + 3000.0 - buy_fee - sell_fee, 1e-6);
+    EXPECT_EQ(results.total_trades, 4);
+    EXPECT_DOUBLE_EQ(results.win_rate, 1.0);
+
+    InstrumentCosts wrong = InstrumentCosts::uniform(3, 0.0);
+    EXPECT_THROW(backtest.set_costs(wrong), std::invalid_argument);
+}